@@ -9,7 +9,9 @@
 #include "SkAAClip.h"
 #include "SkCanvas.h"
 #include "SkPath.h"
+#include "SkRRect.h"
 #include "SkRandom.h"
+#include "SkRasterClip.h"
 #include "SkRegion.h"
 #include "SkString.h"
 #include "SkClipOpPriv.h"
@@ -242,6 +244,62 @@ private:
     typedef Benchmark INHERITED;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// A scrolling list of rounded cards, each clipped to its rrect at a fractional offset.  With
+// gSkAnalyticRasterClips, the clips stay analytic instead of being scan converted to SkAAClips.
+class AAClipCardsBench : public Benchmark {
+public:
+    explicit AAClipCardsBench(bool analytic) : fAnalytic(analytic) {}
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    const char* onGetName() override {
+        return fAnalytic ? "aaclip_rrect_cards_analytic" : "aaclip_rrect_cards_scanconverted";
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fWasAnalytic = gSkAnalyticRasterClips;
+        gSkAnalyticRasterClips = fAnalytic;
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        gSkAnalyticRasterClips = fWasAnalytic;
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint card, content;
+        card.setColor(0xfff1f3f4);
+        content.setColor(0xff4285f4);
+        content.setAntiAlias(true);
+
+        for (int i = 0; i < loops; ++i) {
+            const SkScalar scroll = (i % 16) * 0.3f;
+            for (int y = 0; y < kCards; y++) {
+                SkRect bounds = SkRect::MakeXYWH(8, y * kCardHeight + 4 - scroll,
+                                                 kWidth - 16, kCardHeight - 8);
+                canvas->save();
+                canvas->clipRRect(SkRRect::MakeRectXY(bounds, 12, 12), true);
+                canvas->drawPaint(card);
+                canvas->drawRect(SkRect::MakeXYWH(bounds.fLeft, bounds.fTop, bounds.width(), 12),
+                                 content);
+                canvas->drawCircle(bounds.fLeft + 20, bounds.centerY(), 14, content);
+                canvas->restore();
+            }
+        }
+    }
+
+    SkIPoint onGetSize() override { return SkIPoint::Make(kWidth, kCards * kCardHeight); }
+
+private:
+    static constexpr int kWidth      = 400,
+                         kCardHeight = 64,
+                         kCards      = 12;
+
+    bool fAnalytic;
+    bool fWasAnalytic = false;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH(return new AAClipBuilderBench(false, false);)
@@ -255,3 +313,5 @@ DEF_BENCH(return new AAClipBench(true, false);)
 DEF_BENCH(return new AAClipBench(true, true);)
 DEF_BENCH(return new NestedAAClipBench(false);)
 DEF_BENCH(return new NestedAAClipBench(true);)
+DEF_BENCH(return new AAClipCardsBench(true);)
+DEF_BENCH(return new AAClipCardsBench(false);)
@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkPath.h"
+#include "SkScan.h"
 #include "sk_tool_utils.h"
 
 enum Align {
@@ -84,3 +85,76 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+// Fills the stroked big path, scaled up to cover a tall canvas, with delta AA split into 1..N
+// bands that generate their coverage deltas in parallel on the default SkExecutor.
+// Run nanobench with --threads to pick how many threads can actually work on those bands.
+class BigPathDAABench : public Benchmark {
+    SkPath      fPath;
+    SkString    fName;
+    int         fThreads;
+
+public:
+    explicit BigPathDAABench(int threads) : fThreads(threads) {
+        fName.printf("bigpath_daa_threads_%d", threads);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    SkIPoint onGetSize() override {
+        return SkIPoint::Make(1024, 1024);
+    }
+
+    void onDelayedSetup() override {
+        SkPath path;
+        sk_tool_utils::make_big_path(path);
+
+        SkPaint stroke;
+        stroke.setStyle(SkPaint::kStroke_Style);
+        stroke.setStrokeWidth(2);
+        stroke.getFillPath(path, &fPath);
+
+        const SkRect r = fPath.getBounds();
+        SkMatrix matrix;
+        matrix.setRectToRect(r, SkRect::MakeWH(1024, 1024), SkMatrix::kFill_ScaleToFit);
+        fPath.transform(matrix);
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fWasForcingDAA = gSkForceDeltaAA;
+        fWasThreads    = gSkDeltaAAThreads;
+        gSkForceDeltaAA   = true;
+        gSkDeltaAAThreads = fThreads;
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        gSkForceDeltaAA   = fWasForcingDAA;
+        gSkDeltaAAThreads = fWasThreads;
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        this->setupPaint(&paint);
+
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    bool fWasForcingDAA = false;
+    int  fWasThreads    = 0;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new BigPathDAABench(1); )
+DEF_BENCH( return new BigPathDAABench(2); )
+DEF_BENCH( return new BigPathDAABench(4); )
+DEF_BENCH( return new BigPathDAABench(8); )
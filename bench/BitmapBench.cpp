@@ -11,6 +11,7 @@
 #include "SkColorPriv.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
+#include "SkShader.h"
 #include "SkString.h"
 #include "sk_tool_utils.h"
 
@@ -211,6 +212,57 @@ private:
     typedef BitmapBench INHERITED;
 };
 
+/** Fill the canvas with a filtered, tiled bitmap shader, so every pixel samples off the edges of
+    the bitmap through the repeat or mirror tiling stages. */
+
+class TiledBitmapBench : public Benchmark {
+    const SkShader::TileMode fTileMode;
+    SkBitmap                 fBitmap;
+    SkString                 fName;
+
+    enum { W = 100 };
+    enum { H = 100 };
+public:
+    explicit TiledBitmapBench(SkShader::TileMode tm) : fTileMode(tm) {
+        fName.printf("bitmap_tiled_%s_bilerp",
+                     SkShader::kRepeat_TileMode == tm ? "repeat" : "mirror");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fBitmap.allocN32Pixels(W, H);
+        fBitmap.eraseColor(SK_ColorWHITE);
+
+        SkCanvas canvas(fBitmap);
+        SkPaint p;
+        p.setAntiAlias(true);
+        p.setColor(SK_ColorRED);
+        canvas.drawCircle(W/2, H/2, W*3/8, p);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setFilterQuality(kLow_SkFilterQuality);
+
+        // A slight scale and skew keeps us sampling between pixels.
+        SkMatrix lm;
+        lm.setScale(1.01f, 0.99f);
+        lm.postSkew(0.02f, 0);
+        paint.setShader(SkShader::MakeBitmapShader(fBitmap, fTileMode, fTileMode, &lm));
+
+        SkISize dim = canvas->getBaseLayerSize();
+        SkRect r = SkRect::MakeIWH(dim.fWidth, dim.fHeight);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawRect(r, paint);
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
 /** Verify optimizations that test source alpha values. */
 
 class SourceAlphaBitmapBench : public BitmapBench {
@@ -326,6 +378,10 @@ DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kOpaque_SkAlphaType, t
 DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kPremul_SkAlphaType, false, false, kScale_Flag | kBilerp_Flag | kBicubic_Flag); )
 DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kPremul_SkAlphaType, false, false, kScale_Flag | kRotate_Flag | kBilerp_Flag | kBicubic_Flag); )
 
+// repeat/mirror tiled bilerp -> SkRasterPipeline bilinear_* stages (lowp when available)
+DEF_BENCH( return new TiledBitmapBench(SkShader::kRepeat_TileMode); )
+DEF_BENCH( return new TiledBitmapBench(SkShader::kMirror_TileMode); )
+
 // source alpha tests -> S32A_Opaque_BlitRow32_{arm,neon}
 DEF_BENCH( return new SourceAlphaBitmapBench(SourceAlphaBitmapBench::kOpaque_SourceAlpha, kN32_SkColorType); )
 DEF_BENCH( return new SourceAlphaBitmapBench(SourceAlphaBitmapBench::kTransparent_SourceAlpha, kN32_SkColorType); )
@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "sk_tool_utils.h"
 #include "SkCanvas.h"
+#include "SkClipMaskCache.h"
 #include "SkColorSpace.h"
 #include "SkImage.h"
 #include "SkPictureRecorder.h"
@@ -66,6 +67,75 @@ DEF_BENCH(return new ClipMaskBench("picture", [](int size) -> sk_sp<SkImage> {
                                     SkColorSpace::MakeSRGB());
 });)
 
+// Replays frames of a static layout, a grid of cards each clipped to its own path, the way a UI
+// redraws each frame.  With gSkCacheRasterClips, only the first frame scan converts the clips.
+class ClipMaskReplayBench : public Benchmark {
+public:
+    explicit ClipMaskReplayBench(bool cached) : fCached(cached) {}
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    const char* onGetName() override {
+        return fCached ? "clipmask_replay_cached" : "clipmask_replay_uncached";
+    }
+
+    void onDelayedSetup() override {
+        SkPaint background, content;
+        background.setColor(0xfff1f3f4);
+        content.setColor(0xff4285f4);
+        content.setAntiAlias(true);
+
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(kSize, kSize);
+        const int kCard = kSize / kCards;
+        for (int y = 0; y < kCards; y++)
+        for (int x = 0; x < kCards; x++) {
+            // Cards with a notched, rounded outline, like a ticket or message bubble.
+            SkPath clip;
+            clip.addRoundRect(SkRect::MakeXYWH(x * kCard + 2, y * kCard + 2, kCard - 4, kCard - 4),
+                              8, 8);
+            clip.addCircle(x * kCard + kCard / 2, y * kCard + 2, 6);
+            clip.setFillType(SkPath::kEvenOdd_FillType);
+
+            canvas->save();
+            canvas->clipPath(clip, true);
+            canvas->drawPaint(background);
+            canvas->drawCircle(x * kCard + 4, y * kCard + 4, kCard / 3, content);
+            canvas->restore();
+        }
+        fPicture = recorder.finishRecordingAsPicture();
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fWasCaching = gSkCacheRasterClips;
+        gSkCacheRasterClips = fCached;
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        gSkCacheRasterClips = fWasCaching;
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawPicture(fPicture);
+        }
+    }
+
+    SkIPoint onGetSize() override { return SkIPoint::Make(kSize, kSize); }
+
+private:
+    static constexpr int kSize  = 512,
+                         kCards = 8;
+
+    bool             fCached;
+    bool             fWasCaching = false;
+    sk_sp<SkPicture> fPicture;
+};
+
+DEF_BENCH(return new ClipMaskReplayBench(true);)
+DEF_BENCH(return new ClipMaskReplayBench(false);)
+
 /////////
 #include "SkSurface.h"
 #include "SkPath.h"
@@ -9,12 +9,14 @@
 #include "SkCanvas.h"
 #include "SkPath.h"
 #include "SkPathOps.h"
+#include "SkRRect.h"
 
 class ClipStrategyBench : public Benchmark {
 public:
     enum class Mode {
         kClipPath,
         kMask,
+        kNestedClips,
     };
 
     ClipStrategyBench(Mode mode, size_t count)
@@ -27,8 +29,10 @@ public:
             this->forEachClipCircle([&](float x, float y, float r) {
                 fClipPath.addCircle(x, y, r);
             });
-        } else {
+        } else if (fMode == Mode::kMask) {
             fName.append("mask_");
+        } else {
+            fName.append("nested_");
         }
         fName.appendf("%zu", count);
     }
@@ -51,6 +55,20 @@ protected:
             if (fMode == Mode::kClipPath) {
                 canvas->save();
                 canvas->clipPath(fClipPath, true);
+            } else if (fMode == Mode::kNestedClips) {
+                // Like a document's nested containers: each clips to a rounded rect inside the
+                // last, some overlapping its edges, and draws a little content.
+                SkRect r = SkRect::MakeIWH(this->getSize().x(), this->getSize().y());
+                for (size_t j = 0; j < fCount; ++j) {
+                    r.fLeft   += (j % 3) ? 3 : 0;
+                    r.fTop    += (j % 2) ? 0 : 5;
+                    r.fRight  -= (j % 3) ? 0 : 2;
+                    r.fBottom -= 1;
+                    canvas->save();
+                    canvas->clipRRect(SkRRect::MakeRectXY(r, 12, 12), true);
+                    canvas->drawRect(SkRect::MakeXYWH(r.fLeft + 4, r.fTop + 4, 16, 8), p);
+                }
+                continue;
             } else {
                 canvas->saveLayer(nullptr, nullptr);
                 this->forEachClipCircle([&](float x, float y, float r) {
@@ -89,3 +107,6 @@ DEF_BENCH( return new ClipStrategyBench(ClipStrategyBench::Mode::kMask, 1  );)
 DEF_BENCH( return new ClipStrategyBench(ClipStrategyBench::Mode::kMask, 5  );)
 DEF_BENCH( return new ClipStrategyBench(ClipStrategyBench::Mode::kMask, 10 );)
 DEF_BENCH( return new ClipStrategyBench(ClipStrategyBench::Mode::kMask, 100);)
+
+DEF_BENCH( return new ClipStrategyBench(ClipStrategyBench::Mode::kNestedClips, 10 );)
+DEF_BENCH( return new ClipStrategyBench(ClipStrategyBench::Mode::kNestedClips, 40 );)
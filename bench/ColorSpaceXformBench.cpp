@@ -6,13 +6,17 @@
 */
 
 #include "Benchmark.h"
+#include "SkAutoPixmapStorage.h"
 #include "SkColor.h"
 #include "SkColorSpaceXformer.h"
 #include "SkColorSpaceXformSteps.h"
+#include "SkConvertPixels.h"
+#include "SkExecutor.h"
 #include "SkMakeUnique.h"
 #include "SkRandom.h"
 
-enum class Mode { steps, xformer };
+// The pixels modes convert a whole big image with SkConvertPixels(), on one thread or many.
+enum class Mode { steps, xformer, pixels_serial, pixels_threaded };
 
 struct ColorSpaceXformBench : public Benchmark {
     ColorSpaceXformBench(Mode mode) : fMode(mode) {}
@@ -22,10 +26,16 @@ struct ColorSpaceXformBench : public Benchmark {
     std::unique_ptr<SkColorSpaceXformSteps>  fSteps;
     std::unique_ptr<SkColorSpaceXformer>     fXformer;
 
+    SkAutoPixmapStorage                      fSrcPixels,
+                                             fDstPixels;
+    std::unique_ptr<SkExecutor>              fExecutor;
+
     const char* onGetName() override {
         switch (fMode) {
             case Mode::steps  : return "ColorSpaceXformBench_steps";
             case Mode::xformer: return "ColorSpaceXformBench_xformer";
+            case Mode::pixels_serial  : return "ColorSpaceXformBench_pixels_serial";
+            case Mode::pixels_threaded: return "ColorSpaceXformBench_pixels_threaded";
         }
         return "";
     }
@@ -40,9 +50,33 @@ struct ColorSpaceXformBench : public Benchmark {
         fSteps = skstd::make_unique<SkColorSpaceXformSteps>(src.get(), kOpaque_SkAlphaType,
                                                             dst.get(), kPremul_SkAlphaType);
         fXformer = SkColorSpaceXformer::Make(dst);  // src is implicitly sRGB, what we want anyway
+
+        if (fMode == Mode::pixels_serial || fMode == Mode::pixels_threaded) {
+            fSrcPixels.alloc(SkImageInfo::MakeN32(4096, 4096, kOpaque_SkAlphaType, src));
+            fDstPixels.alloc(SkImageInfo::MakeN32(4096, 4096, kPremul_SkAlphaType, dst));
+            SkRandom rand;
+            for (int y = 0; y < fSrcPixels.height(); y++) {
+                for (int x = 0; x < fSrcPixels.width(); x++) {
+                    *fSrcPixels.writable_addr32(x, y) = rand.nextU() | 0xFF000000;
+                }
+            }
+        }
+        if (fMode == Mode::pixels_threaded) {
+            fExecutor = SkExecutor::MakeWorkStealingThreadPool();
+        }
     }
 
     void onDraw(int n, SkCanvas* canvas) override {
+        if (fMode == Mode::pixels_serial || fMode == Mode::pixels_threaded) {
+            for (int i = 0; i < n; i++) {
+                SkConvertPixels(fDstPixels.info(), fDstPixels.writable_addr(),
+                                fDstPixels.rowBytes(),
+                                fSrcPixels.info(), fSrcPixels.addr(), fSrcPixels.rowBytes(),
+                                fExecutor.get());
+            }
+            return;
+        }
+
         volatile SkColor junk = 0;
         SkRandom rand;
 
@@ -59,6 +93,11 @@ struct ColorSpaceXformBench : public Benchmark {
                 case Mode::xformer: {
                     dst = fXformer->apply(src);
                 } break;
+
+                case Mode::pixels_serial:
+                case Mode::pixels_threaded: {
+                    SK_ABORT("The pixels modes convert whole images above.");
+                } break;
             }
 
             if (false && i == 0) {
@@ -72,3 +111,5 @@ struct ColorSpaceXformBench : public Benchmark {
 
 DEF_BENCH(return new ColorSpaceXformBench{Mode::steps  };)
 DEF_BENCH(return new ColorSpaceXformBench{Mode::xformer};)
+DEF_BENCH(return new ColorSpaceXformBench{Mode::pixels_serial  };)
+DEF_BENCH(return new ColorSpaceXformBench{Mode::pixels_threaded};)
@@ -0,0 +1,89 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkRandom.h"
+
+// Plays back a picture shaped like a draw-heavy SKP: thousands of small rects, ovals and thin
+// lines, sharing a handful of constant-color paints.  Each draw makes a new blitter, so this
+// measures how much the constant-color blit program cache saves over rebuilding the blit
+// pipelines for every draw.  To measure real SKPs, run nanobench --skps with
+// SkGraphics::SetConstantColorBlitCacheCountLimit(0) for the uncached numbers.
+
+class ConstantColorBlitCacheBench : public Benchmark {
+public:
+    explicit ConstantColorBlitCacheBench(bool cached) : fCached(cached) {}
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    const char* onGetName() override {
+        return fCached ? "constant_color_blit_cache_on" : "constant_color_blit_cache_off";
+    }
+
+    void onDelayedSetup() override {
+        const SkColor colors[] = { 0x80336699, 0xff20c040, 0xc0ff8000, 0x40000000 };
+        const SkBlendMode modes[] = { SkBlendMode::kSrcOver, SkBlendMode::kMultiply };
+
+        SkRandom rand;
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(W, H));
+        for (int i = 0; i < kDraws; i++) {
+            SkPaint paint;
+            paint.setColor(colors[rand.nextULessThan(SK_ARRAY_COUNT(colors))]);
+            paint.setBlendMode(modes[rand.nextULessThan(SK_ARRAY_COUNT(modes))]);
+            paint.setAntiAlias(rand.nextBool());
+
+            SkScalar x = rand.nextRangeScalar(0, W - 16),
+                     y = rand.nextRangeScalar(0, H - 16);
+            SkRect r = SkRect::MakeXYWH(x, y, rand.nextRangeScalar(2, 16),
+                                              rand.nextRangeScalar(2, 16));
+            switch (i % 3) {
+                case 0: canvas->drawRect(r, paint); break;
+                case 1: canvas->drawOval(r, paint); break;
+                case 2: canvas->drawLine(r.fLeft, r.fTop, r.fRight, r.fBottom, paint); break;
+            }
+        }
+        fPicture = recorder.finishRecordingAsPicture();
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fPrevLimit = SkGraphics::GetConstantColorBlitCacheCountLimit();
+        SkGraphics::SetConstantColorBlitCacheCountLimit(fCached ? fPrevLimit : 0);
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        SkGraphics::SetConstantColorBlitCacheCountLimit(fPrevLimit);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPicture(fPicture);
+        }
+    }
+
+    SkIPoint onGetSize() override { return SkIPoint::Make(W, H); }
+
+private:
+    static constexpr int W = 512,
+                         H = 512,
+                         kDraws = 4000;
+
+    bool             fCached;
+    int              fPrevLimit = 0;
+    sk_sp<SkPicture> fPicture;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ConstantColorBlitCacheBench(true); )
+DEF_BENCH( return new ConstantColorBlitCacheBench(false); )
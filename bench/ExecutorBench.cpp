@@ -0,0 +1,76 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkExecutor.h"
+#include "SkString.h"
+#include "SkTaskGroup.h"
+#include <atomic>
+
+// Measures how fast an SkExecutor gets through lots of tiny SkTaskGroup::batch() tasks.
+// When nested is true, each task batch()es a few more tasks of its own and waits for them.
+class ExecutorBench : public Benchmark {
+public:
+    enum Pool { kFIFO, kLIFO, kWorkStealing };
+
+    ExecutorBench(Pool pool, bool nested) : fPool(pool), fNested(nested) {
+        static const char* kNames[] = { "fifo", "lifo", "workstealing" };
+        fName.printf("executor_%s%s", kNames[pool], nested ? "_nested" : "");
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        switch (fPool) {
+            case kFIFO:         fExecutor = SkExecutor::MakeFIFOThreadPool();         break;
+            case kLIFO:         fExecutor = SkExecutor::MakeLIFOThreadPool();         break;
+            case kWorkStealing: fExecutor = SkExecutor::MakeWorkStealingThreadPool(); break;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        std::atomic<int> sum{0};
+        for (int loop = 0; loop < loops; loop++) {
+            SkTaskGroup tasks(*fExecutor);
+            if (fNested) {
+                tasks.batch(kTasks / kNestedTasks, [&](int i) {
+                    SkTaskGroup nested(*fExecutor);
+                    nested.batch(kNestedTasks, [&](int j) {
+                        sum.fetch_add(i ^ j, std::memory_order_relaxed);
+                    });
+                });
+            } else {
+                tasks.batch(kTasks, [&](int i) {
+                    sum.fetch_add(i, std::memory_order_relaxed);
+                });
+            }
+        }
+    }
+
+private:
+    static constexpr int kTasks       = 10000,
+                         kNestedTasks = 16;
+
+    SkString                    fName;
+    Pool                        fPool;
+    bool                        fNested;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ExecutorBench(ExecutorBench::kFIFO,         false); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::kLIFO,         false); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::kWorkStealing, false); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::kFIFO,         true); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::kLIFO,         true); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::kWorkStealing, true); )
@@ -8,10 +8,14 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkChecksum.h"
+#include "SkExecutor.h"
 #include "SkFont.h"
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkStrikeCache.h"
 #include "SkString.h"
+#include "SkSurfaceProps.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 
 #include "gUniqueGlyphIDs.h"
@@ -142,6 +146,68 @@ private:
 };
 DEF_BENCH( return new FontCacheBench(); )
 
+// Many threads rendering glyphs of the same few strikes at once, either sharing the strikes
+// (see SkStrikeCache) or each making their own when another thread has the one they want.
+class FontCacheThreadedBench : public Benchmark {
+    SkString                    fName;
+    int                         fThreads;
+    bool                        fShare;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+public:
+    FontCacheThreadedBench(int threads, bool share) : fThreads(threads), fShare(share) {
+        fName.printf("fontcache_threaded_%d_%s", threads, share ? "shared" : "exclusive");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const SkScalar kSizes[] = { 12, 16, 24 };
+        const int kTasksPerLoop = 4 * fThreads;
+
+        SkStrikeCache cache(fShare);
+        SkTaskGroup(*fExecutor).batch(loops * kTasksPerLoop, [&](int i) {
+            SkFont font;
+            font.setEdging(SkFont::Edging::kAntiAlias);
+            font.setSize(kSizes[i % SK_ARRAY_COUNT(kSizes)]);
+            SkAutoDescriptor ad;
+            SkScalerContextEffects effects;
+            auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+                    font, SkPaint(), SkSurfaceProps(SkSurfaceProps::kLegacyFontHost_InitType),
+                    kFakeGammaAndBoostContrast, SkMatrix::I(), &ad, &effects);
+            auto strike = cache.findOrCreateStrikeExclusive(*desc, effects,
+                                                            *font.getTypefaceOrDefault());
+
+            const uint16_t* array = gUniqueGlyphIDs;
+            while (*array != gUniqueGlyphIDs_Sentinel) {
+                int count = count_glyphs(array);
+                for (int j = 0; j < count; ++j) {
+                    strike->findImage(strike->getGlyphIDMetrics(array[j]));
+                }
+                array += count + 1;    // skip the sentinel
+            }
+        });
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+DEF_BENCH( return new FontCacheThreadedBench(1, false); )
+DEF_BENCH( return new FontCacheThreadedBench(1, true); )
+DEF_BENCH( return new FontCacheThreadedBench(4, false); )
+DEF_BENCH( return new FontCacheThreadedBench(4, true); )
+
 // undefine this to run the efficiency test
 //DEF_BENCH( return new FontCacheEfficiency(); )
 
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkCanvas.h"
+#include "SkDashPathEffect.h"
+#include "SkFont.h"
+#include "SkGlyphRunPainter.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkSurface.h"
+#include "SkTextBlob.h"
+#include "SkTypeface.h"
+
+// Time to draw text none of whose glyphs are in the font cache, generating each run's glyphs on
+// this thread or in parallel parts.
+class GlyphBatchBench : public Benchmark {
+    int                     fThreads;
+    bool                    fDashed;
+    SkString                fName;
+    SkPaint                 fPaint;
+    sk_sp<SkTextBlob>       fBlob;
+    sk_sp<SkSurface>        fSurface;
+
+public:
+    GlyphBatchBench(int threads, bool dashed) : fThreads(threads), fDashed(dashed) {
+        fName.printf("glyph_batch_%s_threads%d", dashed ? "dashed" : "plain", threads);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        if (fDashed) {
+            const SkScalar intervals[] = { 2, 1 };
+            fPaint.setPathEffect(SkDashPathEffect::Make(intervals, SK_ARRAY_COUNT(intervals), 0));
+        }
+        SkFont font(MakeResourceAsTypeface("fonts/Roboto-Regular.ttf"), 32);
+        font.setEdging(SkFont::Edging::kAntiAlias);
+
+        // Every glyph in the font, in one run.
+        SkGlyphID glyphs[256];
+        SkPoint positions[SK_ARRAY_COUNT(glyphs)];
+        for (int i = 0; i < (int)SK_ARRAY_COUNT(glyphs); i++) {
+            glyphs[i] = (SkGlyphID)i;
+            positions[i] = { (SkScalar)(i % 16) * 64 + 8, (SkScalar)(i / 16) * 64 + 40 };
+        }
+        fBlob = SkTextBlob::MakeFromPosText(glyphs, sizeof(glyphs), positions, font,
+                                            kGlyphID_SkTextEncoding);
+        fSurface = SkSurface::MakeRasterN32Premul(1024, 1024);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        int threads = gSkGlyphRasterThreads;
+        gSkGlyphRasterThreads = fThreads;
+
+        SkCanvas* canvas = fSurface->getCanvas();
+        for (int i = 0; i < loops; i++) {
+            SkGraphics::PurgeFontCache();
+            canvas->clear(SK_ColorWHITE);
+            canvas->drawTextBlob(fBlob, 0, 0, fPaint);
+        }
+        canvas->flush();
+
+        gSkGlyphRasterThreads = threads;
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new GlyphBatchBench(1, false); )
+DEF_BENCH( return new GlyphBatchBench(4, false); )
+DEF_BENCH( return new GlyphBatchBench(1, true); )
+DEF_BENCH( return new GlyphBatchBench(4, true); )
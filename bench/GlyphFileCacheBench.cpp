@@ -0,0 +1,90 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkCanvas.h"
+#include "SkFont.h"
+#include "SkGlyphFileCache.h"
+#include "SkGraphics.h"
+#include "SkPaint.h"
+#include "SkStrikeCache.h"
+#include "SkSurface.h"
+#include "SkTypeface.h"
+
+// Time to draw a first page of text in a new process: with nothing in the font cache, and either
+// nothing to start from (cold) or a glyph file left by an earlier process (warm).
+class GlyphFileCacheBench : public Benchmark {
+    bool                    fWarm;
+    sk_sp<SkTypeface>       fTypeface;
+    sk_sp<SkSurface>        fSurface;
+    sk_sp<SkData>           fFileData;
+
+public:
+    explicit GlyphFileCacheBench(bool warm) : fWarm(warm) {}
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fWarm ? "glyph_file_cache_first_page_warm" : "glyph_file_cache_first_page_cold";
+    }
+
+    void onDelayedSetup() override {
+        // The file cache needs font data to identify a typeface by, which test fonts don't have.
+        fTypeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+        fSurface = SkSurface::MakeRasterN32Premul(612, 792);
+
+        auto fileCache = SkGlyphFileCache::Make();
+        this->drawPage(fileCache);
+        fFileData = fileCache->serialize();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            this->drawPage(fWarm ? SkGlyphFileCache::Make(fFileData) : nullptr);
+        }
+    }
+
+private:
+    void drawPage(sk_sp<SkGlyphFileCache> fileCache) {
+        SkStrikeCache* strikeCache = SkStrikeCache::GlobalStrikeCache();
+        sk_sp<SkGlyphFileCache> previous = strikeCache->refFileCache();
+        SkGraphics::PurgeFontCache();
+        strikeCache->setFileCache(std::move(fileCache));
+
+        static const char* kLines[] = {
+            "The quick brown fox jumps over the lazy dog, 0123456789 times.",
+            "PACK MY BOX WITH FIVE DOZEN LIQUOR JUGS! (Sphinx of black quartz?)",
+            "How vexingly quick daft zebras jump; \"judge my vow\" & [wax bed].",
+        };
+        const SkScalar kSizes[] = { 10, 12, 18 };
+
+        SkCanvas* canvas = fSurface->getCanvas();
+        canvas->clear(SK_ColorWHITE);
+        SkPaint paint;
+        SkFont font(fTypeface);
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        SkScalar y = 0;
+        for (int line = 0; line < 48; line++) {
+            font.setSize(kSizes[line % SK_ARRAY_COUNT(kSizes)]);
+            y += font.getSize() * 1.2f;
+            const char* text = kLines[line % SK_ARRAY_COUNT(kLines)];
+            canvas->drawSimpleText(text, strlen(text), kUTF8_SkTextEncoding, 36, y, font, paint);
+        }
+        canvas->flush();
+
+        strikeCache->setFileCache(std::move(previous));
+    }
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new GlyphFileCacheBench(false); )
+DEF_BENCH( return new GlyphFileCacheBench(true); )
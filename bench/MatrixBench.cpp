@@ -7,8 +7,10 @@
 #include "Benchmark.h"
 #include "SkMatrix.h"
 #include "SkMatrixUtils.h"
+#include "SkPoint3.h"
 #include "SkRandom.h"
 #include "SkString.h"
+#include "SkTemplates.h"
 
 class MatrixBench : public Benchmark {
     SkString    fName;
@@ -298,6 +300,55 @@ DEF_BENCH( return new MapPointsMatrixBench("mappoints_trans", make_trans()); )
 DEF_BENCH( return new MapPointsMatrixBench("mappoints_scale", make_scale()); )
 DEF_BENCH( return new MapPointsMatrixBench("mappoints_affine", make_afine()); )
 
+static SkMatrix make_persp() {
+    SkMatrix m(make_afine());
+    m.setPerspX(0.001f);
+    m.setPerspY(-0.002f);
+    return m;
+}
+
+// Maps a million points at once, as transforming big paths and vertices does.
+class MapManyPointsMatrixBench : public MatrixBench {
+    SkMatrix fM;
+    bool     fHomogeneous;
+    enum { N = 1000 * 1000 };
+    SkAutoTMalloc<SkPoint>  fSrc, fDst;
+    SkAutoTMalloc<SkPoint3> fSrc3, fDst3;
+public:
+    MapManyPointsMatrixBench(const char name[], const SkMatrix& m, bool homogeneous = false)
+        : MatrixBench(name), fM(m), fHomogeneous(homogeneous) {}
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        if (fHomogeneous) {
+            fSrc3.reset(N);
+            fDst3.reset(N);
+            for (int i = 0; i < N; ++i) {
+                fSrc3[i].set(rand.nextSScalar1(), rand.nextSScalar1(), rand.nextSScalar1());
+            }
+        } else {
+            fSrc.reset(N);
+            fDst.reset(N);
+            for (int i = 0; i < N; ++i) {
+                fSrc[i].set(rand.nextSScalar1(), rand.nextSScalar1());
+            }
+        }
+    }
+
+    void performTest() override {
+        if (fHomogeneous) {
+            fM.mapHomogeneousPoints(fDst3.get(), fSrc3.get(), N);
+        } else {
+            fM.mapPoints(fDst.get(), fSrc.get(), N);
+        }
+    }
+};
+DEF_BENCH( return new MapManyPointsMatrixBench("mappoints_1M_trans", make_trans()); )
+DEF_BENCH( return new MapManyPointsMatrixBench("mappoints_1M_scale", make_scale()); )
+DEF_BENCH( return new MapManyPointsMatrixBench("mappoints_1M_affine", make_afine()); )
+DEF_BENCH( return new MapManyPointsMatrixBench("mappoints_1M_persp", make_persp()); )
+DEF_BENCH( return new MapManyPointsMatrixBench("maphomogeneouspoints_1M", make_persp(), true); )
+
 ///////////////////////////////////////////////////////////////////////////////
 
 class MapRectMatrixBench : public MatrixBench {
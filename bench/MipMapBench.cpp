@@ -7,22 +7,35 @@
 
 #include "Benchmark.h"
 #include "SkBitmap.h"
+#include "SkExecutor.h"
 #include "SkMipMap.h"
 
 class MipMapBench: public Benchmark {
+public:
+    enum Mode {
+        kSerial,    // Build every level on this thread.
+        kThreaded,  // Build every level, splitting big levels across a thread pool.
+    };
+
+private:
     SkBitmap fBitmap;
     SkString fName;
     const int fW, fH;
     bool fHalfFoat;
+    Mode fMode;
+    std::unique_ptr<SkExecutor> fExecutor;
 
 public:
-    MipMapBench(int w, int h, bool halfFloat = false)
-        : fW(w), fH(h), fHalfFoat(halfFloat)
+    MipMapBench(int w, int h, bool halfFloat = false, Mode mode = kSerial)
+        : fW(w), fH(h), fHalfFoat(halfFloat), fMode(mode)
     {
         fName.printf("mipmap_build_%dx%d", w, h);
         if (halfFloat) {
             fName.append("_f16");
         }
+        if (mode == kThreaded) {
+            fName.append("_threaded");
+        }
     }
 
 protected:
@@ -38,11 +51,15 @@ protected:
                                              SkColorSpace::MakeSRGB());
         fBitmap.allocPixels(info);
         fBitmap.eraseColor(SK_ColorWHITE);  // so we don't read uninitialized memory
+        if (fMode == kThreaded) {
+            fExecutor = SkExecutor::MakeWorkStealingThreadPool();
+        }
     }
 
     void onDraw(int loops, SkCanvas*) override {
         for (int i = 0; i < loops * 4; i++) {
-            SkMipMap::Build(fBitmap, nullptr)->unref();
+            // fExecutor is null in serial mode, which builds every level on this thread.
+            SkMipMap::Build(fBitmap, nullptr, fExecutor.get())->unref();
         }
     }
 
@@ -65,3 +82,7 @@ DEF_BENCH( return new MipMapBench(2048, 2048); )
 DEF_BENCH( return new MipMapBench(2047, 2047); )
 DEF_BENCH( return new MipMapBench(2048, 2047); )
 DEF_BENCH( return new MipMapBench(2047, 2048); )
+
+DEF_BENCH( return new MipMapBench(2048, 2048, false, MipMapBench::kThreaded); )
+DEF_BENCH( return new MipMapBench(2047, 2047, false, MipMapBench::kThreaded); )
+DEF_BENCH( return new MipMapBench(2048, 2048, true,  MipMapBench::kThreaded); )
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkDraw.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+
+// Redraws a grid of static anti-aliased icon paths, as an animated UI does every frame, with and
+// without gSkCacheRasterPathMasks.  With the cache, every draw after the first only replays blits.
+
+class PathMaskCacheBench : public Benchmark {
+public:
+    explicit PathMaskCacheBench(bool cached) : fCached(cached) {}
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    const char* onGetName() override {
+        return fCached ? "path_mask_cache_on" : "path_mask_cache_off";
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (int i = 0; i < kIcons; i++) {
+            // Each icon is a closed blob of curves around the center of a 32x32 cell.
+            SkPath& path = fIcons[i];
+            const int n = 5 + i % 4;
+            for (int j = 0; j < n; j++) {
+                SkScalar angle = j * 2 * SK_ScalarPI / n;
+                SkScalar r1 = rand.nextRangeScalar(8, 14),
+                         r2 = rand.nextRangeScalar(4, 15);
+                SkPoint pt   = { 16 + r1 * SkScalarCos(angle), 16 + r1 * SkScalarSin(angle) },
+                        ctrl = { 16 + r2 * SkScalarCos(angle + SK_ScalarPI / n),
+                                 16 + r2 * SkScalarSin(angle + SK_ScalarPI / n) };
+                if (j == 0) {
+                    path.moveTo(pt);
+                } else if (j % 2) {
+                    path.quadTo(ctrl, pt);
+                } else {
+                    path.cubicTo(ctrl, ctrl + SkPoint{1, 2}, pt);
+                }
+            }
+            path.close();
+            path.addCircle(16, 16, 3 + i % 3, SkPath::kCCW_Direction);
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fWasCaching = gSkCacheRasterPathMasks;
+        gSkCacheRasterPathMasks = fCached;
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        gSkCacheRasterPathMasks = fWasCaching;
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(0xff4285f4);
+
+        for (int i = 0; i < loops; i++) {
+            for (int y = 0; y < H; y += 32) {
+                for (int x = 0; x < W; x += 32) {
+                    canvas->save();
+                    canvas->translate(x, y);
+                    canvas->drawPath(fIcons[(x + y) / 32 % kIcons], paint);
+                    canvas->restore();
+                }
+            }
+        }
+    }
+
+    SkIPoint onGetSize() override { return SkIPoint::Make(W, H); }
+
+private:
+    static constexpr int W = 512,
+                         H = 512,
+                         kIcons = 16;
+
+    bool   fCached;
+    bool   fWasCaching = false;
+    SkPath fIcons[kIcons];
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PathMaskCacheBench(true); )
+DEF_BENCH( return new PathMaskCacheBench(false); )
@@ -6,6 +6,7 @@
  */
 
 #include "Benchmark.h"
+#include "SkExecutor.h"
 #include "SkPath.h"
 #include "SkPathOps.h"
 #include "SkRandom.h"
@@ -96,3 +97,133 @@ static SkPath makerects() {
 }
 
 DEF_BENCH( return new PathOpsSimplifyBench("rects", makerects()); )
+
+// A circle of count lines whose ends alternate just inside and outside its radius, so each
+// segment's bounds overlap only its neighbors'.
+static SkPath makewiggle(int count, SkScalar cx, SkScalar cy, SkScalar radius) {
+    SkPath path;
+    for (int i = 0; i < count; ++i) {
+        SkScalar angle = 2 * SK_ScalarPI * i / count;
+        SkScalar r = radius + ((i & 1) ? 1 : -1);
+        SkPoint pt = { cx + r * SkScalarCos(angle), cy + r * SkScalarSin(angle) };
+        if (i == 0) {
+            path.moveTo(pt);
+        } else {
+            path.lineTo(pt);
+        }
+    }
+    path.close();
+    return path;
+}
+
+// Simplifies or intersects paths with enough segments that finding which pairs of them to
+// intersect dominates.
+class PathOpsWiggleBench : public Benchmark {
+    SkString    fName;
+    SkPath      fPath1, fPath2;
+    bool        fSimplify;
+
+public:
+    PathOpsWiggleBench(int count, bool simplify) : fSimplify(simplify) {
+        fName.printf("pathops_%s_wiggle_%dk", simplify ? "simplify" : "sect", count / 1000);
+
+        SkScalar radius = count * 0.35f;
+        fPath1 = makewiggle(count, radius, radius, radius);
+        fPath2 = makewiggle(count, radius * 1.1f, radius * 1.05f, radius);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            SkPath result;
+            if (fSimplify) {
+                Simplify(fPath1, &result);
+            } else {
+                Op(fPath1, fPath2, kIntersect_SkPathOp, &result);
+            }
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PathOpsWiggleBench( 1000, true); )
+DEF_BENCH( return new PathOpsWiggleBench( 1000, false); )
+DEF_BENCH( return new PathOpsWiggleBench(16000, true); )
+DEF_BENCH( return new PathOpsWiggleBench(16000, false); )
+
+// Unions polygons laid out like parcels on a map: city blocks of 16x16 jittered quads, each
+// overlapping its neighbors, with streets between the blocks.
+class PathOpsBuilderBench : public Benchmark {
+    SkString                    fName;
+    int                         fCount;
+    bool                        fThreaded;
+    SkTArray<SkPath>            fPolygons;
+    std::unique_ptr<SkExecutor> fExecutor;
+
+public:
+    PathOpsBuilderBench(int count, bool threaded) : fCount(count), fThreaded(threaded) {
+        fName.printf("pathops_builder_union_%dk_%s", count / 1000,
+                     threaded ? "threaded" : "serial");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        const int columns = SkScalarCeilToInt(SkScalarSqrt(SkIntToScalar(fCount)));
+        for (int i = 0; i < fCount; ++i) {
+            int column = i % columns,
+                row    = i / columns;
+            SkScalar x = SkIntToScalar(column * 10 + column / 16 * 6),
+                     y = SkIntToScalar(row    * 10 + row    / 16 * 6);
+            SkPath polygon;
+            polygon.moveTo(x      + rand.nextRangeScalar(-2, 2), y + rand.nextRangeScalar(-2, 2));
+            polygon.lineTo(x + 12 + rand.nextRangeScalar(-2, 2), y + rand.nextRangeScalar(-2, 2));
+            polygon.lineTo(x + 12 + rand.nextRangeScalar(-2, 2),
+                           y + 12 + rand.nextRangeScalar(-2, 2));
+            polygon.lineTo(x      + rand.nextRangeScalar(-2, 2),
+                           y + 12 + rand.nextRangeScalar(-2, 2));
+            polygon.close();
+            fPolygons.push_back(polygon);
+        }
+        if (fThreaded) {
+            fExecutor = SkExecutor::MakeWorkStealingThreadPool();
+        }
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; i++) {
+            SkOpBuilder builder;
+            for (const SkPath& polygon : fPolygons) {
+                builder.add(polygon, kUnion_SkPathOp);
+            }
+            SkPath result;
+            builder.resolve(&result, fExecutor.get());
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new PathOpsBuilderBench( 1000, false); )
+DEF_BENCH( return new PathOpsBuilderBench( 1000, true); )
+DEF_BENCH( return new PathOpsBuilderBench(10000, false); )
+DEF_BENCH( return new PathOpsBuilderBench(10000, true); )
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmapDevice.h"
+#include "SkCanvas.h"
+#include "SkPicture.h"
+#include "SkPictureRecorder.h"
+#include "SkRRect.h"
+#include "SkSurface.h"
+
+// Plays back a recorded UI-style picture, a scrolling list of rows each with a background,
+// separator, icon, text-like bars and a rounded button, into a raster surface with and without
+// gSkBatchRasterFills.  Like UI SKPs, the picture issues long runs of same-paint fills.
+// For real SKPs, compare nanobench --skps runs with and without --batchRasterFills.
+
+static sk_sp<SkPicture> make_ui_picture(int w, int h) {
+    SkPaint background, separator, icon, text, button;
+    background.setColor(0xfffafafa);
+    separator .setColor(0xffe0e0e0);
+    icon      .setColor(0xff4285f4);
+    text      .setColor(0xff202124);
+    button    .setColor(0x801a73e8);
+    button    .setAntiAlias(true);
+
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(SkRect::MakeIWH(w, h));
+    const int kRowHeight = 24;
+    for (int y = 0; y < h; y += kRowHeight) {
+        canvas->drawRect(SkRect::MakeXYWH(0, y, w, kRowHeight - 1), background);
+    }
+    for (int y = 0; y < h; y += kRowHeight) {
+        canvas->drawRect(SkRect::MakeXYWH(8, y + kRowHeight - 1, w - 16, 1), separator);
+    }
+    for (int y = 0; y < h; y += kRowHeight) {
+        canvas->drawRect(SkRect::MakeXYWH(8, y + 4, 16, 16), icon);
+    }
+    for (int y = 0; y < h; y += kRowHeight) {
+        // Words of "text", as runs of thin bars.
+        for (int x = 32; x < w - 96; x += 7 + (x % 5)) {
+            canvas->drawRect(SkRect::MakeXYWH(x, y + 8, 5, 8), text);
+        }
+    }
+    for (int y = 0; y < h; y += kRowHeight) {
+        canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(w - 88, y + 3, 80, 18), 4, 4),
+                          button);
+    }
+    return recorder.finishRecordingAsPicture();
+}
+
+class RasterFillBatchBench : public Benchmark {
+public:
+    explicit RasterFillBatchBench(bool batch) : fBatch(batch) {}
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    const char* onGetName() override {
+        return fBatch ? "raster_fill_batch_ui" : "raster_fill_nobatch_ui";
+    }
+
+    void onDelayedSetup() override {
+        const int W = 800, H = 1200;
+        fPicture = make_ui_picture(W, H);
+
+        // Only surfaces made while gSkBatchRasterFills is set batch their fills.
+        bool wasBatching = gSkBatchRasterFills;
+        gSkBatchRasterFills = fBatch;
+        fSurface = SkSurface::MakeRasterN32Premul(W, H);
+        fSurface->getCanvas();  // Make the canvas now, while the flag is set as we want.
+        gSkBatchRasterFills = wasBatching;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas* canvas = fSurface->getCanvas();
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPicture(fPicture);
+        }
+        canvas->flush();
+    }
+
+private:
+    bool             fBatch;
+    sk_sp<SkPicture> fPicture;
+    sk_sp<SkSurface> fSurface;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new RasterFillBatchBench(true); )
+DEF_BENCH( return new RasterFillBatchBench(false); )
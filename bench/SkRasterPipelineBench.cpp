@@ -0,0 +1,133 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkRasterPipeline.h"
+
+// These benches run a few of the hottest SkRasterPipeline stage sequences over a row of N pixels,
+// using whichever stages SkOpts picked for this CPU (e.g. SSE4.1 or AVX2).
+
+static const int N = 1023;  // Not a multiple of any stride, so we always exercise the tail.
+
+static uint32_t dst_8888[N],
+                src_8888[N];
+static uint64_t dst_f16 [N];
+
+class SkRasterPipelineBlendBench : public Benchmark {
+public:
+    explicit SkRasterPipelineBlendBench(bool f16) : fF16(f16) {}
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override {
+        return fF16 ? "SkRasterPipeline_srcover_f16" : "SkRasterPipeline_srcover_8888";
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkRasterPipeline_MemoryCtx src_ctx = { src_8888, 0 },
+                                   dst_ctx = { fF16 ? (void*)dst_f16 : (void*)dst_8888, 0 };
+
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipeline::load_8888, &src_ctx);
+        if (fF16) {
+            p.append(SkRasterPipeline::load_f16_dst, &dst_ctx);
+            p.append(SkRasterPipeline::srcover);
+            p.append(SkRasterPipeline::store_f16, &dst_ctx);
+        } else {
+            p.append(SkRasterPipeline::load_8888_dst, &dst_ctx);
+            p.append(SkRasterPipeline::srcover);
+            p.append(SkRasterPipeline::store_8888, &dst_ctx);
+        }
+
+        auto fn = p.compile();
+        while (loops --> 0) {
+            fn(0,0,N,1);
+        }
+    }
+
+private:
+    bool fF16;
+};
+DEF_BENCH( return new SkRasterPipelineBlendBench(false); )
+DEF_BENCH( return new SkRasterPipelineBlendBench(true); )
+
+class SkRasterPipelineGradientBench : public Benchmark {
+public:
+    explicit SkRasterPipelineGradientBench(int stops) : fStops(stops) {
+        fName.printf("SkRasterPipeline_evenly_spaced_gradient_%d", stops);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas*) override {
+        // Allocate at least 8 stops, as SkGradientShader does, so AVX2 permutes stay in bounds.
+        float fs[4][32] = {}, bs[4][32] = {};
+        for (int i = 0; i < fStops; i++) {
+            for (int c = 0; c < 4; c++) {
+                fs[c][i] = (float)((i + c) % 3) * 0.25f;
+                bs[c][i] = (float)((i + c) % 2) * 0.5f;
+            }
+        }
+        SkRasterPipeline_GradientCtx ctx;
+        ctx.stopCount = fStops;
+        for (int c = 0; c < 4; c++) {
+            ctx.fs[c] = fs[c];
+            ctx.bs[c] = bs[c];
+        }
+        ctx.ts = nullptr;
+        ctx.interpolatedInPremul = true;
+
+        const float matrix[] = { 1.0f/N, 0, 0, 0 };  // x -> t, in [0,1).
+        SkRasterPipeline_MemoryCtx dst_ctx = { dst_8888, 0 };
+
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipeline::seed_shader);
+        p.append(SkRasterPipeline::matrix_scale_translate, matrix);
+        p.append(SkRasterPipeline::evenly_spaced_gradient, &ctx);
+        p.append(SkRasterPipeline::store_8888, &dst_ctx);
+
+        auto fn = p.compile();
+        while (loops --> 0) {
+            fn(0,0,N,1);
+        }
+    }
+
+private:
+    int      fStops;
+    SkString fName;
+};
+DEF_BENCH( return new SkRasterPipelineGradientBench( 4); )
+DEF_BENCH( return new SkRasterPipelineGradientBench(12); )
+DEF_BENCH( return new SkRasterPipelineGradientBench(24); )
+
+class SkRasterPipelineBilerpBench : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return "SkRasterPipeline_bilerp_clamp_8888"; }
+
+    void onDraw(int loops, SkCanvas*) override {
+        // Sample src_8888 as a 32x31 image, stretching its width across the row with a slight
+        // skew so we always land between pixels.
+        SkRasterPipeline_GatherCtx gather = { src_8888, 32, 32, 31 };
+        const float matrix[] = { 32.0f/N, 0.01f,
+                                 0.0f,    1.0f,
+                                 0.25f,   7.0f };
+        SkRasterPipeline_MemoryCtx dst_ctx = { dst_8888, 0 };
+
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipeline::seed_shader);
+        p.append(SkRasterPipeline::matrix_2x3, matrix);
+        p.append(SkRasterPipeline::bilerp_clamp_8888, &gather);
+        p.append(SkRasterPipeline::store_8888, &dst_ctx);
+
+        auto fn = p.compile();
+        while (loops --> 0) {
+            fn(0,0,N,1);
+        }
+    }
+};
+DEF_BENCH( return new SkRasterPipelineBilerpBench; )
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkStrokeCache.h"
+
+// Redraws a chart of stroked polylines, like an app redrawing the same series every frame, with
+// and without gSkCacheStrokedPaths.  With the cache, only the first frame strokes the paths.
+
+class StrokeCacheBench : public Benchmark {
+public:
+    explicit StrokeCacheBench(bool cached) : fCached(cached) {}
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    const char* onGetName() override {
+        return fCached ? "stroke_cache_chart_on" : "stroke_cache_chart_off";
+    }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        for (SkPath& path : fSeries) {
+            SkScalar y = rand.nextRangeScalar(H/4, 3*H/4);
+            path.moveTo(0, y);
+            for (int i = 1; i < kPoints; i++) {
+                y = SkTPin(y + rand.nextRangeScalar(-12, 12), 0.0f, (SkScalar)H);
+                path.lineTo(i * (SkScalar)W / (kPoints - 1), y);
+            }
+        }
+    }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        fWasCaching = gSkCacheStrokedPaths;
+        gSkCacheStrokedPaths = fCached;
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        gSkCacheStrokedPaths = fWasCaching;
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        const SkColor colors[] = { 0xff4285f4, 0xffdb4437, 0xfff4b400, 0xff0f9d58 };
+
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setStyle(SkPaint::kStroke_Style);
+        paint.setStrokeWidth(2.5f);
+        paint.setStrokeJoin(SkPaint::kRound_Join);
+        for (int i = 0; i < loops; i++) {
+            for (int s = 0; s < kSeries; s++) {
+                paint.setColor(colors[s % SK_ARRAY_COUNT(colors)]);
+                canvas->drawPath(fSeries[s], paint);
+            }
+        }
+    }
+
+    SkIPoint onGetSize() override { return SkIPoint::Make(W, H); }
+
+private:
+    static constexpr int W = 640,
+                         H = 480,
+                         kSeries = 8,
+                         kPoints = 400;
+
+    bool   fCached;
+    bool   fWasCaching = false;
+    SkPath fSeries[kSeries];
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new StrokeCacheBench(true); )
+DEF_BENCH( return new StrokeCacheBench(false); )
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkCanvas.h"
+#include "SkColorSpace.h"
+#include "SkFont.h"
+#include "SkSurface.h"
+#include "SkTextBlob.h"
+
+// Draws a page of small text into a raster surface of each color type, with glyphs already in the
+// font cache, so that this measures blitting their masks.
+class TextColorTypeBench : public Benchmark {
+    SkColorType             fColorType;
+    SkFont::Edging          fEdging;
+    SkString                fName;
+    sk_sp<SkTextBlob>       fBlob;
+    sk_sp<SkSurface>        fSurface;
+
+public:
+    TextColorTypeBench(SkColorType colorType, const char* colorTypeName, SkFont::Edging edging)
+        : fColorType(colorType), fEdging(edging) {
+        fName.printf("text_%s_%s", colorTypeName,
+                     edging == SkFont::Edging::kSubpixelAntiAlias ? "lcd" : "aa");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkFont font(MakeResourceAsTypeface("fonts/Roboto-Regular.ttf"), 13);
+        font.setEdging(fEdging);
+        const char* text = "The quick brown fox jumps over the lazy dog, 0123456789 times.";
+        fBlob = SkTextBlob::MakeFromString(text, font);
+
+        sk_sp<SkColorSpace> colorSpace = fColorType == kRGBA_F16_SkColorType
+                                       ? SkColorSpace::MakeSRGBLinear()
+                                       : SkColorSpace::MakeSRGB();
+        SkSurfaceProps props(0, kRGB_H_SkPixelGeometry);
+        fSurface = SkSurface::MakeRaster(SkImageInfo::Make(512, 800, fColorType,
+                                                           kPremul_SkAlphaType, colorSpace),
+                                         &props);
+        fSurface->getCanvas()->clear(SK_ColorWHITE);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas* canvas = fSurface->getCanvas();
+        SkPaint paint;
+        for (int i = 0; i < loops; i++) {
+            for (int line = 0; line < 50; line++) {
+                paint.setColor(line % 2 ? SK_ColorBLACK : 0xFF204080);
+                canvas->drawTextBlob(fBlob, 4, 16 * line + 14, paint);
+            }
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+#define DEF_TEXT_BENCHES(ct, name)                                                            \
+    DEF_BENCH( return new TextColorTypeBench(ct, name, SkFont::Edging::kAntiAlias); )         \
+    DEF_BENCH( return new TextColorTypeBench(ct, name, SkFont::Edging::kSubpixelAntiAlias); )
+
+DEF_TEXT_BENCHES(kN32_SkColorType,          "8888")
+DEF_TEXT_BENCHES(kRGBA_F16_SkColorType,     "f16")
+DEF_TEXT_BENCHES(kRGBA_1010102_SkColorType, "1010102")
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkExecutor.h"
+#include "SkGradientShader.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkString.h"
+#include "SkSurface.h"
+#include "SkTArray.h"
+
+// Draws the same scene into a 4K raster surface, either serially (threads == 0) or with
+// SkSurface::MakeRasterThreaded() on a pool of the given number of threads.
+class ThreadedRasterBench : public Benchmark {
+public:
+    explicit ThreadedRasterBench(int threads) : fThreads(threads) {
+        if (fThreads > 0) {
+            fName.printf("threaded_raster_%d", fThreads);
+        } else {
+            fName.set("threaded_raster_serial");
+        }
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override {
+        return kNonRendering_Backend == backend;
+    }
+
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        const SkImageInfo info = SkImageInfo::MakeN32Premul(kW, kH);
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+            fSurface = SkSurface::MakeRasterThreaded(info, fExecutor.get(), 4 * fThreads);
+        } else {
+            fSurface = SkSurface::MakeRaster(info);
+        }
+
+        SkRandom rand;
+        for (int i = 0; i < kPaths; ++i) {
+            SkPath path;
+            SkScalar x = rand.nextRangeScalar(0, kW),
+                     y = rand.nextRangeScalar(0, kH);
+            path.moveTo(x, y);
+            for (int j = 0; j < 8; ++j) {
+                SkScalar dx0 = rand.nextRangeScalar(-300, 300),
+                         dy0 = rand.nextRangeScalar(-300, 300),
+                         dx1 = rand.nextRangeScalar(-300, 300),
+                         dy1 = rand.nextRangeScalar(-300, 300);
+                path.quadTo(x + dx0, y + dy0, x + dx1, y + dy1);
+            }
+            fPaths.push_back(path);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas* canvas = fSurface->getCanvas();
+
+        const SkPoint pts[] = { {0, 0}, {SkIntToScalar(kW), SkIntToScalar(kH)} };
+        const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+        SkPaint background;
+        background.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 3,
+                                                          SkShader::kMirror_TileMode));
+
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int loop = 0; loop < loops; ++loop) {
+            canvas->drawPaint(background);
+            for (int i = 0; i < fPaths.count(); ++i) {
+                paint.setColor(0x80000000 | (i * 0x0F0E0D));
+                paint.setStyle(i & 1 ? SkPaint::kStroke_Style : SkPaint::kFill_Style);
+                paint.setStrokeWidth(i % 13);
+                canvas->drawPath(fPaths[i], paint);
+            }
+            canvas->flush();
+        }
+    }
+
+private:
+    static constexpr int kW = 3840,
+                         kH = 2160,
+                         kPaths = 200;
+
+    SkString                    fName;
+    int                         fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+    sk_sp<SkSurface>            fSurface;
+    SkTArray<SkPath>            fPaths;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ThreadedRasterBench(0); )
+DEF_BENCH( return new ThreadedRasterBench(1); )
+DEF_BENCH( return new ThreadedRasterBench(2); )
+DEF_BENCH( return new ThreadedRasterBench(4); )
+DEF_BENCH( return new ThreadedRasterBench(8); )
+DEF_BENCH( return new ThreadedRasterBench(16); )
+DEF_BENCH( return new ThreadedRasterBench(32); )
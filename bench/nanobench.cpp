@@ -24,8 +24,10 @@
 #include "SkAndroidCodec.h"
 #include "SkAutoMalloc.h"
 #include "SkBBoxHierarchy.h"
+#include "SkBitmapDevice.h"
 #include "SkBitmapRegionDecoder.h"
 #include "SkCanvas.h"
+#include "SkClipMaskCache.h"
 #include "SkCodec.h"
 #include "SkColorSpacePriv.h"
 #include "SkCommonFlags.h"
@@ -33,15 +35,20 @@
 #include "SkCommonFlagsGpu.h"
 #include "SkData.h"
 #include "SkDebugfTracer.h"
+#include "SkDraw.h"
 #include "SkEventTracingPriv.h"
+#include "SkGlyphRunPainter.h"
 #include "SkGraphics.h"
 #include "SkJSONWriter.h"
 #include "SkLeanWindows.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkPictureRecorder.h"
+#include "SkRasterClip.h"
 #include "SkScan.h"
+#include "SkStrikeCache.h"
 #include "SkString.h"
+#include "SkStrokeCache.h"
 #include "SkSurface.h"
 #include "SkTaskGroup.h"
 #include "SkTraceEvent.h"
@@ -1187,6 +1194,14 @@ int main(int argc, char** argv) {
 
     gSkUseAnalyticAA = FLAGS_analyticAA;
     gSkUseDeltaAA = FLAGS_deltaAA;
+    gSkDeltaAAThreads = FLAGS_deltaAAThreads;
+    gSkBatchRasterFills = FLAGS_batchRasterFills;
+    gSkCacheRasterPathMasks = FLAGS_cacheRasterPathMasks;
+    gSkCacheStrokedPaths = FLAGS_cacheStrokedPaths;
+    gSkCacheRasterClips = FLAGS_cacheRasterClips;
+    gSkAnalyticRasterClips = FLAGS_analyticRasterClips;
+    gSkShareStrikes = FLAGS_shareStrikes;
+    gSkGlyphRasterThreads = FLAGS_glyphRasterThreads;
 
     if (FLAGS_forceDeltaAA) {
         gSkForceDeltaAA = true;
@@ -10,8 +10,10 @@
 #include "ProcStats.h"
 #include "Resources.h"
 #include "SkBBHFactory.h"
+#include "SkBitmapDevice.h"
 #include "SkChecksum.h"
 #include "SkChromeTracingTracer.h"
+#include "SkClipMaskCache.h"
 #include "SkCodec.h"
 #include "SkColorPriv.h"
 #include "SkColorSpace.h"
@@ -22,9 +24,11 @@
 #include "SkData.h"
 #include "SkDebugfTracer.h"
 #include "SkDocument.h"
+#include "SkDraw.h"
 #include "SkEventTracingPriv.h"
 #include "SkFontMgr.h"
 #include "SkFontMgrPriv.h"
+#include "SkGlyphRunPainter.h"
 #include "SkGraphics.h"
 #include "SkHalf.h"
 #include "SkLeanWindows.h"
@@ -33,8 +37,11 @@
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkPngEncoder.h"
+#include "SkRasterClip.h"
 #include "SkScan.h"
 #include "SkSpinlock.h"
+#include "SkStrikeCache.h"
+#include "SkStrokeCache.h"
 #include "SkTestFontMgr.h"
 #include "SkTHash.h"
 #include "SkTaskGroup.h"
@@ -1426,6 +1433,14 @@ int main(int argc, char** argv) {
 
     gSkUseAnalyticAA = FLAGS_analyticAA;
     gSkUseDeltaAA = FLAGS_deltaAA;
+    gSkDeltaAAThreads = FLAGS_deltaAAThreads;
+    gSkBatchRasterFills = FLAGS_batchRasterFills;
+    gSkCacheRasterPathMasks = FLAGS_cacheRasterPathMasks;
+    gSkCacheStrokedPaths = FLAGS_cacheStrokedPaths;
+    gSkCacheRasterClips = FLAGS_cacheRasterClips;
+    gSkAnalyticRasterClips = FLAGS_analyticRasterClips;
+    gSkShareStrikes = FLAGS_shareStrikes;
+    gSkGlyphRasterThreads = FLAGS_glyphRasterThreads;
 
     if (FLAGS_forceAnalyticAA) {
         gSkForceAnalyticAA = true;
@@ -8,6 +8,7 @@
 #define SK_GAMMA_APPLY_TO_A8
 #define SK_GAMMA_CONTRAST 0.0
 #define SK_GAMMA_EXPONENT 1.4
+#define SK_HAS_FREETYPE_LIBRARY
 #define SK_HAS_JPEG_LIBRARY
 #define SK_HAS_PNG_LIBRARY
 #define SK_HAS_WEBP_LIBRARY
@@ -20,6 +20,11 @@ public:
     static std::unique_ptr<SkExecutor> MakeFIFOThreadPool(int threads = 0);
     static std::unique_ptr<SkExecutor> MakeLIFOThreadPool(int threads = 0);
 
+    // Like the thread pools above, but each thread keeps its own queue of work and steals from
+    // the others when it runs out.  Work added from inside a task stays on that task's thread
+    // when possible.  This scales better when there is lots of small work, e.g. big batch()es.
+    static std::unique_ptr<SkExecutor> MakeWorkStealingThreadPool(int threads = 0);
+
     // There is always a default SkExecutor available by calling SkExecutor::GetDefault().
     static SkExecutor& GetDefault();
     static void SetDefault(SkExecutor*);  // Does not take ownership.  Not thread safe.
@@ -103,6 +103,39 @@ public:
      */
     static void PurgeFontCache();
 
+    /**
+     *  Keep glyphs between processes in the file at path: glyphs drawn from now on are read from
+     *  it if it has them, rather than generated, and those it doesn't have are added to be
+     *  written back by WriteFontCacheFile(). Pass nullptr to stop using the file.
+     */
+    static void SetFontCacheFile(const char path[]);
+
+    /**
+     *  Write the glyphs read from and added to the font cache file back to it. Returns false if
+     *  there is no file, or it couldn't be written.
+     */
+    static bool WriteFontCacheFile();
+
+    /**
+     *  Start recording which strikes (typeface, size, matrix, etc.) and glyphs are drawn, in
+     *  strikes the font cache makes from now on, for StopRecordingFontCacheManifest().
+     */
+    static void StartRecordingFontCacheManifest();
+
+    /**
+     *  Stop recording, and return a manifest of the strikes and glyphs drawn while recording,
+     *  for PrewarmFontCache() in a later process. Returns nullptr if not recording.
+     */
+    static sk_sp<SkData> StopRecordingFontCacheManifest();
+
+    /**
+     *  Generate the strikes and glyphs in a manifest from StopRecordingFontCacheManifest() in the
+     *  font cache, so that drawing them later finds them there. May be called on a background
+     *  thread, e.g. at startup before drawing. Returns false, having generated nothing, if the
+     *  manifest is invalid.
+     */
+    static bool PrewarmFontCache(const void* data, size_t length);
+
     /**
      *  Scaling bitmaps with the kHigh_SkFilterQuality setting is
      *  expensive, so the result is saved in the global Scaled Image
@@ -137,6 +170,45 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  The constant-color blit program cache.  Raster draws whose color is constant (no shader,
+     *  or one that reduces to a color) share their compiled blit programs through a cache keyed
+     *  by color, blend mode and destination format, so runs of draws with the same paint don't
+     *  rebuild them.  Draws with other shaders build their blit programs per draw, uncached.
+     *
+     *  These functions get the number of programs in the cache and get/set the maximum number
+     *  kept.  Setting the limit purges the cache and returns the previous limit; a limit of zero
+     *  disables caching.
+     */
+    static int GetConstantColorBlitCacheCountUsed();
+    static int GetConstantColorBlitCacheCountLimit();
+    static int SetConstantColorBlitCacheCountLimit(int count);
+
+    /**
+     *  Reports how many times a constant-color draw found its blit program in the cache (hits) or
+     *  had to compile it (misses), since the process started.
+     */
+    static void GetConstantColorBlitCacheStats(int64_t* hits, int64_t* misses);
+
+    /**
+     *  Frees all cached constant-color blit programs.  It does not change the limit.
+     */
+    static void PurgeConstantColorBlitCache();
+
+    /**
+     *  Reports how many times stroking a path found its outline in the stroked path cache (hits)
+     *  or had to stroke it (misses), since the process started.  The cache is only used by
+     *  processes that opt in to it (e.g. DM and nanobench with --cacheStrokedPaths).
+     */
+    static void GetStrokeCacheStats(int64_t* hits, int64_t* misses);
+
+    /**
+     *  Reports how many times clipping to a path found its anti-aliased clip in the raster clip
+     *  cache (hits) or had to scan convert it (misses), since the process started.  The cache is
+     *  only used by processes that opt in to it (e.g. DM and nanobench with --cacheRasterClips).
+     */
+    static void GetClipMaskCacheStats(int64_t* hits, int64_t* misses);
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
@@ -30,6 +30,7 @@
 
 class SkCanvas;
 class SkDeferredDisplayList;
+class SkExecutor;
 class SkPaint;
 class SkSurfaceCharacterization;
 class GrBackendRenderTarget;
@@ -170,6 +171,32 @@ public:
     static sk_sp<SkSurface> MakeRasterN32Premul(int width, int height,
                                                 const SkSurfaceProps* surfaceProps = nullptr);
 
+    /** Allocates raster SkSurface whose SkCanvas rasterizes on several threads.
+        Allocates and zeroes pixel memory, like MakeRaster().
+
+        Draws are recorded, and the surface is split into tiles. When the draws are
+        flushed, each tile replays the draws that intersect it, in the order they were
+        made, as one task on executor. The result matches a surface returned by
+        MakeRaster(), except that anti-aliased curves may differ slightly along tile
+        seams. Pending draws are flushed when pixels are
+        read, written, peeked, or snapshotted, and when SkCanvas::flush() is called.
+        Text and vertices are drawn immediately on the calling thread.
+
+        executor must outlive SkSurface. tiles should be a few times the number of
+        threads used by executor; if tiles is zero, it is chosen from imageInfo height.
+
+        @param imageInfo     width, height, SkColorType, SkAlphaType, SkColorSpace,
+                             of raster surface; width and height must be greater than zero
+        @param executor      runs the tile tasks; may be nullptr to use SkExecutor::GetDefault()
+        @param tiles         number of horizontal bands to split the surface into, or zero
+        @param surfaceProps  LCD striping orientation and setting for device independent fonts;
+                             may be nullptr
+        @return              SkSurface if all parameters are valid; otherwise, nullptr
+    */
+    static sk_sp<SkSurface> MakeRasterThreaded(const SkImageInfo& imageInfo, SkExecutor* executor,
+                                               int tiles = 0,
+                                               const SkSurfaceProps* surfaceProps = nullptr);
+
     /** Caller data passed to RenderTarget/TextureReleaseProc; may be nullptr. */
     typedef void* ReleaseContext;
 
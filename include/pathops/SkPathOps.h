@@ -11,6 +11,7 @@
 #include "../private/SkTDArray.h"
 #include "SkPreConfig.h"
 
+class SkExecutor;
 class SkPath;
 struct SkRect;
 
@@ -101,6 +102,17 @@ public:
       */
     bool resolve(SkPath* result);
 
+    /** Like resolve(), but if every operand is a union of a non-inverse path, the paths are
+        combined on executor's threads. Groups of paths whose bounds overlap are resolved
+        independently, each by splitting it in halves, resolving those in parallel and
+        joining them with Op(). If executor is nullptr, this is the same as resolve().
+
+        @param result The product of the operands.
+        @param executor The SkExecutor to run the unions on, or nullptr.
+        @return True if the operation succeeded.
+      */
+    bool resolve(SkPath* result, SkExecutor* executor);
+
 private:
     SkTArray<SkPath> fPathRefs;
     SkTDArray<SkPathOp> fOps;
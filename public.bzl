@@ -614,12 +614,14 @@ def base_defines(os_conditions):
                 "SK_BUILD_FOR_UNIX",
                 "SK_SAMPLES_FOR_X",
                 "SK_PDF_USE_SFNTLY",
+                "SK_HAS_FREETYPE_LIBRARY",
                 "SK_HAS_PNG_LIBRARY",
                 "SK_HAS_WEBP_LIBRARY",
             ],
             # ANDROID
             [
                 "SK_BUILD_FOR_ANDROID",
+                "SK_HAS_FREETYPE_LIBRARY",
                 "SK_HAS_PNG_LIBRARY",
                 "SK_HAS_WEBP_LIBRARY",
             ],
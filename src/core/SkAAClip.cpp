@@ -7,6 +7,7 @@
 
 #include "SkAAClip.h"
 
+#include "SkAnalyticClip.h"
 #include "SkBlitter.h"
 #include "SkColorData.h"
 #include "SkMacros.h"
@@ -1348,6 +1349,33 @@ bool SkAAClip::setPath(const SkPath& path, const SkRegion* clip, bool doAA) {
     return builder.finish(this);
 }
 
+bool SkAAClip::setAnalyticClip(const SkAnalyticClip& clip) {
+    AUTO_AACLIP_VALIDATE(*this);
+
+    if (clip.isEmpty()) {
+        return this->setEmpty();
+    }
+
+    const SkIRect& bounds = clip.getBounds();
+    Builder builder(bounds);
+    for (int y = bounds.fTop; y < bounds.fBottom;) {
+        int lastY;
+        const uint8_t* row = clip.findRow(y, &lastY);
+        for (; y <= lastY; y++) {
+            // The clip's rows may start left of its bounds, and run past them on the right.
+            const uint8_t* data = row;
+            for (int x = clip.rowLeft(); x < bounds.fRight; x += data[0], data += 2) {
+                int left  = SkTMax(x, bounds.fLeft),
+                    right = SkTMin(x + data[0], bounds.fRight);
+                if (left < right) {
+                    builder.addRun(left, y, data[1], right - left);
+                }
+            }
+        }
+    }
+    return builder.finish(this);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 typedef void (*RowProc)(SkAAClip::Builder&, int bottom,
@@ -1524,6 +1552,43 @@ static void operatorX(SkAAClip::Builder& builder, int lastY,
     }
 }
 
+// Is the row, which starts at x, opaque over [left, right)?
+static bool row_is_opaque(const uint8_t* row, int x, int left, int right) {
+    SkASSERT(x <= left && left < right);
+    while (x + row[0] <= left) {
+        x += row[0];
+        row += 2;
+    }
+    for (;;) {
+        if (0xFF != row[1]) {
+            return false;
+        }
+        x += row[0];
+        if (x >= right) {
+            return true;
+        }
+        row += 2;
+    }
+}
+
+// Adds the part of the row, which starts at x, within bounds' left and right.
+static void copy_row(SkAAClip::Builder& builder, int lastY, const uint8_t* row, int x,
+                     const SkIRect& bounds) {
+    SkASSERT(x <= bounds.fLeft);
+    while (x + row[0] <= bounds.fLeft) {
+        x += row[0];
+        row += 2;
+    }
+    int left = bounds.fLeft;
+    while (left < bounds.fRight) {
+        x += row[0];
+        int rite = SkMin32(x, bounds.fRight);
+        builder.addRun(left, lastY, row[1], rite - left);
+        left = rite;
+        row += 2;
+    }
+}
+
 static void adjust_iter(SkAAClip::Iter& iter, int& topA, int& botA, int bot) {
     if (bot == botA) {
         iter.next();
@@ -1588,6 +1653,14 @@ static void operateY(SkAAClip::Builder& builder, const SkAAClip& A,
 
         if (!rowA && !rowB) {
             builder.addRun(bounds.fLeft, bot - 1, 0, bounds.width());
+        } else if (top >= bounds.fTop && rowA && rowB && SkRegion::kIntersect_Op == op &&
+                   row_is_opaque(rowB, B.getBounds().fLeft, bounds.fLeft, bounds.fRight)) {
+            // Intersecting with an opaque row leaves the other row as it was, so we only
+            // really compute the rows where both clips have partial coverage.
+            copy_row(builder, bot - 1, rowA, A.getBounds().fLeft, bounds);
+        } else if (top >= bounds.fTop && rowA && rowB && SkRegion::kIntersect_Op == op &&
+                   row_is_opaque(rowA, A.getBounds().fLeft, bounds.fLeft, bounds.fRight)) {
+            copy_row(builder, bot - 1, rowB, B.getBounds().fLeft, bounds);
         } else if (top >= bounds.fTop) {
             SkASSERT(bot <= bounds.fBottom);
             RowIter rowIterA(rowA, rowA ? A.getBounds() : bounds);
@@ -1600,6 +1673,20 @@ static void operateY(SkAAClip::Builder& builder, const SkAAClip& A,
     } while (!iterA.done() || !iterB.done());
 }
 
+// Is the clip opaque everywhere in r?
+static bool is_opaque_in(const SkAAClip& clip, const SkIRect& r) {
+    if (!clip.getBounds().contains(r)) {
+        return false;
+    }
+    for (SkAAClip::Iter iter(clip); !iter.done() && iter.top() < r.fBottom; iter.next()) {
+        if (iter.bottom() > r.fTop &&
+            !row_is_opaque(iter.data(), clip.getBounds().fLeft, r.fLeft, r.fRight)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool SkAAClip::op(const SkAAClip& clipAOrig, const SkAAClip& clipBOrig,
                   SkRegion::Op op) {
     AUTO_AACLIP_VALIDATE(*this);
@@ -1637,6 +1724,14 @@ bool SkAAClip::op(const SkAAClip& clipAOrig, const SkAAClip& clipBOrig,
                                                          clipB->fBounds)) {
                 return this->setEmpty();
             }
+            // If either clip is opaque all over the other, the answer is the other, and can
+            // share its runs.  This is common with nested clips.
+            if (is_opaque_in(*clipB, clipA->fBounds)) {
+                return this->set(*clipA);
+            }
+            if (is_opaque_in(*clipA, clipB->fBounds)) {
+                return this->set(*clipB);
+            }
             break;
 
         case SkRegion::kUnion_Op:
@@ -1805,6 +1900,13 @@ void SkAAClip::copyToMask(SkMask* mask) const {
     }
 }
 
+size_t SkAAClip::approximateBytesUsed() const {
+    if (this->isEmpty()) {
+        return 0;
+    }
+    return sizeof(RunHead) + fRunHead->fRowCount * sizeof(YOffset) + fRunHead->fDataSize;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -1851,14 +1953,42 @@ void SkAAClipBlitter::ensureRunsAndAA() {
     }
 }
 
+void SkAAClipBlitter::init(SkBlitter* blitter, const SkAnalyticClip* analytic) {
+    SkASSERT(analytic && !analytic->isEmpty());
+    fBlitter = blitter;
+    fAAClip = nullptr;
+    fAnalyticClip = analytic;
+    fAAClipBounds = analytic->getBounds();
+}
+
+bool SkAAClipBlitter::quickContains(int left, int top, int right, int bottom) const {
+    SkIRect r = SkIRect::MakeLTRB(left, top, right, bottom);
+    return fAAClip ? fAAClip->quickContains(r) : fAnalyticClip->quickContains(r);
+}
+
+const uint8_t* SkAAClipBlitter::findRow(int y, int x, int* initialCount, int* lastY) const {
+    if (fAAClip) {
+        const uint8_t* row = fAAClip->findRow(y, lastY);
+        return fAAClip->findX(row, x, initialCount);
+    }
+
+    const uint8_t* row = fAnalyticClip->findRow(y, lastY);
+    x -= fAnalyticClip->rowLeft();
+    while (x >= row[0]) {
+        x -= row[0];
+        row += 2;
+    }
+    *initialCount = row[0] - x;
+    return row;
+}
+
 void SkAAClipBlitter::blitH(int x, int y, int width) {
     SkASSERT(width > 0);
     SkASSERT(fAAClipBounds.contains(x, y));
     SkASSERT(fAAClipBounds.contains(x + width  - 1, y));
 
-    const uint8_t* row = fAAClip->findRow(y);
     int initialCount;
-    row = fAAClip->findX(row, x, &initialCount);
+    const uint8_t* row = this->findRow(y, x, &initialCount);
 
     if (initialCount >= width) {
         SkAlpha alpha = row[1];
@@ -1924,9 +2054,8 @@ static void merge(const uint8_t* SK_RESTRICT row, int rowN,
 void SkAAClipBlitter::blitAntiH(int x, int y, const SkAlpha aa[],
                                 const int16_t runs[]) {
 
-    const uint8_t* row = fAAClip->findRow(y);
     int initialCount;
-    row = fAAClip->findX(row, x, &initialCount);
+    const uint8_t* row = this->findRow(y, x, &initialCount);
 
     this->ensureRunsAndAA();
 
@@ -1935,21 +2064,21 @@ void SkAAClipBlitter::blitAntiH(int x, int y, const SkAlpha aa[],
 }
 
 void SkAAClipBlitter::blitV(int x, int y, int height, SkAlpha alpha) {
-    if (fAAClip->quickContains(x, y, x + 1, y + height)) {
+    if (this->quickContains(x, y, x + 1, y + height)) {
         fBlitter->blitV(x, y, height, alpha);
         return;
     }
 
     for (;;) {
         int lastY SK_INIT_TO_AVOID_WARNING;
-        const uint8_t* row = fAAClip->findRow(y, &lastY);
+        int initialCount;
+        const uint8_t* row = this->findRow(y, x, &initialCount, &lastY);
         int dy = lastY - y + 1;
         if (dy > height) {
             dy = height;
         }
         height -= dy;
 
-        row = fAAClip->findX(row, x);
         SkAlpha newAlpha = SkMulDiv255Round(alpha, row[1]);
         if (newAlpha) {
             fBlitter->blitV(x, y, dy, newAlpha);
@@ -1963,7 +2092,7 @@ void SkAAClipBlitter::blitV(int x, int y, int height, SkAlpha alpha) {
 }
 
 void SkAAClipBlitter::blitRect(int x, int y, int width, int height) {
-    if (fAAClip->quickContains(x, y, x + width, y + height)) {
+    if (this->quickContains(x, y, x + width, y + height)) {
         fBlitter->blitRect(x, y, width, height);
         return;
     }
@@ -2096,9 +2225,9 @@ static void upscaleBW2A8(SkMask* dstMask, const SkMask& srcMask) {
 }
 
 void SkAAClipBlitter::blitMask(const SkMask& origMask, const SkIRect& clip) {
-    SkASSERT(fAAClip->getBounds().contains(clip));
+    SkASSERT(fAAClipBounds.contains(clip));
 
-    if (fAAClip->quickContains(clip)) {
+    if (this->quickContains(clip.fLeft, clip.fTop, clip.fRight, clip.fBottom)) {
         fBlitter->blitMask(origMask, clip);
         return;
     }
@@ -2141,12 +2270,10 @@ void SkAAClipBlitter::blitMask(const SkMask& origMask, const SkIRect& clip) {
 
     do {
         int localStopY SK_INIT_TO_AVOID_WARNING;
-        const uint8_t* row = fAAClip->findRow(y, &localStopY);
+        int initialCount;
+        const uint8_t* row = this->findRow(y, clip.fLeft, &initialCount, &localStopY);
         // findRow returns last Y, not stop, so we add 1
         localStopY = SkMin32(localStopY + 1, stopY);
-
-        int initialCount;
-        row = fAAClip->findX(row, clip.fLeft, &initialCount);
         do {
             mergeProc(src, width, row, initialCount, rowMask.fImage);
             rowMask.fBounds.fTop = y;
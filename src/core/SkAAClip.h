@@ -12,6 +12,8 @@
 #include "SkBlitter.h"
 #include "SkRegion.h"
 
+class SkAnalyticClip;
+
 class SkAAClip {
 public:
     SkAAClip();
@@ -38,6 +40,7 @@ public:
     bool setRect(const SkRect&, bool doAA = true);
     bool setPath(const SkPath&, const SkRegion* clip = nullptr, bool doAA = true);
     bool setRegion(const SkRegion&);
+    bool setAnalyticClip(const SkAnalyticClip&);
     bool set(const SkAAClip&);
 
     bool op(const SkAAClip&, const SkAAClip&, SkRegion::Op);
@@ -58,6 +61,9 @@ public:
      */
     void copyToMask(SkMask*) const;
 
+    // Returns the size of the clip's runs, which copies of the clip share.
+    size_t approximateBytesUsed() const;
+
     // called internally
 
     bool quickContains(int left, int top, int right, int bottom) const;
@@ -106,9 +112,13 @@ public:
         SkASSERT(aaclip && !aaclip->isEmpty());
         fBlitter = blitter;
         fAAClip = aaclip;
+        fAnalyticClip = nullptr;
         fAAClipBounds = aaclip->getBounds();
     }
 
+    // Clips to an analytic clip, reading its rows as SkAAClip's.
+    void init(SkBlitter* blitter, const SkAnalyticClip* analytic);
+
     void blitH(int x, int y, int width) override;
     void blitAntiH(int x, int y, const SkAlpha[], const int16_t runs[]) override;
     void blitV(int x, int y, int height, SkAlpha alpha) override;
@@ -117,9 +127,10 @@ public:
     const SkPixmap* justAnOpaqueColor(uint32_t* value) override;
 
 private:
-    SkBlitter*      fBlitter;
-    const SkAAClip* fAAClip;
-    SkIRect         fAAClipBounds;
+    SkBlitter*              fBlitter;
+    const SkAAClip*         fAAClip;
+    const SkAnalyticClip*   fAnalyticClip;
+    SkIRect                 fAAClipBounds;
 
     // point into fScanlineScratch
     int16_t*        fRuns;
@@ -132,6 +143,9 @@ private:
     void* fScanlineScratch;  // enough for a mask at 32bit, or runs+aa
 
     void ensureRunsAndAA();
+    bool quickContains(int left, int top, int right, int bottom) const;
+    // Returns row y of the clip from x, as SkAAClip's findRow() and findX() would.
+    const uint8_t* findRow(int y, int x, int* initialCount, int* lastY = nullptr) const;
 };
 
 #endif
@@ -0,0 +1,272 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAnalyticClip.h"
+#include "SkTemplates.h"
+
+namespace {
+// Rows crossing a corner are sliced this many times to follow its curve.
+constexpr int kMaxSpans = 16;
+
+// The part of a row between fLeft and fRight, fWeight tall.
+struct Span {
+    float fWeight, fLeft, fRight;
+};
+} // namespace
+
+// How much of the pixel [x, x+1) lies within [lo, hi).
+static float coverage(float x, float lo, float hi) {
+    return SkTPin(SkTMin(x + 1.0f, hi) - SkTMax(x, lo), 0.0f, 1.0f);
+}
+
+static SkAlpha to_alpha(float coverage) {
+    return SkToU8(SkScalarRoundToInt(SkTPin(coverage, 0.0f, 1.0f) * 255));
+}
+
+// Slices row y of rrect into the spans it covers, returning how many there are.
+static int get_spans(const SkRRect& rrect, int y, Span spans[kMaxSpans]) {
+    const SkRect& r = rrect.rect();
+    SkVector ul = rrect.radii(SkRRect::kUpperLeft_Corner),
+             ur = rrect.radii(SkRRect::kUpperRight_Corner),
+             lr = rrect.radii(SkRRect::kLowerRight_Corner),
+             ll = rrect.radii(SkRRect::kLowerLeft_Corner);
+
+    // Rows that miss the corners cover [left, right) as much as they're covered vertically.
+    float topRY = SkTMax(ul.fY, ur.fY),
+          botRY = SkTMax(ll.fY, lr.fY);
+    bool topCorners = topRY > 0 && y < r.fTop + topRY && y + 1 > r.fTop,
+         botCorners = botRY > 0 && y < r.fBottom && y + 1 > r.fBottom - botRY;
+    if (!topCorners && !botCorners) {
+        spans[0] = { coverage((float)y, r.fTop, r.fBottom), r.fLeft, r.fRight };
+        return 1;
+    }
+
+    // Otherwise, slice the row, and find where each slice crosses the corners' ellipses.
+    auto inset = [](SkVector radii, float dy) {
+        if (radii.fX <= 0 || radii.fY <= 0 || dy <= 0) {
+            return 0.0f;
+        }
+        float t = SkTMin(dy / radii.fY, 1.0f);
+        return radii.fX * (1 - sk_float_sqrt(1 - t * t));
+    };
+    auto left = [&](float sy) {
+        return r.fLeft + SkTMax(inset(ul, r.fTop + ul.fY - sy), inset(ll, sy - r.fBottom + ll.fY));
+    };
+    auto right = [&](float sy) {
+        return r.fRight - SkTMax(inset(ur, r.fTop + ur.fY - sy), inset(lr, sy - r.fBottom + lr.fY));
+    };
+
+    // Slice finely enough that each slice's ends move at most a quarter pixel.
+    float top    = SkTMax((float)y, r.fTop),
+          bottom = SkTMin(y + 1.0f, r.fBottom),
+          mid    = 0.5f * (top + bottom);
+    float sweep = SkTMax(SkScalarAbs(left(top) - left(mid)) + SkScalarAbs(left(mid) - left(bottom)),
+                         SkScalarAbs(right(top) - right(mid)) +
+                         SkScalarAbs(right(mid) - right(bottom)));
+    int count = SkTPin(SkScalarCeilToInt(4 * sweep), 1, kMaxSpans);
+    float height = (bottom - top) / count;
+    for (int i = 0; i < count; i++) {
+        float sy = top + (i + 0.5f) * height,
+              l  = left(sy);
+        spans[i] = { height, l, SkTMax(l, right(sy)) };
+    }
+    return count;
+}
+
+// Appends row y of rrect, from x = left to right, to data in SkAAClip's row format.
+static void append_row(const SkRRect& rrect, int y, int left, int right,
+                       SkTDArray<uint8_t>* data) {
+    Span spans[kMaxSpans];
+    int count = get_spans(rrect, y, spans);
+
+    float weight = 0,
+          minL =  SK_ScalarInfinity, maxL = -SK_ScalarInfinity,
+          minR =  SK_ScalarInfinity, maxR = -SK_ScalarInfinity;
+    for (int i = 0; i < count; i++) {
+        weight += spans[i].fWeight;
+        minL = SkTMin(minL, spans[i].fLeft);
+        maxL = SkTMax(maxL, spans[i].fLeft);
+        minR = SkTMin(minR, spans[i].fRight);
+        maxR = SkTMax(maxR, spans[i].fRight);
+    }
+    // Pixels in [edgeL, innerL) are partly covered by the spans' left ends, those in
+    // [innerR, edgeR) by their right ends, and those in between by every span.
+    int edgeL  = SkScalarFloorToInt(minL),
+        innerL = SkScalarCeilToInt(maxL),
+        innerR = SkScalarFloorToInt(minR),
+        edgeR  = SkScalarCeilToInt(maxR);
+    if (innerL > innerR) {
+        innerL = innerR = edgeR;
+    }
+
+    const int start = data->count();
+    auto append = [&](SkAlpha alpha, int n) {
+        if (n <= 0) {
+            return;
+        }
+        if (data->count() > start && data->top() == alpha) {
+            uint8_t& prev = (*data)[data->count() - 2];
+            int merged = SkTMin(n, 255 - prev);
+            prev += merged;
+            n -= merged;
+        }
+        while (n > 0) {
+            uint8_t* run = data->append(2);
+            run[0] = SkTMin(n, 255);
+            run[1] = alpha;
+            n -= run[0];
+        }
+    };
+    auto appendRun = [&](SkAlpha alpha, int l, int r) {
+        append(alpha, SkTMin(r, right) - SkTMax(l, left));
+    };
+
+    // A span covers pixel p by w * (c(right) - c(left)), where c(e) is clamp(e - p, 0, 1): all
+    // of the pixels before e, part of e's, and none after.  So we sum each end's weight over the
+    // pixels before it with steps, and add its part of its own pixel.
+    SkAutoSTMalloc<64, float> storage;
+    auto appendEdges = [&](int l, int r) {
+        l = SkTMax(l, left);
+        r = SkTMin(r, right);
+        if (l >= r) {
+            return;
+        }
+        const int n = r - l;
+        float* steps   = storage.reset(2 * n);
+        float* partial = steps + n;
+        sk_bzero(steps, 2 * n * sizeof(float));
+
+        float covered = 0;
+        auto addEnd = [&](float e, float w) {
+            if (e >= r) {
+                covered += w;
+            } else if (e >= l) {
+                int p = SkScalarFloorToInt(e) - l;
+                covered    += w;
+                steps[p]   -= w;
+                partial[p] += w * (e - (p + l));
+            }
+        };
+        for (int i = 0; i < count; i++) {
+            addEnd(spans[i].fRight,  spans[i].fWeight);
+            addEnd(spans[i].fLeft,  -spans[i].fWeight);
+        }
+        for (int i = 0; i < n; i++) {
+            covered += steps[i];
+            append(to_alpha(covered + partial[i]), 1);
+        }
+    };
+
+    appendRun(0, left, edgeL);
+    appendEdges(edgeL, innerL);
+    appendRun(to_alpha(weight), innerL, innerR);
+    appendEdges(innerR, edgeR);
+    appendRun(0, edgeR, right);
+}
+
+bool SkAnalyticClip::setEmpty() {
+    fBounds.setEmpty();
+    fRows.reset();
+    return false;
+}
+
+bool SkAnalyticClip::set(const SkRRect& rrect, const SkIRect& bounds) {
+    if (rrect.isEmpty() || !fBounds.intersect(rrect.getBounds().roundOut(), bounds)) {
+        return this->setEmpty();
+    }
+    fRRect = rrect;
+    this->computeRows();
+    return true;
+}
+
+bool SkAnalyticClip::intersect(const SkIRect& rect) {
+    // Our rows still hold for any part of our bounds.
+    if (this->isEmpty() || !fBounds.intersect(rect)) {
+        return this->setEmpty();
+    }
+    return true;
+}
+
+void SkAnalyticClip::translate(int dx, int dy, SkAnalyticClip* dst) const {
+    dst->fRRect = fRRect.makeOffset(SkIntToScalar(dx), SkIntToScalar(dy));
+    dst->fBounds = fBounds.makeOffset(dx, dy);
+    dst->fRows = fRows;
+    dst->fRowLeft = fRowLeft + dx;
+    dst->fRowTop = fRowTop + dy;
+    dst->fMiddleTop = fMiddleTop + dy;
+    dst->fMiddleBottom = fMiddleBottom + dy;
+}
+
+void SkAnalyticClip::computeRows() {
+    const SkRect& r = fRRect.rect();
+    float topRY = SkTMax(fRRect.radii(SkRRect::kUpperLeft_Corner).fY,
+                         fRRect.radii(SkRRect::kUpperRight_Corner).fY),
+          botRY = SkTMax(fRRect.radii(SkRRect::kLowerLeft_Corner).fY,
+                         fRRect.radii(SkRRect::kLowerRight_Corner).fY);
+
+    // A row is in the middle if it lies within the rect, below the top corners and above the
+    // bottom ones.
+    fMiddleTop    = SkTPin(SkScalarCeilToInt(r.fTop + topRY), fBounds.fTop, fBounds.fBottom);
+    fMiddleBottom = SkTPin(SkScalarFloorToInt(r.fBottom - botRY), fMiddleTop, fBounds.fBottom);
+
+    fRowLeft = fBounds.fLeft;
+    fRowTop = fBounds.fTop;
+    fRows = sk_make_sp<Rows>();
+    for (int y = fBounds.fTop; y < fBounds.fBottom; y++) {
+        if (y > fMiddleTop && y < fMiddleBottom) {
+            continue;
+        }
+        fRows->fOffsets.push_back(fRows->fData.count());
+        append_row(fRRect, y, fBounds.fLeft, fBounds.fRight, &fRows->fData);
+    }
+}
+
+const uint8_t* SkAnalyticClip::findRow(int y, int* lastY) const {
+    SkASSERT(y >= fBounds.fTop && y < fBounds.fBottom);
+
+    int index = y - fRowTop,
+        last  = y;
+    if (y >= fMiddleTop && y < fMiddleBottom) {
+        index = fMiddleTop - fRowTop;
+        last  = SkTMin(fMiddleBottom, fBounds.fBottom) - 1;
+    } else if (y >= fMiddleBottom) {
+        index -= SkTMax(fMiddleBottom - fMiddleTop - 1, 0);
+    }
+    if (lastY) {
+        *lastY = last;
+    }
+    return fRows->fData.begin() + fRows->fOffsets[index];
+}
+
+bool SkAnalyticClip::quickContains(const SkIRect& ir) const {
+    if (this->isEmpty() || !fBounds.contains(ir)) {
+        return false;
+    }
+    const SkRect rect = SkRect::Make(ir);
+    const SkRect& r = fRRect.rect();
+    if (!r.contains(rect)) {
+        return false;
+    }
+
+    // Conservatively, stay clear of the boxes bounding the corners.
+    SkVector ul = fRRect.radii(SkRRect::kUpperLeft_Corner),
+             ur = fRRect.radii(SkRRect::kUpperRight_Corner),
+             lr = fRRect.radii(SkRRect::kLowerRight_Corner),
+             ll = fRRect.radii(SkRRect::kLowerLeft_Corner);
+    const SkRect corners[] = {
+        SkRect::MakeLTRB(r.fLeft,          r.fTop,            r.fLeft + ul.fX, r.fTop + ul.fY),
+        SkRect::MakeLTRB(r.fRight - ur.fX, r.fTop,            r.fRight,        r.fTop + ur.fY),
+        SkRect::MakeLTRB(r.fRight - lr.fX, r.fBottom - lr.fY, r.fRight,        r.fBottom),
+        SkRect::MakeLTRB(r.fLeft,          r.fBottom - ll.fY, r.fLeft + ll.fX, r.fBottom),
+    };
+    for (const SkRect& corner : corners) {
+        if (SkRect::Intersects(rect, corner)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAnalyticClip_DEFINED
+#define SkAnalyticClip_DEFINED
+
+#include "SkColor.h"
+#include "SkRRect.h"
+#include "SkRefCnt.h"
+#include "SkTDArray.h"
+
+/**
+ *  An anti-aliased clip to a device space rect or rrect, limited to integer bounds.  Unlike
+ *  SkAAClip, nothing is scan converted: each row's coverage is computed from the rrect's edges
+ *  and corners, and only the rows that differ are kept.
+ */
+class SkAnalyticClip {
+public:
+    SkAnalyticClip() : fBounds(SkIRect::MakeEmpty()) {}
+
+    bool isEmpty() const { return fBounds.isEmpty(); }
+    const SkIRect& getBounds() const { return fBounds; }
+    const SkRRect& getRRect() const { return fRRect; }
+
+    bool setEmpty();
+
+    /**
+     *  Sets the clip to rrect, limited to bounds.  Returns false (leaving the clip empty) if they
+     *  don't intersect.
+     */
+    bool set(const SkRRect& rrect, const SkIRect& bounds);
+
+    // Limits the clip to rect.  Returns false if that leaves it empty.
+    bool intersect(const SkIRect& rect);
+
+    void translate(int dx, int dy, SkAnalyticClip* dst) const;
+
+    // Returns true if every pixel of r is fully covered by the clip.
+    bool quickContains(const SkIRect& r) const;
+
+    /**
+     *  Returns row y of the clip in SkAAClip's row format: (count, alpha) pairs, with counts of at
+     *  most 255.  Rows start at rowLeft(), and reach at least the right edge of the bounds.  Rows
+     *  y through *lastY are the same.
+     */
+    const uint8_t* findRow(int y, int* lastY = nullptr) const;
+    int rowLeft() const { return fRowLeft; }
+
+    friend bool operator==(const SkAnalyticClip& a, const SkAnalyticClip& b) {
+        return a.fBounds == b.fBounds && (a.isEmpty() || a.fRRect == b.fRRect);
+    }
+
+private:
+    // Computed once by set(), then shared by copies and translations of the clip.
+    struct Rows : public SkNVRefCnt<Rows> {
+        SkTDArray<uint8_t>  fData;
+        SkTDArray<int>      fOffsets;   // of each row in fData, from the top row
+    };
+
+    SkRRect     fRRect;
+    SkIRect     fBounds;
+    sk_sp<Rows> fRows;
+    int         fRowLeft;
+    int         fRowTop;
+    // Rows from fMiddleTop to fMiddleBottom are fully covered vertically, and miss the corners,
+    // so fRows keeps just one of them.
+    int         fMiddleTop;
+    int         fMiddleBottom;
+
+    void computeRows();
+};
+
+#endif
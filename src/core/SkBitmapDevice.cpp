@@ -24,6 +24,8 @@
 #include "SkTLazy.h"
 #include "SkVertices.h"
 
+std::atomic<bool> gSkBatchRasterFills{false};
+
 struct Bounder {
     SkRect  fBounds;
     bool    fHasBounds;
@@ -245,6 +247,11 @@ SkBitmapDevice::SkBitmapDevice(const SkBitmap& bitmap, const SkSurfaceProps& sur
     }
 }
 
+SkBitmapDevice::~SkBitmapDevice() {
+    // Our pixels may outlive us, so make sure they're up to date.
+    this->flushFills();
+}
+
 SkBitmapDevice* SkBitmapDevice::Create(const SkImageInfo& origInfo,
                                        const SkSurfaceProps& surfaceProps,
                                        bool trackCoverage,
@@ -294,6 +301,7 @@ SkBitmapDevice* SkBitmapDevice::Create(const SkImageInfo& origInfo,
 }
 
 void SkBitmapDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
+    this->flushFills();
     SkASSERT(bm.width() == fBitmap.width());
     SkASSERT(bm.height() == fBitmap.height());
     fBitmap = bm;   // intent is to use bm's pixelRef (and rowbytes/config)
@@ -302,8 +310,12 @@ void SkBitmapDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
 
 SkBaseDevice* SkBitmapDevice::onCreateDevice(const CreateInfo& cinfo, const SkPaint*) {
     const SkSurfaceProps surfaceProps(this->surfaceProps().flags(), cinfo.fPixelGeometry);
-    return SkBitmapDevice::Create(cinfo.fInfo, surfaceProps, cinfo.fTrackCoverage,
-                                  cinfo.fAllocator);
+    SkBitmapDevice* device = SkBitmapDevice::Create(cinfo.fInfo, surfaceProps,
+                                                    cinfo.fTrackCoverage, cinfo.fAllocator);
+    if (device) {
+        device->fBatchFills = fBatchFills;
+    }
+    return device;
 }
 
 bool SkBitmapDevice::onAccessPixels(SkPixmap* pmap) {
@@ -315,6 +327,8 @@ bool SkBitmapDevice::onAccessPixels(SkPixmap* pmap) {
 }
 
 bool SkBitmapDevice::onPeekPixels(SkPixmap* pmap) {
+    // Every draw (other than a batched fill) peeks at our pixels, so this flushes before them too.
+    this->flushFills();
     const SkImageInfo info = fBitmap.info();
     if (fBitmap.getPixels() && (kUnknown_SkColorType != info.colorType())) {
         pmap->reset(fBitmap.info(), fBitmap.getPixels(), fBitmap.rowBytes());
@@ -324,6 +338,7 @@ bool SkBitmapDevice::onPeekPixels(SkPixmap* pmap) {
 }
 
 bool SkBitmapDevice::onWritePixels(const SkPixmap& pm, int x, int y) {
+    this->flushFills();
     // since we don't stop creating un-pixeled devices yet, check for no pixels here
     if (nullptr == fBitmap.getPixels()) {
         return false;
@@ -337,6 +352,7 @@ bool SkBitmapDevice::onWritePixels(const SkPixmap& pm, int x, int y) {
 }
 
 bool SkBitmapDevice::onReadPixels(const SkPixmap& pm, int x, int y) {
+    this->flushFills();
     return fBitmap.readPixels(pm, x, y);
 }
 
@@ -352,6 +368,9 @@ void SkBitmapDevice::drawPoints(SkCanvas::PointMode mode, size_t count,
 }
 
 void SkBitmapDevice::drawRect(const SkRect& r, const SkPaint& paint) {
+    if (this->batchFill(&r, nullptr, paint)) {
+        return;
+    }
     LOOP_TILER( drawRect(r, paint), Bounder(r, paint))
 }
 
@@ -372,10 +391,77 @@ void SkBitmapDevice::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
     // required to override drawRRect.
     this->drawPath(path, paint, true);
 #else
+    if (this->batchFill(nullptr, &rrect, paint)) {
+        return;
+    }
     LOOP_TILER( drawRRect(rrect, paint), Bounder(rrect.getBounds(), paint))
 #endif
 }
 
+// Batched fills must look the same to the blitter.  Without a shader, that's just these.
+static bool same_fill_paint(const SkPaint& a, const SkPaint& b) {
+    return a.getColor4f()     == b.getColor4f()
+        && a.getBlendMode()   == b.getBlendMode()
+        && a.getColorFilter() == b.getColorFilter()
+        && a.isAntiAlias()    == b.isAntiAlias()
+        && a.isDither()       == b.isDither();
+}
+
+bool SkBitmapDevice::batchFill(const SkRect* rect, const SkRRect* rrect, const SkPaint& paint) {
+    SkASSERT(!rect != !rrect);
+    // Any matrix will do for rrects, which are drawn as paths.
+    if (!fBatchFills || fCoverage || SkDrawTiler::NeedsTiling(this) ||
+        !SkDraw::CanBatchFills(paint, rect ? this->ctm() : SkMatrix::I())) {
+        return false;
+    }
+
+    static constexpr int kMaxBatch = 256;
+    int pending = fBatchRects.count() + fBatchRRects.count();
+    if (pending > 0 && (!same_fill_paint(paint, fBatchPaint) ||
+                        this->ctm() != fBatchMatrix ||
+                        (rect ? fBatchRRects.count() : fBatchRects.count()) > 0)) {
+        this->flushFills();
+        pending = 0;
+    }
+    if (pending == 0) {
+        fBatchPaint  = paint;
+        fBatchMatrix = this->ctm();
+    }
+
+    if (rect) {
+        fBatchRects.push_back(*rect);
+    } else {
+        fBatchRRects.push_back(*rrect);
+    }
+    if (pending + 1 >= kMaxBatch) {
+        this->flushFills();
+    }
+    return true;
+}
+
+void SkBitmapDevice::flushFills() {
+    if (fBatchRects.empty() && fBatchRRects.empty()) {
+        return;
+    }
+    // Take the batch first: BDDraw peeks our pixels, which would otherwise flush again.
+    SkTArray<SkRect,  true> rects  = std::move(fBatchRects);
+    SkTArray<SkRRect, true> rrects = std::move(fBatchRRects);
+    fBatchRects.reset();
+    fBatchRRects.reset();
+
+    BDDraw draw(this);
+    draw.fMatrix = &fBatchMatrix;
+    if (!rects.empty()) {
+        draw.fillRects(rects.begin(), rects.count(), fBatchPaint);
+    } else {
+        draw.fillRRects(rrects.begin(), rrects.count(), fBatchPaint);
+    }
+}
+
+void SkBitmapDevice::flush() {
+    this->flushFills();
+}
+
 void SkBitmapDevice::drawPath(const SkPath& path,
                               const SkPaint& paint,
                               bool pathIsMutable) {
@@ -560,6 +646,7 @@ void SkBitmapDevice::drawDevice(SkBaseDevice* device, int x, int y, const SkPain
 
     // hack to test coverage
     SkBitmapDevice* src = static_cast<SkBitmapDevice*>(device);
+    src->flushFills();
     if (src->fCoverage) {
         SkDraw draw;
         draw.fDst = fBitmap.pixmap();
@@ -706,10 +793,12 @@ sk_sp<SkSpecialImage> SkBitmapDevice::makeSpecial(const SkImage* image) {
 }
 
 sk_sp<SkSpecialImage> SkBitmapDevice::snapSpecial() {
+    this->flushFills();
     return this->makeSpecial(fBitmap);
 }
 
 sk_sp<SkSpecialImage> SkBitmapDevice::snapBackImage(const SkIRect& bounds) {
+    this->flushFills();
     return SkSpecialImage::CopyFromRaster(bounds, fBitmap, &this->surfaceProps());
 }
 
@@ -732,22 +821,27 @@ void SkBitmapDevice::onSave() {
 }
 
 void SkBitmapDevice::onRestore() {
+    this->flushFills();
     fRCStack.restore();
 }
 
 void SkBitmapDevice::onClipRect(const SkRect& rect, SkClipOp op, bool aa) {
+    this->flushFills();
     fRCStack.clipRect(this->ctm(), rect, op, aa);
 }
 
 void SkBitmapDevice::onClipRRect(const SkRRect& rrect, SkClipOp op, bool aa) {
+    this->flushFills();
     fRCStack.clipRRect(this->ctm(), rrect, op, aa);
 }
 
 void SkBitmapDevice::onClipPath(const SkPath& path, SkClipOp op, bool aa) {
+    this->flushFills();
     fRCStack.clipPath(this->ctm(), path, op, aa);
 }
 
 void SkBitmapDevice::onClipRegion(const SkRegion& rgn, SkClipOp op) {
+    this->flushFills();
     SkIPoint origin = this->getOrigin();
     SkRegion tmp;
     const SkRegion* ptr = &rgn;
@@ -760,6 +854,7 @@ void SkBitmapDevice::onClipRegion(const SkRegion& rgn, SkClipOp op) {
 }
 
 void SkBitmapDevice::onSetDeviceClipRestriction(SkIRect* mutableClipRestriction) {
+    this->flushFills();
     fRCStack.setDeviceClipRestriction(mutableClipRestriction);
     if (!mutableClipRestriction->isEmpty()) {
         SkRegion rgn(*mutableClipRestriction);
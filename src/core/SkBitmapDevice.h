@@ -20,6 +20,8 @@
 #include "SkScalar.h"
 #include "SkSize.h"
 #include "SkSurfaceProps.h"
+#include "SkTArray.h"
+#include <atomic>
 
 class SkImageFilterCache;
 class SkMatrix;
@@ -31,6 +33,10 @@ class SkRRect;
 class SkSurface;
 struct SkPoint;
 
+// When true, raster surfaces made after this is set batch runs of rect and rrect fills that share
+// a paint and matrix, drawing each run with one blitter.  Pixels are the same either way.
+extern std::atomic<bool> gSkBatchRasterFills;
+
 ///////////////////////////////////////////////////////////////////////////////
 class SkBitmapDevice : public SkBaseDevice {
 public:
@@ -64,10 +70,18 @@ public:
         return Create(info, props, false, nullptr);
     }
 
+    ~SkBitmapDevice() override;
+
+    // Draws any batched fills.
+    void flush() override;
+
     const SkPixmap* accessCoverage() const {
         return fCoverage ? &fCoverage->pixmap() : nullptr;
     }
 
+    // Test hook: the clip to set SkRasterClip's test options on, before drawing.
+    SkRasterClip& rasterClipForTesting() { return fRCStack.writableRCForTesting(); }
+
 protected:
     void* getRasterHandle() const override { return fRasterHandle; }
 
@@ -136,6 +150,11 @@ protected:
     virtual void drawBitmap(const SkBitmap&, const SkMatrix&, const SkRect* dstOrNull,
                             const SkPaint&);
 
+    // used to change the backend's pixels (and possibly config/rowbytes)
+    // but cannot change the width/height, so there should be no change to
+    // any clip information.
+    void replaceBitmapBackendForRasterSurface(const SkBitmap&) override;
+
 private:
     friend class SkCanvas;
     friend struct DeviceCM; //for setMatrixClip
@@ -143,20 +162,28 @@ private:
     friend class SkDrawIter;
     friend class SkDrawTiler;
     friend class SkSurface_Raster;
+    friend class SkThreadedBMPDevice;   // to record fRCStack and rasterize into fBitmap
 
     class BDDraw;
 
-    // used to change the backend's pixels (and possibly config/rowbytes)
-    // but cannot change the width/height, so there should be no change to
-    // any clip information.
-    void replaceBitmapBackendForRasterSurface(const SkBitmap&) override;
-
     SkBaseDevice* onCreateDevice(const CreateInfo&, const SkPaint*) override;
 
     sk_sp<SkSurface> makeSurface(const SkImageInfo&, const SkSurfaceProps&) override;
 
     SkImageFilterCache* getImageFilterCache() override;
 
+    // Adds a rect or rrect fill to the current batch, returning false if it can't be batched.
+    // The batch is drawn by flushFills(), which we call before anything else draws or reads our
+    // pixels, or changes the clip.  Layer devices inherit fBatchFills from their parent.
+    bool batchFill(const SkRect*, const SkRRect*, const SkPaint&);
+    void flushFills();
+
+    bool               fBatchFills = false;
+    SkPaint            fBatchPaint;
+    SkMatrix           fBatchMatrix;
+    SkTArray<SkRect,  true> fBatchRects;
+    SkTArray<SkRRect, true> fBatchRRects;
+
     SkBitmap    fBitmap;
     void*       fRasterHandle = nullptr;
     SkRasterClipStack  fRCStack;
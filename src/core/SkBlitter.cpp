@@ -588,6 +588,24 @@ const SkPixmap* SkRectClipBlitter::justAnOpaqueColor(uint32_t* value) {
     return fBlitter->justAnOpaqueColor(value);
 }
 
+// Some blitters blend pairs with different rounding than blitAntiH(), so we only split the
+// pairs we have to.
+void SkRectClipBlitter::blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) {
+    if (fClipRect.contains(SkIRect::MakeXYWH(x, y, 2, 1))) {
+        fBlitter->blitAntiH2(x, y, a0, a1);
+    } else {
+        this->INHERITED::blitAntiH2(x, y, a0, a1);
+    }
+}
+
+void SkRectClipBlitter::blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) {
+    if (fClipRect.contains(SkIRect::MakeXYWH(x, y, 1, 2))) {
+        fBlitter->blitAntiV2(x, y, a0, a1);
+    } else {
+        this->INHERITED::blitAntiV2(x, y, a0, a1);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkRgnClipBlitter::blitH(int x, int y, int width) {
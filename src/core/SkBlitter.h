@@ -198,6 +198,8 @@ public:
                      SkAlpha leftAlpha, SkAlpha rightAlpha) override;
     void blitMask(const SkMask&, const SkIRect& clip) override;
     const SkPixmap* justAnOpaqueColor(uint32_t* value) override;
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
 
     int requestRowsPreserved() const override {
         return fBlitter->requestRowsPreserved();
@@ -210,6 +212,8 @@ public:
 private:
     SkBlitter*  fBlitter;
     SkIRect     fClipRect;
+
+    typedef SkBlitter INHERITED;
 };
 
 /** Wraps another (real) blitter, and ensures that the real blitter is only
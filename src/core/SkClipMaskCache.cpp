@@ -0,0 +1,40 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkClipMaskCache.h"
+
+std::atomic<bool> gSkCacheRasterClips{false};
+
+namespace {
+struct ClipParams {
+    ClipParams(const SkMatrix& matrix, const SkIRect& bounds) : fBounds(bounds) {
+        matrix.get9(fMatrix);
+    }
+
+    SkIRect     fBounds;
+    SkScalar    fMatrix[9];
+};
+} // namespace
+
+static size_t clip_bytes(const SkAAClip& clip) { return clip.approximateBytesUsed(); }
+
+// SkAAClips share their runs, so finding a clip doesn't copy its coverage.
+static SkPathResourceCache<ClipParams, SkAAClip> gCache("clip-mask", clip_bytes);
+
+bool SkClipMaskCache::Find(const SkPath& src, const SkMatrix& matrix, const SkIRect& bounds,
+                           SkAAClip* dst, SkResourceCache* localCache) {
+    return gCache.find(src, ClipParams(matrix, bounds), dst, localCache);
+}
+
+void SkClipMaskCache::Add(const SkPath& src, const SkMatrix& matrix, const SkIRect& bounds,
+                          const SkAAClip& dst, SkResourceCache* localCache) {
+    gCache.add(src, ClipParams(matrix, bounds), dst, localCache);
+}
+
+void SkClipMaskCache::GetStats(int64_t* hits, int64_t* misses) {
+    gCache.getStats(hits, misses);
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkClipMaskCache_DEFINED
+#define SkClipMaskCache_DEFINED
+
+#include "SkAAClip.h"
+#include "SkMatrix.h"
+#include "SkPath.h"
+#include "SkResourceCache.h"
+
+#include <atomic>
+
+// If set, SkRasterClip keeps the anti-aliased clips it scan converts from (non-volatile) paths in
+// SkResourceCache, so clipping to the same path again, e.g. each frame of a static layout, skips
+// scan converting it.
+extern std::atomic<bool> gSkCacheRasterClips;
+
+/**
+ *  Caches the SkAAClip made by scan converting a path, mapped by a matrix, within device bounds.
+ *  Entries are keyed by the path's generation ID and fill type, the matrix and the bounds, and
+ *  are purged when the path's generation ID changes (i.e. it's edited or destroyed).
+ */
+class SkClipMaskCache {
+public:
+    /**
+     *  On success, set dst to the cached clip of src mapped by matrix within bounds and return
+     *  true.
+     */
+    static bool Find(const SkPath& src, const SkMatrix& matrix, const SkIRect& bounds,
+                     SkAAClip* dst, SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Add dst, the anti-aliased clip of src mapped by matrix within bounds, to the cache.
+     */
+    static void Add(const SkPath& src, const SkMatrix& matrix, const SkIRect& bounds,
+                    const SkAAClip& dst, SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Reports how many times Find() found a clip (hits) or didn't (misses), since the process
+     *  started.
+     */
+    static void GetStats(int64_t* hits, int64_t* misses);
+};
+
+#endif
@@ -9,10 +9,12 @@
 #include "SkColorSpacePriv.h"
 #include "SkColorSpaceXformSteps.h"
 #include "SkConvertPixels.h"
+#include "SkExecutor.h"
 #include "SkHalf.h"
 #include "SkImageInfoPriv.h"
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
+#include "SkTaskGroup.h"
 
 static bool rect_memcpy(const SkImageInfo& dstInfo,       void* dstPixels, size_t dstRB,
                         const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB,
@@ -178,18 +180,48 @@ static void convert_with_pipeline(const SkImageInfo& dstInfo, void* dstRow, size
     pipeline.run(0,0, srcInfo.width(), srcInfo.height());
 }
 
+static void convert_pixels(const SkImageInfo& dstInfo,       void* dstPixels, size_t dstRB,
+                           const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB,
+                           const SkColorSpaceXformSteps& steps) {
+    for (auto fn : {rect_memcpy, swizzle_or_premul, convert_to_alpha8}) {
+        if (fn(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, steps)) {
+            return;
+        }
+    }
+    convert_with_pipeline(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, steps);
+}
+
+// Images with at least twice this many pixels are converted in bands of about this many pixels,
+// in parallel.  Rows never depend on each other.  Smaller images aren't worth the overhead.
+static constexpr int kConvertChunkPixels = 1 << 16;
+
 void SkConvertPixels(const SkImageInfo& dstInfo,       void* dstPixels, size_t dstRB,
                      const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB) {
+    SkConvertPixels(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB,
+                    &SkExecutor::GetDefault());
+}
+
+void SkConvertPixels(const SkImageInfo& dstInfo,       void* dstPixels, size_t dstRB,
+                     const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRB,
+                     SkExecutor* executor) {
     SkASSERT(dstInfo.dimensions() == srcInfo.dimensions());
     SkASSERT(SkImageInfoValidConversion(dstInfo, srcInfo));
 
     SkColorSpaceXformSteps steps{srcInfo.colorSpace(), srcInfo.alphaType(),
                                  dstInfo.colorSpace(), dstInfo.alphaType()};
 
-    for (auto fn : {rect_memcpy, swizzle_or_premul, convert_to_alpha8}) {
-        if (fn(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, steps)) {
-            return;
-        }
+    const int width  = dstInfo.width(),
+              height = dstInfo.height();
+    if (!executor || (int64_t)width * height < 2 * kConvertChunkPixels) {
+        convert_pixels(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, steps);
+        return;
     }
-    convert_with_pipeline(dstInfo, dstPixels, dstRB, srcInfo, srcPixels, srcRB, steps);
+
+    const int grain = SkTMax(1, kConvertChunkPixels / width);
+    SkTaskGroup(*executor).forkJoin(height, grain, [&](int y0, int y1) {
+        const SkImageInfo dstBand = dstInfo.makeWH(width, y1 - y0),
+                          srcBand = srcInfo.makeWH(width, y1 - y0);
+        convert_pixels(dstBand, SkTAddOffset<void>(dstPixels, y0 * dstRB), dstRB,
+                       srcBand, SkTAddOffset<const void>(srcPixels, y0 * srcRB), srcRB, steps);
+    });
 }
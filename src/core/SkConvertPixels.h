@@ -12,10 +12,17 @@
 #include "SkTemplates.h"
 
 class SkColorTable;
+class SkExecutor;
 
 void SkConvertPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRowBytes,
                      const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRowBytes);
 
+// Large images are split into bands of rows, converted in parallel on executor.  The overload
+// above uses SkExecutor::GetDefault(); pass nullptr to convert on the calling thread only.
+void SkConvertPixels(const SkImageInfo& dstInfo, void* dstPixels, size_t dstRowBytes,
+                     const SkImageInfo& srcInfo, const void* srcPixels, size_t srcRowBytes,
+                     SkExecutor* executor);
+
 static inline void SkRectMemcpy(void* dst, size_t dstRB, const void* src, size_t srcRB,
                                 size_t trimRowBytes, int rowCount) {
     SkASSERT(trimRowBytes <= dstRB);
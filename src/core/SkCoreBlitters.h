@@ -11,10 +11,15 @@
 #include "SkBitmapProcShader.h"
 #include "SkBlitter.h"
 #include "SkBlitRow.h"
+#include "SkLRUCache.h"
+#include "SkMutex.h"
 #include "SkPaint.h"
 #include "SkShaderBase.h"
 #include "SkXfermodePriv.h"
 
+#include <atomic>
+#include <memory>
+
 class SkRasterBlitter : public SkBlitter {
 public:
     SkRasterBlitter(const SkPixmap& device) : fDevice(device) {}
@@ -164,9 +169,67 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+struct SkCachedBlitProgram;
+
+/**
+ *  Caches the blit programs SkRasterPipelineBlitter compiles for constant colors, so blitters
+ *  drawing the same color with the same blend mode into the same kind of dst share them.  Global()
+ *  is the cache raster drawing uses, and backs SkGraphics' ConstantColorBlitCache calls.
+ *  All methods are thread safe.
+ */
+class SkConstantColorBlitCache : SkNoncopyable {
+public:
+    // A limit of zero disables caching.
+    explicit SkConstantColorBlitCache(int countLimit);
+    ~SkConstantColorBlitCache();
+
+    static SkConstantColorBlitCache* Global();
+
+    int getCountUsed() const;
+    int getCountLimit() const;
+    // Purges the cache and returns the previous limit.
+    int setCountLimit(int count);
+
+    // Reports how many times a blitter found its program here (hits) or had to compile it
+    // (misses).
+    void getStats(int64_t* hits, int64_t* misses) const;
+
+    void purgeAll();
+
+    // Everything a constant color blit program depends on.  Compared and hashed bytewise.
+    struct Key {
+        float    color[4];
+        uint32_t colorType;
+        uint32_t alphaType;
+        uint32_t blend;
+        uint32_t kindAndFlags;  // The kind of blit, plus kHasColorSpace_Flag.
+
+        static constexpr uint32_t kHasColorSpace_Flag = 1 << 8;
+
+        bool operator==(const Key& that) const { return 0 == memcmp(this, &that, sizeof(*this)); }
+    };
+
+    // Returns the cached program for key, or null.
+    sk_sp<SkCachedBlitProgram> find(const Key&);
+    // Caches program for key, unless caching is disabled.  If another program beat it there,
+    // returns that one instead.
+    sk_sp<SkCachedBlitProgram> add(const Key&, sk_sp<SkCachedBlitProgram> program);
+
+private:
+    mutable SkMutex fMutex;
+    std::unique_ptr<SkLRUCache<Key, sk_sp<SkCachedBlitProgram>>> fPrograms;  // Null if disabled.
+    int fCountLimit;
+
+    std::atomic<int64_t> fHits{0},
+                         fMisses{0};
+};
+
 // Neither of these ever returns nullptr, but this first factory may return a SkNullBlitter.
+// Constant color blitters share their blit programs through programCache, or
+// SkConstantColorBlitCache::Global() if it's null.
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap&, const SkPaint&, const SkMatrix& ctm,
-                                         SkArenaAlloc*);
+                                         SkArenaAlloc*,
+                                         SkConstantColorBlitCache* programCache = nullptr);
 // Use this if you've pre-baked a shader pipeline, including modulating with paint alpha.
 // This factory never returns an SkNullBlitter.
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap&, const SkPaint&,
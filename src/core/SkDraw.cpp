@@ -15,6 +15,7 @@
 #include "SkColorData.h"
 #include "SkDevice.h"
 #include "SkDrawProcs.h"
+#include "SkMaskCache.h"
 #include "SkMaskFilterBase.h"
 #include "SkMacros.h"
 #include "SkMatrix.h"
@@ -25,16 +26,20 @@
 #include "SkRRect.h"
 #include "SkRasterClip.h"
 #include "SkRectPriv.h"
+#include "SkResourceCache.h"
 #include "SkScan.h"
 #include "SkShader.h"
+#include "SkSharedScan.h"
 #include "SkString.h"
 #include "SkStroke.h"
 #include "SkStrokeRec.h"
+#include "SkTArray.h"
 #include "SkTLazy.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 #include "SkUtils.h"
 
+#include <algorithm>
 #include <utility>
 
 static SkPaint make_paint_with_image(
@@ -50,6 +55,72 @@ static SkPaint make_paint_with_image(
 
 SkDraw::SkDraw() {}
 
+// Limits a blitter to one tile of the clip.  Anti-aliased pairs straddling the tile's edge are
+// blitted as a two pixel mask, just as SkRasterPipelineBlitter blits whole pairs, so each tile
+// blends its half of the pair exactly as drawing the whole clip would.  (The legacy blitters
+// round pairs differently than masks; SkThreadedBMPDevice doesn't tile draws that use them.)
+class SkTileClipBlitter final : public SkRectClipBlitter {
+public:
+    void init(SkBlitter* blitter, const SkIRect& tile) {
+        this->INHERITED::init(blitter, tile);
+        fTile = tile;
+    }
+
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override {
+        const SkIRect pair = SkIRect::MakeXYWH(x, y, 2, 1);
+        if (fTile.contains(pair)) {
+            this->INHERITED::blitAntiH2(x, y, a0, a1);
+        } else {
+            this->blitPair(pair, a0, a1);
+        }
+    }
+
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override {
+        const SkIRect pair = SkIRect::MakeXYWH(x, y, 1, 2);
+        if (fTile.contains(pair)) {
+            this->INHERITED::blitAntiV2(x, y, a0, a1);
+        } else {
+            this->blitPair(pair, a0, a1);
+        }
+    }
+
+private:
+    void blitPair(const SkIRect& pair, U8CPU a0, U8CPU a1) {
+        uint8_t coverage[] = { (uint8_t)a0, (uint8_t)a1 };
+
+        SkMask mask;
+        mask.fImage    = coverage;
+        mask.fBounds   = pair;
+        mask.fRowBytes = pair.width();
+        mask.fFormat   = SkMask::kA8_Format;
+
+        // SkRectClipBlitter::blitMask() limits this to the tile.
+        this->blitMask(mask, pair);
+    }
+
+    SkIRect fTile;
+
+    typedef SkRectClipBlitter INHERITED;
+};
+
+// Picks the clip to scan convert against, limiting the blitter to fRC if that isn't fRC.
+class SkDrawScanClip : SkNoncopyable {
+public:
+    SkDrawScanClip(const SkDraw& draw, SkBlitter** blitter) : fRC(draw.fRC) {
+        if (draw.fScanRC && !draw.fRC->isEmpty()) {
+            fClipper.init(*blitter, draw.fRC->getBounds());
+            *blitter = &fClipper;
+            fRC = draw.fScanRC;
+        }
+    }
+
+    const SkRasterClip& rc() const { return *fRC; }
+
+private:
+    const SkRasterClip* fRC;
+    SkTileClipBlitter   fClipper;
+};
+
 bool SkDraw::computeConservativeLocalClipBounds(SkRect* localBounds) const {
     if (fRC->isEmpty()) {
         return false;
@@ -60,7 +131,7 @@ bool SkDraw::computeConservativeLocalClipBounds(SkRect* localBounds) const {
         return false;
     }
 
-    SkIRect devBounds = fRC->getBounds();
+    SkIRect devBounds = (fScanRC ? fScanRC : fRC)->getBounds();
     // outset to have slop for antialasing and hairlines
     devBounds.outset(1, 1);
     inverse.mapRect(localBounds, SkRect::Make(devBounds));
@@ -355,12 +426,13 @@ void SkDraw::drawPoints(SkCanvas::PointMode mode, size_t count,
     }
 
     PtProcRec rec;
-    if (!device && rec.init(mode, paint, fMatrix, fRC)) {
+    if (!device && rec.init(mode, paint, fMatrix, fScanRC ? fScanRC : fRC)) {
         SkAutoBlitterChoose blitter(*this, nullptr, paint);
 
         SkPoint             devPts[MAX_DEV_PTS];
         const SkMatrix*     matrix = fMatrix;
         SkBlitter*          bltr = blitter.get();
+        SkDrawScanClip      scanClip(*this, &bltr);
         PtProcRec::Proc     proc = rec.chooseProc(&bltr);
         // we have to back up subsequent passes if we're in polygon mode
         const size_t backup = (SkCanvas::kPolygon_PointMode == mode);
@@ -665,8 +737,9 @@ void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
     }
 
     SkAutoBlitterChoose blitterStorage(*this, matrix, paint);
-    const SkRasterClip& clip = *fRC;
     SkBlitter*          blitter = blitterStorage.get();
+    SkDrawScanClip      scanClip(*this, &blitter);
+    const SkRasterClip& clip = scanClip.rc();
 
     // we want to "fill" if we are kFill or kStrokeAndFill, since in the latter
     // case we are also hairline (if we've gotten to here), which devolves to
@@ -698,6 +771,80 @@ void SkDraw::drawRect(const SkRect& prePaintRect, const SkPaint& paint,
     }
 }
 
+bool SkDraw::CanBatchFills(const SkPaint& paint, const SkMatrix& matrix) {
+    SkPoint unused;
+    return !paint.getShader()
+        && paint.getStyle() == SkPaint::kFill_Style
+        && kFill_RectType == ComputeRectType(paint, matrix, &unused);
+}
+
+void SkDraw::fillRects(const SkRect rects[], int count, const SkPaint& paint) const {
+    SkDEBUGCODE(this->validate();)
+    SkASSERT(CanBatchFills(paint, *fMatrix));
+
+    if (fRC->isEmpty()) {
+        return;
+    }
+
+    SkSTArray<64, SkRect, true> devRects;
+    for (int i = 0; i < count; i++) {
+        SkRect devRect;
+        fMatrix->mapPoints(rect_points(devRect), rect_points(rects[i]), 2);
+        devRect.sort();
+        if (SkPathPriv::TooBigForMath(devRect)) {
+            continue;
+        }
+        if (!SkRectPriv::FitsInFixed(devRect)) {
+            // This is rare enough that we don't bother keeping the batch's blitter.
+            for (int j = 0; j < count; j++) {
+                this->drawRect(rects[j], paint);
+            }
+            return;
+        }
+        if (!fRC->quickReject(devRect.roundOut())) {
+            devRects.push_back(devRect);
+        }
+    }
+    if (devRects.empty()) {
+        return;
+    }
+
+    if (!paint.isAntiAlias()) {
+        // Anti-aliased coverage is rounded as each rect is blended, so those keep their order.
+        std::sort(devRects.begin(), devRects.end(), [](const SkRect& a, const SkRect& b) {
+            return a.fTop < b.fTop || (a.fTop == b.fTop && a.fLeft < b.fLeft);
+        });
+    }
+
+    SkAutoBlitterChoose blitterStorage(*this, nullptr, paint);
+    SkBlitter* blitter = blitterStorage.get();
+    SkDrawScanClip scanClip(*this, &blitter);
+    for (const SkRect& devRect : devRects) {
+        if (paint.isAntiAlias()) {
+            SkScan::AntiFillRect(devRect, scanClip.rc(), blitter);
+        } else {
+            SkScan::FillRect(devRect, scanClip.rc(), blitter);
+        }
+    }
+}
+
+void SkDraw::fillRRects(const SkRRect rrects[], int count, const SkPaint& paint) const {
+    SkDEBUGCODE(this->validate();)
+    SkASSERT(CanBatchFills(paint, SkMatrix::I()));
+
+    if (fRC->isEmpty()) {
+        return;
+    }
+
+    // Just as drawRRect() does without a mask filter, we draw each rrect as a path.
+    SkAutoBlitterChoose blitter(*this, nullptr, paint);
+    for (int i = 0; i < count; i++) {
+        SkPath path;
+        path.addRRect(rrects[i]);
+        this->drawPath(path, paint, nullptr, true, false, blitter.get());
+    }
+}
+
 void SkDraw::drawDevMask(const SkMask& srcM, const SkPaint& paint) const {
     if (srcM.fBounds.isEmpty()) {
         return;
@@ -787,9 +934,11 @@ void SkDraw::drawRRect(const SkRRect& rrect, const SkPaint& paint) const {
         // Transform the rrect into device space.
         SkRRect devRRect;
         if (rrect.transform(*fMatrix, &devRRect)) {
-            SkAutoBlitterChoose blitter(*this, nullptr, paint);
+            SkAutoBlitterChoose blitterStorage(*this, nullptr, paint);
+            SkBlitter* blitter = blitterStorage.get();
+            SkDrawScanClip scanClip(*this, &blitter);
             if (as_MFB(paint.getMaskFilter())->filterRRect(devRRect, *fMatrix,
-                                                           *fRC, blitter.get())) {
+                                                           scanClip.rc(), blitter)) {
                 return; // filterRRect() called the blitter, so we're done
             }
         }
@@ -827,11 +976,13 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
     } else {
         blitter = customBlitter;
     }
+    SkDrawScanClip scanClip(*this, &blitter);
 
     if (paint.getMaskFilter()) {
         SkStrokeRec::InitStyle style = doFill ? SkStrokeRec::kFill_InitStyle
         : SkStrokeRec::kHairline_InitStyle;
-        if (as_MFB(paint.getMaskFilter())->filterPath(devPath, *fMatrix, *fRC, blitter, style)) {
+        if (as_MFB(paint.getMaskFilter())->filterPath(devPath, *fMatrix, scanClip.rc(), blitter,
+                                                      style)) {
             return; // filterPath() called the blitter, so we're done
         }
     }
@@ -877,7 +1028,11 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
         }
     }
 
-    proc(devPath, *fRC, blitter);
+    if (fSharedScan && &scanClip.rc() == fScanRC &&
+            fSharedScan->draw(devPath, proc, *fScanRC, fRC->getBounds(), blitter)) {
+        return;
+    }
+    proc(devPath, scanClip.rc(), blitter);
 }
 
 void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
@@ -960,6 +1115,15 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
     // transform the path into device space
     pathPtr->transform(*matrix, devPathPtr);
 
+    // Only the original path has a generation ID worth caching under, and only if we didn't
+    // just overwrite it with the device path.
+    if (fCachePathMasks && pathPtr == &origSrcPath && devPathPtr != pathPtr &&
+            doFill && !drawCoverage && !customBlitter && paint->isAntiAlias() &&
+            !paint->getMaskFilter() &&
+            this->drawCachedPathMask(origSrcPath, *matrix, *devPathPtr, *paint)) {
+        return;
+    }
+
     this->drawDevPath(*devPathPtr, *paint, drawCoverage, customBlitter, doFill);
 }
 
@@ -1270,6 +1434,52 @@ static void draw_into_mask(const SkMask& mask, const SkPath& devPath,
     draw.drawPath(devPath, paint);
 }
 
+std::atomic<bool> gSkCacheRasterPathMasks{false};
+
+bool SkDraw::drawCachedPathMask(const SkPath& srcPath, const SkMatrix& matrix,
+                                const SkPath& devPath, const SkPaint& paint) const {
+    // Paths bigger than this cost more memory to record than scan converting them costs time.
+    static constexpr int64_t kMaxMaskArea = 512 * 512;
+
+    if (srcPath.isVolatile() || srcPath.isInverseFillType() || matrix.hasPerspective() ||
+            SkPathPriv::TooBigForMath(devPath)) {
+        return false;
+    }
+    SkIRect bounds;
+    if (!ComputeMaskBounds(devPath.getBounds(), nullptr, nullptr, nullptr, &bounds) ||
+            bounds.isEmpty() || (int64_t)bounds.width() * bounds.height() > kMaxMaskArea) {
+        return false;
+    }
+    // Scan converters chop edges at the clip, so we only record paths inside it, and they
+    // scan convert against anti-aliased clips differently, so we only record against BW clips.
+    const SkRasterClip* scanRC = fScanRC ? fScanRC : fRC;
+    if (!scanRC->isBW() || !scanRC->getBounds().contains(bounds)) {
+        return false;
+    }
+
+    // Scan converting also depends on the clip bounds, so recordings are keyed on them too.
+    const SkIRect& clipBounds = scanRC->getBounds();
+    SkCachedData* data = SkMaskCache::FindAndRef(srcPath, matrix, clipBounds);
+    if (!data) {
+        // Device blitters all preserve one row (see SkBlitter::requestRowsPreserved()).
+        SkScanRecording recording;
+        recording.record(devPath, SkScan::AntiFillPath, SkRasterClip(clipBounds), 1);
+        data = SkResourceCache::NewCachedData(recording.flattenedSize());
+        recording.flatten(data->writable_data());
+        SkMaskCache::Add(srcPath, matrix, clipBounds, data);
+    }
+
+    // Replay the recording through the blitters drawDevPath() and the scan converter would use.
+    SkAutoBlitterChoose blitterChooser(*this, nullptr, paint);
+    SkBlitter* blitter = blitterChooser.get();
+    SkDrawScanClip scanClip(*this, &blitter);
+    SkBlitterClipper clipper;
+    SkScanRecording::ReplayFlattened(data->data(),
+                                     clipper.apply(blitter, &scanClip.rc().bwRgn(), &bounds));
+    data->unref();
+    return true;
+}
+
 bool SkDraw::DrawToMask(const SkPath& devPath, const SkIRect* clipBounds,
                         const SkMaskFilter* filter, const SkMatrix* filterMatrix,
                         SkMask* mask, SkMask::CreateMode mode,
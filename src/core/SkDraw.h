@@ -18,6 +18,8 @@
 #include "SkStrokeRec.h"
 #include "SkVertices.h"
 
+#include <atomic>
+
 class SkBitmap;
 class SkClipStack;
 class SkBaseDevice;
@@ -26,9 +28,15 @@ class SkMatrix;
 class SkPath;
 class SkRegion;
 class SkRasterClip;
+class SkSharedScan;
 struct SkRect;
 class SkRRect;
 
+// If true, anti-aliased fills of non-volatile paths inside the clip are drawn by replaying their
+// scan conversions, recorded and cached in SkResourceCache (see SkMaskCache), so redrawing the
+// same path with the same matrix and clip bounds skips building edges and scan converting.
+extern std::atomic<bool> gSkCacheRasterPathMasks;
+
 class SkDraw : public SkGlyphRunListPainter::BitmapDevicePainter {
 public:
     SkDraw();
@@ -42,6 +50,21 @@ public:
         this->drawRect(rect, paint, nullptr, nullptr);
     }
     void    drawRRect(const SkRRect&, const SkPaint&) const;
+
+    /**
+     *  Can runs of rects or rrects drawn with this paint and matrix share one blitter?
+     *  Shader-free fills qualify: their blitter doesn't depend on the geometry or matrix.
+     */
+    static bool CanBatchFills(const SkPaint&, const SkMatrix&);
+
+    /**
+     *  Draw each rect (or rrect) as if by drawRect() (or drawRRect()), but choose the blitter
+     *  only once.  The paint must pass CanBatchFills().  Aliased rects are blitted sorted
+     *  top-to-bottom, which gives the same pixels: each covered pixel sees the same blend once
+     *  per rect, whatever the order.
+     */
+    void    fillRects(const SkRect[], int count, const SkPaint&) const;
+    void    fillRRects(const SkRRect[], int count, const SkPaint&) const;
     /**
      *  To save on mallocs, we allow a flag that tells us that srcPath is
      *  mutable, so that we don't have to make copies of it as we transform it.
@@ -143,6 +166,15 @@ private:
                      bool drawCoverage,
                      SkBlitter* customBlitter,
                      bool doFill) const;
+
+    /**
+     *  Draw the fill of srcPath, mapped by matrix to devPath, by replaying its cached scan
+     *  conversion, recording and caching it if needed.  This draws exactly what drawDevPath()
+     *  would.  Return false if the path isn't cacheable.
+     */
+    bool drawCachedPathMask(const SkPath& srcPath, const SkMatrix& matrix, const SkPath& devPath,
+                            const SkPaint&) const;
+
     /**
      *  Return the current clip bounds, in local coordinates, with slop to account
      *  for antialiasing or hairlines (i.e. device-bounds outset by 1, and then
@@ -158,9 +190,21 @@ public:
     const SkMatrix* fMatrix{nullptr};        // required
     const SkRasterClip* fRC{nullptr};        // required
 
+    // optional: if present, geometry is culled and scan converted against this clip, and fRC,
+    // which must be within it, only limits which pixels are written.  Scan converters chop
+    // edges to their clip, so this lets a tile draw exactly the pixels the whole clip would.
+    const SkRasterClip* fScanRC{nullptr};
+
+    // optional, with fScanRC: paths are scan converted against fScanRC just once, shared by
+    // every SkDraw with this fSharedScan, and each replays the part within fRC.
+    SkSharedScan* fSharedScan{nullptr};
+
     // optional, will be same dimensions as fDst if present
     const SkPixmap* fCoverage{nullptr};
 
+    // draw anti-aliased fills of non-volatile paths through cached scan conversions?
+    bool fCachePathMasks{gSkCacheRasterPathMasks};
+
 #ifdef SK_DEBUG
     void validate() const;
 #else
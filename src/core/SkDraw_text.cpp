@@ -73,8 +73,7 @@ void SkDraw::paintMasks(SkSpan<const SkMask> masks, const SkPaint& paint) const
             }
         }
     } else {
-        SkIRect clipBounds = fRC->isBW() ? fRC->bwRgn().getBounds()
-                                         : fRC->aaRgn().getBounds();
+        SkIRect clipBounds = fRC->getBounds();
         for (const SkMask& mask : masks) {
             SkIRect storage;
             const SkIRect* bounds = &mask.fBounds;
@@ -11,6 +11,7 @@
 #include "SkSemaphore.h"
 #include "SkSpinlock.h"
 #include "SkTArray.h"
+#include "SkTLS.h"
 #include <deque>
 #include <thread>
 
@@ -131,6 +132,125 @@ private:
     SkSemaphore           fWorkAvailable;
 };
 
+// An SkWorkStealingThreadPool gives each of its threads its own list of work.  Work added from
+// one of our threads (usually by a task, e.g. a nested SkTaskGroup) goes onto that thread's list,
+// and work added from anywhere else goes onto a shared list.  Threads take work from the back of
+// their own list, so nested work runs where its data is still warm, and otherwise take the oldest
+// work from the shared list or from another thread's list.  Each list has its own lock, so most
+// add()s and do_work()s never touch a lock any other thread wants.
+class SkWorkStealingThreadPool final : public SkExecutor {
+public:
+    explicit SkWorkStealingThreadPool(int threads) : fWorkers(new WorkList[threads]) {
+        for (int i = 0; i < threads; i++) {
+            fThreads.emplace_back(&Loop, this, i);
+        }
+    }
+
+    ~SkWorkStealingThreadPool() override {
+        // Signal each thread that it's time to shut down.
+        for (int i = 0; i < fThreads.count(); i++) {
+            this->push(&fShared, nullptr);
+        }
+        // Wait for each thread to shut down.
+        for (int i = 0; i < fThreads.count(); i++) {
+            fThreads[i].join();
+        }
+    }
+
+    void add(std::function<void(void)> work) override {
+        int self = this->threadIndex();
+        this->push(self < 0 ? &fShared : &fWorkers[self], std::move(work));
+    }
+
+    void borrow() override {
+        // If there is work waiting, do it.
+        if (fWorkAvailable.try_wait()) {
+            SkAssertResult(this->do_work(this->threadIndex()));
+        }
+    }
+
+private:
+    struct WorkList {
+        SkSpinlock                             fLock;
+        std::deque<std::function<void(void)>> fWork;
+    };
+
+    void push(WorkList* list, std::function<void(void)> work) {
+        {
+            SkAutoExclusive lock(list->fLock);
+            list->fWork.emplace_back(std::move(work));
+        }
+        fWorkAvailable.signal(1);
+    }
+
+    static bool pop_back(WorkList* list, std::function<void(void)>* work) {
+        SkAutoExclusive lock(list->fLock);
+        if (list->fWork.empty()) {
+            return false;
+        }
+        *work = std::move(list->fWork.back());
+        list->fWork.pop_back();
+        return true;
+    }
+
+    static bool pop_front(WorkList* list, std::function<void(void)>* work) {
+        SkAutoExclusive lock(list->fLock);
+        if (list->fWork.empty()) {
+            return false;
+        }
+        *work = std::move(list->fWork.front());
+        list->fWork.pop_front();
+        return true;
+    }
+
+    // Each of our threads remembers its pool and its index there in SkTLS as it starts.
+    struct Worker {
+        const SkWorkStealingThreadPool* fPool;
+        int                             fIndex;
+    };
+    static void* CreateWorker() { return new Worker{ nullptr, -1 }; }
+    static void DeleteWorker(void* worker) { delete static_cast<Worker*>(worker); }
+
+    // Which of our threads is calling, or -1 if it's not one of ours.
+    int threadIndex() const {
+        auto worker = static_cast<const Worker*>(SkTLS::Find(CreateWorker));
+        return worker && worker->fPool == this ? worker->fIndex : -1;
+    }
+
+    // This method should be called only when fWorkAvailable indicates there's work to do.
+    bool do_work(int self) {
+        // Every signal of fWorkAvailable follows a push, so the work we're owed is in some list,
+        // though it may take us a lap or two to find it if other threads are busy taking work.
+        std::function<void(void)> work;
+        const int n = fThreads.count();
+        for (bool found = self >= 0 && pop_back(&fWorkers[self], &work); !found; ) {
+            found = pop_front(&fShared, &work);
+            for (int i = 1; !found && i <= n; i++) {
+                found = pop_front(&fWorkers[(SkTMax(self, 0) + i) % n], &work);
+            }
+        }
+
+        if (!work) {
+            return false;  // This is Loop()'s signal to shut down.
+        }
+
+        work();
+        return true;
+    }
+
+    static void Loop(SkWorkStealingThreadPool* pool, int self) {
+        *static_cast<Worker*>(SkTLS::Get(CreateWorker, DeleteWorker)) = { pool, self };
+        do {
+            pool->fWorkAvailable.wait();
+        } while (pool->do_work(self));
+    }
+
+    SkTArray<std::thread>       fThreads;
+    std::unique_ptr<WorkList[]> fWorkers;
+    WorkList                    fShared;
+    SkSemaphore                 fWorkAvailable;
+};
+
 std::unique_ptr<SkExecutor> SkExecutor::MakeFIFOThreadPool(int threads) {
     using WorkList = std::deque<std::function<void(void)>>;
     return skstd::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores());
@@ -139,3 +259,7 @@ std::unique_ptr<SkExecutor> SkExecutor::MakeLIFOThreadPool(int threads) {
     using WorkList = SkTArray<std::function<void(void)>>;
     return skstd::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores());
 }
+
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingThreadPool(int threads) {
+    return skstd::make_unique<SkWorkStealingThreadPool>(threads > 0 ? threads : num_cores());
+}
@@ -0,0 +1,474 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkGlyphFileCache.h"
+
+#include "SkAutoMalloc.h"
+#include "SkDescriptor.h"
+#include "SkFontArguments.h"
+#include "SkMilestone.h"
+#include "SkOpts.h"
+#include "SkPath.h"
+#include "SkScalerContext.h"
+#include "SkStream.h"
+#include "SkTypeface.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+#if defined(SK_BUILD_FOR_WIN)
+    #include <process.h>
+    static int process_id() { return _getpid(); }
+#else
+    #include <unistd.h>
+    static int process_id() { return getpid(); }
+#endif
+
+struct SkGlyphFileCache::Header {
+    uint32_t fMagic;
+    uint32_t fVersion;
+    uint32_t fMilestone;     // SK_MILESTONE of the Skia that wrote the file
+    uint32_t fFontHostVersion;
+    uint32_t fStrikeCount;
+    uint32_t fEntryCount;
+    uint32_t fRecordsSize;
+    uint32_t fChecksum;      // of everything after the header
+};
+
+namespace {
+constexpr uint32_t kMagic   = SkSetFourByteTag('S', 'k', 'G', 'C');
+// Bump when the layout of the file, a record, or a descriptor changes.
+constexpr uint32_t kVersion = 2;
+
+// Glyphs rasterized by one version of FreeType may differ from another's, so files record the
+// version they were written with, as 0xMMmmpp.
+uint32_t font_host_version() {
+#if defined(SK_HAS_FREETYPE_LIBRARY)
+    return SkFreeTypeVersion();
+#else
+    return 0;
+#endif
+}
+
+// How much of a typeface's font data identifies it, along with its length.
+constexpr size_t kIdentifyingBytes = 4096;
+
+// How many bytes of glyphs we add by default, like the strike cache's default limit.
+constexpr size_t kDefaultAddedByteLimit = 2 * 1024 * 1024;
+
+// The metrics an SkScalerContext computes for a glyph.
+struct Metrics {
+    float    fAdvanceX, fAdvanceY;
+    uint16_t fWidth, fHeight;
+    int16_t  fTop, fLeft;
+    int8_t   fForceBW;
+    uint8_t  fMaskFormat;
+    uint16_t fPad;
+};
+static_assert(sizeof(Metrics) == 20, "");
+
+size_t align4(size_t size) { return SkAlign4(size); }
+
+// Identifies the font data a typeface draws from, or returns an empty string if it has none.
+SkString typeface_key(const SkTypeface& typeface) {
+    int ttcIndex;
+    std::unique_ptr<SkStreamAsset> stream(typeface.openStream(&ttcIndex));
+    if (!stream || !stream->hasLength()) {
+        return SkString();
+    }
+
+    uint32_t head[3] = {
+        SkToU32(stream->getLength()),
+        SkToU32(ttcIndex),
+        0,
+    };
+    size_t length = SkTMin(stream->getLength(), kIdentifyingBytes);
+    if (const void* base = stream->getMemoryBase()) {
+        head[2] = SkOpts::hash(base, length);
+    } else {
+        SkAutoMalloc bytes(length);
+        if (stream->read(bytes.get(), length) != length) {
+            return SkString();
+        }
+        head[2] = SkOpts::hash(bytes.get(), length);
+    }
+
+    SkString key(reinterpret_cast<const char*>(head), sizeof(head));
+    int coordinateCount = typeface.getVariationDesignPosition(nullptr, 0);
+    if (coordinateCount > 0) {
+        SkAutoTMalloc<SkFontArguments::VariationPosition::Coordinate> coordinates(coordinateCount);
+        if (typeface.getVariationDesignPosition(coordinates, coordinateCount) != coordinateCount) {
+            return SkString();
+        }
+        key.append(reinterpret_cast<const char*>(coordinates.get()),
+                   coordinateCount * sizeof(coordinates[0]));
+    }
+    return key;
+}
+
+uint32_t hash_of(const SkString& bytes) { return SkOpts::hash(bytes.c_str(), bytes.size()); }
+}  // namespace
+
+sk_sp<SkGlyphFileCache> SkGlyphFileCache::Make(sk_sp<SkData> data) {
+    return sk_sp<SkGlyphFileCache>(new SkGlyphFileCache(std::move(data), SkString()));
+}
+
+sk_sp<SkGlyphFileCache> SkGlyphFileCache::MakeFromFile(const char path[]) {
+    SkASSERT(path);
+    return sk_sp<SkGlyphFileCache>(
+            new SkGlyphFileCache(SkData::MakeFromFileName(path), SkString(path)));
+}
+
+SkGlyphFileCache::SkGlyphFileCache(sk_sp<SkData> data, SkString path)
+    : fData{std::move(data)}
+    , fPath{std::move(path)}
+    , fAddedByteLimit{kDefaultAddedByteLimit}
+{
+    if (!fData || fData->size() < sizeof(Header) || !SkIsAlign4((uintptr_t)fData->data())) {
+        return;
+    }
+    auto base = static_cast<const uint8_t*>(fData->data());
+    auto header = reinterpret_cast<const Header*>(base);
+    uint64_t size = sizeof(Header)
+                  + (uint64_t)header->fStrikeCount * sizeof(Strike)
+                  + (uint64_t)header->fEntryCount  * sizeof(Entry)
+                  + header->fRecordsSize;
+    if (header->fMagic != kMagic || header->fVersion != kVersion
+        || header->fMilestone != SK_MILESTONE || header->fFontHostVersion != font_host_version()
+        || size != fData->size()
+        || header->fChecksum != SkOpts::hash(base + sizeof(Header), size - sizeof(Header))) {
+        return;
+    }
+
+    fStrikes     = reinterpret_cast<const Strike*>(base + sizeof(Header));
+    fStrikeCount = header->fStrikeCount;
+    fEntries     = reinterpret_cast<const Entry*>(fStrikes + fStrikeCount);
+    fEntryCount  = header->fEntryCount;
+    fRecords     = reinterpret_cast<const uint8_t*>(fEntries + fEntryCount);
+    fRecordsSize = header->fRecordsSize;
+
+    if (!this->validate()) {
+        fStrikes     = nullptr;
+        fStrikeCount = 0;
+        fEntries     = nullptr;
+        fEntryCount  = 0;
+        fRecords     = nullptr;
+        fRecordsSize = 0;
+    }
+}
+
+bool SkGlyphFileCache::validate() const {
+    auto in_records = [this](uint32_t offset, uint32_t size) {
+        return SkIsAlign4(offset) && offset <= fRecordsSize && size <= fRecordsSize - offset;
+    };
+    for (int i = 0; i < fStrikeCount; i++) {
+        const Strike& strike = fStrikes[i];
+        if (!in_records(strike.fOffset, strike.fSize)
+            || (i > 0 && strike.fHash < fStrikes[i - 1].fHash)
+            || strike.fHash != SkOpts::hash(fRecords + strike.fOffset, strike.fSize)) {
+            return false;
+        }
+    }
+    for (int i = 0; i < fEntryCount; i++) {
+        const Entry& entry = fEntries[i];
+        if (!in_records(entry.fOffset, entry.fSize)
+            || entry.fKey.fStrike >= SkToU32(fStrikeCount)
+            || entry.fKey.fKind > kPath_Kind
+            || (i > 0 && !(fEntries[i - 1].fKey < entry.fKey))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int SkGlyphFileCache::findOrAddStrike(const SkDescriptor& desc, const SkTypeface& typeface) {
+    SkString key;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (SkString* typefaceKey = fTypefaceKeys.find(typeface.uniqueID())) {
+            key = *typefaceKey;
+        } else {
+            key = *fTypefaceKeys.set(typeface.uniqueID(), typeface_key(typeface));
+        }
+    }
+    if (key.isEmpty()) {
+        return -1;
+    }
+
+    // The typeface's ID differs from process to process, so leave it out, and the checksum with it.
+    std::unique_ptr<SkDescriptor> copy = desc.copy();
+    auto rec = static_cast<const SkScalerContextRec*>(copy->findEntry(kRec_SkDescriptorTag,
+                                                                      nullptr));
+    if (rec == nullptr) {
+        return -1;
+    }
+    const_cast<SkScalerContextRec*>(rec)->fFontID = 0;
+    key.append(reinterpret_cast<const char*>(copy.get()) + sizeof(uint32_t),
+               copy->getLength() - sizeof(uint32_t));
+
+    uint32_t hash = hash_of(key);
+    auto range = std::equal_range(fStrikes, fStrikes + fStrikeCount, Strike{hash, 0, 0},
+                                  [](const Strike& a, const Strike& b) {
+                                      return a.fHash < b.fHash;
+                                  });
+    for (const Strike* strike = range.first; strike != range.second; strike++) {
+        if (strike->fSize == key.size()
+            && memcmp(fRecords + strike->fOffset, key.c_str(), key.size()) == 0) {
+            return SkToInt(strike - fStrikes);
+        }
+    }
+
+    SkAutoMutexAcquire lock(fMutex);
+    if (int* id = fAddedStrikeIDs.find(key)) {
+        return *id;
+    }
+    int id = fStrikeCount + fAddedStrikes.count();
+    fAddedStrikes.push_back(key);
+    fAddedStrikeIDs.set(key, id);
+    return id;
+}
+
+const void* SkGlyphFileCache::find(const Key& key, uint32_t* size) const {
+    const Entry* entry = std::lower_bound(fEntries, fEntries + fEntryCount, key,
+                                          [](const Entry& e, const Key& k) {
+                                              return e.fKey < k;
+                                          });
+    if (entry != fEntries + fEntryCount && entry->fKey == key) {
+        *size = entry->fSize;
+        return fRecords + entry->fOffset;
+    }
+
+    // Added records are never removed, so they stay put while this lives.
+    SkAutoMutexAcquire lock(fMutex);
+    if (const sk_sp<SkData>* data = fAdded.find(key)) {
+        *size = SkToU32((*data)->size());
+        return (*data)->data();
+    }
+    return nullptr;
+}
+
+void SkGlyphFileCache::add(const Key& key, const void* data, size_t size) {
+    uint32_t foundSize;
+    if (size > UINT32_MAX || this->find(key, &foundSize) != nullptr) {
+        return;
+    }
+    SkAutoMutexAcquire lock(fMutex);
+    // Added records are never removed, so once we're full we just stop adding.
+    if (size > fAddedByteLimit - fAddedBytes) {
+        return;
+    }
+    if (fAdded.find(key) == nullptr) {
+        fAdded.set(key, SkData::MakeWithCopy(data, size));
+        fAddedBytes += size;
+    }
+}
+
+bool SkGlyphFileCache::findMetrics(int strikeID, SkGlyph* glyph) const {
+    uint32_t size;
+    auto metrics = static_cast<const Metrics*>(
+            this->find({SkToU32(strikeID), glyph->getPackedID().value(), kMetrics_Kind}, &size));
+    if (metrics == nullptr || size != sizeof(Metrics)
+        || metrics->fMaskFormat >= SkMask::kCountMaskFormats) {
+        return false;
+    }
+    glyph->fAdvanceX   = metrics->fAdvanceX;
+    glyph->fAdvanceY   = metrics->fAdvanceY;
+    glyph->fWidth      = metrics->fWidth;
+    glyph->fHeight     = metrics->fHeight;
+    glyph->fTop        = metrics->fTop;
+    glyph->fLeft       = metrics->fLeft;
+    glyph->fForceBW    = metrics->fForceBW;
+    glyph->fMaskFormat = metrics->fMaskFormat;
+    return true;
+}
+
+bool SkGlyphFileCache::findImage(int strikeID, const SkGlyph& glyph) const {
+    SkASSERT(glyph.fImage);
+    uint32_t size;
+    const void* image =
+            this->find({SkToU32(strikeID), glyph.getPackedID().value(), kImage_Kind}, &size);
+    if (image == nullptr || size != glyph.computeImageSize()) {
+        return false;
+    }
+    memcpy(glyph.fImage, image, size);
+    return true;
+}
+
+bool SkGlyphFileCache::findPath(int strikeID, SkPackedGlyphID id, SkPath* path,
+                                bool* hasPath) const {
+    uint32_t size;
+    const void* data = this->find({SkToU32(strikeID), id.value(), kPath_Kind}, &size);
+    if (data == nullptr) {
+        return false;
+    }
+    *hasPath = size > 0;
+    return !*hasPath || path->readFromMemory(data, size) == size;
+}
+
+void SkGlyphFileCache::addMetrics(int strikeID, const SkGlyph& glyph) {
+    SkASSERT(glyph.isFullMetrics());
+    Metrics metrics = {
+        glyph.fAdvanceX, glyph.fAdvanceY,
+        glyph.fWidth, glyph.fHeight,
+        glyph.fTop, glyph.fLeft,
+        glyph.fForceBW,
+        glyph.fMaskFormat,
+        0,
+    };
+    this->add({SkToU32(strikeID), glyph.getPackedID().value(), kMetrics_Kind},
+              &metrics, sizeof(metrics));
+}
+
+void SkGlyphFileCache::addImage(int strikeID, const SkGlyph& glyph) {
+    SkASSERT(glyph.fImage);
+    this->add({SkToU32(strikeID), glyph.getPackedID().value(), kImage_Kind},
+              glyph.fImage, glyph.computeImageSize());
+}
+
+void SkGlyphFileCache::addPath(int strikeID, SkPackedGlyphID id, const SkPath* path) {
+    Key key = {SkToU32(strikeID), id.value(), kPath_Kind};
+    if (path == nullptr) {
+        this->add(key, nullptr, 0);
+        return;
+    }
+    SkAutoMalloc data(path->writeToMemory(nullptr));
+    this->add(key, data.get(), path->writeToMemory(data.get()));
+}
+
+int SkGlyphFileCache::countAdded() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fAdded.count();
+}
+
+size_t SkGlyphFileCache::getAddedBytes() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fAddedBytes;
+}
+
+size_t SkGlyphFileCache::setAddedByteLimit(size_t limit) {
+    SkAutoMutexAcquire lock(fMutex);
+    size_t prevLimit = fAddedByteLimit;
+    fAddedByteLimit = SkTMax(limit, fAddedBytes);
+    return prevLimit;
+}
+
+sk_sp<SkData> SkGlyphFileCache::serialize() const {
+    SkAutoMutexAcquire lock(fMutex);
+
+    struct StrikeBytes {
+        uint32_t    fHash;
+        int         fID;
+        const void* fBytes;
+        size_t      fSize;
+    };
+    std::vector<StrikeBytes> strikes;
+    for (int i = 0; i < fStrikeCount; i++) {
+        strikes.push_back({fStrikes[i].fHash, i, fRecords + fStrikes[i].fOffset,
+                           fStrikes[i].fSize});
+    }
+    for (int i = 0; i < fAddedStrikes.count(); i++) {
+        const SkString& key = fAddedStrikes[i];
+        strikes.push_back({hash_of(key), fStrikeCount + i, key.c_str(), key.size()});
+    }
+    std::stable_sort(strikes.begin(), strikes.end(),
+                     [](const StrikeBytes& a, const StrikeBytes& b) { return a.fHash < b.fHash; });
+    std::vector<uint32_t> newIDs(strikes.size());
+    for (size_t i = 0; i < strikes.size(); i++) {
+        newIDs[strikes[i].fID] = SkToU32(i);
+    }
+
+    struct EntryBytes {
+        Key         fKey;
+        const void* fBytes;
+        size_t      fSize;
+    };
+    std::vector<EntryBytes> entries;
+    for (int i = 0; i < fEntryCount; i++) {
+        Key key = fEntries[i].fKey;
+        key.fStrike = newIDs[key.fStrike];
+        entries.push_back({key, fRecords + fEntries[i].fOffset, fEntries[i].fSize});
+    }
+    fAdded.foreach([&](const Key& added, const sk_sp<SkData>& data) {
+        Key key = added;
+        key.fStrike = newIDs[key.fStrike];
+        entries.push_back({key, data->data(), data->size()});
+    });
+    std::sort(entries.begin(), entries.end(),
+              [](const EntryBytes& a, const EntryBytes& b) { return a.fKey < b.fKey; });
+
+    size_t recordsSize = 0;
+    for (const StrikeBytes& strike : strikes) { recordsSize += align4(strike.fSize); }
+    for (const EntryBytes&  entry  : entries) { recordsSize += align4(entry.fSize);  }
+    size_t size = sizeof(Header) + strikes.size() * sizeof(Strike)
+                                 + entries.size() * sizeof(Entry) + recordsSize;
+    if (recordsSize > UINT32_MAX) {
+        return nullptr;
+    }
+
+    sk_sp<SkData> data = SkData::MakeUninitialized(size);
+    auto base = static_cast<uint8_t*>(data->writable_data());
+    sk_bzero(base, size);  // including the padding, so the same glyphs make the same file
+    auto header = reinterpret_cast<Header*>(base);
+    auto strikeTable = reinterpret_cast<Strike*>(base + sizeof(Header));
+    auto entryTable = reinterpret_cast<Entry*>(strikeTable + strikes.size());
+    auto records = reinterpret_cast<uint8_t*>(entryTable + entries.size());
+
+    uint32_t offset = 0;
+    auto write_record = [&](const void* bytes, size_t size) {
+        uint32_t at = offset;
+        if (size > 0) {
+            memcpy(records + at, bytes, size);
+        }
+        offset += align4(size);
+        return at;
+    };
+    for (size_t i = 0; i < strikes.size(); i++) {
+        strikeTable[i] = {strikes[i].fHash, write_record(strikes[i].fBytes, strikes[i].fSize),
+                          SkToU32(strikes[i].fSize)};
+    }
+    for (size_t i = 0; i < entries.size(); i++) {
+        entryTable[i] = {entries[i].fKey, write_record(entries[i].fBytes, entries[i].fSize),
+                         SkToU32(entries[i].fSize)};
+    }
+    SkASSERT(offset == recordsSize);
+
+    *header = {kMagic, kVersion, SK_MILESTONE, font_host_version(),
+               SkToU32(strikes.size()), SkToU32(entries.size()), SkToU32(recordsSize), SkOpts::hash(base + sizeof(Header), size - sizeof(Header))};
+    return data;
+}
+
+bool SkGlyphFileCache::writeToFile() const {
+    if (fPath.isEmpty()) {
+        return false;
+    }
+    sk_sp<SkData> data = this->serialize();
+    if (!data) {
+        return false;
+    }
+
+    // Every process and every write in it gets its own temporary file, so that concurrent
+    // writers never write into each other's, and whichever renames last wins.
+    static std::atomic<uint32_t> gWriteCount{0};
+    SkString temporary = SkStringPrintf("%s.%d.%u.tmp", fPath.c_str(), process_id(),
+                                        gWriteCount++);
+    {
+        SkFILEWStream stream(temporary.c_str());
+        if (!stream.isValid() || !stream.write(data->data(), data->size())) {
+            remove(temporary.c_str());
+            return false;
+        }
+    }
+    // Some platforms won't rename over an existing file.  We fail there rather than remove the
+    // file first, which would leave no file at all if another process's rename got in between.
+    if (rename(temporary.c_str(), fPath.c_str()) != 0) {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
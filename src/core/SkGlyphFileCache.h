@@ -0,0 +1,157 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGlyphFileCache_DEFINED
+#define SkGlyphFileCache_DEFINED
+
+#include "SkData.h"
+#include "SkGlyph.h"
+#include "SkMutex.h"
+#include "SkRefCnt.h"
+#include "SkString.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+
+class SkDescriptor;
+class SkPath;
+class SkTypeface;
+
+#if defined(SK_HAS_FREETYPE_LIBRARY)
+    // The version of FreeType that SkFontHost_FreeType.cpp rasterizes glyphs with, as 0xMMmmpp.
+    uint32_t SkFreeTypeVersion();
+#endif
+
+/**
+ *  Keeps glyph metrics, images and paths between processes, in a file that is mapped into memory
+ *  rather than parsed. Strikes are identified by their descriptor, less its process-specific
+ *  typeface ID, and by their typeface's font data, so that the same font at the same size, matrix,
+ *  etc. finds the same glyphs in the next process.
+ *
+ *  Glyphs the file doesn't have are generated as usual and added, to be written out along with
+ *  those it has by serialize() or writeToFile(). The file is checked when it is loaded, and if
+ *  anything is wrong with it, or it was written by another Skia milestone or FreeType version,
+ *  the cache starts out empty.
+ *
+ *  All methods are thread safe.
+ */
+class SkGlyphFileCache : public SkRefCnt {
+public:
+    /** Make a cache of the glyphs in data, as made by serialize(), or an empty one. */
+    static sk_sp<SkGlyphFileCache> Make(sk_sp<SkData> data = nullptr);
+
+    /** Map the glyphs in the file at path, which writeToFile() will write back to. */
+    static sk_sp<SkGlyphFileCache> MakeFromFile(const char path[]);
+
+    /**
+     *  Returns the ID other calls use for the strike with this descriptor and typeface, or -1 if
+     *  its glyphs can't be kept, e.g. because the typeface has no font data to identify it by.
+     */
+    int findOrAddStrike(const SkDescriptor&, const SkTypeface&);
+
+    /** Fill in the glyph's metrics, and return true, if the strike has them. */
+    bool findMetrics(int strikeID, SkGlyph*) const;
+
+    /** Fill in the glyph's already allocated image, and return true, if the strike has it. */
+    bool findImage(int strikeID, const SkGlyph&) const;
+
+    /**
+     *  If the strike has the glyph's path, set path to it, or hasPath to false if the glyph has
+     *  none, and return true.
+     */
+    bool findPath(int strikeID, SkPackedGlyphID, SkPath* path, bool* hasPath) const;
+
+    void addMetrics(int strikeID, const SkGlyph&);
+    void addImage(int strikeID, const SkGlyph&);
+    /** Add the glyph's path, or that it has none if path is null. */
+    void addPath(int strikeID, SkPackedGlyphID, const SkPath* path);
+
+    /** The number of metrics, images and paths loaded and added. */
+    int countLoaded() const { return fEntryCount; }
+    int countAdded() const;
+
+    /**
+     *  Added glyphs are copied to the heap until they're written out, and never purged, so we
+     *  stop adding them once they take up this many bytes (by default 2MB). Loaded glyphs don't
+     *  count, as they stay in the file. The limit can't be set below what's already added.
+     *  Returns the previous limit.
+     */
+    size_t getAddedBytes() const;
+    size_t setAddedByteLimit(size_t limit);
+
+    /** Return the loaded and added glyphs, in the form Make() reads. */
+    sk_sp<SkData> serialize() const;
+
+    /**
+     *  Write serialize() to the file this was made from, replacing it rather than overwriting it,
+     *  so that processes mapping the old file are unaffected. Returns false on failure, including
+     *  where the platform can't rename over an existing file, or if this wasn't made from a file.
+     */
+    bool writeToFile() const;
+
+private:
+    enum Kind : uint32_t {
+        kMetrics_Kind,
+        kImage_Kind,
+        kPath_Kind,
+    };
+
+    struct Key {
+        uint32_t fStrike;
+        uint32_t fGlyph;
+        uint32_t fKind;
+
+        bool operator==(const Key& that) const {
+            return fStrike == that.fStrike && fGlyph == that.fGlyph && fKind == that.fKind;
+        }
+        bool operator<(const Key& that) const {
+            if (fStrike != that.fStrike) { return fStrike < that.fStrike; }
+            if (fGlyph  != that.fGlyph ) { return fGlyph  < that.fGlyph;  }
+            return fKind < that.fKind;
+        }
+    };
+
+    // The file is a Header, then its Strikes sorted by hash, its Entries sorted by key, and the
+    // records they refer to, each 4-byte aligned.
+    struct Header;
+    struct Strike {
+        uint32_t fHash;
+        uint32_t fOffset;
+        uint32_t fSize;
+    };
+    struct Entry {
+        Key      fKey;
+        uint32_t fOffset;
+        uint32_t fSize;
+    };
+
+    SkGlyphFileCache(sk_sp<SkData>, SkString path);
+
+    bool validate() const;
+    const void* find(const Key&, uint32_t* size) const;
+    void add(const Key&, const void* data, size_t size);
+
+    // Loaded, immutable once made.
+    const sk_sp<SkData>    fData;
+    const SkString         fPath;
+    const Strike*          fStrikes{nullptr};
+    int                    fStrikeCount{0};
+    const Entry*           fEntries{nullptr};
+    int                    fEntryCount{0};
+    const uint8_t*         fRecords{nullptr};
+    size_t                 fRecordsSize{0};
+
+    // Added. Added strikes' IDs follow the loaded ones'.
+    mutable SkMutex                fMutex;
+    SkTHashMap<uint32_t, SkString> fTypefaceKeys;   // by typeface unique ID, empty if none
+    SkTHashMap<SkString, int>      fAddedStrikeIDs;
+    SkTArray<SkString>             fAddedStrikes;
+    SkTHashMap<Key, sk_sp<SkData>> fAdded;
+    size_t                         fAddedBytes{0};
+    size_t                         fAddedByteLimit;
+};
+
+#endif
@@ -23,6 +23,7 @@
 #include "SkDevice.h"
 #include "SkDistanceFieldGen.h"
 #include "SkDraw.h"
+#include "SkExecutor.h"
 #include "SkFontPriv.h"
 #include "SkMaskFilter.h"
 #include "SkPaintPriv.h"
@@ -35,6 +36,10 @@
 #include "SkTDArray.h"
 #include "SkTraceEvent.h"
 
+#include <algorithm>
+
+std::atomic<int> gSkGlyphRasterThreads{0};
+
 // -- SkGlyphCacheCommon ---------------------------------------------------------------------------
 
 SkVector SkStrikeCommon::PixelRounding(bool isSubpixel, SkAxisAlignment axisAlignment) {
@@ -228,17 +233,25 @@ void SkGlyphRunListPainter::drawForBitmapDevice(
             matrix.postTranslate(rounding.x(), rounding.y());
             matrix.mapPoints(fPositions, glyphRun.positions().data(), runSize);
 
+            // Find the metrics, and then the images, of the whole run, so that any glyphs the
+            // strike doesn't have yet are generated together.
+            int glyphCount = cache->glyphMetrics(
+                    glyphRun.glyphsIDs().data(), fPositions, runSize, fGlyphPos);
+            SkGlyphPos* glyphPos = fGlyphPos.get();
+            glyphCount = std::remove_if(glyphPos, glyphPos + glyphCount,
+                                        [](const SkGlyphPos& g) {
+                                            return !check_glyph_position(g.position);
+                                        }) - glyphPos;
+            int threads = gSkGlyphRasterThreads;
+            cache->prepareImages(SkSpan<const SkGlyphPos>{glyphPos, SkTo<size_t>(glyphCount)},
+                                 threads > 1 ? &SkExecutor::GetDefault() : nullptr, threads);
+
             SkTDArray<SkMask> masks;
-            masks.setReserve(runSize);
-            const SkPoint* positionCursor = fPositions;
-            for (auto glyphID : glyphRun.glyphsIDs()) {
-                auto position = *positionCursor++;
-                if (check_glyph_position(position)) {
-                    const SkGlyph& glyph = cache->getGlyphMetrics(glyphID, position);
-                    const void* image;
-                    if (!glyph.isEmpty() && (image = cache->findImage(glyph))) {
-                        masks.push_back(create_mask(glyph, position, image));
-                    }
+            masks.setReserve(glyphCount);
+            for (int i = 0; i < glyphCount; i++) {
+                const SkGlyph& glyph = *fGlyphPos[i].glyph;
+                if (const void* image = cache->findImage(glyph)) {
+                    masks.push_back(create_mask(glyph, fGlyphPos[i].position, image));
                 }
             }
             bitmapDevice->paintMasks(SkSpan<const SkMask>{masks.begin(), masks.size()}, runPaint);
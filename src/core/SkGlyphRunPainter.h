@@ -14,6 +14,8 @@
 #include "SkSurfaceProps.h"
 #include "SkTextBlobPriv.h"
 
+#include <atomic>
+
 #if SK_SUPPORT_GPU
 #include "text/GrTextContext.h"
 class GrColorSpaceInfo;
@@ -22,6 +24,10 @@ class GrRenderTargetContext;
 
 class SkGlyphRunPainterInterface;
 
+// If > 1, drawForBitmapDevice() generates the images a run is missing in up to this many parts
+// in parallel, on SkExecutor::GetDefault(). Shared strikes generate theirs on the drawing thread.
+extern std::atomic<int> gSkGlyphRasterThreads;
+
 class SkStrikeCommon {
 public:
     static SkVector PixelRounding(bool isSubpixel, SkAxisAlignment axisAlignment);
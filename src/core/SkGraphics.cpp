@@ -9,6 +9,8 @@
 
 #include "SkBlitter.h"
 #include "SkCanvas.h"
+#include "SkClipMaskCache.h"
+#include "SkCoreBlitters.h"
 #include "SkCpu.h"
 #include "SkGeometry.h"
 #include "SkImageFilter.h"
@@ -23,6 +25,7 @@
 #include "SkShader.h"
 #include "SkStream.h"
 #include "SkStrikeCache.h"
+#include "SkStrokeCache.h"
 #include "SkTSearch.h"
 #include "SkTime.h"
 #include "SkTypefaceCache.h"
@@ -58,9 +61,38 @@ void SkGraphics::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
 void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
+    SkGraphics::PurgeConstantColorBlitCache();
     SkImageFilter::PurgeCache();
 }
 
+int SkGraphics::GetConstantColorBlitCacheCountUsed() {
+    return SkConstantColorBlitCache::Global()->getCountUsed();
+}
+
+int SkGraphics::GetConstantColorBlitCacheCountLimit() {
+    return SkConstantColorBlitCache::Global()->getCountLimit();
+}
+
+int SkGraphics::SetConstantColorBlitCacheCountLimit(int count) {
+    return SkConstantColorBlitCache::Global()->setCountLimit(count);
+}
+
+void SkGraphics::GetConstantColorBlitCacheStats(int64_t* hits, int64_t* misses) {
+    SkConstantColorBlitCache::Global()->getStats(hits, misses);
+}
+
+void SkGraphics::PurgeConstantColorBlitCache() {
+    SkConstantColorBlitCache::Global()->purgeAll();
+}
+
+void SkGraphics::GetStrokeCacheStats(int64_t* hits, int64_t* misses) {
+    SkStrokeCache::GetStats(hits, misses);
+}
+
+void SkGraphics::GetClipMaskCacheStats(int64_t* hits, int64_t* misses) {
+    SkClipMaskCache::GetStats(hits, misses);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const char kFontCacheLimitStr[] = "font-cache-limit";
@@ -145,3 +177,25 @@ void SkGraphics::PurgeFontCache() {
     SkStrikeCache::GlobalStrikeCache()->purgeAll();
     SkTypefaceCache::PurgeAll();
 }
+
+void SkGraphics::SetFontCacheFile(const char path[]) {
+    SkStrikeCache::GlobalStrikeCache()->setFileCache(
+            path ? SkGlyphFileCache::MakeFromFile(path) : nullptr);
+}
+
+bool SkGraphics::WriteFontCacheFile() {
+    sk_sp<SkGlyphFileCache> fileCache = SkStrikeCache::GlobalStrikeCache()->refFileCache();
+    return fileCache && fileCache->writeToFile();
+}
+
+void SkGraphics::StartRecordingFontCacheManifest() {
+    SkStrikeCache::GlobalStrikeCache()->startRecordingManifest();
+}
+
+sk_sp<SkData> SkGraphics::StopRecordingFontCacheManifest() {
+    return SkStrikeCache::GlobalStrikeCache()->stopRecordingManifest();
+}
+
+bool SkGraphics::PrewarmFontCache(const void* data, size_t length) {
+    return SkStrikeManifest::Prewarm(data, length, SkStrikeCache::GlobalStrikeCache()) >= 0;
+}
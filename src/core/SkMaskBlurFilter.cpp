@@ -12,6 +12,7 @@
 #include "SkGaussFilter.h"
 #include "SkMalloc.h"
 #include "SkNx.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTo.h"
 
@@ -949,6 +950,31 @@ static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMa
     return {radiusX, radiusY};
 }
 
+// Every row of a blur pass is independent of the others, so big masks blur chunks of about this
+// many pixels in parallel.  Each chunk needs its own scan buffer.
+static constexpr int kBlurChunkPixels = 1 << 14;
+
+// Each pass writes its rows transposed, row y into byte column y of the output.  Chunks are
+// whole blocks of this many rows, so each task writes a cache line's worth of every output row,
+// and neighbouring tasks share at most the one line at the edge of their blocks.
+static constexpr int kBlurBlockRows = 64;
+
+static void blur_rows(int rows, int rowWidth, size_t bufferSize, SkArenaAlloc* alloc,
+                      const std::function<void(int start, int end, uint32_t* buffer)>& fn) {
+    if ((int64_t)rows * rowWidth < 2 * kBlurChunkPixels) {
+        fn(0, rows, alloc->makeArrayDefault<uint32_t>(bufferSize));
+        return;
+    }
+    int blocks = (rows + kBlurBlockRows - 1) / kBlurBlockRows,
+        grain  = SkTMax(1, kBlurChunkPixels / (kBlurBlockRows * rowWidth));
+    SkTaskGroup().forkJoin(blocks, grain, [&](int startBlock, int endBlock) {
+        SkAutoTMalloc<uint32_t> chunkBuffer(bufferSize);
+        fn(startBlock * kBlurBlockRows,
+           SkTMin(rows, endBlock * kBlurBlockRows),
+           chunkBuffer.get());
+    });
+}
+
 // TODO: assuming sigmaW = sigmaH. Allow different sigmas. Right now the
 // API forces the sigmas to be the same.
 SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
@@ -982,9 +1008,6 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
         dstH = dst->fBounds.height();
     SkASSERT(srcW >= 0 && srcH >= 0 && dstW >= 0 && dstH >= 0);
 
-    auto bufferSize = std::max(planW.bufferSize(), planH.bufferSize());
-    auto buffer = alloc.makeArrayDefault<uint32_t>(bufferSize);
-
     // Blur both directions.
     int tmpW = srcH,
         tmpH = dstW;
@@ -992,58 +1015,67 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMask* dst) const {
     auto tmp = alloc.makeArrayDefault<uint8_t>(tmpW * tmpH);
 
     // Blur horizontally, and transpose.
-    const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffer);
-    switch (src.fFormat) {
-        case SkMask::kBW_Format: {
-            const uint8_t* bwStart = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
-            auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kA8_Format: {
-            const uint8_t* a8Start = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
-            auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kARGB32_Format: {
-            const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
-            auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kLCD16_Format: {
-            const uint16_t* lcdStart = reinterpret_cast<const uint16_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
-            auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        default:
-            SK_ABORT("Unhandled format.");
-    }
+    blur_rows(srcH, srcW, planW.bufferSize(), &alloc, [&](int startY, int endY, uint32_t* scratch) {
+        const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, scratch);
+        const uint8_t* row = src.fImage + startY * src.fRowBytes;
+        switch (src.fFormat) {
+            case SkMask::kBW_Format: {
+                const uint8_t* bwStart = row;
+                auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
+                auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
+                for (int y = startY; y < endY;
+                     ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            case SkMask::kA8_Format: {
+                const uint8_t* a8Start = row;
+                auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
+                auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
+                for (int y = startY; y < endY;
+                     ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            case SkMask::kARGB32_Format: {
+                const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(row);
+                auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
+                auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
+                for (int y = startY; y < endY;
+                     ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            case SkMask::kLCD16_Format: {
+                const uint16_t* lcdStart = reinterpret_cast<const uint16_t*>(row);
+                auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
+                auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
+                for (int y = startY; y < endY;
+                     ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            default:
+                SK_ABORT("Unhandled format.");
+        }
+    });
 
     // Blur vertically (scan in memory order because of the transposition),
     // and transpose back to the original orientation.
-    const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
-    for (int y = 0; y < tmpH; y++) {
-        auto tmpStart = &tmp[y * tmpW];
-        auto dstStart = &dst->fImage[y];
-
-        scanH.blur(tmpStart, tmpStart + tmpW,
-                   dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
-    }
+    blur_rows(tmpH, tmpW, planH.bufferSize(), &alloc, [&](int startY, int endY, uint32_t* scratch) {
+        const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, scratch);
+        for (int y = startY; y < endY; y++) {
+            auto tmpStart = &tmp[y * tmpW];
+            auto dstStart = &dst->fImage[y];
+
+            scanH.blur(tmpStart, tmpStart + tmpW,
+                       dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
+        }
+    });
 
     return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
 }
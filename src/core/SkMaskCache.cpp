@@ -183,3 +183,91 @@ void SkMaskCache::Add(SkScalar sigma, SkBlurStyle style,
     RectsBlurKey key(sigma, style, rects, count);
     return CHECK_LOCAL(localCache, add, Add, new RectsBlurRec(key, mask, data));
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+static unsigned gPathMaskKeyNamespaceLabel;
+
+struct PathMaskKey : public SkResourceCache::Key {
+public:
+    PathMaskKey(const SkPath& path, const SkMatrix& matrix, const SkIRect& clipBounds)
+        : fGenID(path.getGenerationID())
+        , fFillType(path.getFillType())
+        , fClipBounds(clipBounds)
+    {
+        SkASSERT(!matrix.hasPerspective());
+        fMatrix[0] = matrix.getScaleX();
+        fMatrix[1] = matrix.getSkewX();
+        fMatrix[2] = matrix.getTranslateX();
+        fMatrix[3] = matrix.getSkewY();
+        fMatrix[4] = matrix.getScaleY();
+        fMatrix[5] = matrix.getTranslateY();
+        this->init(&gPathMaskKeyNamespaceLabel, SkMakeResourceCacheSharedIDForPath(fGenID),
+                   sizeof(fGenID) + sizeof(fFillType) + sizeof(fClipBounds) + sizeof(fMatrix));
+    }
+
+    uint32_t    fGenID;
+    int32_t     fFillType;
+    SkIRect     fClipBounds;
+    SkScalar    fMatrix[6];
+};
+
+struct PathMaskRec : public SkResourceCache::Rec {
+    PathMaskRec(const PathMaskKey& key, SkCachedData* data,
+                sk_sp<SkPathRef::GenIDChangeListener> invalidator)
+        : fKey(key)
+        , fData(data)
+        , fInvalidator(std::move(invalidator))
+    {
+        fData->attachToCacheAndRef();
+    }
+    ~PathMaskRec() override {
+        fData->detachFromCacheAndUnref();
+        // Once we're gone, the path can drop our listener.
+        fInvalidator->markShouldUnregisterFromPath();
+    }
+
+    PathMaskKey                             fKey;
+    SkCachedData*                           fData;
+    sk_sp<SkPathRef::GenIDChangeListener>   fInvalidator;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fData->size(); }
+    const char* getCategory() const override { return "path-mask"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PathMaskRec& rec = static_cast<const PathMaskRec&>(baseRec);
+        SkCachedData** result = static_cast<SkCachedData**>(contextData);
+
+        SkCachedData* tmpData = rec.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *result = tmpData;
+        return true;
+    }
+};
+} // namespace
+
+SkCachedData* SkMaskCache::FindAndRef(const SkPath& path, const SkMatrix& matrix,
+                                      const SkIRect& clipBounds, SkResourceCache* localCache) {
+    SkCachedData* result;
+    PathMaskKey key(path, matrix, clipBounds);
+    if (!CHECK_LOCAL(localCache, find, Find, key, PathMaskRec::Visitor, &result)) {
+        return nullptr;
+    }
+    return result;
+}
+
+void SkMaskCache::Add(const SkPath& path, const SkMatrix& matrix, const SkIRect& clipBounds,
+                      SkCachedData* data, SkResourceCache* localCache) {
+    PathMaskKey key(path, matrix, clipBounds);
+    auto invalidator = SkPurgeResourceCacheOnPathChange(path);
+    return CHECK_LOCAL(localCache, add, Add, new PathMaskRec(key, data, std::move(invalidator)));
+}
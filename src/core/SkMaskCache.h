@@ -11,6 +11,8 @@
 #include "SkBlurTypes.h"
 #include "SkCachedData.h"
 #include "SkMask.h"
+#include "SkMatrix.h"
+#include "SkPath.h"
 #include "SkRect.h"
 #include "SkResourceCache.h"
 #include "SkRRect.h"
@@ -39,6 +41,18 @@ public:
     static void Add(SkScalar sigma, SkBlurStyle style,
                     const SkRect rects[], int count, const SkMask& mask, SkCachedData* data,
                     SkResourceCache* localCache = nullptr);
+
+    /**
+     * The anti-aliased fill of a (non-volatile) path through a matrix, scan converted against a
+     * clip with the given bounds, as a flattened SkScanRecording.  Keyed by the path's generation
+     * ID and fill type, the matrix and the clip bounds.  Entries are purged when the path's
+     * generation ID changes.
+     */
+    static SkCachedData* FindAndRef(const SkPath& path, const SkMatrix& matrix,
+                                    const SkIRect& clipBounds,
+                                    SkResourceCache* localCache = nullptr);
+    static void Add(const SkPath& path, const SkMatrix& matrix, const SkIRect& clipBounds,
+                    SkCachedData* data, SkResourceCache* localCache = nullptr);
 };
 
 #endif
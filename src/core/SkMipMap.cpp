@@ -13,6 +13,7 @@
 #include "SkImageInfoPriv.h"
 #include "SkMathPriv.h"
 #include "SkNx.h"
+#include "SkTaskGroup.h"
 #include "SkTo.h"
 #include "SkTypes.h"
 #include <new>
@@ -311,17 +312,12 @@ size_t SkMipMap::AllocLevelsSize(int levelCount, size_t pixelSize) {
     return SkTo<int32_t>(size);
 }
 
-SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
-    typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
+// Levels with at least twice this many pixels are downsampled in chunks of about this many
+// pixels, in parallel.
+static constexpr int kMipChunkPixels = 1 << 15;
 
-    FilterProc* proc_1_2 = nullptr;
-    FilterProc* proc_1_3 = nullptr;
-    FilterProc* proc_2_1 = nullptr;
-    FilterProc* proc_2_2 = nullptr;
-    FilterProc* proc_2_3 = nullptr;
-    FilterProc* proc_3_1 = nullptr;
-    FilterProc* proc_3_2 = nullptr;
-    FilterProc* proc_3_3 = nullptr;
+SkMipMap* SkMipMap::Allocate(const SkPixmap& src, SkDiscardableFactoryProc fact) {
+    FilterProcs procs;
 
     const SkColorType ct = src.colorType();
     const SkAlphaType at = src.alphaType();
@@ -329,56 +325,56 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
     switch (ct) {
         case kRGBA_8888_SkColorType:
         case kBGRA_8888_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
+            procs.f_1_2 = downsample_1_2<ColorTypeFilter_8888>;
+            procs.f_1_3 = downsample_1_3<ColorTypeFilter_8888>;
+            procs.f_2_1 = downsample_2_1<ColorTypeFilter_8888>;
+            procs.f_2_2 = downsample_2_2<ColorTypeFilter_8888>;
+            procs.f_2_3 = downsample_2_3<ColorTypeFilter_8888>;
+            procs.f_3_1 = downsample_3_1<ColorTypeFilter_8888>;
+            procs.f_3_2 = downsample_3_2<ColorTypeFilter_8888>;
+            procs.f_3_3 = downsample_3_3<ColorTypeFilter_8888>;
             break;
         case kRGB_565_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_565>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_565>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_565>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_565>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_565>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_565>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_565>;
+            procs.f_1_2 = downsample_1_2<ColorTypeFilter_565>;
+            procs.f_1_3 = downsample_1_3<ColorTypeFilter_565>;
+            procs.f_2_1 = downsample_2_1<ColorTypeFilter_565>;
+            procs.f_2_2 = downsample_2_2<ColorTypeFilter_565>;
+            procs.f_2_3 = downsample_2_3<ColorTypeFilter_565>;
+            procs.f_3_1 = downsample_3_1<ColorTypeFilter_565>;
+            procs.f_3_2 = downsample_3_2<ColorTypeFilter_565>;
+            procs.f_3_3 = downsample_3_3<ColorTypeFilter_565>;
             break;
         case kARGB_4444_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_4444>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_4444>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_4444>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_4444>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_4444>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_4444>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_4444>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_4444>;
+            procs.f_1_2 = downsample_1_2<ColorTypeFilter_4444>;
+            procs.f_1_3 = downsample_1_3<ColorTypeFilter_4444>;
+            procs.f_2_1 = downsample_2_1<ColorTypeFilter_4444>;
+            procs.f_2_2 = downsample_2_2<ColorTypeFilter_4444>;
+            procs.f_2_3 = downsample_2_3<ColorTypeFilter_4444>;
+            procs.f_3_1 = downsample_3_1<ColorTypeFilter_4444>;
+            procs.f_3_2 = downsample_3_2<ColorTypeFilter_4444>;
+            procs.f_3_3 = downsample_3_3<ColorTypeFilter_4444>;
             break;
         case kAlpha_8_SkColorType:
         case kGray_8_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8>;
+            procs.f_1_2 = downsample_1_2<ColorTypeFilter_8>;
+            procs.f_1_3 = downsample_1_3<ColorTypeFilter_8>;
+            procs.f_2_1 = downsample_2_1<ColorTypeFilter_8>;
+            procs.f_2_2 = downsample_2_2<ColorTypeFilter_8>;
+            procs.f_2_3 = downsample_2_3<ColorTypeFilter_8>;
+            procs.f_3_1 = downsample_3_1<ColorTypeFilter_8>;
+            procs.f_3_2 = downsample_3_2<ColorTypeFilter_8>;
+            procs.f_3_3 = downsample_3_3<ColorTypeFilter_8>;
             break;
         case kRGBA_F16Norm_SkColorType:
         case kRGBA_F16_SkColorType:
-            proc_1_2 = downsample_1_2<ColorTypeFilter_F16>;
-            proc_1_3 = downsample_1_3<ColorTypeFilter_F16>;
-            proc_2_1 = downsample_2_1<ColorTypeFilter_F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_F16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_F16>;
-            proc_3_1 = downsample_3_1<ColorTypeFilter_F16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_F16>;
+            procs.f_1_2 = downsample_1_2<ColorTypeFilter_F16>;
+            procs.f_1_3 = downsample_1_3<ColorTypeFilter_F16>;
+            procs.f_2_1 = downsample_2_1<ColorTypeFilter_F16>;
+            procs.f_2_2 = downsample_2_2<ColorTypeFilter_F16>;
+            procs.f_2_3 = downsample_2_3<ColorTypeFilter_F16>;
+            procs.f_3_1 = downsample_3_1<ColorTypeFilter_F16>;
+            procs.f_3_2 = downsample_3_2<ColorTypeFilter_F16>;
+            procs.f_3_3 = downsample_3_3<ColorTypeFilter_F16>;
             break;
         default:
             return nullptr;
@@ -417,79 +413,111 @@ SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
     mipmap->fLevels = (Level*)mipmap->writable_data();
     SkASSERT(mipmap->fLevels);
 
-    Level* levels = mipmap->fLevels;
+    mipmap->fProcs = procs;
+
+    // Lay out every level now; buildLevels() fills in their pixels.
+    Level*      levels = mipmap->fLevels;
     uint8_t*    baseAddr = (uint8_t*)&levels[countLevels];
     uint8_t*    addr = baseAddr;
-    int         width = src.width();
-    int         height = src.height();
-    uint32_t    rowBytes;
-    SkPixmap    srcPM(src);
 
     // Depending on architecture and other factors, the pixel data alignment may need to be as
     // large as 8 (for F16 pixels). See the comment on SkMipMap::Level.
     SkASSERT(SkIsAlign8((uintptr_t)addr));
 
     for (int i = 0; i < countLevels; ++i) {
+        SkISize mipSize = ComputeLevelSize(src.width(), src.height(), i);
+        uint32_t rowBytes = SkToU32(SkColorTypeMinRowBytes(ct, mipSize.fWidth));
+
+        // We make the Info w/o any colorspace, since that storage is not under our control, and
+        // will not be deleted in a controlled fashion. When the caller is given the pixmap for
+        // a given level, we augment this pixmap with fCS (which we do manage).
+        SkImageInfo info = SkImageInfo::Make(mipSize.fWidth, mipSize.fHeight, ct, at);
+        new (&levels[i].fPixmap) SkPixmap(info, addr, rowBytes);
+        levels[i].fScale  = SkSize::Make(SkIntToScalar(mipSize.fWidth)  / src.width(),
+                                         SkIntToScalar(mipSize.fHeight) / src.height());
+        addr += mipSize.fHeight * rowBytes;
+    }
+    SkASSERT(addr == baseAddr + size);
+
+    return mipmap;
+}
+
+void SkMipMap::buildLevels(const SkPixmap& src, SkExecutor* executor) {
+    SkASSERT(fLevels);
+
+    for (int i = 0; i < fCount; ++i) {
+        const SkPixmap& srcPM = i > 0 ? fLevels[i - 1].fPixmap : src;
+        const SkPixmap& dstPM = fLevels[i].fPixmap;
+
+        // Pick a proc from the source footprint of each destination pixel.
+        int width = srcPM.width(),
+            height = srcPM.height();
         FilterProc* proc;
         if (height & 1) {
             if (height == 1) {        // src-height is 1
                 if (width & 1) {      // src-width is 3
-                    proc = proc_3_1;
+                    proc = fProcs.f_3_1;
                 } else {              // src-width is 2
-                    proc = proc_2_1;
+                    proc = fProcs.f_2_1;
                 }
             } else {                  // src-height is 3
                 if (width & 1) {
                     if (width == 1) { // src-width is 1
-                        proc = proc_1_3;
+                        proc = fProcs.f_1_3;
                     } else {          // src-width is 3
-                        proc = proc_3_3;
+                        proc = fProcs.f_3_3;
                     }
                 } else {              // src-width is 2
-                    proc = proc_2_3;
+                    proc = fProcs.f_2_3;
                 }
             }
         } else {                      // src-height is 2
             if (width & 1) {
                 if (width == 1) {     // src-width is 1
-                    proc = proc_1_2;
+                    proc = fProcs.f_1_2;
                 } else {              // src-width is 3
-                    proc = proc_3_2;
+                    proc = fProcs.f_3_2;
                 }
             } else {                  // src-width is 2
-                proc = proc_2_2;
+                proc = fProcs.f_2_2;
             }
         }
-        width = SkTMax(1, width >> 1);
-        height = SkTMax(1, height >> 1);
-        rowBytes = SkToU32(SkColorTypeMinRowBytes(ct, width));
-
-        // We make the Info w/o any colorspace, since that storage is not under our control, and
-        // will not be deleted in a controlled fashion. When the caller is given the pixmap for
-        // a given level, we augment this pixmap with fCS (which we do manage).
-        new (&levels[i].fPixmap) SkPixmap(SkImageInfo::Make(width, height, ct, at), addr, rowBytes);
-        levels[i].fScale  = SkSize::Make(SkIntToScalar(width)  / src.width(),
-                                         SkIntToScalar(height) / src.height());
-
-        const SkPixmap& dstPM = levels[i].fPixmap;
-        const void* srcBasePtr = srcPM.addr();
-        void* dstBasePtr = dstPM.writable_addr();
+        width = dstPM.width();
+        height = dstPM.height();
 
         const size_t srcRB = srcPM.rowBytes();
-        for (int y = 0; y < height; y++) {
-            proc(dstBasePtr, srcBasePtr, srcRB, width);
-            srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-            dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
+        auto downsample_rows = [&](int startY, int endY) {
+            const void* srcBasePtr = (const char*)srcPM.addr() + startY * srcRB * 2;
+            void* dstBasePtr = (char*)dstPM.writable_addr() + startY * dstPM.rowBytes();
+            for (int y = startY; y < endY; y++) {
+                proc(dstBasePtr, srcBasePtr, srcRB, width);
+                srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
+                dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
+            }
+        };
+        // Rows of a level only depend on the level above, so big levels are split across threads.
+        if (executor && (int64_t)width * height >= 2 * kMipChunkPixels) {
+            SkTaskGroup(*executor).forkJoin(height, SkTMax(1, kMipChunkPixels / width),
+                                            downsample_rows);
+        } else {
+            downsample_rows(0, height);
         }
-        srcPM = dstPM;
-        addr += height * rowBytes;
     }
-    SkASSERT(addr == baseAddr + size);
+}
 
-    SkASSERT(mipmap->fLevels);
+SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
+                          SkExecutor* executor) {
+    SkMipMap* mipmap = Allocate(src, fact);
+    if (mipmap) {
+        mipmap->buildLevels(src, executor);
+    }
     return mipmap;
 }
 
+SkMipMap* SkMipMap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact) {
+    return Build(src, fact, &SkExecutor::GetDefault());
+}
+
 int SkMipMap::ComputeLevelCount(int baseWidth, int baseHeight) {
     if (baseWidth < 1 || baseHeight < 1) {
         return 0;
@@ -595,12 +623,17 @@ bool SkMipMap::extractLevel(const SkSize& scaleSize, Level* levelPtr) const {
 
 // Helper which extracts a pixmap from the src bitmap
 //
-SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
+SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact,
+                          SkExecutor* executor) {
     SkPixmap srcPixmap;
     if (!src.peekPixels(&srcPixmap)) {
         return nullptr;
     }
-    return Build(srcPixmap, fact);
+    return Build(srcPixmap, fact, executor);
+}
+
+SkMipMap* SkMipMap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
+    return Build(src, fact, &SkExecutor::GetDefault());
 }
 
 int SkMipMap::countLevels() const {
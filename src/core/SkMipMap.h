@@ -17,6 +17,7 @@
 
 class SkBitmap;
 class SkDiscardableMemory;
+class SkExecutor;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
 
@@ -32,6 +33,11 @@ public:
     static SkMipMap* Build(const SkPixmap& src, SkDiscardableFactoryProc);
     static SkMipMap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
 
+    // Big levels are downsampled in parallel on executor.  The overloads above use
+    // SkExecutor::GetDefault(); pass nullptr to build every level on the calling thread only.
+    static SkMipMap* Build(const SkPixmap& src, SkDiscardableFactoryProc, SkExecutor* executor);
+    static SkMipMap* Build(const SkBitmap& src, SkDiscardableFactoryProc, SkExecutor* executor);
+
     // Determines how many levels a SkMipMap will have without creating that mipmap.
     // This does not include the base mipmap level that the user provided when
     // creating the SkMipMap.
@@ -67,15 +73,36 @@ protected:
     }
 
 private:
+    typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
+
+    // Downsample procs, named by the size of the source footprint for each destination pixel.
+    struct FilterProcs {
+        FilterProc* f_1_2;
+        FilterProc* f_1_3;
+        FilterProc* f_2_1;
+        FilterProc* f_2_2;
+        FilterProc* f_2_3;
+        FilterProc* f_3_1;
+        FilterProc* f_3_2;
+        FilterProc* f_3_3;
+    };
+
     sk_sp<SkColorSpace> fCS;
     Level*              fLevels;    // managed by the baseclass, may be null due to onDataChanged.
     int                 fCount;
 
+    FilterProcs         fProcs;
+
     SkMipMap(void* malloc, size_t size) : INHERITED(malloc, size) {}
     SkMipMap(size_t size, SkDiscardableMemory* dm) : INHERITED(size, dm) {}
 
+    static SkMipMap* Allocate(const SkPixmap& src, SkDiscardableFactoryProc);
     static size_t AllocLevelsSize(int levelCount, size_t pixelSize);
 
+    // Generate every level, each from the one before it.  src is the base level.
+    // Big levels are split across executor's threads, or built serially if it's null.
+    void buildLevels(const SkPixmap& src, SkExecutor* executor);
+
     typedef SkCachedData INHERITED;
 };
 
@@ -40,6 +40,7 @@
 #include "SkBlitMask_opts.h"
 #include "SkBlitRow_opts.h"
 #include "SkChecksum_opts.h"
+#include "SkMatrix_opts.h"
 #include "SkRasterPipeline_opts.h"
 #include "SkSwizzler_opts.h"
 #include "SkUtils_opts.h"
@@ -54,6 +55,10 @@ namespace SkOpts {
     DEFINE_DEFAULT(create_xfermode);
 
     DEFINE_DEFAULT(blit_mask_d32_a8);
+    DEFINE_DEFAULT(blit_mask_f16_a8);
+    DEFINE_DEFAULT(blit_mask_f16_lcd16);
+    DEFINE_DEFAULT(blit_mask_1010102_a8);
+    DEFINE_DEFAULT(blit_mask_1010102_lcd16);
 
     DEFINE_DEFAULT(blit_row_s32a_opaque);
 
@@ -75,6 +80,12 @@ namespace SkOpts {
     DEFINE_DEFAULT(hash_fn);
 
     DEFINE_DEFAULT(S32_alpha_D32_filter_DX);
+
+    DEFINE_DEFAULT(map_trans_pts);
+    DEFINE_DEFAULT(map_scale_pts);
+    DEFINE_DEFAULT(map_affine_pts);
+    DEFINE_DEFAULT(map_persp_pts);
+    DEFINE_DEFAULT(map_homogeneous_pts);
 #undef DEFINE_DEFAULT
 
 #define M(st) (StageFn)SK_OPTS_NS::st,
@@ -12,7 +12,10 @@
 #include "SkTypes.h"
 #include "SkXfermodePriv.h"
 
+class SkMatrix;
 struct SkBitmapProcState;
+struct SkPoint;
+struct SkPoint3;
 
 namespace SkOpts {
     // Call to replace pointers to portable functions with pointers to CPU-specific functions.
@@ -26,6 +29,18 @@ namespace SkOpts {
     extern SkXfermode* (*create_xfermode)(SkBlendMode);
 
     extern void (*blit_mask_d32_a8)(SkPMColor*, size_t, const SkAlpha*, size_t, SkColor, int, int);
+
+    // Blend a color, premultiplied and in the dst's color space, into F16 or 1010102 pixels
+    // through an A8 or LCD16 mask with SrcOver.
+    extern void (*blit_mask_f16_a8)       (uint64_t*, size_t, const SkAlpha*,  size_t,
+                                           const SkColor4f&, int, int);
+    extern void (*blit_mask_f16_lcd16)    (uint64_t*, size_t, const uint16_t*, size_t,
+                                           const SkColor4f&, int, int);
+    extern void (*blit_mask_1010102_a8)   (uint32_t*, size_t, const SkAlpha*,  size_t,
+                                           const SkColor4f&, int, int);
+    extern void (*blit_mask_1010102_lcd16)(uint32_t*, size_t, const uint16_t*, size_t,
+                                           const SkColor4f&, int, int);
+
     extern void (*blit_row_s32a_opaque)(SkPMColor*, const SkPMColor*, int, U8CPU);
 
     // Swizzle input into some sort of 8888 pixel, {premul,unpremul} x {rgba,bgra}.
@@ -58,6 +73,15 @@ namespace SkOpts {
     extern void (*S32_alpha_D32_filter_DX)(const SkBitmapProcState&,
                                            const uint32_t* xy, int count, SkPMColor*);
 
+    // SkMatrix::mapPoints() for each kind of matrix, and SkMatrix::mapHomogeneousPoints().
+    typedef void (*MapPts)(const SkMatrix&, SkPoint dst[], const SkPoint src[], int count);
+    extern MapPts map_trans_pts,
+                  map_scale_pts,
+                  map_affine_pts,
+                  map_persp_pts;
+    extern void (*map_homogeneous_pts)(const SkMatrix&, SkPoint3 dst[], const SkPoint3 src[],
+                                       int count);
+
 #define M(st) +1
     // We can't necessarily express the type of SkJumper stage functions here,
     // so we just use this void(*)(void) as a stand-in.
@@ -28,6 +28,7 @@
 #include "SkShaderBase.h"
 #include "SkStringUtils.h"
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
 #include "SkStrokeRec.h"
 #include "SkSurfacePriv.h"
 #include "SkTLazy.h"
@@ -459,7 +460,12 @@ bool SkPaint::getFillPath(const SkPath& src, SkPath* dst, const SkRect* cullRect
         srcPtr = &tmpPath;
     }
 
-    if (!rec.applyToPath(dst, *srcPtr)) {
+    // We can only cache outlines stroked from the caller's own path, and only if the stroke
+    // doesn't write over it.
+    bool stroked = gSkCacheStrokedPaths && srcPtr == &src && dst != &src
+                 ? SkStrokeCache::ApplyToPath(rec, src, dst)
+                 : rec.applyToPath(dst, *srcPtr);
+    if (!stroked) {
         if (srcPtr == &tmpPath) {
             // If path's were copy-on-write, this trick would not be needed.
             // As it is, we want to save making a deep-copy from tmpPath -> dst
@@ -3830,6 +3830,48 @@ void SkPathPriv::CreateDrawArcPath(SkPath* path, const SkRect& oval, SkScalar st
     path->setFirstDirection(firstDir);
 }
 
+void SkPathPriv::AppendVerbs(SkPath* path, const uint8_t verbs[], int verbCount,
+                             const SkPoint pts[], const SkScalar conicWeights[]) {
+    if (verbCount == 0) {
+        return;
+    }
+    int ptCount = 0;
+    for (int i = 0; i < verbCount; ++i) {
+        ptCount += pts_in_verb(verbs[i]);
+    }
+
+    SkPathRef::Editor ed(&path->fPathRef, verbCount, ptCount);
+    for (int i = 0; i < verbCount;) {
+        unsigned verb = verbs[i];
+        if (SkPath::kClose_Verb == verb) {
+            path->fLastMoveToIndex ^=
+                    ~path->fLastMoveToIndex >> (8 * sizeof(path->fLastMoveToIndex) - 1);
+            ed.growForVerb(verb);
+            ++i;
+            continue;
+        }
+        // Add each run of the same verb in one go, as most of a stroke is long runs of lines.
+        int run = 1;
+        while (i + run < verbCount && verbs[i + run] == verb) {
+            ++run;
+        }
+        int n = run * pts_in_verb(verb);
+        if (SkPath::kMove_Verb == verb) {
+            path->fLastMoveToIndex = path->fPathRef->countPoints() + run - 1;
+        }
+        SkScalar* weights = nullptr;
+        memcpy(ed.growForRepeatedVerb(verb, run, &weights), pts, n * sizeof(SkPoint));
+        if (SkPath::kConic_Verb == verb) {
+            memcpy(weights, conicWeights, run * sizeof(SkScalar));
+            conicWeights += run;
+        }
+        pts += n;
+        i += run;
+    }
+    path->setConvexity(SkPath::kUnknown_Convexity);
+    path->setFirstDirection(SkPathPriv::kUnknown_FirstDirection);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 #include "SkNx.h"
 
@@ -120,6 +120,14 @@ public:
      */
     static bool DrawArcIsConvex(SkScalar sweepAngle, bool useCenter, bool isFillNoPathEffect);
 
+    /**
+     * Appends verbs, with their points and conic weights, to the path in a single edit, as if
+     * each had been added with its own SkPath call (moveTo(), lineTo(), ..., close()). The verbs
+     * must already be as SkPath would store them, e.g. with a move starting every contour.
+     */
+    static void AppendVerbs(SkPath* path, const uint8_t verbs[], int verbCount,
+                            const SkPoint pts[], const SkScalar conicWeights[]);
+
     /**
      * Returns a C++11-iterable object that traverses a path's verbs in order. e.g:
      *
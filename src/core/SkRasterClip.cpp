@@ -6,9 +6,14 @@
  */
 
 #include "SkRasterClip.h"
+#include "SkClipMaskCache.h"
+#include "SkMakeUnique.h"
 #include "SkPath.h"
+#include "SkRRect.h"
 #include "SkRegionPriv.h"
 
+std::atomic<bool> gSkAnalyticRasterClips{false};
+
 enum MutateResult {
     kDoNothing_MutateResult,
     kReplaceClippedAgainstGlobalBounds_MutateResult,
@@ -133,18 +138,49 @@ SkRasterClip::SkRasterClip(const SkRasterClip& src) {
         fBW = src.fBW;
     } else {
         fAA = src.fAA;
+        if (src.isAnalytic()) {
+            fAnalytic = skstd::make_unique<SkAnalyticClip>(*src.fAnalytic);
+        }
     }
 
     fIsEmpty = src.isEmpty();
     fIsRect = src.isRect();
+    fAllowAnalytic = src.fAllowAnalytic;
+    fCachePaths = src.fCachePaths;
     fClipRestrictionRect = src.fClipRestrictionRect;
     SkDEBUGCODE(this->validate();)
 }
 
+SkRasterClip& SkRasterClip::operator=(const SkRasterClip& src) {
+    AUTO_RASTERCLIP_VALIDATE(src);
+
+    if (this != &src) {
+        fBW = src.fBW;
+        fAA = src.fAA;
+        if (!src.isAnalytic()) {
+            fAnalytic.reset();
+        } else if (this->isAnalytic()) {
+            *fAnalytic = *src.fAnalytic;
+        } else {
+            fAnalytic = skstd::make_unique<SkAnalyticClip>(*src.fAnalytic);
+        }
+        fIsBW = src.fIsBW;
+        fIsEmpty = src.fIsEmpty;
+        fIsRect = src.fIsRect;
+        fAllowAnalytic = src.fAllowAnalytic;
+    fCachePaths = src.fCachePaths;
+        fClipRestrictionRect = src.fClipRestrictionRect;
+    }
+    SkDEBUGCODE(this->validate();)
+    return *this;
+}
+
 SkRasterClip::SkRasterClip(const SkRegion& rgn) : fBW(rgn) {
     fIsBW = true;
     fIsEmpty = this->computeIsEmpty();  // bounds might be empty, so compute
     fIsRect = !fIsEmpty;
+    fAllowAnalytic = gSkAnalyticRasterClips;
+    fCachePaths = gSkCacheRasterClips;
     SkDEBUGCODE(this->validate();)
 }
 
@@ -152,6 +188,8 @@ SkRasterClip::SkRasterClip(const SkIRect& bounds) : fBW(bounds) {
     fIsBW = true;
     fIsEmpty = this->computeIsEmpty();  // bounds might be empty, so compute
     fIsRect = !fIsEmpty;
+    fAllowAnalytic = gSkAnalyticRasterClips;
+    fCachePaths = gSkCacheRasterClips;
     SkDEBUGCODE(this->validate();)
 }
 
@@ -159,6 +197,8 @@ SkRasterClip::SkRasterClip() {
     fIsBW = true;
     fIsEmpty = true;
     fIsRect = false;
+    fAllowAnalytic = gSkAnalyticRasterClips;
+    fCachePaths = gSkCacheRasterClips;
     SkDEBUGCODE(this->validate();)
 }
 
@@ -170,7 +210,9 @@ bool SkRasterClip::operator==(const SkRasterClip& other) const {
     if (fIsBW != other.fIsBW) {
         return false;
     }
-    bool isEqual = fIsBW ? fBW == other.fBW : fAA == other.fAA;
+    bool isEqual = fIsBW ? fBW == other.fBW
+                         : fAA == other.fAA && this->isAnalytic() == other.isAnalytic() &&
+                           (!this->isAnalytic() || *fAnalytic == *other.fAnalytic);
 #ifdef SK_DEBUG
     if (isEqual) {
         SkASSERT(fIsEmpty == other.fIsEmpty);
@@ -181,10 +223,13 @@ bool SkRasterClip::operator==(const SkRasterClip& other) const {
 }
 
 bool SkRasterClip::isComplex() const {
-    return fIsBW ? fBW.isComplex() : !fAA.isEmpty();
+    return fIsBW ? fBW.isComplex() : !fAA.isEmpty() || this->isAnalytic();
 }
 
 const SkIRect& SkRasterClip::getBounds() const {
+    if (this->isAnalytic()) {
+        return fAnalytic->getBounds();
+    }
     return fIsBW ? fBW.getBounds() : fAA.getBounds();
 }
 
@@ -194,6 +239,7 @@ bool SkRasterClip::setEmpty() {
     fIsBW = true;
     fBW.setEmpty();
     fAA.setEmpty();
+    fAnalytic.reset();
     fIsEmpty = true;
     fIsRect = false;
     return false;
@@ -204,6 +250,7 @@ bool SkRasterClip::setRect(const SkIRect& rect) {
 
     fIsBW = true;
     fAA.setEmpty();
+    fAnalytic.reset();
     fIsRect = fBW.setRect(rect);
     fIsEmpty = !fIsRect;
     return fIsRect;
@@ -236,6 +283,7 @@ bool SkRasterClip::setPath(const SkPath& path, const SkRegion& clip, bool doAA)
         if (this->isBW()) {
             this->convertToAA();
         }
+        fAnalytic.reset();
         (void)fAA.setPath(path, &clip, doAA);
     }
     return this->updateCacheAndReturnNonEmpty();
@@ -243,11 +291,19 @@ bool SkRasterClip::setPath(const SkPath& path, const SkRegion& clip, bool doAA)
 
 bool SkRasterClip::op(const SkRRect& rrect, const SkMatrix& matrix, const SkIRect& devBounds,
                       SkRegion::Op op, bool doAA) {
+    if (fAllowAnalytic && doAA && SkRegion::kIntersect_Op == op && this->isRect()) {
+        SkRRect devRRect;
+        if (rrect.transform(matrix, &devRRect)) {
+            return this->opAnalytic(devRRect);
+        }
+    }
+
     SkIRect bounds(devBounds);
     this->applyClipRestriction(op, &bounds);
 
     SkPath path;
     path.addRRect(rrect);
+    path.setIsVolatile(true);
 
     return this->op(path, matrix, bounds, op, doAA);
 }
@@ -258,6 +314,10 @@ bool SkRasterClip::op(const SkPath& path, const SkMatrix& matrix, const SkIRect&
     SkIRect bounds(devBounds);
     this->applyClipRestriction(op, &bounds);
 
+    if (fCachePaths && doAA && !path.isVolatile()) {
+        return this->opCachedPath(path, matrix, bounds, op);
+    }
+
     // base is used to limit the size (and therefore memory allocation) of the
     // region that results from scan converting devPath.
     SkRegion base;
@@ -303,9 +363,58 @@ bool SkRasterClip::setPath(const SkPath& path, const SkIRect& clip, bool doAA) {
     return this->setPath(path, tmp, doAA);
 }
 
+bool SkRasterClip::setAAClip(const SkAAClip& clip) {
+    AUTO_RASTERCLIP_VALIDATE(*this);
+
+    fBW.setEmpty();
+    fAA = clip;
+    fAnalytic.reset();
+    fIsBW = false;
+    return this->updateCacheAndReturnNonEmpty();
+}
+
+// Like op(path), but scan converts the path through SkClipMaskCache.
+bool SkRasterClip::opCachedPath(const SkPath& path, const SkMatrix& matrix,
+                                const SkIRect& bounds, SkRegion::Op op) {
+    if (SkRegion::kIntersect_Op == op && this->isEmpty()) {
+        return false;
+    }
+
+    // As op(path) does, scan convert within our bounds when intersecting, else within bounds.
+    const SkIRect base = SkRegion::kIntersect_Op == op ? this->getBounds() : bounds;
+
+    SkAAClip aaclip;
+    if (!SkClipMaskCache::Find(path, matrix, base, &aaclip)) {
+        SkPath devPath;
+        path.transform(matrix, &devPath);
+        devPath.setIsVolatile(true);
+
+        SkRegion rgn(base);
+        aaclip.setPath(devPath, &rgn, true);
+        SkClipMaskCache::Add(path, matrix, base, aaclip);
+    }
+
+    if ((SkRegion::kIntersect_Op == op && this->isRect()) || SkRegion::kReplace_Op == op) {
+        // aaclip already lies within our (rectangular) clip, or replaces it.
+        return this->setAAClip(aaclip);
+    }
+    SkRasterClip clip;
+    clip.setAAClip(aaclip);
+    return this->op(clip, op);
+}
+
 bool SkRasterClip::op(const SkIRect& rect, SkRegion::Op op) {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
+    if (this->isAnalytic()) {
+        if (SkRegion::kIntersect_Op == op) {
+            if (!fAnalytic->intersect(rect)) {
+                fAnalytic.reset();
+            }
+            return this->updateCacheAndReturnNonEmpty();
+        }
+        this->convertAnalyticToAA();
+    }
     fIsBW ? fBW.op(rect, op) : fAA.op(rect, op);
     return this->updateCacheAndReturnNonEmpty();
 }
@@ -313,6 +422,9 @@ bool SkRasterClip::op(const SkIRect& rect, SkRegion::Op op) {
 bool SkRasterClip::op(const SkRegion& rgn, SkRegion::Op op) {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
+    if (this->isAnalytic()) {
+        this->convertAnalyticToAA();
+    }
     if (fIsBW) {
         (void)fBW.op(rgn, op);
     } else {
@@ -336,9 +448,15 @@ bool SkRasterClip::op(const SkRasterClip& clip, SkRegion::Op op) {
         if (this->isBW()) {
             this->convertToAA();
         }
+        if (this->isAnalytic()) {
+            this->convertAnalyticToAA();
+        }
         if (clip.isBW()) {
             tmp.setRegion(clip.bwRgn());
             other = &tmp;
+        } else if (clip.isAnalytic()) {
+            tmp.setAnalyticClip(clip.analyticRgn());
+            other = &tmp;
         } else {
             other = &clip.aaRgn();
         }
@@ -384,6 +502,19 @@ bool SkRasterClip::op(const SkRect& localRect, const SkMatrix& matrix, const SkI
         }
     }
 
+    if (fAllowAnalytic && doAA && SkRegion::kIntersect_Op == op && this->isRect()) {
+        return this->opAnalytic(SkRRect::MakeRect(devRect));
+    }
+    if (this->isAnalytic()) {
+        if (!doAA && SkRegion::kIntersect_Op == op) {
+            if (!fAnalytic->intersect(devRect.round())) {
+                fAnalytic.reset();
+            }
+            return this->updateCacheAndReturnNonEmpty();
+        }
+        this->convertAnalyticToAA();
+    }
+
     if (fIsBW && !doAA) {
         SkIRect ir;
         devRect.round(&ir);
@@ -419,14 +550,26 @@ void SkRasterClip::translate(int dx, int dy, SkRasterClip* dst) const {
     if (fIsBW) {
         fBW.translate(dx, dy, &dst->fBW);
         dst->fAA.setEmpty();
+        dst->fAnalytic.reset();
+    } else if (this->isAnalytic()) {
+        if (!dst->isAnalytic()) {
+            dst->fAnalytic = skstd::make_unique<SkAnalyticClip>();
+        }
+        fAnalytic->translate(dx, dy, dst->fAnalytic.get());
+        dst->fAA.setEmpty();
+        dst->fBW.setEmpty();
     } else {
         fAA.translate(dx, dy, &dst->fAA);
+        dst->fAnalytic.reset();
         dst->fBW.setEmpty();
     }
     dst->updateCacheAndReturnNonEmpty();
 }
 
 bool SkRasterClip::quickContains(const SkIRect& ir) const {
+    if (this->isAnalytic()) {
+        return fAnalytic->quickContains(ir);
+    }
     return fIsBW ? fBW.quickContains(ir) : fAA.quickContains(ir);
 }
 
@@ -436,7 +579,7 @@ const SkRegion& SkRasterClip::forceGetBW() {
     AUTO_RASTERCLIP_VALIDATE(*this);
 
     if (!fIsBW) {
-        fBW.setRect(fAA.getBounds());
+        fBW.setRect(this->getBounds());
     }
     return fBW;
 }
@@ -453,11 +596,41 @@ void SkRasterClip::convertToAA() {
     (void)this->updateCacheAndReturnNonEmpty(false);
 }
 
+// Intersects our (rectangular) clip with devRRect, keeping its edges analytic.
+bool SkRasterClip::opAnalytic(const SkRRect& devRRect) {
+    AUTO_RASTERCLIP_VALIDATE(*this);
+    SkASSERT(this->isRect());
+
+    auto analytic = skstd::make_unique<SkAnalyticClip>();
+    if (!analytic->set(devRRect, this->getBounds())) {
+        return this->setEmpty();
+    }
+    fAnalytic = std::move(analytic);
+    fBW.setEmpty();
+    fAA.setEmpty();
+    fIsBW = false;
+    return this->updateCacheAndReturnNonEmpty();
+}
+
+void SkRasterClip::convertAnalyticToAA() {
+    AUTO_RASTERCLIP_VALIDATE(*this);
+
+    SkASSERT(this->isAnalytic());
+    fAA.setAnalyticClip(*fAnalytic);
+    fAnalytic.reset();
+    (void)this->updateCacheAndReturnNonEmpty(false);
+}
+
 #ifdef SK_DEBUG
 void SkRasterClip::validate() const {
     // can't ever assert that fBW is empty, since we may have called forceGetBW
     if (fIsBW) {
         SkASSERT(fAA.isEmpty());
+        SkASSERT(!this->isAnalytic());
+    }
+    if (this->isAnalytic()) {
+        SkASSERT(fAA.isEmpty());
+        SkASSERT(!fAnalytic->isEmpty());
     }
 
     SkRegionPriv::Validate(fBW);
@@ -496,6 +669,11 @@ void SkAAClipBlitterWrapper::init(const SkRasterClip& clip, SkBlitter* blitter)
     if (clip.isBW()) {
         fClipRgn = &clip.bwRgn();
         fBlitter = blitter;
+    } else if (clip.isAnalytic()) {
+        fBWRgn.setRect(clip.getBounds());
+        fAABlitter.init(blitter, &clip.analyticRgn());
+        fClipRgn = &fBWRgn;
+        fBlitter = &fAABlitter;
     } else {
         const SkAAClip& aaclip = clip.aaRgn();
         fBWRgn.setRect(aaclip.getBounds());
@@ -9,11 +9,19 @@
 #define SkRasterClip_DEFINED
 
 #include "SkAAClip.h"
+#include "SkAnalyticClip.h"
 #include "SkMacros.h"
 #include "SkRegion.h"
 
+#include <atomic>
+#include <memory>
+
 class SkRRect;
 
+// If set, anti-aliased rect and rrect clips of a rectangular clip keep their edges analytic (see
+// SkAnalyticClip), rather than being scan converted into an SkAAClip.
+extern std::atomic<bool> gSkAnalyticRasterClips;
+
 class SkConservativeClip {
     SkIRect         fBounds;
     const SkIRect*  fClipRestrictionRect;
@@ -64,6 +72,8 @@ public:
     SkRasterClip(const SkRasterClip&);
     ~SkRasterClip();
 
+    SkRasterClip& operator=(const SkRasterClip&);
+
     // Only compares the current state. Does not compare isForceConservativeRects(), so that field
     // could be different but this could still return true.
     bool operator==(const SkRasterClip&) const;
@@ -73,8 +83,11 @@ public:
 
     bool isBW() const { return fIsBW; }
     bool isAA() const { return !fIsBW; }
+    // Analytic clips are AA, but have no SkAAClip: blit through SkAAClipBlitterWrapper.
+    bool isAnalytic() const { return fAnalytic != nullptr; }
     const SkRegion& bwRgn() const { SkASSERT(fIsBW); return fBW; }
-    const SkAAClip& aaRgn() const { SkASSERT(!fIsBW); return fAA; }
+    const SkAAClip& aaRgn() const { SkASSERT(!fIsBW && !this->isAnalytic()); return fAA; }
+    const SkAnalyticClip& analyticRgn() const { SkASSERT(this->isAnalytic()); return *fAnalytic; }
 
     bool isEmpty() const {
         SkASSERT(this->computeIsEmpty() == fIsEmpty);
@@ -130,17 +143,27 @@ public:
         fClipRestrictionRect = rect;
     }
 
+    // Test hooks: override gSkAnalyticRasterClips and gSkCacheRasterClips for this clip and the
+    // clips copied from it.
+    void setAnalyticForTesting(bool analytic) { fAllowAnalytic = analytic; }
+    void setCachePathsForTesting(bool cache) { fCachePaths = cache; }
+
 private:
     SkRegion    fBW;
     SkAAClip    fAA;
+    // When set, this is our clip (never empty), and fAA is empty.  It's only allocated then, so
+    // clips that are never analytic don't pay for it.
+    std::unique_ptr<SkAnalyticClip> fAnalytic;
     bool        fIsBW;
     // these 2 are caches based on querying the right obj based on fIsBW
     bool        fIsEmpty;
     bool        fIsRect;
+    bool        fAllowAnalytic; // keep AA rect and rrect clips analytic
+    bool        fCachePaths;    // scan convert AA path clips through SkClipMaskCache
     const SkIRect*    fClipRestrictionRect = nullptr;
 
     bool computeIsEmpty() const {
-        return fIsBW ? fBW.isEmpty() : fAA.isEmpty();
+        return fIsBW ? fBW.isEmpty() : fAA.isEmpty() && !this->isAnalytic();
     }
 
     bool computeIsRect() const {
@@ -162,9 +185,13 @@ private:
     }
 
     void convertToAA();
+    void convertAnalyticToAA();
 
     bool setPath(const SkPath& path, const SkRegion& clip, bool doAA);
     bool setPath(const SkPath& path, const SkIRect& clip, bool doAA);
+    bool setAAClip(const SkAAClip&);
+    bool opCachedPath(const SkPath&, const SkMatrix&, const SkIRect&, SkRegion::Op);
+    bool opAnalytic(const SkRRect& devRRect);
     bool op(const SkRasterClip&, SkRegion::Op);
     bool setConservativeRect(const SkRect& r, const SkIRect& clipR, bool isInverse);
 
@@ -84,6 +84,9 @@ public:
 
     const SkRasterClip& rc() const { return fStack.top().fRC; }
 
+    // Test hook: the clip to set SkRasterClip's test options on, before clipping.
+    SkRasterClip& writableRCForTesting() { return this->writable_rc(); }
+
     void save() {
         fCounter += 1;
         SkASSERT(fStack.top().fDeferredCount >= 0);
@@ -6,8 +6,11 @@
  */
 
 #include "SkRasterPipeline.h"
+#include "SkMutex.h"
 #include "SkOpts.h"
+#include "SkTHash.h"
 #include <algorithm>
+#include <atomic>
 
 SkRasterPipeline::SkRasterPipeline(SkArenaAlloc* alloc) : fAlloc(alloc) {
     this->reset();
@@ -58,17 +61,20 @@ void SkRasterPipeline::extend(const SkRasterPipeline& src) {
     fSlotsNeeded += src.fSlotsNeeded - 1;  // Don't double count just_returns().
 }
 
+static const char* stage_name(uint64_t stage) {
+    switch (stage) {
+    #define M(x) case SkRasterPipeline::x: return #x;
+        SK_RASTER_PIPELINE_STAGES(M)
+    #undef M
+    }
+    return "";
+}
+
 void SkRasterPipeline::dump() const {
     SkDebugf("SkRasterPipeline, %d stages\n", fNumStages);
     std::vector<const char*> stages;
     for (auto st = fStages; st; st = st->prev) {
-        const char* name = "";
-        switch (st->stage) {
-        #define M(x) case x: name = #x; break;
-            SK_RASTER_PIPELINE_STAGES(M)
-        #undef M
-        }
-        stages.push_back(name);
+        stages.push_back(st->rawFunction ? "" : stage_name(st->stage));
     }
     std::reverse(stages.begin(), stages.end());
     for (const char* name : stages) {
@@ -259,42 +265,237 @@ void SkRasterPipeline::append_gamut_clamp_if_normalized(const SkImageInfo& dstIn
     }
 }
 
-SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void** ip) const {
+// Each fused stage does the work of a short run of stages in a single call.  Runs are listed front
+// to back, in the order they'd be appended.  Every stage in a run that takes a context must take
+// the same one, and the fused stage takes it too.
+namespace {
+    struct Fusion {
+        SkRasterPipeline::StockStage fused;
+        int                          count;
+        SkRasterPipeline::StockStage stages[3];
+    };
+}
+
+static const Fusion kFusions[] = {
+    { SkRasterPipeline::srcover_8888, 3,
+      { SkRasterPipeline::load_8888_dst, SkRasterPipeline::srcover,
+        SkRasterPipeline::store_8888 } },
+    { SkRasterPipeline::srcover_f16, 3,
+      { SkRasterPipeline::load_f16_dst, SkRasterPipeline::srcover,
+        SkRasterPipeline::store_f16 } },
+    { SkRasterPipeline::seed_shader_matrix_translate, 2,
+      { SkRasterPipeline::seed_shader, SkRasterPipeline::matrix_translate } },
+    { SkRasterPipeline::seed_shader_matrix_scale_translate, 2,
+      { SkRasterPipeline::seed_shader, SkRasterPipeline::matrix_scale_translate } },
+    { SkRasterPipeline::seed_shader_matrix_2x3, 2,
+      { SkRasterPipeline::seed_shader, SkRasterPipeline::matrix_2x3 } },
+};
+
+int SkRasterPipeline::match_fused(const StageList* st, StockStage* fused, void** ctx) const {
+    for (const Fusion& fusion : kFusions) {
+        // fStages is backwards, so we match the run from its last stage to its first.
+        const StageList* s = st;
+        void* runCtx = nullptr;
+        int i = fusion.count;
+        for (; i > 0 && s && !s->rawFunction && s->stage == (uint64_t)fusion.stages[i-1]; i--) {
+            if (s->ctx) {
+                if (runCtx && runCtx != s->ctx) {
+                    break;
+                }
+                runCtx = s->ctx;
+            }
+            s = s->prev;
+        }
+        if (i == 0) {
+            *fused = fusion.fused;
+            *ctx   = runCtx;
+            return fusion.count;
+        }
+    }
+    return 0;
+}
+
+// How many pipelines build_pipeline() has built for each precision, while stats are enabled.
+static std::atomic<bool> gStatsEnabled{false};
+static std::atomic<int64_t> gLowpBuilds{0},
+                            gHighpBuilds{0};
+
+SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(void** ip,
+                                                                   void*** program) const {
     // We'll try to build a lowp pipeline, but if that fails fallback to a highp float pipeline.
     void** reset_point = ip;
 
     // Stages are stored backwards in fStages, so we reverse here, back to front.
+    // Wherever we can, we use a fused stage in place of the stages it's made from.
     *--ip = (void*)SkOpts::just_return_lowp;
-    for (const StageList* st = fStages; st; st = st->prev) {
+    for (const StageList* st = fStages; st; ) {
+        StockStage fused;
+        void* ctx;
+        int n = this->match_fused(st, &fused, &ctx);
+
         SkOpts::StageFn fn;
-        if (!st->rawFunction && (fn = SkOpts::stages_lowp[st->stage])) {
-            if (st->ctx) {
-                *--ip = st->ctx;
-            }
-            *--ip = (void*)fn;
+        if (n > 0 && (fn = SkOpts::stages_lowp[fused])) {
+            // Great, use the fused stage.
+        } else if (!st->rawFunction && (fn = SkOpts::stages_lowp[st->stage])) {
+            n   = 1;
+            ctx = st->ctx;
         } else {
             ip = reset_point;
             break;
         }
+        if (ctx) {
+            *--ip = ctx;
+        }
+        *--ip = (void*)fn;
+        while (n --> 0) {
+            st = st->prev;
+        }
     }
     if (ip != reset_point) {
+        if (gStatsEnabled.load(std::memory_order_relaxed)) {
+            gLowpBuilds.fetch_add(1, std::memory_order_relaxed);
+        }
+        *program = ip;
         return SkOpts::start_pipeline_lowp;
     }
 
     *--ip = (void*)SkOpts::just_return_highp;
-    for (const StageList* st = fStages; st; st = st->prev) {
-        if (st->ctx) {
-            *--ip = st->ctx;
-        }
-        if (st->rawFunction) {
-            *--ip = (void*)st->stage;
+    for (const StageList* st = fStages; st; ) {
+        StockStage fused;
+        void* ctx;
+        int n = this->match_fused(st, &fused, &ctx);
+
+        void* fn;
+        if (n > 0) {
+            fn = (void*)SkOpts::stages_highp[fused];
         } else {
-            *--ip = (void*)SkOpts::stages_highp[st->stage];
+            n   = 1;
+            ctx = st->ctx;
+            fn  = st->rawFunction ? (void*)st->stage
+                                  : (void*)SkOpts::stages_highp[st->stage];
+        }
+        if (ctx) {
+            *--ip = ctx;
+        }
+        *--ip = fn;
+        while (n --> 0) {
+            st = st->prev;
         }
     }
+    if (gStatsEnabled.load(std::memory_order_relaxed)) {
+        gHighpBuilds.fetch_add(1, std::memory_order_relaxed);
+    }
+    *program = ip;
     return SkOpts::start_pipeline_highp;
 }
 
+bool SkRasterPipeline::canRunLowp() const {
+    for (const StageList* st = fStages; st; st = st->prev) {
+        if (st->rawFunction || !SkOpts::stages_lowp[st->stage]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+SkRasterPipeline::PrecisionCounts SkRasterPipeline::GetPrecisionCounts() {
+    return { gLowpBuilds .load(std::memory_order_relaxed),
+             gHighpBuilds.load(std::memory_order_relaxed) };
+}
+
+namespace {
+    struct SequenceCounts {
+        SkString             stages;
+        bool                 lowp;
+        std::atomic<int64_t> runs{0},
+                             pixels{0};
+
+        void add(size_t w, size_t h) {
+            runs  .fetch_add(1,                       std::memory_order_relaxed);
+            pixels.fetch_add((int64_t)w * (int64_t)h, std::memory_order_relaxed);
+        }
+    };
+}
+
+SK_DECLARE_STATIC_MUTEX(gStatsMutex);
+// Counters are never freed: compiled pipelines hold on to them.
+static SkTHashMap<SkString, SequenceCounts*>* gStats = nullptr;
+
+// Returns the counters for this stage sequence, or nullptr if we're not collecting stats.
+static SequenceCounts* find_counts(const SkRasterPipeline& pipeline, bool lowp) {
+    if (!gStatsEnabled.load(std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    SkString stages = pipeline.stage_sequence();
+    SkString key = SkStringPrintf("%s %s", lowp ? "lowp" : "highp", stages.c_str());
+
+    SkAutoMutexAcquire lock(gStatsMutex);
+    if (!gStats) {
+        gStats = new SkTHashMap<SkString, SequenceCounts*>;
+    }
+    if (SequenceCounts** counts = gStats->find(key)) {
+        return *counts;
+    }
+    auto counts = new SequenceCounts;
+    counts->stages = std::move(stages);
+    counts->lowp   = lowp;
+    gStats->set(key, counts);
+    return counts;
+}
+
+SkString SkRasterPipeline::stage_sequence() const {
+    std::vector<const char*> stages;
+    for (auto st = fStages; st; st = st->prev) {
+        stages.push_back(st->rawFunction ? "(raw)" : stage_name(st->stage));
+    }
+    SkString sequence;
+    for (auto name = stages.rbegin(); name != stages.rend(); ++name) {
+        sequence.appendf("%s%s", sequence.isEmpty() ? "" : ", ", *name);
+    }
+    return sequence;
+}
+
+void SkRasterPipeline::SetStatsEnabled(bool enabled) {
+    gStatsEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool SkRasterPipeline::StatsEnabled() {
+    return gStatsEnabled.load(std::memory_order_relaxed);
+}
+
+void SkRasterPipeline::ResetStats() {
+    gLowpBuilds .store(0, std::memory_order_relaxed);
+    gHighpBuilds.store(0, std::memory_order_relaxed);
+
+    SkAutoMutexAcquire lock(gStatsMutex);
+    if (gStats) {
+        gStats->foreach([](const SkString&, SequenceCounts** counts) {
+            (*counts)->runs  .store(0, std::memory_order_relaxed);
+            (*counts)->pixels.store(0, std::memory_order_relaxed);
+        });
+    }
+}
+
+std::vector<SkRasterPipeline::SequenceStats> SkRasterPipeline::GetStats() {
+    std::vector<SequenceStats> stats;
+    {
+        SkAutoMutexAcquire lock(gStatsMutex);
+        if (gStats) {
+            gStats->foreach([&](const SkString&, SequenceCounts** counts) {
+                int64_t runs = (*counts)->runs.load(std::memory_order_relaxed);
+                if (runs > 0) {
+                    stats.push_back({(*counts)->stages, (*counts)->lowp, runs,
+                                     (*counts)->pixels.load(std::memory_order_relaxed)});
+                }
+            });
+        }
+    }
+    std::sort(stats.begin(), stats.end(), [](const SequenceStats& a, const SequenceStats& b) {
+        return a.pixels > b.pixels;
+    });
+    return stats;
+}
+
 void SkRasterPipeline::run(size_t x, size_t y, size_t w, size_t h) const {
     if (this->empty()) {
         return;
@@ -303,8 +504,19 @@ void SkRasterPipeline::run(size_t x, size_t y, size_t w, size_t h) const {
     // Best to not use fAlloc here... we can't bound how often run() will be called.
     SkAutoSTMalloc<64, void*> program(fSlotsNeeded);
 
-    auto start_pipeline = this->build_pipeline(program.get() + fSlotsNeeded);
-    start_pipeline(x,y,x+w,y+h, program.get());
+    void** start;
+    auto start_pipeline = this->build_pipeline(program.get() + fSlotsNeeded, &start);
+    if (SequenceCounts* counts =
+            find_counts(*this, start_pipeline == SkOpts::start_pipeline_lowp)) {
+        counts->add(w,h);
+    }
+    start_pipeline(x,y,x+w,y+h, start);
+}
+
+SkRasterPipeline::StartPipelineFn SkRasterPipeline::compile_into(void** program,
+                                                                  void*** start) const {
+    SkASSERT(!this->empty());
+    return this->build_pipeline(program + fSlotsNeeded, start);
 }
 
 std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile() const {
@@ -314,7 +526,14 @@ std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile()
 
     void** program = fAlloc->makeArray<void*>(fSlotsNeeded);
 
-    auto start_pipeline = this->build_pipeline(program + fSlotsNeeded);
+    auto start_pipeline = this->build_pipeline(program + fSlotsNeeded, &program);
+    if (SequenceCounts* counts =
+            find_counts(*this, start_pipeline == SkOpts::start_pipeline_lowp)) {
+        return [=](size_t x, size_t y, size_t w, size_t h) {
+            counts->add(w,h);
+            start_pipeline(x,y,x+w,y+h, program);
+        };
+    }
     return [=](size_t x, size_t y, size_t w, size_t h) {
         start_pipeline(x,y,x+w,y+h, program);
     };
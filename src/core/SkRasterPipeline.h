@@ -12,6 +12,7 @@
 #include "SkColor.h"
 #include "SkImageInfo.h"
 #include "SkNx.h"
+#include "SkString.h"
 #include "SkTArray.h" // TODO: unused
 #include "SkTypes.h"
 #include <functional>
@@ -61,7 +62,9 @@
     M(colorburn) M(colordodge) M(darken) M(difference)             \
     M(exclusion) M(hardlight) M(lighten) M(overlay) M(softlight)   \
     M(hue) M(saturation) M(color) M(luminosity)                    \
-    M(srcover_rgba_8888)                                           \
+    M(srcover_rgba_8888) M(srcover_8888) M(srcover_f16)            \
+    M(seed_shader_matrix_translate) M(seed_shader_matrix_scale_translate) \
+    M(seed_shader_matrix_2x3)                                      \
     M(matrix_translate) M(matrix_scale_translate)                  \
     M(matrix_2x3) M(matrix_3x3) M(matrix_3x4) M(matrix_4x5) M(matrix_4x3) \
     M(matrix_perspective)                                          \
@@ -120,6 +123,7 @@ struct SkRasterPipeline_SamplerCtx {
     float     fy[SkRasterPipeline_kMaxStride];
     float scalex[SkRasterPipeline_kMaxStride];
     float scaley[SkRasterPipeline_kMaxStride];
+    int  samples;   // How many bilinear samples lowp has accumulated so far.
 };
 
 struct SkRasterPipeline_TileCtx {
@@ -206,6 +210,15 @@ public:
     // Allocates a thunk which amortizes run() setup cost in alloc.
     std::function<void(size_t, size_t, size_t, size_t)> compile() const;
 
+    // Like compile(), but builds the program into program, which must have room for
+    // slots_needed() pointers, and points *start at its first slot.  Run it by calling the
+    // returned function with (x,y, x+w,y+h, *start).  The program is plain data, so it can be
+    // copied and its contexts re-pointed, which lets SkRasterPipelineBlitter cache programs.
+    // Runs of these programs are not counted in SequenceStats.
+    using StartPipelineFn = void(*)(size_t,size_t,size_t,size_t, void** program);
+    StartPipelineFn compile_into(void** program, void*** start) const;
+    int slots_needed() const { return fSlotsNeeded; }
+
     void dump() const;
 
     // Appends a stage for the specified matrix.
@@ -235,6 +248,36 @@ public:
 
     bool empty() const { return fStages == nullptr; }
 
+    // Optional statistics about which stage sequences run, and over how many pixels, used to pick
+    // which sequences deserve fused stages.  Sequences are the stages as appended, before fusion.
+    // Collection is off by default and costs a lock per run() or compile() when on.
+    struct SequenceStats {
+        SkString stages;  // Comma separated stage names.
+        bool     lowp;    // Did this sequence run in lowp?
+        int64_t  runs;    // Calls to run() or to compile()'s function.
+        int64_t  pixels;
+    };
+    static void SetStatsEnabled(bool);
+    static bool StatsEnabled();
+    static void ResetStats();
+    // Sorted by pixels, most first.
+    static std::vector<SequenceStats> GetStats();
+
+    // The stages as appended, comma separated.
+    SkString stage_sequence() const;
+
+    // Counts of the pipelines run() and compile() have built for each precision, collected only
+    // while stats are enabled.
+    // Lowp is faster but falls back to highp if any stage has no lowp implementation on this CPU.
+    // ResetStats() zeroes these too.
+    struct PrecisionCounts {
+        int64_t lowp;
+        int64_t highp;
+    };
+    static PrecisionCounts GetPrecisionCounts();
+
+    // Would this pipeline run in lowp on this CPU?
+    bool canRunLowp() const;
 
 private:
     struct StageList {
@@ -244,8 +287,12 @@ private:
         bool       rawFunction;
     };
 
-    using StartPipelineFn = void(*)(size_t,size_t,size_t,size_t, void** program);
-    StartPipelineFn build_pipeline(void**) const;
+    // Fills in the program backwards from end, pointing *program at its first slot.
+    StartPipelineFn build_pipeline(void** end, void*** program) const;
+
+    // If a fused stage can replace the run of stages ending at st, returns how many stages it
+    // replaces, setting *fused and *ctx.  Otherwise returns 0.
+    int match_fused(const StageList* st, StockStage* fused, void** ctx) const;
 
     void unchecked_append(StockStage, void*);
 
@@ -9,10 +9,12 @@
 #include "SkBlendModePriv.h"
 #include "SkBlitter.h"
 #include "SkColor.h"
+#include "SkColorData.h"
 #include "SkColorFilter.h"
 #include "SkColorSpacePriv.h"
 #include "SkColorSpaceXformer.h"
 #include "SkColorSpaceXformSteps.h"
+#include "SkCoreBlitters.h"
 #include "SkOpts.h"
 #include "SkRasterPipeline.h"
 #include "SkShader.h"
@@ -20,12 +22,34 @@
 #include "SkTo.h"
 #include "SkUtils.h"
 
+// A blit program compiled for a constant color, shared between every blitter drawing that color
+// with the same blend mode into the same kind of dst.  fProgram is a template: the slots listed in
+// fRelocations point into the SkRasterPipelineBlitter that compiled it, and each blitter using it
+// copies the program and re-points those slots at itself.  Everything else fProgram points to is
+// either code or lives in fAlloc, so the program stays valid as long as the blitter holds a ref.
+struct SkCachedBlitProgram : public SkNVRefCnt<SkCachedBlitProgram> {
+    struct Relocation {
+        int       slot;
+        ptrdiff_t offset;  // From the start of the blitter.
+    };
+
+    SkSTArenaAlloc<64>                fAlloc;  // Holds the constant color context, if any.
+    SkRasterPipeline::StartPipelineFn fStartPipeline = nullptr;
+    SkAutoTMalloc<void*>              fProgram;
+    int                               fStart = 0;  // The first slot used in fProgram.
+    int                               fSlots = 0;
+    SkSTArray<4, Relocation, true>    fRelocations;
+    uint64_t                          fMemsetColor = 0;  // For kSrc rects: the color to memset.
+};
+
 class SkRasterPipelineBlitter final : public SkBlitter {
 public:
     // This is our common entrypoint for creating the blitter once we've sorted out shaders.
+    // If there's no shader, paintColor is the premul paint color and shaderPipeline is empty.
     static SkBlitter* Create(const SkPixmap&, const SkPaint&, SkArenaAlloc*,
                              const SkRasterPipeline& shaderPipeline,
-                             bool is_opaque, bool is_constant);
+                             bool is_opaque, bool is_constant,
+                             SkConstantColorBlitCache*, const SkPMColor4f* paintColor = nullptr);
 
     SkRasterPipelineBlitter(SkPixmap dst,
                             SkBlendMode blend,
@@ -45,8 +69,27 @@ public:
     void blitV     (int x, int y, int height, SkAlpha alpha)        override;
 
 private:
+    // The blit pipelines we build lazily, one for each kind of blit.
+    enum BlitKind {
+        kRect_BlitKind,
+        kAntiH_BlitKind,
+        kMaskA8_BlitKind,
+        kMaskLCD16_BlitKind,
+        kMask3D_BlitKind,
+
+        kLast_BlitKind = kMask3D_BlitKind,
+    };
+
     void append_load_dst      (SkRasterPipeline*) const;
-    void append_store         (SkRasterPipeline*) const;
+    // Stores to dstPtr, or fDstPtr if it's null.
+    void append_store         (SkRasterPipeline*,
+                               const SkRasterPipeline_MemoryCtx* dstPtr = nullptr) const;
+    // Appends everything that follows fColorPipeline in the blit pipeline for this kind.
+    void append_blit_stages   (BlitKind, SkRasterPipeline*) const;
+
+    // Builds the blit pipeline for this kind, using a cached program when we can.
+    std::function<void(size_t, size_t, size_t, size_t)> build_blit(BlitKind);
+    sk_sp<SkCachedBlitProgram> find_or_compile_program(BlitKind) const;
 
     SkPixmap               fDst;
     SkBlendMode            fBlend;
@@ -74,13 +117,25 @@ private:
     float fCurrentCoverage = 0.0f;
     float fDitherRate      = 0.0f;
 
+    // A8 and LCD16 masks skip the pipeline for SkOpts::blit_mask_{f16,1010102}_{a8,lcd16}().
+    bool fBlitMaskWithOpts = false;
+
+    // When fColorPipeline would be just fConstantColor, our blit programs can be shared with
+    // other blitters through fProgramCache, and we needn't build fColorPipeline at all.  We keep
+    // a ref on each cached program we use.
+    bool                       fCacheable = false;
+    SkConstantColorBlitCache*  fProgramCache = nullptr;
+    SkColor4f                  fConstantColor = {0,0,0,0};
+    sk_sp<SkCachedBlitProgram> fCachedPrograms[kLast_BlitKind + 1];
+
     typedef SkBlitter INHERITED;
 };
 
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
                                          const SkPaint& paint,
                                          const SkMatrix& ctm,
-                                         SkArenaAlloc* alloc) {
+                                         SkArenaAlloc* alloc,
+                                         SkConstantColorBlitCache* programCache) {
     // For legacy/SkColorSpaceXformCanvas to keep working,
     // we need to sometimes still need to distinguish null dstCS from sRGB.
 #if 0
@@ -99,11 +154,12 @@ SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
     SkRasterPipeline_<256> shaderPipeline;
     if (!shader) {
         // Having no shader makes things nice and easy... just use the paint color.
-        shaderPipeline.append_constant_color(alloc, paintColor.premul().vec());
+        SkPMColor4f premulColor = paintColor.premul();
         bool is_opaque    = paintColor.fA == 1.0f,
              is_constant  = true;
         return SkRasterPipelineBlitter::Create(dst, paint, alloc,
-                                               shaderPipeline, is_opaque, is_constant);
+                                               shaderPipeline, is_opaque, is_constant,
+                                               programCache, &premulColor);
     }
 
     bool is_opaque    = shader->isOpaque() && paintColor.fA == 1.0f;
@@ -115,7 +171,8 @@ SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
                                   alloc->make<float>(paintColor.fA));
         }
         return SkRasterPipelineBlitter::Create(dst, paint, alloc,
-                                               shaderPipeline, is_opaque, is_constant);
+                                               shaderPipeline, is_opaque, is_constant,
+                                               programCache);
     }
 
     // The shader has opted out of drawing anything.
@@ -129,7 +186,7 @@ SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
                                          SkArenaAlloc* alloc) {
     bool is_constant = false;  // If this were the case, it'd be better to just set a paint color.
     return SkRasterPipelineBlitter::Create(dst, paint, alloc,
-                                           shaderPipeline, is_opaque, is_constant);
+                                           shaderPipeline, is_opaque, is_constant, nullptr);
 }
 
 SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
@@ -137,24 +194,13 @@ SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
                                            SkArenaAlloc* alloc,
                                            const SkRasterPipeline& shaderPipeline,
                                            bool is_opaque,
-                                           bool is_constant) {
+                                           bool is_constant,
+                                           SkConstantColorBlitCache* programCache,
+                                           const SkPMColor4f* paintColor) {
     auto blitter = alloc->make<SkRasterPipelineBlitter>(dst,
                                                         paint.getBlendMode(),
                                                         alloc);
-
-    // Our job in this factory is to fill out the blitter's color pipeline.
-    // This is the common front of the full blit pipelines, each constructed lazily on first use.
-    // The full blit pipelines handle reading and writing the dst, blending, coverage, dithering.
-    auto colorPipeline = &blitter->fColorPipeline;
-
-    // Let's get the shader in first.
-    colorPipeline->extend(shaderPipeline);
-
-    // If there's a color filter it comes next.
-    if (auto colorFilter = paint.getColorFilter()) {
-        colorFilter->appendStages(colorPipeline, dst.colorSpace(), alloc, is_opaque);
-        is_opaque = is_opaque && (colorFilter->getFlags() & SkColorFilter::kAlphaUnchanged_Flag);
-    }
+    blitter->fProgramCache = programCache ? programCache : SkConstantColorBlitCache::Global();
 
     // Not all formats make sense to dither (think, F16).  We set their dither rate
     // to zero.  We need to decide if we're going to dither now to keep is_constant accurate.
@@ -176,19 +222,73 @@ SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
     }
     is_constant = is_constant && (blitter->fDitherRate == 0.0f);
 
-    // We're logically done here.  The code between here and return blitter is all optimization.
+    // Stats are counted per compile(), so we skip the cache while they're being collected.
+    const bool cacheable = is_constant && !SkRasterPipeline::StatsEnabled();
 
-    // A pipeline that's still constant here can collapse back into a constant color.
-    if (is_constant) {
-        SkColor4f constantColor;
-        SkRasterPipeline_MemoryCtx constantColorPtr = { &constantColor, 0 };
-        colorPipeline->append_gamut_clamp_if_normalized(dst.info());
-        colorPipeline->append(SkRasterPipeline::store_f32, &constantColorPtr);
-        colorPipeline->run(0,0,1,1);
-        colorPipeline->reset();
-        colorPipeline->append_constant_color(alloc, constantColor);
+    // Our job in this factory is to fill out the blitter's color pipeline.
+    // This is the common front of the full blit pipelines, each constructed lazily on first use.
+    // The full blit pipelines handle reading and writing the dst, blending, coverage, dithering.
+    auto colorPipeline = &blitter->fColorPipeline;
 
+    if (cacheable && paintColor && !paint.getColorFilter()) {
+        // The color pipeline would be just the paint color, so we can collapse it to a constant
+        // color (as below) without building or running it, and our cached programs never need it.
+        SkColor4f constantColor = { paintColor->fR, paintColor->fG, paintColor->fB,
+                                    paintColor->fA };
+        // As append_gamut_clamp_if_normalized() and the clamp_gamut stage would.
+        if (dst.colorType() != kRGBA_F16_SkColorType &&
+            dst.colorType() != kRGBA_F32_SkColorType &&
+            dst.alphaType() == kPremul_SkAlphaType) {
+            for (int i = 0; i < 3; i++) {
+                constantColor.vec()[i] = SkTMin(SkTMax(constantColor.vec()[i], 0.0f),
+                                                constantColor.fA);
+            }
+        }
         is_opaque = constantColor.fA == 1.0f;
+
+        blitter->fCacheable     = true;
+        blitter->fConstantColor = constantColor;
+    } else {
+        // Let's get the shader (or paint color) in first.
+        if (paintColor) {
+            colorPipeline->append_constant_color(alloc, paintColor->vec());
+        } else {
+            colorPipeline->extend(shaderPipeline);
+        }
+
+        // If there's a color filter it comes next.
+        if (auto colorFilter = paint.getColorFilter()) {
+            colorFilter->appendStages(colorPipeline, dst.colorSpace(), alloc, is_opaque);
+            is_opaque = is_opaque
+                     && (colorFilter->getFlags() & SkColorFilter::kAlphaUnchanged_Flag);
+        }
+
+        // We're logically done here.  The code between here and return blitter is all
+        // optimization.
+
+        // A pipeline that's still constant here can collapse back into a constant color.
+        if (is_constant) {
+            SkColor4f constantColor;
+            SkRasterPipeline_MemoryCtx constantColorPtr = { &constantColor, 0 };
+            colorPipeline->append_gamut_clamp_if_normalized(dst.info());
+            colorPipeline->append(SkRasterPipeline::store_f32, &constantColorPtr);
+            colorPipeline->run(0,0,1,1);
+            colorPipeline->reset();
+            colorPipeline->append_constant_color(alloc, constantColor);
+
+            is_opaque = constantColor.fA == 1.0f;
+
+            blitter->fCacheable     = cacheable;
+            blitter->fConstantColor = constantColor;
+        }
+    }
+
+    // Constant color SrcOver masks, i.e. most text, into F16 and 1010102 have SkOpts kernels.
+    if (is_constant && blitter->fBlend == SkBlendMode::kSrcOver
+                    && dst.alphaType() == kPremul_SkAlphaType
+                    && (dst.colorType() == kRGBA_F16_SkColorType ||
+                        dst.colorType() == kRGBA_1010102_SkColorType)) {
+        blitter->fBlitMaskWithOpts = true;
     }
 
     // We can strength-reduce SrcOver into Src when opaque.
@@ -199,14 +299,21 @@ SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
     // When we're drawing a constant color in Src mode, we can sometimes just memset.
     // (The previous two optimizations help find more opportunities for this one.)
     if (is_constant && blitter->fBlend == SkBlendMode::kSrc) {
-        // Run our color pipeline all the way through to produce what we'd memset when we can.
-        // Not all blits can memset, so we need to keep colorPipeline too.
-        SkRasterPipeline_<256> p;
-        p.extend(*colorPipeline);
-        p.append_gamut_clamp_if_normalized(dst.info());
-        blitter->fDstPtr = SkRasterPipeline_MemoryCtx{&blitter->fMemsetColor, 0};
-        blitter->append_store(&p);
-        p.run(0,0,1,1);
+        if (blitter->fCacheable) {
+            // Our rect program, cached or compiled now, carries the color to memset.
+            sk_sp<SkCachedBlitProgram> rect = blitter->find_or_compile_program(kRect_BlitKind);
+            blitter->fMemsetColor = rect->fMemsetColor;
+            blitter->fCachedPrograms[kRect_BlitKind] = std::move(rect);
+        } else {
+            // Run our color pipeline all the way through to produce what we'd memset when we
+            // can.  Not all blits can memset, so we need to keep colorPipeline too.
+            SkRasterPipeline_<256> p;
+            p.extend(*colorPipeline);
+            p.append_gamut_clamp_if_normalized(dst.info());
+            SkRasterPipeline_MemoryCtx memsetPtr = {&blitter->fMemsetColor, 0};
+            blitter->append_store(&p, &memsetPtr);
+            p.run(0,0,1,1);
+        }
 
         switch (blitter->fDst.shiftPerPixel()) {
             case 0: blitter->fMemset2D = [](SkPixmap* dst, int x,int y, int w,int h, uint64_t c) {
@@ -263,7 +370,8 @@ void SkRasterPipelineBlitter::append_load_dst(SkRasterPipeline* p) const {
     }
 }
 
-void SkRasterPipelineBlitter::append_store(SkRasterPipeline* p) const {
+void SkRasterPipelineBlitter::append_store(SkRasterPipeline* p,
+                                           const SkRasterPipeline_MemoryCtx* dstPtr) const {
     if (fDst.info().alphaType() == kUnpremul_SkAlphaType) {
         p->append(SkRasterPipeline::unpremul);
     }
@@ -271,7 +379,228 @@ void SkRasterPipelineBlitter::append_store(SkRasterPipeline* p) const {
         p->append(SkRasterPipeline::dither, &fDitherRate);
     }
 
-    p->append_store(fDst.info().colorType(), &fDstPtr);
+    p->append_store(fDst.info().colorType(), dstPtr ? dstPtr : &fDstPtr);
+}
+
+void SkRasterPipelineBlitter::append_blit_stages(BlitKind kind, SkRasterPipeline* p) const {
+    if (kind == kMask3D_BlitKind) {
+        // This bit is where we differ from kA8_Format.  Now onward just as kA8.
+        p->append(SkRasterPipeline::emboss, &fEmbossCtx);
+        kind = kMaskA8_BlitKind;
+    }
+    p->append_gamut_clamp_if_normalized(fDst.info());
+
+    switch (kind) {
+        case kRect_BlitKind:
+            if (fBlend == SkBlendMode::kSrcOver
+                    && (fDst.info().colorType() == kRGBA_8888_SkColorType ||
+                        fDst.info().colorType() == kBGRA_8888_SkColorType)
+                    && !fDst.colorSpace()
+                    && fDst.info().alphaType() != kUnpremul_SkAlphaType
+                    && fDitherRate == 0.0f) {
+                if (fDst.info().colorType() == kBGRA_8888_SkColorType) {
+                    p->append(SkRasterPipeline::swap_rb);
+                }
+                p->append(SkRasterPipeline::srcover_rgba_8888, &fDstPtr);
+                return;
+            }
+            if (fBlend != SkBlendMode::kSrc) {
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+            }
+            break;
+
+        case kAntiH_BlitKind:
+            if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
+                p->append(SkRasterPipeline::scale_1_float, &fCurrentCoverage);
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+            } else {
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+                p->append(SkRasterPipeline::lerp_1_float, &fCurrentCoverage);
+            }
+            break;
+
+        case kMaskA8_BlitKind:
+            if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
+                p->append(SkRasterPipeline::scale_u8, &fMaskPtr);
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+            } else {
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+                p->append(SkRasterPipeline::lerp_u8, &fMaskPtr);
+            }
+            break;
+
+        case kMaskLCD16_BlitKind:
+            if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/true)) {
+                // Somewhat unusually, scale_565 needs dst loaded first.
+                this->append_load_dst(p);
+                p->append(SkRasterPipeline::scale_565, &fMaskPtr);
+                SkBlendMode_AppendStages(fBlend, p);
+            } else {
+                this->append_load_dst(p);
+                SkBlendMode_AppendStages(fBlend, p);
+                p->append(SkRasterPipeline::lerp_565, &fMaskPtr);
+            }
+            break;
+
+        case kMask3D_BlitKind:
+            SkASSERT(false);  // Handled as kMaskA8_BlitKind above.
+            break;
+    }
+    this->append_store(p);
+}
+
+static_assert(sizeof(SkConstantColorBlitCache::Key) == 8*sizeof(uint32_t), "");
+
+static constexpr int kDefaultConstantColorBlitCacheCountLimit = 256;
+
+SkConstantColorBlitCache::SkConstantColorBlitCache(int countLimit) : fCountLimit(0) {
+    this->setCountLimit(countLimit);
+}
+
+SkConstantColorBlitCache::~SkConstantColorBlitCache() {}
+
+SkConstantColorBlitCache* SkConstantColorBlitCache::Global() {
+    static SkConstantColorBlitCache* gCache =
+            new SkConstantColorBlitCache(kDefaultConstantColorBlitCacheCountLimit);
+    return gCache;
+}
+
+int SkConstantColorBlitCache::getCountUsed() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fPrograms ? fPrograms->count() : 0;
+}
+
+int SkConstantColorBlitCache::getCountLimit() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fCountLimit;
+}
+
+int SkConstantColorBlitCache::setCountLimit(int count) {
+    SkAutoMutexAcquire lock(fMutex);
+    int prev = fCountLimit;
+    fCountLimit = SkTMax(count, 0);
+    // SkLRUCache's limit is fixed, so we start over with a new cache.
+    fPrograms.reset(fCountLimit > 0 ? new SkLRUCache<Key, sk_sp<SkCachedBlitProgram>>(fCountLimit)
+                                    : nullptr);
+    return prev;
+}
+
+void SkConstantColorBlitCache::getStats(int64_t* hits, int64_t* misses) const {
+    *hits   = fHits  .load(std::memory_order_relaxed);
+    *misses = fMisses.load(std::memory_order_relaxed);
+}
+
+void SkConstantColorBlitCache::purgeAll() {
+    SkAutoMutexAcquire lock(fMutex);
+    if (fPrograms) {
+        fPrograms->reset();
+    }
+}
+
+sk_sp<SkCachedBlitProgram> SkConstantColorBlitCache::find(const Key& key) {
+    SkAutoMutexAcquire lock(fMutex);
+    if (fPrograms) {
+        if (sk_sp<SkCachedBlitProgram>* cached = fPrograms->find(key)) {
+            fHits.fetch_add(1, std::memory_order_relaxed);
+            return *cached;
+        }
+    }
+    fMisses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+sk_sp<SkCachedBlitProgram> SkConstantColorBlitCache::add(const Key& key,
+                                                         sk_sp<SkCachedBlitProgram> program) {
+    SkAutoMutexAcquire lock(fMutex);
+    if (!fPrograms) {
+        return program;  // Caching is disabled.
+    }
+    if (sk_sp<SkCachedBlitProgram>* raced = fPrograms->find(key)) {
+        return *raced;  // Another thread beat us to it.  Theirs is just as good.
+    }
+    return *fPrograms->insert(key, std::move(program));
+}
+
+sk_sp<SkCachedBlitProgram> SkRasterPipelineBlitter::find_or_compile_program(BlitKind kind) const {
+    using Key = SkConstantColorBlitCache::Key;
+    Key key;
+    memcpy(key.color, fConstantColor.vec(), sizeof(key.color));
+    key.colorType    = fDst.info().colorType();
+    key.alphaType    = fDst.info().alphaType();
+    key.blend        = (uint32_t)fBlend;
+    key.kindAndFlags = kind | (fDst.colorSpace() ? Key::kHasColorSpace_Flag : 0);
+
+    if (sk_sp<SkCachedBlitProgram> cached = fProgramCache->find(key)) {
+        return cached;
+    }
+
+    // Compile outside the lock.  This pipeline is our usual blit pipeline, except that its
+    // constant color context lives in the cached program rather than in our fAlloc.
+    auto cached = sk_make_sp<SkCachedBlitProgram>();
+    SkRasterPipeline_<256> p;
+    p.append_constant_color(&cached->fAlloc, fConstantColor);
+    this->append_blit_stages(kind, &p);
+
+    cached->fSlots = p.slots_needed();
+    cached->fProgram.reset(cached->fSlots);
+    void** start;
+    cached->fStartPipeline = p.compile_into(cached->fProgram.get(), &start);
+    cached->fStart = SkToInt(start - cached->fProgram.get());
+
+    // Any slot pointing into this blitter is a context we must re-point in each copy.
+    auto begin = (const char*)this,
+         end   = (const char*)(this + 1);
+    for (int i = cached->fStart; i < cached->fSlots; i++) {
+        auto ptr = (const char*)cached->fProgram[i];
+        if (begin <= ptr && ptr < end) {
+            cached->fRelocations.push_back({i, ptr - begin});
+        }
+    }
+
+    if (kind == kRect_BlitKind && fBlend == SkBlendMode::kSrc) {
+        // Run the color through to produce what we'd memset when we can.
+        SkSTArenaAlloc<64> alloc;
+        SkRasterPipeline_<256> m;
+        m.append_constant_color(&alloc, fConstantColor);
+        m.append_gamut_clamp_if_normalized(fDst.info());
+        SkRasterPipeline_MemoryCtx memsetPtr = {&cached->fMemsetColor, 0};
+        this->append_store(&m, &memsetPtr);
+        m.run(0,0,1,1);
+    }
+
+    return fProgramCache->add(key, std::move(cached));
+}
+
+std::function<void(size_t, size_t, size_t, size_t)>
+SkRasterPipelineBlitter::build_blit(BlitKind kind) {
+    if (!fCacheable) {
+        SkRasterPipeline p(fAlloc);
+        p.extend(fColorPipeline);
+        this->append_blit_stages(kind, &p);
+        return p.compile();
+    }
+
+    sk_sp<SkCachedBlitProgram> cached = fCachedPrograms[kind] ? fCachedPrograms[kind]
+                                                              : this->find_or_compile_program(kind);
+
+    // Copy the program into our fAlloc, re-pointing its contexts at this blitter.
+    int slots = cached->fSlots - cached->fStart;
+    void** program = fAlloc->makeArrayDefault<void*>(slots);
+    memcpy(program, cached->fProgram.get() + cached->fStart, slots * sizeof(void*));
+    for (const SkCachedBlitProgram::Relocation& r : cached->fRelocations) {
+        program[r.slot - cached->fStart] = (char*)this + r.offset;
+    }
+
+    auto start_pipeline = cached->fStartPipeline;
+    fCachedPrograms[kind] = std::move(cached);  // Keeps the program's constant color alive.
+    return [=](size_t x, size_t y, size_t w, size_t h) {
+        start_pipeline(x,y,x+w,y+h, program);
+    };
 }
 
 void SkRasterPipelineBlitter::blitH(int x, int y, int w) {
@@ -285,27 +614,7 @@ void SkRasterPipelineBlitter::blitRect(int x, int y, int w, int h) {
     }
 
     if (!fBlitRect) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (fBlend == SkBlendMode::kSrcOver
-                && (fDst.info().colorType() == kRGBA_8888_SkColorType ||
-                    fDst.info().colorType() == kBGRA_8888_SkColorType)
-                && !fDst.colorSpace()
-                && fDst.info().alphaType() != kUnpremul_SkAlphaType
-                && fDitherRate == 0.0f) {
-            if (fDst.info().colorType() == kBGRA_8888_SkColorType) {
-                p.append(SkRasterPipeline::swap_rb);
-            }
-            p.append(SkRasterPipeline::srcover_rgba_8888, &fDstPtr);
-        } else {
-            if (fBlend != SkBlendMode::kSrc) {
-                this->append_load_dst(&p);
-                SkBlendMode_AppendStages(fBlend, &p);
-            }
-            this->append_store(&p);
-        }
-        fBlitRect = p.compile();
+        fBlitRect = this->build_blit(kRect_BlitKind);
     }
 
     fBlitRect(x,y,w,h);
@@ -313,21 +622,7 @@ void SkRasterPipelineBlitter::blitRect(int x, int y, int w, int h) {
 
 void SkRasterPipelineBlitter::blitAntiH(int x, int y, const SkAlpha aa[], const int16_t runs[]) {
     if (!fBlitAntiH) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
-            p.append(SkRasterPipeline::scale_1_float, &fCurrentCoverage);
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_1_float, &fCurrentCoverage);
-        }
-
-        this->append_store(&p);
-        fBlitAntiH = p.compile();
+        fBlitAntiH = this->build_blit(kAntiH_BlitKind);
     }
 
     for (int16_t run = *runs; run > 0; run = *runs) {
@@ -393,6 +688,35 @@ void SkRasterPipelineBlitter::blitMask(const SkMask& mask, const SkIRect& clip)
           || mask.fFormat == SkMask::kLCD16_Format
           || mask.fFormat == SkMask::k3D_Format);
 
+    if (fBlitMaskWithOpts && mask.fFormat != SkMask::k3D_Format) {
+        int x = clip.left(),
+            y = clip.top();
+        bool a8 = mask.fFormat == SkMask::kA8_Format;
+        if (fDst.colorType() == kRGBA_F16_SkColorType) {
+            uint64_t* dst = fDst.writable_addr64(x,y);
+            if (a8) {
+                SkOpts::blit_mask_f16_a8(dst, fDst.rowBytes(), mask.getAddr8(x,y), mask.fRowBytes,
+                                         fConstantColor, clip.width(), clip.height());
+            } else {
+                SkOpts::blit_mask_f16_lcd16(dst, fDst.rowBytes(),
+                                            mask.getAddrLCD16(x,y), mask.fRowBytes,
+                                            fConstantColor, clip.width(), clip.height());
+            }
+        } else {
+            uint32_t* dst = fDst.writable_addr32(x,y);
+            if (a8) {
+                SkOpts::blit_mask_1010102_a8(dst, fDst.rowBytes(),
+                                             mask.getAddr8(x,y), mask.fRowBytes,
+                                             fConstantColor, clip.width(), clip.height());
+            } else {
+                SkOpts::blit_mask_1010102_lcd16(dst, fDst.rowBytes(),
+                                                mask.getAddrLCD16(x,y), mask.fRowBytes,
+                                                fConstantColor, clip.width(), clip.height());
+            }
+        }
+        return;
+    }
+
     auto extract_mask_plane = [&mask](int plane, SkRasterPipeline_MemoryCtx* ctx) {
         // LCD is 16-bit per pixel; A8 and 3D are 8-bit per pixel.
         size_t bpp = mask.fFormat == SkMask::kLCD16_Format ? 2 : 1;
@@ -418,56 +742,13 @@ void SkRasterPipelineBlitter::blitMask(const SkMask& mask, const SkIRect& clip)
 
     // Lazily build whichever pipeline we need, specialized for each mask format.
     if (mask.fFormat == SkMask::kA8_Format && !fBlitMaskA8) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
-            p.append(SkRasterPipeline::scale_u8, &fMaskPtr);
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_u8, &fMaskPtr);
-        }
-        this->append_store(&p);
-        fBlitMaskA8 = p.compile();
+        fBlitMaskA8 = this->build_blit(kMaskA8_BlitKind);
     }
     if (mask.fFormat == SkMask::kLCD16_Format && !fBlitMaskLCD16) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/true)) {
-            // Somewhat unusually, scale_565 needs dst loaded first.
-            this->append_load_dst(&p);
-            p.append(SkRasterPipeline::scale_565, &fMaskPtr);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_565, &fMaskPtr);
-        }
-        this->append_store(&p);
-        fBlitMaskLCD16 = p.compile();
+        fBlitMaskLCD16 = this->build_blit(kMaskLCD16_BlitKind);
     }
     if (mask.fFormat == SkMask::k3D_Format && !fBlitMask3D) {
-        SkRasterPipeline p(fAlloc);
-        p.extend(fColorPipeline);
-        // This bit is where we differ from kA8_Format:
-        p.append(SkRasterPipeline::emboss, &fEmbossCtx);
-        // Now onward just as kA8.
-        p.append_gamut_clamp_if_normalized(fDst.info());
-        if (SkBlendMode_ShouldPreScaleCoverage(fBlend, /*rgb_coverage=*/false)) {
-            p.append(SkRasterPipeline::scale_u8, &fMaskPtr);
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-        } else {
-            this->append_load_dst(&p);
-            SkBlendMode_AppendStages(fBlend, &p);
-            p.append(SkRasterPipeline::lerp_u8, &fMaskPtr);
-        }
-        this->append_store(&p);
-        fBlitMask3D = p.compile();
+        fBlitMask3D = this->build_blit(kMask3D_BlitKind);
     }
 
     std::function<void(size_t,size_t,size_t,size_t)>* blitter = nullptr;
@@ -12,6 +12,7 @@
 #include "SkMipMap.h"
 #include "SkMutex.h"
 #include "SkOpts.h"
+#include "SkPathPriv.h"
 #include "SkTo.h"
 #include "SkTraceMemoryDump.h"
 
@@ -539,6 +540,33 @@ void SkResourceCache::PostPurgeSharedID(uint64_t sharedID) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+uint64_t SkMakeResourceCacheSharedIDForPath(uint32_t pathGenID) {
+    uint64_t sharedID = SkSetFourByteTag('p', 'a', 't', 'h');
+    return (sharedID << 32) | pathGenID;
+}
+
+namespace {
+class PathPurgeListener : public SkPathRef::GenIDChangeListener {
+public:
+    explicit PathPurgeListener(uint32_t pathGenID)
+        : fSharedID(SkMakeResourceCacheSharedIDForPath(pathGenID)) {}
+
+private:
+    void onChange() override { SkResourceCache::PostPurgeSharedID(fSharedID); }
+
+    uint64_t fSharedID;
+};
+}
+
+sk_sp<SkPathRef::GenIDChangeListener> SkPurgeResourceCacheOnPathChange(const SkPath& path) {
+    sk_sp<SkPathRef::GenIDChangeListener> listener =
+            sk_make_sp<PathPurgeListener>(path.getGenerationID());
+    SkPathPriv::AddGenIDChangeListener(path, listener);
+    return listener;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 #include "SkGraphics.h"
 #include "SkImageFilter.h"
 
@@ -10,8 +10,12 @@
 
 #include "SkBitmap.h"
 #include "SkMessageBus.h"
+#include "SkPath.h"
+#include "SkPathRef.h"
 #include "SkTDArray.h"
 
+#include <atomic>
+
 class SkCachedData;
 class SkDiscardableMemory;
 class SkTraceMemoryDump;
@@ -289,4 +293,109 @@ private:
     void validate() const {}
 #endif
 };
+
+/**
+ *  Use this for cache entries made from a path (e.g. its masks or stroked outlines), so they can
+ *  all be purged together when the path changes.
+ */
+uint64_t SkMakeResourceCacheSharedIDForPath(uint32_t pathGenID);
+
+/**
+ *  Registers a listener on the path that purges its shared ID (as above) from the resource caches
+ *  when the path is edited or destroyed.  Recs that hold the returned listener should call
+ *  markShouldUnregisterFromPath() on it when they are purged, so the path can drop it.
+ */
+sk_sp<SkPathRef::GenIDChangeListener> SkPurgeResourceCacheOnPathChange(const SkPath& path);
+
+/**
+ *  Values made from paths, e.g. their stroked outlines, kept in the global SkResourceCache or in
+ *  a local one.  Entries are keyed on the path's generation ID and fill type plus Params, which
+ *  must be tightly packed 32-bit fields, and are purged when the path changes.  Value should be
+ *  cheap to copy, like the copy-on-write SkPath.  Counts how often find() hits and misses.
+ */
+template <typename Params, typename Value>
+class SkPathResourceCache {
+public:
+    constexpr SkPathResourceCache(const char* category, size_t (*valueBytes)(const Value&))
+        : fCategory(category), fValueBytes(valueBytes) {}
+
+    /**
+     *  On success, set value to the one cached for path and params and return true.
+     */
+    bool find(const SkPath& path, const Params& params, Value* value,
+              SkResourceCache* localCache = nullptr) {
+        PathKey key(this, path, params);
+        bool found = localCache ? localCache->find(key, Rec::Visitor, value)
+                                : SkResourceCache::Find(key, Rec::Visitor, value);
+        (found ? fHits : fMisses).fetch_add(1, std::memory_order_relaxed);
+        return found;
+    }
+
+    void add(const SkPath& path, const Params& params, const Value& value,
+             SkResourceCache* localCache = nullptr) {
+        auto rec = new Rec(this, PathKey(this, path, params), value,
+                           SkPurgeResourceCacheOnPathChange(path));
+        if (localCache) {
+            localCache->add(rec);
+        } else {
+            SkResourceCache::Add(rec);
+        }
+    }
+
+    void getStats(int64_t* hits, int64_t* misses) const {
+        *hits   = fHits  .load(std::memory_order_relaxed);
+        *misses = fMisses.load(std::memory_order_relaxed);
+    }
+
+private:
+    static_assert(sizeof(Params) % 4 == 0, "Params must be tightly packed 32-bit fields.");
+
+    struct PathKey : public SkResourceCache::Key {
+        // Our cache's address is the namespace, so each cache has its own keys.
+        PathKey(SkPathResourceCache* cache, const SkPath& path, const Params& params)
+            : fGenID(path.getGenerationID())
+            , fFillType(path.getFillType())
+            , fParams(params) {
+            this->init(cache, SkMakeResourceCacheSharedIDForPath(fGenID),
+                       sizeof(fGenID) + sizeof(fFillType) + sizeof(fParams));
+        }
+
+        uint32_t fGenID;
+        int32_t  fFillType;
+        Params   fParams;
+    };
+
+    struct Rec : public SkResourceCache::Rec {
+        Rec(const SkPathResourceCache* cache, const PathKey& key, const Value& value,
+            sk_sp<SkPathRef::GenIDChangeListener> invalidator)
+            : fCache(cache)
+            , fKey(key)
+            , fValue(value)
+            , fInvalidator(std::move(invalidator)) {}
+        ~Rec() override {
+            // Once we're gone, the path can drop our listener.
+            fInvalidator->markShouldUnregisterFromPath();
+        }
+
+        const SkPathResourceCache*              fCache;
+        PathKey                                 fKey;
+        Value                                   fValue;
+        sk_sp<SkPathRef::GenIDChangeListener>   fInvalidator;
+
+        const Key& getKey() const override { return fKey; }
+        size_t bytesUsed() const override { return sizeof(*this) + fCache->fValueBytes(fValue); }
+        const char* getCategory() const override { return fCache->fCategory; }
+
+        static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+            *static_cast<Value*>(contextData) = static_cast<const Rec&>(baseRec).fValue;
+            return true;
+        }
+    };
+
+    const char*           fCategory;
+    size_t              (*fValueBytes)(const Value&);
+    std::atomic<int64_t>  fHits{0},
+                          fMisses{0};
+};
+
 #endif
@@ -573,6 +573,37 @@ void SkScalerContext::getImage(const SkGlyph& origGlyph) {
     }
 }
 
+void SkScalerContext::getMetrics(SkSpan<SkGlyph*> glyphs) {
+    // Metrics made from paths, like those images, take most of their time outside the port.
+    if (fGenerateImageFromPath) {
+        for (SkGlyph* glyph : glyphs) {
+            this->getMetrics(glyph);
+        }
+        return;
+    }
+    this->beginGlyphBatch();
+    for (SkGlyph* glyph : glyphs) {
+        this->getMetrics(glyph);
+    }
+    this->endGlyphBatch();
+}
+
+void SkScalerContext::getImages(SkSpan<const SkGlyph*> glyphs) {
+    // Images made from paths, or filtered, take most of their time outside the port. Leave the
+    // port to set up per glyph, so that scaler contexts for the same face can work in parallel.
+    if (!this->batchesImages()) {
+        for (const SkGlyph* glyph : glyphs) {
+            this->getImage(*glyph);
+        }
+        return;
+    }
+    this->beginGlyphBatch();
+    for (const SkGlyph* glyph : glyphs) {
+        this->getImage(*glyph);
+    }
+    this->endGlyphBatch();
+}
+
 bool SkScalerContext::getPath(SkPackedGlyphID glyphID, SkPath* path) {
     return this->internalGetPath(glyphID, path);
 }
@@ -120,6 +120,11 @@ private:
 public:
     uint16_t    fFlags;
 
+    // Are the stroke join and cap ones SkPaint has?  Recs from outside this process may not be.
+    bool hasValidStrokeParams() const {
+        return fStrokeJoin < SkPaint::kJoinCount && fStrokeCap < SkPaint::kCapCount;
+    }
+
     // Warning: when adding members note that the size of this structure
     // must be a multiple of 4. SkDescriptor requires that its arguments be
     // multiples of four and this structure is put in an SkDescriptor in
@@ -282,6 +287,19 @@ public:
     bool SK_WARN_UNUSED_RESULT getPath(SkPackedGlyphID, SkPath*);
     void        getFontMetrics(SkFontMetrics*);
 
+    /** Like getMetrics() and getImage() on each glyph, but the port sets up once for the whole
+        batch rather than once per glyph, unless glyphs are made from paths (or for images, mask
+        filtered), see batchesImages(). The glyphs passed to getImages() must have their metrics,
+        and fImage allocated.
+     */
+    void        getMetrics(SkSpan<SkGlyph*> glyphs);
+    void        getImages(SkSpan<const SkGlyph*> glyphs);
+
+    /** Whether getImages() sets the port up once for its batch. If not, images take most of
+        their time outside the port, and a batch can be split across scaler contexts for free.
+     */
+    bool batchesImages() const { return !fGenerateImageFromPath && !fMaskFilter; }
+
     /** Return the size in bytes of the associated gamma lookup table
      */
     static size_t GetGammaLUTSize(SkScalar contrast, SkScalar paintGamma, SkScalar deviceGamma,
@@ -392,6 +410,13 @@ protected:
      */
     virtual uint16_t generateCharToGlyph(SkUnichar unichar) = 0;
 
+    /** Called before and after generating the metrics, images and paths for a batch of glyphs,
+     *  so that work common to all of them, like locking and selecting the size and transform of
+     *  a shared face, can be done once.
+     */
+    virtual void beginGlyphBatch() {}
+    virtual void endGlyphBatch() {}
+
     void forceGenerateImageFromPath() { fGenerateImageFromPath = true; }
     void forceOffGenerateImageFromPath() { fGenerateImageFromPath = false; }
 
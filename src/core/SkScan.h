@@ -26,6 +26,7 @@ typedef SkIRect SkXRect;
 
 extern std::atomic<bool> gSkUseDeltaAA;
 extern std::atomic<bool> gSkForceDeltaAA;
+extern std::atomic<int>  gSkDeltaAAThreads;  // If > 1, DAA splits big paths into this many bands.
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
 
@@ -77,6 +78,10 @@ public:
     static void AntiFillPath(const SkPath& path, const SkRasterClip& rc, SkBlitter* blitter) {
         AntiFillPath(path, rc, blitter, nullptr);
     }
+
+    // Test hook: fill path with DAA, whatever AntiFillPath() would choose, splitting it into up to
+    // threads bands rather than gSkDeltaAAThreads.
+    static void DAAFillPathForTesting(const SkPath&, const SkIRect& clip, SkBlitter*, int threads);
 private:
     friend class SkAAClip;
     friend class SkRegion;
@@ -96,8 +101,10 @@ private:
     static void AntiHairLineRgn(const SkPoint[], int count, const SkRegion*, SkBlitter*);
     static void AAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
+    // If threads > 1, a big path may be split into up to that many bands, generated in parallel.
     static void DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
-                            const SkIRect& clipBounds, bool forceRLE, SkDAARecord* daaRecord);
+                            const SkIRect& clipBounds, bool forceRLE, SkDAARecord* daaRecord,
+                            int threads);
     static void SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
                             const SkIRect& clipBounds, bool forceRLE);
 };
@@ -837,7 +837,8 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
     compute_complexity(path, avgLength, complexity);
 
     if (daaRecord || ShouldUseDAA(path, avgLength, complexity)) {
-        SkScan::DAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE, daaRecord);
+        SkScan::DAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE, daaRecord,
+                            gSkDeltaAAThreads);
     } else if (ShouldUseAAA(path, avgLength, complexity)) {
         // Do not use AAA if path is too complicated:
         // there won't be any speedup or significant visual improvement.
@@ -863,12 +864,8 @@ void SkScan::FillPath(const SkPath& path, const SkRasterClip& clip, SkBlitter* b
     if (clip.isBW()) {
         FillPath(path, clip.bwRgn(), blitter);
     } else {
-        SkRegion        tmp;
-        SkAAClipBlitter aaBlitter;
-
-        tmp.setRect(clip.getBounds());
-        aaBlitter.init(blitter, &clip.aaRgn());
-        SkScan::FillPath(path, tmp, &aaBlitter);
+        SkAAClipBlitterWrapper wrapper(clip, blitter);
+        SkScan::FillPath(path, wrapper.getRgn(), wrapper.getBlitter());
     }
 }
 
@@ -882,11 +879,8 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip,
     if (clip.isBW()) {
         AntiFillPath(path, clip.bwRgn(), blitter, false, daaRecord);
     } else {
-        SkRegion        tmp;
-        SkAAClipBlitter aaBlitter;
-
-        tmp.setRect(clip.getBounds());
-        aaBlitter.init(blitter, &clip.aaRgn());
-        AntiFillPath(path, tmp, &aaBlitter, true, daaRecord); // SkAAClipBlitter can blitMask, why forceRLE?
+        SkAAClipBlitterWrapper wrapper(clip, blitter);
+        // SkAAClipBlitter can blitMask, why forceRLE?
+        AntiFillPath(path, wrapper.getRgn(), wrapper.getBlitter(), true, daaRecord);
     }
 }
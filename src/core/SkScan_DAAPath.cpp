@@ -21,12 +21,14 @@
 #include "SkScan.h"
 #include "SkScanPriv.h"
 #include "SkTSort.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkUTF.h"
 
 #if defined(SK_DISABLE_DAA)
 void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
-                         const SkIRect& clipBounds, bool forceRLE, SkDAARecord* record) {
+                         const SkIRect& clipBounds, bool forceRLE, SkDAARecord* record,
+                         int threads) {
     SkDEBUGFAIL("DAA Disabled");
     return;
 }
@@ -156,76 +158,17 @@ public:
     }
 };
 
-template<class Deltas> static SK_ALWAYS_INLINE
-void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRect& clipBounds,
-        Deltas& result, SkBlitter* blitter, bool skipRect, bool pathContainedInClip) {
-    // 1. Build edges
-    SkBezierEdgeBuilder builder;
-    // We have to use clipBounds instead of clippedIR to build edges because of "canCullToTheRight":
-    // if the builder finds a right edge past the right clip, it won't build that right edge.
-    int  count = builder.buildEdges(path, pathContainedInClip ? nullptr : &clipBounds);
-
-    if (count == 0) {
-        return;
-    }
-    SkBezier** list = builder.bezierList();
-
-    // 2. Try to find the rect part because blitAntiRect is so much faster than blitCoverageDeltas
-    int rectTop = clippedIR.fBottom;   // the rect is initialized to be empty as top = bot
-    int rectBot = clippedIR.fBottom;
-    if (skipRect) {             // only find that rect is skipRect == true
-        YLessThan lessThan;     // sort edges in YX order
-        SkTQSort(list, list + count - 1, lessThan);
-        for(int i = 0; i < count - 1; ++i) {
-            SkBezier* lb = list[i];
-            SkBezier* rb = list[i + 1];
-
-            // fCount == 2 ensures that lb and rb are lines instead of quads or cubics.
-            bool lDX0 = lb->fP0.fX == lb->fP1.fX && lb->fCount == 2;
-            bool rDX0 = rb->fP0.fX == rb->fP1.fX && rb->fCount == 2;
-            if (!lDX0 || !rDX0) { // make sure that the edges are vertical
-                continue;
-            }
-
-            SkAnalyticEdge l, r;
-            if (!l.setLine(lb->fP0, lb->fP1) || !r.setLine(rb->fP0, rb->fP1)) {
-                continue;
-            }
-
-            SkFixed xorUpperY = l.fUpperY ^ r.fUpperY;
-            SkFixed xorLowerY = l.fLowerY ^ r.fLowerY;
-            if ((xorUpperY | xorLowerY) == 0) { // equal upperY and lowerY
-                rectTop = SkFixedCeilToInt(l.fUpperY);
-                rectBot = SkFixedFloorToInt(l.fLowerY);
-                if (rectBot > rectTop) { // if bot == top, the rect is too short for blitAntiRect
-                    int L = SkFixedCeilToInt(l.fUpperX);
-                    int R = SkFixedFloorToInt(r.fUpperX);
-                    if (L <= R) {
-                        SkAlpha la = (SkIntToFixed(L) - l.fUpperX) >> 8;
-                        SkAlpha ra = (r.fUpperX - SkIntToFixed(R)) >> 8;
-                        result.setAntiRect(L - 1, rectTop, R - L, rectBot - rectTop, la, ra);
-                    } else { // too thin to use blitAntiRect; reset the rect region to be emtpy
-                        rectTop = rectBot = clippedIR.fBottom;
-                    }
-                }
-                break;
-            }
-
-        }
-    }
-
-    // 3. Sort edges in x so we may need less sorting for delta based on x. This only helps
-    //    SkCoverageDeltaList. And we don't want to sort more than SORT_THRESHOLD edges where
-    //    the log(count) factor of the quick sort may become a bottleneck; when there are so
-    //    many edges, we're unlikely to make deltas sorted anyway.
-    constexpr int SORT_THRESHOLD = 256;
-    if (std::is_same<Deltas, SkCoverageDeltaList>::value && count < SORT_THRESHOLD) {
-        XLessThan lessThan;
-        SkTQSort(list, list + count - 1, lessThan);
-    }
-
-    // Future todo: parallize and SIMD the following code.
-    // 4. iterate through edges and generate deltas
+// Walk the edges and add their coverage deltas on rows [rows.fTop, rows.fBottom). Rows in
+// [rectTop, rectBot) are skipped as they're covered by the anti-rect.
+//
+// If isBanded is false, rows is clippedIR and the edges are already clipped to it vertically, so
+// only the partial rows need checking. If isBanded is true, rows is one horizontal band of
+// clippedIR and we skip the full rows above and below it too. Edges are only read, so many bands
+// can walk the same edge list at once.
+template<bool isBanded, class Deltas>
+static void add_edge_deltas(SkBezier** list, int count, const SkIRect& rows,
+                            int rectTop, int rectBot, Deltas& result) {
+    // Future todo: SIMD the following code.
     for(int index = 0; index < count; ++index) {
         SkAnalyticCubicEdge storage;
         SkASSERT(sizeof(SkAnalyticQuadraticEdge) >= sizeof(SkAnalyticEdge));
@@ -235,6 +178,24 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
         SkAnalyticEdge* currE   = &storage;
         bool edgeSet            = false;
 
+        if (isBanded) {
+            // Skip beziers entirely above or below the band without setting up their edges.
+            SkScalar top = SkTMin(bezier->fP0.fY, bezier->fP1.fY),
+                     bot = SkTMax(bezier->fP0.fY, bezier->fP1.fY);
+            if (bezier->fCount == 3) {
+                SkScalar y2 = static_cast<SkQuad*>(bezier)->fP2.fY;
+                top = SkTMin(top, y2);
+                bot = SkTMax(bot, y2);
+            } else if (bezier->fCount == 4) {
+                SkCubic* cubic = static_cast<SkCubic*>(bezier);
+                top = SkTMin(top, SkTMin(cubic->fP2.fY, cubic->fP3.fY));
+                bot = SkTMax(bot, SkTMax(cubic->fP2.fY, cubic->fP3.fY));
+            }
+            if (bot < rows.fTop || top >= rows.fBottom) {
+                continue;
+            }
+        }
+
         int originalWinding = 1;
         bool sortY = true;
         switch (bezier->fCount) {
@@ -271,10 +232,16 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
             SkFixed lowerCeil   = SkFixedCeilToFixed(currE->fLowerY);
             int     iy          = SkFixedFloorToInt(upperFloor);
 
+            if (isBanded) {
+                if (iy >= rows.fBottom || lowerCeil <= SkIntToFixed(rows.fTop)) {
+                    continue;   // this part of the edge is outside the band
+                }
+            }
+
             if (lowerCeil <= upperFloor + SK_Fixed1) { // only one row is affected by the currE
                 SkFixed rowHeight = currE->fLowerY - currE->fUpperY;
                 SkFixed nextX = currE->fX + SkFixedMul(currE->fDX, rowHeight);
-                if (iy >= clippedIR.fTop && iy < clippedIR.fBottom) {
+                if (iy >= rows.fTop && iy < rows.fBottom) {
                     add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
                 }
                 continue;
@@ -285,12 +252,24 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
             SkFixed nextX;
             if (rowHeight != SK_Fixed1) {   // it's a partial row
                 nextX = currE->fX + SkFixedMul(currE->fDX, rowHeight);
-                add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
+                if (!isBanded || iy >= rows.fTop) {
+                    add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
+                }
             } else {                        // it's a full row so we can leave it to the while loop
                 iy--;                       // compensate the iy++ in the while loop
                 nextX = currE->fX;
             }
 
+            if (isBanded && iy + 1 < rows.fTop) {
+                // Jump over the full rows above the band. Stepping nextX by fDX per row is exact
+                // integer math, so this lands on the same x as walking the rows one by one.
+                int skip = SkTMin(rows.fTop, SkFixedFloorToInt(currE->fLowerY)) - (iy + 1);
+                if (skip > 0) {
+                    iy    += skip;
+                    nextX += currE->fDX * skip;
+                }
+            }
+
             while (true) { // process the full rows in the middle
                 iy++;
                 SkFixed y = SkIntToFixed(iy);
@@ -301,6 +280,10 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
                     break; // no full rows left, break
                 }
 
+                if (isBanded && iy >= rows.fBottom) {
+                    break; // the rest of the rows are below the band
+                }
+
                 // Check whether we're in the rect part that will be covered by blitAntiRect
                 if (iy >= rectTop && iy < rectBot) {
                     SkASSERT(currE->fDX == 0);  // If yes, we must be on an edge with fDX = 0.
@@ -314,7 +297,7 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
 
             // last partial row
             if (SkIntToFixed(iy) < currE->fLowerY &&
-                    iy >= clippedIR.fTop && iy < clippedIR.fBottom) {
+                    iy >= rows.fTop && iy < rows.fBottom) {
                 rowHeight = currE->fLowerY - SkIntToFixed(iy);
                 nextX = currE->fX + SkFixedMul(currE->fDX, rowHeight);
                 add_coverage_delta_segment<true>(iy, rowHeight, currE, nextX, &result);
@@ -324,8 +307,122 @@ void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRec
     }
 }
 
+// We don't want to sort more than SORT_THRESHOLD edges where the log(count) factor of the quick
+// sort may become a bottleneck; when there are so many edges, we're unlikely to make deltas sorted
+// anyway.
+static void sort_edges_in_x(SkBezier** list, int count) {
+    constexpr int SORT_THRESHOLD = 256;
+    if (count < SORT_THRESHOLD) {
+        XLessThan lessThan;
+        SkTQSort(list, list + count - 1, lessThan);
+    }
+}
+
+template<class Deltas> static SK_ALWAYS_INLINE
+void gen_alpha_deltas(const SkPath& path, const SkIRect& clippedIR, const SkIRect& clipBounds,
+        Deltas& result, SkBlitter* blitter, bool skipRect, bool pathContainedInClip) {
+    // 1. Build edges
+    SkBezierEdgeBuilder builder;
+    // We have to use clipBounds instead of clippedIR to build edges because of "canCullToTheRight":
+    // if the builder finds a right edge past the right clip, it won't build that right edge.
+    int  count = builder.buildEdges(path, pathContainedInClip ? nullptr : &clipBounds);
+
+    if (count == 0) {
+        return;
+    }
+    SkBezier** list = builder.bezierList();
+
+    // 2. Try to find the rect part because blitAntiRect is so much faster than blitCoverageDeltas
+    int rectTop = clippedIR.fBottom;   // the rect is initialized to be empty as top = bot
+    int rectBot = clippedIR.fBottom;
+    if (skipRect) {             // only find that rect is skipRect == true
+        YLessThan lessThan;     // sort edges in YX order
+        SkTQSort(list, list + count - 1, lessThan);
+        for(int i = 0; i < count - 1; ++i) {
+            SkBezier* lb = list[i];
+            SkBezier* rb = list[i + 1];
+
+            // fCount == 2 ensures that lb and rb are lines instead of quads or cubics.
+            bool lDX0 = lb->fP0.fX == lb->fP1.fX && lb->fCount == 2;
+            bool rDX0 = rb->fP0.fX == rb->fP1.fX && rb->fCount == 2;
+            if (!lDX0 || !rDX0) { // make sure that the edges are vertical
+                continue;
+            }
+
+            SkAnalyticEdge l, r;
+            if (!l.setLine(lb->fP0, lb->fP1) || !r.setLine(rb->fP0, rb->fP1)) {
+                continue;
+            }
+
+            SkFixed xorUpperY = l.fUpperY ^ r.fUpperY;
+            SkFixed xorLowerY = l.fLowerY ^ r.fLowerY;
+            if ((xorUpperY | xorLowerY) == 0) { // equal upperY and lowerY
+                rectTop = SkFixedCeilToInt(l.fUpperY);
+                rectBot = SkFixedFloorToInt(l.fLowerY);
+                if (rectBot > rectTop) { // if bot == top, the rect is too short for blitAntiRect
+                    int L = SkFixedCeilToInt(l.fUpperX);
+                    int R = SkFixedFloorToInt(r.fUpperX);
+                    if (L <= R) {
+                        SkAlpha la = (SkIntToFixed(L) - l.fUpperX) >> 8;
+                        SkAlpha ra = (r.fUpperX - SkIntToFixed(R)) >> 8;
+                        result.setAntiRect(L - 1, rectTop, R - L, rectBot - rectTop, la, ra);
+                    } else { // too thin to use blitAntiRect; reset the rect region to be emtpy
+                        rectTop = rectBot = clippedIR.fBottom;
+                    }
+                }
+                break;
+            }
+
+        }
+    }
+
+    // 3. Sort edges in x so we may need less sorting for delta based on x. This only helps
+    //    SkCoverageDeltaList.
+    if (std::is_same<Deltas, SkCoverageDeltaList>::value) {
+        sort_edges_in_x(list, count);
+    }
+
+    // 4. iterate through edges and generate deltas
+    add_edge_deltas<false>(list, count, clippedIR, rectTop, rectBot, result);
+}
+
+// Like gen_alpha_deltas into a SkCoverageDeltaList, but clippedIR is split into horizontal bands,
+// each with its own list, and the bands are generated in parallel. Every band walks the same edges
+// in the same order, so each row gets exactly the deltas that gen_alpha_deltas would give it.
+// There's no anti-rect, so this is only used when skipRect is false.
+static void gen_alpha_deltas_in_bands(const SkPath& path, const SkIRect& clipBounds,
+        SkCoverageDeltaList* bands[], int bandCount, bool pathContainedInClip) {
+    SkBezierEdgeBuilder builder;
+    int  count = builder.buildEdges(path, pathContainedInClip ? nullptr : &clipBounds);
+
+    if (count == 0) {
+        return;
+    }
+    SkBezier** list = builder.bezierList();
+    sort_edges_in_x(list, count);
+
+    SkTaskGroup().batch(bandCount, [&](int i) {
+        SkCoverageDeltaList* band = bands[i];
+        SkIRect rows = SkIRect::MakeLTRB(band->left(), band->top(), band->right(), band->bottom());
+        add_edge_deltas<true>(list, count, rows, rows.fBottom, rows.fBottom, *band);
+    });
+}
+
+// Return how many bands gen_alpha_deltas_in_bands should split clippedIR into, or 1 if the path
+// isn't worth splitting.
+static int band_count(const SkPath& path, const SkIRect& clippedIR, int threads) {
+    constexpr int MIN_BAND_POINTS = 256;    // smaller paths don't pay for the threading overhead
+    constexpr int MIN_BAND_HEIGHT = 32;     // shorter bands spend more time skipping edges
+
+    if (threads <= 1 || path.countPoints() < MIN_BAND_POINTS) {
+        return 1;
+    }
+    return SkTMax(1, SkTMin(threads, clippedIR.height() / MIN_BAND_HEIGHT));
+}
+
 void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& ir,
-                         const SkIRect& clipBounds, bool forceRLE, SkDAARecord* record) {
+                         const SkIRect& clipBounds, bool forceRLE, SkDAARecord* record,
+                         int threads) {
     bool containedInClip = clipBounds.contains(ir);
     bool isEvenOdd  = path.getFillType() & 1;
     bool isConvex   = path.isConvex();
@@ -355,6 +452,29 @@ void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect&
     // phase because the same record could be accessed by multiple threads simultaneously.
     SkArenaAlloc* alloc = isInitOnce ? record->fAlloc : &stackAlloc;
 
+    // Huge paths may be split into bands that generate their deltas in parallel. We don't do that
+    // with a record because the threaded backend already generates deltas out of order.
+    int bandCount = record || skipRect ? 1 : band_count(path, clippedIR, threads);
+    if (bandCount > 1 && (forceRLE || isInverse || !SkCoverageDeltaMask::Suitable(clippedIR))) {
+        SkCoverageDeltaList** bands = alloc->makeArrayDefault<SkCoverageDeltaList*>(bandCount);
+        for (int i = 0; i < bandCount; ++i) {
+            int top    = clippedIR.fTop + clippedIR.height() *  i      / bandCount;
+            int bottom = clippedIR.fTop + clippedIR.height() * (i + 1) / bandCount;
+            // Give each band its own arena, big enough for INIT_ROW_SIZE deltas on every row.
+            size_t rowSize = SkCoverageDeltaList::INIT_ROW_SIZE * sizeof(SkCoverageDelta) +
+                             sizeof(SkCoverageDelta*) + sizeof(bool) + 2 * sizeof(int);
+            SkArenaAlloc* bandAlloc = alloc->make<SkArenaAlloc>((bottom - top) * rowSize + 64);
+            bands[i] = bandAlloc->make<SkCoverageDeltaList>(
+                    bandAlloc, SkIRect::MakeLTRB(clippedIR.fLeft, top, clippedIR.fRight, bottom),
+                    forceRLE);
+        }
+        gen_alpha_deltas_in_bands(path, clipBounds, bands, bandCount, containedInClip);
+        for (int i = 0; i < bandCount; ++i) {
+            blitter->blitCoverageDeltas(bands[i], clipBounds, isEvenOdd, isInverse, isConvex);
+        }
+        return;
+    }
+
     if (record == nullptr) {
         record = alloc->make<SkDAARecord>(alloc);
     }
@@ -391,3 +511,14 @@ void SkScan::DAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect&
     }
 }
 #endif //defined(SK_DISABLE_DAA)
+
+void SkScan::DAAFillPathForTesting(const SkPath& path, const SkIRect& clip, SkBlitter* blitter,
+                                   int threads) {
+    SkIRect ir = path.getBounds().roundOut();
+    SkRectClipBlitter clipper;
+    if (!clip.contains(ir)) {
+        clipper.init(blitter, clip);
+        blitter = &clipper;
+    }
+    DAAFillPath(path, blitter, ir, clip, false, nullptr, threads);
+}
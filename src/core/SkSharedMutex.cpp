@@ -343,9 +343,10 @@
     void SkSharedMutex::releaseShared() {
         ANNOTATE_RWLOCK_RELEASED(this, 0);
 
-        // Decrement the shared count.
+        // Decrement the shared count. This acquires too, so that the last shared thread to leave
+        // passes on what the others did to the exclusive waiter it signals.
         int32_t oldQueueCounts = fQueueCounts.fetch_sub(1 << kSharedOffset,
-                                                        std::memory_order_release);
+                                                        std::memory_order_acq_rel);
 
         // If shared count is going to zero (because the old count == 1) and there are exclusive
         // waiters, then run a single exclusive waiter.
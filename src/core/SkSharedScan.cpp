@@ -0,0 +1,232 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSharedScan.h"
+
+#include "SkBlitter.h"
+#include "SkRectPriv.h"
+#include "SkTemplates.h"
+
+// Records the calls a scan converter makes, copying anything they point to.
+class SkScanRecording::Recorder final : public SkBlitter {
+public:
+    Recorder(SkScanRecording* recording, int rowsPreserved)
+        : fRecording(recording)
+        , fRowsPreserved(rowsPreserved) {}
+
+    void blitH(int x, int y, int width) override {
+        this->add(OpType::kH, x, y, width, 1);
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        Op* op = this->add(OpType::kAntiH, x, y, 0, 1);
+        op->fData = fRecording->fRunCounts.count();
+        for (int i = 0; runs[i] > 0; i += runs[i]) {
+            fRecording->fRunCounts.push_back(runs[i]);
+            fRecording->fRunAlphas.push_back(antialias[i]);
+            op->fWidth += runs[i];
+        }
+        op->fRunCount = fRecording->fRunCounts.count() - op->fData;
+        fRecording->fMaxRunWidth = SkTMax(fRecording->fMaxRunWidth, op->fWidth);
+    }
+
+    void blitV(int x, int y, int height, SkAlpha alpha) override {
+        this->add(OpType::kV, x, y, 1, height)->fAlpha0 = alpha;
+    }
+
+    void blitRect(int x, int y, int width, int height) override {
+        this->add(OpType::kRect, x, y, width, height);
+    }
+
+    void blitAntiRect(int x, int y, int width, int height,
+                      SkAlpha leftAlpha, SkAlpha rightAlpha) override {
+        Op* op = this->add(OpType::kAntiRect, x, y, width, height);
+        op->fAlpha0 = leftAlpha;
+        op->fAlpha1 = rightAlpha;
+    }
+
+    void blitMask(const SkMask& mask, const SkIRect& clip) override {
+        Op* op = this->add(OpType::kMask, clip.fLeft, clip.fTop, clip.width(), clip.height());
+        size_t size = mask.computeTotalImageSize();
+        op->fData = fRecording->fMaskImages.count();
+        op->fMask = mask;
+        op->fMask.fImage = nullptr;
+        op->fClip = clip;
+        memcpy(fRecording->fMaskImages.append(SkToInt(size)), mask.fImage, size);
+    }
+
+    void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override {
+        Op* op = this->add(OpType::kAntiH2, x, y, 2, 1);
+        op->fAlpha0 = SkToU8(a0);
+        op->fAlpha1 = SkToU8(a1);
+    }
+
+    void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override {
+        Op* op = this->add(OpType::kAntiV2, x, y, 1, 2);
+        op->fAlpha0 = SkToU8(a0);
+        op->fAlpha1 = SkToU8(a1);
+    }
+
+    // Scan converters only ask the blitter how many rows of runs to keep.
+    int requestRowsPreserved() const override { return fRowsPreserved; }
+
+private:
+    Op* add(OpType type, int x, int y, int width, int height) {
+        Op* op = fRecording->fOps.append();
+        *op = Op();
+        op->fType   = type;
+        op->fX      = x;
+        op->fY      = y;
+        op->fWidth  = width;
+        op->fHeight = height;
+        return op;
+    }
+
+    SkScanRecording* fRecording;
+    const int        fRowsPreserved;
+};
+
+void SkScanRecording::record(const SkPath& devPath, ScanProc proc, const SkRasterClip& clip,
+                             int rowsPreserved) {
+    this->reset();
+    Recorder recorder(this, rowsPreserved);
+    proc(devPath, clip, &recorder);
+}
+
+void SkScanRecording::replay(const SkIRect& rows, SkBlitter* blitter) const {
+    Replay({ fOps.begin(), fOps.count(), fRunCounts.begin(), fRunAlphas.begin(),
+             fMaskImages.begin(), fMaxRunWidth }, rows, blitter);
+}
+
+// A flattened recording is this header, then the ops, run counts, run alphas and mask images.
+namespace {
+struct FlatHeader {
+    int fOpCount;
+    int fRunCount;
+    int fMaskBytes;
+    int fMaxRunWidth;
+};
+}
+
+size_t SkScanRecording::flattenedSize() const {
+    return sizeof(FlatHeader) + fOps.bytes() + fRunCounts.bytes() + fRunAlphas.bytes() +
+           fMaskImages.bytes();
+}
+
+void SkScanRecording::flatten(void* buffer) const {
+    FlatHeader header = { fOps.count(), fRunCounts.count(), fMaskImages.count(), fMaxRunWidth };
+    char* dst = static_cast<char*>(buffer);
+    auto write = [&dst](const void* src, size_t size) {
+        sk_careful_memcpy(dst, src, size);
+        dst += size;
+    };
+    write(&header, sizeof(header));
+    write(fOps.begin(), fOps.bytes());
+    write(fRunCounts.begin(), fRunCounts.bytes());
+    write(fRunAlphas.begin(), fRunAlphas.bytes());
+    write(fMaskImages.begin(), fMaskImages.bytes());
+}
+
+void SkScanRecording::ReplayFlattened(const void* buffer, SkBlitter* blitter) {
+    static_assert(sizeof(FlatHeader) % alignof(Op) == 0, "");
+    const FlatHeader* header = static_cast<const FlatHeader*>(buffer);
+    const char* src = reinterpret_cast<const char*>(header + 1);
+    Ops ops;
+    ops.fOps = reinterpret_cast<const Op*>(src);
+    ops.fCount = header->fOpCount;
+    src += header->fOpCount * sizeof(Op);
+    ops.fRunCounts = reinterpret_cast<const int16_t*>(src);
+    src += header->fRunCount * sizeof(int16_t);
+    ops.fRunAlphas = reinterpret_cast<const SkAlpha*>(src);
+    src += header->fRunCount * sizeof(SkAlpha);
+    ops.fMaskImages = reinterpret_cast<const uint8_t*>(src);
+    ops.fMaxRunWidth = header->fMaxRunWidth;
+    Replay(ops, SkRectPriv::MakeILarge(), blitter);
+}
+
+void SkScanRecording::Replay(const Ops& ops, const SkIRect& rows, SkBlitter* blitter) {
+    // Blitters may write to the runs they're passed, so each replay gets its own copy.
+    SkAutoSTMalloc<256, int16_t> runs(ops.fMaxRunWidth + 1);
+    SkAutoSTMalloc<256, SkAlpha> aa(ops.fMaxRunWidth + 1);
+    for (int i = 0; i < ops.fCount; i++) {
+        const Op& op = ops.fOps[i];
+        if (op.fY < rows.fBottom && op.fY + op.fHeight > rows.fTop) {
+            Replay(ops, op, blitter, runs.get(), aa.get());
+        }
+    }
+}
+
+void SkScanRecording::Replay(const Ops& ops, const Op& op, SkBlitter* blitter,
+                             int16_t runs[], SkAlpha aa[]) {
+    switch (op.fType) {
+        case OpType::kH:
+            blitter->blitH(op.fX, op.fY, op.fWidth);
+            break;
+        case OpType::kAntiH: {
+            int x = 0;
+            for (int i = op.fData; i < op.fData + op.fRunCount; i++) {
+                runs[x] = ops.fRunCounts[i];
+                aa[x] = ops.fRunAlphas[i];
+                x += ops.fRunCounts[i];
+            }
+            runs[x] = 0;
+            blitter->blitAntiH(op.fX, op.fY, aa, runs);
+        } break;
+        case OpType::kV:
+            blitter->blitV(op.fX, op.fY, op.fHeight, op.fAlpha0);
+            break;
+        case OpType::kRect:
+            blitter->blitRect(op.fX, op.fY, op.fWidth, op.fHeight);
+            break;
+        case OpType::kAntiRect:
+            blitter->blitAntiRect(op.fX, op.fY, op.fWidth, op.fHeight, op.fAlpha0, op.fAlpha1);
+            break;
+        case OpType::kMask: {
+            SkMask mask = op.fMask;
+            mask.fImage = const_cast<uint8_t*>(ops.fMaskImages) + op.fData;
+            blitter->blitMask(mask, op.fClip);
+        } break;
+        case OpType::kAntiH2:
+            blitter->blitAntiH2(op.fX, op.fY, op.fAlpha0, op.fAlpha1);
+            break;
+        case OpType::kAntiV2:
+            blitter->blitAntiV2(op.fX, op.fY, op.fAlpha0, op.fAlpha1);
+            break;
+    }
+}
+
+void SkScanRecording::reset() {
+    fOps.reset();
+    fRunCounts.reset();
+    fRunAlphas.reset();
+    fMaskImages.reset();
+    fMaxRunWidth = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool SkSharedScan::draw(const SkPath& devPath, ScanProc proc, const SkRasterClip& clip,
+                        const SkIRect& rows, SkBlitter* blitter) {
+    fOnce([&] {
+        fPath = devPath;
+        fProc = proc;
+        fClip = &clip;
+        fRecording.record(devPath, proc, clip, blitter->requestRowsPreserved());
+    });
+    if (proc != fProc || &clip != fClip || devPath != fPath) {
+        return false;
+    }
+    fRecording.replay(rows, blitter);
+    return true;
+}
+
+void SkSharedScan::done() {
+    if (fUsers.fetch_add(-1, std::memory_order_acq_rel) == 1) {
+        fPath.reset();
+        fRecording.reset();
+    }
+}
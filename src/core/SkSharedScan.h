@@ -0,0 +1,125 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSharedScan_DEFINED
+#define SkSharedScan_DEFINED
+
+#include "SkMask.h"
+#include "SkNoncopyable.h"
+#include "SkOnce.h"
+#include "SkPath.h"
+#include "SkTDArray.h"
+#include <atomic>
+
+class SkBlitter;
+class SkRasterClip;
+
+/**
+ *  The blitter calls scan converting one device path makes, recorded so they can be replayed
+ *  exactly, all of them or just those touching some rows.  A recording can be flattened into
+ *  one block of memory and replayed from there too.
+ */
+class SkScanRecording : SkNoncopyable {
+public:
+    using ScanProc = void (*)(const SkPath&, const SkRasterClip&, SkBlitter*);
+
+    /**
+     *  Records the calls proc(devPath, clip, blitter) makes, for a blitter that asks for
+     *  rowsPreserved rows (see SkBlitter::requestRowsPreserved()).
+     */
+    void record(const SkPath& devPath, ScanProc proc, const SkRasterClip& clip,
+                int rowsPreserved);
+
+    // Makes the recorded calls that touch the rows of rows.
+    void replay(const SkIRect& rows, SkBlitter*) const;
+
+    size_t flattenedSize() const;
+    void flatten(void* buffer) const;
+
+    // Makes all the calls of a recording flattened into buffer.
+    static void ReplayFlattened(const void* buffer, SkBlitter*);
+
+    void reset();
+
+private:
+    class Recorder;
+
+    enum class OpType {
+        kH, kAntiH, kV, kRect, kAntiRect, kMask, kAntiH2, kAntiV2,
+    };
+
+    // kAntiH's runs are the fRunCount entries of the run counts and alphas from fData.  kMask's
+    // image is in the mask images from fData, and fMask (with no image) and fClip are its
+    // arguments.
+    struct Op {
+        OpType  fType;
+        int     fX, fY;
+        int     fWidth, fHeight;    // fHeight counts the rows the call touches.
+        SkAlpha fAlpha0, fAlpha1;
+        int     fData;
+        int     fRunCount;
+        SkMask  fMask;
+        SkIRect fClip;
+    };
+
+    // Recorded calls, in our arrays or in a flattened buffer.
+    struct Ops {
+        const Op*       fOps;
+        int             fCount;
+        const int16_t*  fRunCounts;
+        const SkAlpha*  fRunAlphas;
+        const uint8_t*  fMaskImages;
+        int             fMaxRunWidth;
+    };
+
+    static void Replay(const Ops&, const SkIRect& rows, SkBlitter*);
+    static void Replay(const Ops&, const Op&, SkBlitter*, int16_t runs[], SkAlpha aa[]);
+
+    SkTDArray<Op>       fOps;
+    SkTDArray<int16_t>  fRunCounts;
+    SkTDArray<SkAlpha>  fRunAlphas;
+    SkTDArray<uint8_t>  fMaskImages;
+    int                 fMaxRunWidth{0};
+};
+
+/**
+ *  The scan conversion of one device path, shared by the tiles of a threaded draw.  The first
+ *  tile to draw the path scan converts it once, recording the calls, and every tile replays
+ *  just the calls that touch its own rows.  Replayed calls are exactly the calls the scan
+ *  converter makes, so tiles draw the same pixels as a serial draw, without each one scan
+ *  converting the whole path.
+ */
+class SkSharedScan : SkNoncopyable {
+public:
+    using ScanProc = SkScanRecording::ScanProc;
+
+    // users is how many tiles will call done().
+    explicit SkSharedScan(int users) : fUsers(users) {}
+
+    /**
+     *  Makes the blitter calls proc(devPath, clip, blitter) would, limited to those touching the
+     *  rows of rows.  Returns false, drawing nothing, if the shared calls were recorded for a
+     *  different path, proc or clip: each SkSharedScan records just one scan.
+     */
+    bool draw(const SkPath& devPath, ScanProc proc, const SkRasterClip& clip,
+              const SkIRect& rows, SkBlitter* blitter);
+
+    // Each user calls this once it's done drawing.  The last one frees the recorded calls.
+    void done();
+
+private:
+    SkOnce              fOnce;
+    std::atomic<int>    fUsers;
+
+    // Written once by the first draw(), then only read until done() frees them.
+    SkPath              fPath;
+    ScanProc            fProc{nullptr};
+    const SkRasterClip* fClip{nullptr};
+    SkScanRecording     fRecording;
+};
+
+#endif
@@ -7,26 +7,66 @@
 
 #include "SkStrike.h"
 
+#include "SkExecutor.h"
 #include "SkGraphics.h"
 #include "SkMakeUnique.h"
 #include "SkMutex.h"
 #include "SkOnce.h"
 #include "SkPath.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTypeface.h"
+#include <algorithm>
 #include <cctype>
 
 namespace {
 size_t compute_path_size(const SkPath& path) {
     return sizeof(SkPath) + path.countPoints() * sizeof(SkPoint);
 }
+
+// Strikes that only one thread uses at a time don't pay for locking.
+class AutoSharedLock : SkNoncopyable {
+public:
+    AutoSharedLock(SkSharedMutex& lock, bool shared) : fLock(shared ? &lock : nullptr) {
+        if (fLock) {
+            fLock->acquireShared();
+        }
+    }
+    ~AutoSharedLock() {
+        if (fLock) {
+            fLock->releaseShared();
+        }
+    }
+
+private:
+    SkSharedMutex* fLock;
+};
+
+class AutoExclusiveLock : SkNoncopyable {
+public:
+    AutoExclusiveLock(SkSharedMutex& lock, bool shared) : fLock(shared ? &lock : nullptr) {
+        if (fLock) {
+            fLock->acquire();
+        }
+    }
+    ~AutoExclusiveLock() {
+        if (fLock) {
+            fLock->release();
+        }
+    }
+
+private:
+    SkSharedMutex* fLock;
+};
 }  // namespace
 
 SkStrike::SkStrike(
     const SkDescriptor& desc,
     std::unique_ptr<SkScalerContext> scaler,
-    const SkFontMetrics& fontMetrics)
-    : fDesc{desc}
+    const SkFontMetrics& fontMetrics,
+    bool shared)
+    : fShared{shared}
+    , fDesc{desc}
     , fScalerContext{std::move(scaler)}
     , fFontMetrics{fontMetrics}
     , fIsSubpixel{fScalerContext->isSubpixel()}
@@ -36,6 +76,24 @@ SkStrike::SkStrike(
     fMemoryUsed = sizeof(*this);
 }
 
+void SkStrike::setFileCache(sk_sp<SkGlyphFileCache> fileCache) {
+    SkASSERT(fGlyphMap.count() == 0);
+    if (fileCache) {
+        fFileStrikeID = fileCache->findOrAddStrike(*fDesc.getDesc(),
+                                                   *fScalerContext->getTypeface());
+    }
+    fFileCache = fFileStrikeID >= 0 ? std::move(fileCache) : nullptr;
+}
+
+void SkStrike::setManifest(sk_sp<SkStrikeManifest> manifest) {
+    SkASSERT(fGlyphMap.count() == 0);
+    if (manifest) {
+        fManifestStrikeID = manifest->findOrAddStrike(*fDesc.getDesc(),
+                                                      *fScalerContext->getTypeface());
+    }
+    fManifest = fManifestStrikeID >= 0 ? std::move(manifest) : nullptr;
+}
+
 const SkDescriptor& SkStrike::getDescriptor() const {
     return *fDesc.getDesc();
 }
@@ -51,11 +109,13 @@ unsigned SkStrike::getGlyphCount() const {
 }
 
 int SkStrike::countCachedGlyphs() const {
+    AutoSharedLock lock(fLock, fShared);
     return fGlyphMap.count();
 }
 
 bool SkStrike::isGlyphCached(SkGlyphID glyphID, SkFixed x, SkFixed y) const {
     SkPackedGlyphID packedGlyphID{glyphID, x, y};
+    AutoSharedLock lock(fLock, fShared);
     return fGlyphMap.find(packedGlyphID) != nullptr;
 }
 
@@ -89,6 +149,16 @@ void SkStrike::getAdvances(SkSpan<const SkGlyphID> glyphIDs, SkPoint advances[])
 }
 
 SkGlyph* SkStrike::lookupByPackedGlyphID(SkPackedGlyphID packedGlyphID, MetricsType type) {
+    // Most lookups find a glyph with all they need, and only have to share the lock.
+    if (fShared) {
+        AutoSharedLock lock(fLock, fShared);
+        SkGlyph* glyphPtr = fGlyphMap.findOrNull(packedGlyphID);
+        if (glyphPtr != nullptr && (type != kFull_MetricsType || !glyphPtr->isJustAdvance())) {
+            return glyphPtr;
+        }
+    }
+
+    AutoExclusiveLock lock(fLock, fShared);
     SkGlyph* glyphPtr = fGlyphMap.findOrNull(packedGlyphID);
 
     if (glyphPtr == nullptr) {
@@ -104,31 +174,92 @@ SkGlyph* SkStrike::lookupByPackedGlyphID(SkPackedGlyphID packedGlyphID, MetricsT
             case kNothing_MetricsType:
                 break;
             case kJustAdvance_MetricsType:
-                fScalerContext->getAdvance(glyphPtr);
+                this->getAdvance(glyphPtr);
                 break;
             case kFull_MetricsType:
-                fScalerContext->getMetrics(glyphPtr);
+                this->getMetrics(glyphPtr);
                 break;
         }
     } else {
         // Glyph is present in strike. Make sure the glyph has the right data.
 
         if (type == kFull_MetricsType && glyphPtr->isJustAdvance()) {
-            fScalerContext->getMetrics(glyphPtr);
+            this->getMetrics(glyphPtr);
         }
     }
 
     return glyphPtr;
 }
 
+void SkStrike::getAdvance(SkGlyph* glyph) {
+    // The file only keeps full metrics, which are as good as an advance, and which some scaler
+    // contexts compute to get one.
+    if (fFileCache == nullptr) {
+        fScalerContext->getAdvance(glyph);
+    } else if (!fFileCache->findMetrics(fFileStrikeID, glyph)) {
+        fScalerContext->getAdvance(glyph);
+        if (glyph->isFullMetrics()) {
+            fFileCache->addMetrics(fFileStrikeID, *glyph);
+        }
+    }
+    this->recordUse(*glyph, SkStrikeManifest::kMetrics_Use);
+}
+
+void SkStrike::getMetrics(SkGlyph* glyph) {
+    if (fFileCache == nullptr) {
+        fScalerContext->getMetrics(glyph);
+    } else if (!fFileCache->findMetrics(fFileStrikeID, glyph)) {
+        fScalerContext->getMetrics(glyph);
+        fFileCache->addMetrics(fFileStrikeID, *glyph);
+    }
+    this->recordUse(*glyph, SkStrikeManifest::kMetrics_Use);
+}
+
+void SkStrike::getMetrics(SkSpan<SkGlyph*> glyphs) {
+    for (const SkGlyph* glyph : glyphs) {
+        this->recordUse(*glyph, SkStrikeManifest::kMetrics_Use);
+    }
+    if (fFileCache != nullptr) {
+        size_t missingCount = 0;
+        for (SkGlyph* glyph : glyphs) {
+            if (!fFileCache->findMetrics(fFileStrikeID, glyph)) {
+                glyphs[missingCount++] = glyph;
+            }
+        }
+        glyphs = glyphs.first(missingCount);
+    }
+    if (glyphs.empty()) {
+        return;
+    }
+    fScalerContext->getMetrics(glyphs);
+    if (fFileCache != nullptr) {
+        for (const SkGlyph* glyph : glyphs) {
+            fFileCache->addMetrics(fFileStrikeID, *glyph);
+        }
+    }
+}
+
 const void* SkStrike::findImage(const SkGlyph& glyph) {
     if (glyph.fWidth > 0 && glyph.fWidth < kMaxGlyphWidth) {
+        if (fShared) {
+            AutoSharedLock lock(fLock, fShared);
+            if (glyph.fImage != nullptr) {
+                return glyph.fImage;
+            }
+        }
+        AutoExclusiveLock lock(fLock, fShared);
         if (nullptr == glyph.fImage) {
             SkDEBUGCODE(SkMask::Format oldFormat = (SkMask::Format)glyph.fMaskFormat);
             size_t  size = const_cast<SkGlyph&>(glyph).allocImage(&fAlloc);
             // check that alloc() actually succeeded
             if (glyph.fImage) {
-                fScalerContext->getImage(glyph);
+                this->recordUse(glyph, SkStrikeManifest::kImage_Use);
+                if (fFileCache == nullptr) {
+                    fScalerContext->getImage(glyph);
+                } else if (!fFileCache->findImage(fFileStrikeID, glyph)) {
+                    fScalerContext->getImage(glyph);
+                    fFileCache->addImage(fFileStrikeID, glyph);
+                }
                 // TODO: the scaler may have changed the maskformat during
                 // getImage (e.g. from AA or LCD to BW) which means we may have
                 // overallocated the buffer. Check if the new computedImageSize
@@ -137,13 +268,87 @@ const void* SkStrike::findImage(const SkGlyph& glyph) {
             }
             SkASSERT(oldFormat == glyph.fMaskFormat);
         }
+        return glyph.fImage;
     }
     return glyph.fImage;
 }
 
+// Batches with fewer images than this per thread aren't worth splitting, as each thread past the
+// first needs its own scaler context, and makes one the first time.
+static constexpr int kMinParallelImages = 16;
+
+void SkStrike::prepareImages(SkSpan<const SkGlyphPos> glyphs, SkExecutor* executor, int threads) {
+    auto needs_image = [](const SkGlyphPos& glyphPos) {
+        const SkGlyph& glyph = *glyphPos.glyph;
+        return glyph.fImage == nullptr && glyph.fWidth > 0 && glyph.fWidth < kMaxGlyphWidth;
+    };
+    if (fShared) {
+        AutoSharedLock lock(fLock, fShared);
+        if (std::none_of(glyphs.begin(), glyphs.end(), needs_image)) {
+            return;
+        }
+    }
+
+    AutoExclusiveLock lock(fLock, fShared);
+    SkSTArray<64, const SkGlyph*> missing;
+    for (const SkGlyphPos& glyphPos : glyphs) {
+        if (needs_image(glyphPos)) {
+            SkGlyph* glyph = const_cast<SkGlyph*>(glyphPos.glyph);
+            size_t size = glyph->allocImage(&fAlloc);
+            if (glyph->fImage) {
+                fMemoryUsed += size;
+                this->recordUse(*glyph, SkStrikeManifest::kImage_Use);
+                if (fFileCache == nullptr || !fFileCache->findImage(fFileStrikeID, *glyph)) {
+                    missing.push_back(glyph);
+                }
+            }
+        }
+    }
+    if (missing.empty()) {
+        return;
+    }
+
+    // Splitting the batch costs the port's batching, so we only do it when images are made
+    // mostly outside the port anyway. Shared strikes never split: waiting on the batch with fLock
+    // held may run another task on this thread that wants this strike, and that would deadlock.
+    int parts = fParallelImages && !fShared && executor && !fScalerContext->batchesImages()
+              ? SkTMin(threads, missing.count() / kMinParallelImages) : 1;
+    if (parts <= 1) {
+        fScalerContext->getImages(SkSpan<const SkGlyph*>{missing.begin(), missing.size()});
+    } else {
+        if (fPartScalerContexts.size() < SkTo<size_t>(parts - 1)) {
+            fPartScalerContexts.resize(parts - 1);
+        }
+        SkTaskGroup(*executor).batch(parts, [&](int i) {
+            int begin = missing.count() *  i      / parts,
+                end   = missing.count() * (i + 1) / parts;
+            SkSpan<const SkGlyph*> part{missing.begin() + begin, SkTo<size_t>(end - begin)};
+            if (i == 0) {
+                fScalerContext->getImages(part);
+            } else {
+                // The scaler context is not thread safe, but an identical one makes identical
+                // images.  Each part owns its slot, so tasks can fill them in concurrently.
+                std::unique_ptr<SkScalerContext>& scaler = fPartScalerContexts[i - 1];
+                if (scaler == nullptr) {
+                    scaler = fScalerContext->getTypeface()->createScalerContext(
+                            fScalerContext->getEffects(), &this->getDescriptor());
+                }
+                scaler->getImages(part);
+            }
+        });
+    }
+
+    if (fFileCache != nullptr) {
+        for (const SkGlyph* glyph : missing) {
+            fFileCache->addImage(fFileStrikeID, *glyph);
+        }
+    }
+}
+
 void SkStrike::initializeImage(const volatile void* data, size_t size, SkGlyph* glyph) {
     // Don't overwrite the image if we already have one. We could have used a fallback if the
     // glyph was missing earlier.
+    AutoExclusiveLock lock(fLock, fShared);
     if (glyph->fImage) return;
 
     if (glyph->fWidth > 0 && glyph->fWidth < kMaxGlyphWidth) {
@@ -161,6 +366,14 @@ const SkPath* SkStrike::findPath(const SkGlyph& glyph) {
 
     if (!glyph.isEmpty()) {
         // If the path already exists, return it.
+        if (fShared) {
+            AutoSharedLock lock(fLock, fShared);
+            if (glyph.fPathData != nullptr) {
+                return glyph.path();
+            }
+        }
+
+        AutoExclusiveLock lock(fLock, fShared);
         if (glyph.fPathData != nullptr) {
             if (glyph.fPathData->fHasPath) {
                 return &glyph.fPathData->fPath;
@@ -168,7 +381,25 @@ const SkPath* SkStrike::findPath(const SkGlyph& glyph) {
             return nullptr;
         }
 
-        const_cast<SkGlyph&>(glyph).addPath(fScalerContext.get(), &fAlloc);
+        this->recordUse(glyph, SkStrikeManifest::kPath_Use);
+        SkPath path;
+        bool hasPath;
+        if (fFileCache != nullptr
+            && fFileCache->findPath(fFileStrikeID, glyph.getPackedID(), &path, &hasPath)) {
+            SkGlyph::PathData* pathData = fAlloc.make<SkGlyph::PathData>();
+            const_cast<SkGlyph&>(glyph).fPathData = pathData;
+            if (hasPath) {
+                pathData->fPath = std::move(path);
+                pathData->fPath.updateBoundsCache();
+                pathData->fPath.getGenerationID();
+                pathData->fHasPath = true;
+            }
+        } else {
+            const_cast<SkGlyph&>(glyph).addPath(fScalerContext.get(), &fAlloc);
+            if (fFileCache != nullptr) {
+                fFileCache->addPath(fFileStrikeID, glyph.getPackedID(), glyph.path());
+            }
+        }
         if (glyph.fPathData != nullptr) {
             fMemoryUsed += compute_path_size(glyph.fPathData->fPath);
         }
@@ -182,6 +413,7 @@ const SkPath* SkStrike::findPath(const SkGlyph& glyph) {
 bool SkStrike::initializePath(SkGlyph* glyph, const volatile void* data, size_t size) {
     // Don't overwrite the path if we already have one. We could have used a fallback if the
     // glyph was missing earlier.
+    AutoExclusiveLock lock(fLock, fShared);
     if (glyph->fPathData) return true;
 
     if (glyph->fWidth) {
@@ -221,36 +453,107 @@ void SkStrike::initializeGlyphFromFallback(SkGlyph* glyph, const SkGlyph& fallba
     fMemoryUsed += glyph->copyImageData(fallback, &fAlloc);
 }
 
+bool SkStrike::initializeFallbackGlyph(SkGlyph* glyph, SkStrike* target) const {
+    AutoSharedLock lock(fLock, fShared);
+    const SkGlyph* fallback = fGlyphMap.findOrNull(glyph->getPackedID());
+    if (fallback == nullptr) {
+        // Look for any sub-pixel pos for this glyph, in case there is a pos mismatch.
+        fallback = this->getCachedGlyphAnySubPix(glyph->getGlyphID());
+    }
+    if (fallback == nullptr) {
+        return false;
+    }
+    // We may disappear as soon as the caller is done with us, so this copies the glyph
+    // into target, including a deep copy of the mask.
+    target->initializeGlyphFromFallback(glyph, *fallback);
+    return true;
+}
+
+bool SkStrike::copyCachedPath(SkGlyphID glyphID, SkPath* path) const {
+    AutoSharedLock lock(fLock, fShared);
+    const SkGlyph* from = fGlyphMap.findOrNull(SkPackedGlyphID(glyphID));
+    if (from == nullptr || from->fPathData == nullptr) {
+        return false;
+    }
+    // We can just copy the path out by value here, so no need to worry about our lifetime.
+    *path = from->fPathData->fPath;
+    return true;
+}
+
 SkVector SkStrike::rounding() const {
     return SkStrikeCommon::PixelRounding(fIsSubpixel, fAxisAlignment);
 }
 
-const SkGlyph& SkStrike::getGlyphMetrics(SkGlyphID glyphID, SkPoint position) {
+SkPackedGlyphID SkStrike::packedGlyphID(SkGlyphID glyphID, SkPoint position) const {
     if (!fIsSubpixel) {
-        return this->getGlyphIDMetrics(glyphID);
+        return SkPackedGlyphID(glyphID);
     } else {
         SkIPoint lookupPosition = SkStrikeCommon::SubpixelLookup(fAxisAlignment, position);
 
-        return this->getGlyphIDMetrics(glyphID, lookupPosition.x(), lookupPosition.y());
+        return SkPackedGlyphID(glyphID, lookupPosition.x(), lookupPosition.y());
     }
 }
 
+const SkGlyph& SkStrike::getGlyphMetrics(SkGlyphID glyphID, SkPoint position) {
+    VALIDATE();
+    return *this->lookupByPackedGlyphID(this->packedGlyphID(glyphID, position),
+                                        kFull_MetricsType);
+}
+
 // N.B. This glyphMetrics call culls all the glyphs which will not display based on a non-finite
 // position or that there are no mask pixels.
 int SkStrike::glyphMetrics(const SkGlyphID glyphIDs[],
                  const SkPoint positions[],
                  int n,
                  SkGlyphPos result[]) {
+    // Look up every glyph first, leaving those without full metrics null to generate together.
+    SkAutoSTMalloc<64, SkPackedGlyphID> packedIDs(n);
+    int count = 0;
+    int missingCount = 0;
+    {
+        AutoSharedLock lock(fLock, fShared);
+        for (int i = 0; i < n; i++) {
+            SkPoint glyphPos = positions[i];
+            if (SkScalarsAreFinite(glyphPos.x(), glyphPos.y())) {
+                packedIDs[count] = this->packedGlyphID(glyphIDs[i], glyphPos);
+                SkGlyph* glyph = fGlyphMap.findOrNull(packedIDs[count]);
+                if (glyph == nullptr || glyph->isJustAdvance()) {
+                    glyph = nullptr;
+                    missingCount++;
+                }
+                result[count++] = {glyph, glyphPos};
+            }
+        }
+    }
 
-    int drawableGlyphCount = 0;
-    const SkPoint* posCursor = positions;
-    for (int i = 0; i < n; i++) {
-        SkPoint glyphPos = *posCursor++;
-        if (SkScalarsAreFinite(glyphPos.x(), glyphPos.y())) {
-            const SkGlyph& glyph = this->getGlyphMetrics(glyphIDs[i], glyphPos);
-            if (!glyph.isEmpty()) {
-                result[drawableGlyphCount++] = {&glyph, glyphPos};
+    if (missingCount > 0) {
+        AutoExclusiveLock lock(fLock, fShared);
+        SkAutoSTMalloc<64, SkGlyph*> toGenerate(missingCount);
+        int generateCount = 0;
+        for (int i = 0; i < count; i++) {
+            if (result[i].glyph != nullptr) {
+                continue;
             }
+            SkGlyph* glyph = fGlyphMap.findOrNull(packedIDs[i]);
+            if (glyph == nullptr) {
+                fMemoryUsed += sizeof(SkGlyph);
+                glyph = fAlloc.make<SkGlyph>(packedIDs[i]);
+                fGlyphMap.set(glyph);
+                toGenerate[generateCount++] = glyph;
+            } else if (glyph->isJustAdvance()) {
+                // No longer just an advance, so it's only generated once however often it repeats.
+                glyph->fMaskFormat = MASK_FORMAT_UNKNOWN;
+                toGenerate[generateCount++] = glyph;
+            }
+            result[i].glyph = glyph;
+        }
+        this->getMetrics(SkSpan<SkGlyph*>{toGenerate.get(), SkTo<size_t>(generateCount)});
+    }
+
+    int drawableGlyphCount = 0;
+    for (int i = 0; i < count; i++) {
+        if (!result[i].glyph->isEmpty()) {
+            result[drawableGlyphCount++] = result[i];
         }
     }
 
@@ -357,6 +660,7 @@ const SkGlyph::Intercept* SkStrike::MatchBounds(const SkGlyph* glyph,
 
 void SkStrike::findIntercepts(const SkScalar bounds[2], SkScalar scale, SkScalar xPos,
         bool yAxis, SkGlyph* glyph, SkScalar* array, int* count) {
+    AutoExclusiveLock lock(fLock, fShared);
     const SkGlyph::Intercept* match = MatchBounds(glyph, bounds);
 
     if (match) {
@@ -433,6 +737,7 @@ void SkStrike::dump() const {
     SkString name;
     face->getFamilyName(&name);
 
+    AutoSharedLock lock(fLock, fShared);
     SkString msg;
     SkFontStyle style = face->fontStyle();
     msg.printf("cache typeface:%x %25s:(%d,%d,%d)\n %s glyphs:%3d",
@@ -449,6 +754,7 @@ void SkStrike::onAboutToExitScope() { }
 
 #ifdef SK_DEBUG
 void SkStrike::forceValidate() const {
+    AutoSharedLock lock(fLock, fShared);
     size_t memoryUsed = sizeof(*this);
     fGlyphMap.foreach ([&memoryUsed](const SkGlyph* glyphPtr) {
         memoryUsed += sizeof(SkGlyph);
@@ -12,13 +12,20 @@
 #include "SkFontMetrics.h"
 #include "SkFontTypes.h"
 #include "SkGlyph.h"
+#include "SkGlyphFileCache.h"
 #include "SkGlyphRunPainter.h"
 #include "SkPaint.h"
 #include "SkTHash.h"
 #include "SkScalerContext.h"
+#include "SkSharedMutex.h"
 #include "SkStrikeInterface.h"
+#include "SkStrikeManifest.h"
 #include "SkTemplates.h"
+#include <atomic>
 #include <memory>
+#include <vector>
+
+class SkExecutor;
 
 /** \class SkGlyphCache
 
@@ -27,17 +34,20 @@
     return the requested glyph, either instantly if it is already cached, or by first generating
     it and then adding it to the strike.
 
-    The strikes are held in a global list, available to all threads. To interact with one, call
+    The strikes are held in a global cache, available to all threads. To interact with one, call
     either Find{OrCreate}Exclusive().
 
-    The Find*Exclusive() method returns SkExclusiveStrikePtr, which releases exclusive ownership
-    when they go out of scope.
+    The Find*Exclusive() method returns SkExclusiveStrikePtr, which hands the strike back to the
+    cache when it goes out of scope. If the strike is shared (see SkStrikeCache), other threads
+    may use it meanwhile, so lookups share a lock and adding glyphs, images or paths takes it
+    exclusively. Otherwise only one thread uses it at a time, and it doesn't lock.
 */
 class SkStrike final : public SkStrikeInterface {
 public:
     SkStrike(const SkDescriptor& desc,
              std::unique_ptr<SkScalerContext> scaler,
-             const SkFontMetrics&);
+             const SkFontMetrics&,
+             bool shared);
 
     /** Return true if glyph is cached. */
     bool isGlyphCached(SkGlyphID glyphID, SkFixed x, SkFixed y) const;
@@ -99,6 +109,8 @@ public:
     bool initializePath(SkGlyph*, const volatile void* data, size_t size);
 
     /** Fallback glyphs used during font remoting if the original glyph can't be found.
+     *  The remote scaler context calls these three back while generating a glyph, with this
+     *  strike already locked, so they don't lock it again.
      */
     bool belongsToCache(const SkGlyph* glyph) const;
     /** Find any glyph in this cache with the given ID, regardless of subpixel positioning.
@@ -108,6 +120,16 @@ public:
                                            SkPackedGlyphID vetoID = SkPackedGlyphID()) const;
     void initializeGlyphFromFallback(SkGlyph* glyph, const SkGlyph&);
 
+    /** Initialize glyph, from target, with our cached glyph of the same ID, preferring one at the
+        same sub-pixel position. Returns false if we have none.
+    */
+    bool initializeFallbackGlyph(SkGlyph* glyph, SkStrike* target) const;
+
+    /** Copy our cached path for glyphID at sub-pixel position (0,0). Returns false if we have
+        none.
+    */
+    bool copyCachedPath(SkGlyphID glyphID, SkPath* path) const;
+
     /** Return the vertical metrics for this strike.
     */
     const SkFontMetrics& getFontMetrics() const {
@@ -136,17 +158,47 @@ public:
                             this->getScalerContext()->getEffects()};
     }
 
+    /** Glyphs missing from the strike, or with only their advances, are generated together. */
     int glyphMetrics(const SkGlyphID[], const SkPoint[], int n, SkGlyphPos result[]) override;
 
+    /** Make sure each of the glyphs, which must have full metrics, has its image, generating any
+        that are missing together rather than one at a time as findImage() would. With an
+        executor and more than one thread, a big batch of images made from paths or mask filtered
+        is split in up to that many parts, generated in parallel each with its own scaler context,
+        if the strike allows it (see allowParallelImages()) and isn't shared.
+    */
+    void prepareImages(SkSpan<const SkGlyphPos> glyphs,
+                       SkExecutor* executor = nullptr, int threads = 1);
+
     void onAboutToExitScope() override;
 
     /** Return the approx RAM usage for this cache. */
-    size_t getMemoryUsed() const { return fMemoryUsed; }
+    size_t getMemoryUsed() const { return fMemoryUsed.load(std::memory_order_relaxed); }
 
     void dump() const;
 
     SkScalerContext* getScalerContext() const { return fScalerContext.get(); }
 
+    /** Whether several threads may use this strike at once. */
+    bool isShared() const { return fShared; }
+
+    /** Look for glyphs in fileCache before generating them, and add those it doesn't have. Call
+        before the strike is used.
+    */
+    void setFileCache(sk_sp<SkGlyphFileCache> fileCache);
+
+    /** Record the glyphs used, and whether their images and paths were, in manifest. Call before
+        the strike is used.
+    */
+    void setManifest(sk_sp<SkStrikeManifest> manifest);
+
+    /** Let prepareImages() split big batches across threads. The extra parts use scaler contexts
+        the strike makes from its typeface and keeps for later batches, so only allow this if a
+        new scaler context works on its own (pinned strikes, like remote ones, set theirs up by
+        hand). Call before the strike is used.
+    */
+    void allowParallelImages() { fParallelImages = true; }
+
 #ifdef SK_DEBUG
     void forceValidate() const;
     void validate() const;
@@ -191,6 +243,20 @@ private:
     // then x and y are assumed to be zero. Limit the amount of work using type.
     SkGlyph* lookupByPackedGlyphID(SkPackedGlyphID packedGlyphID, MetricsType type);
 
+    // Fill in the glyph's metrics from the file cache, or the scaler context.
+    void getAdvance(SkGlyph* glyph);
+    void getMetrics(SkGlyph* glyph);
+    // The same for a batch of glyphs. The strike must be locked exclusively.
+    void getMetrics(SkSpan<SkGlyph*> glyphs);
+
+    SkPackedGlyphID packedGlyphID(SkGlyphID glyphID, SkPoint position) const;
+
+    void recordUse(const SkGlyph& glyph, uint32_t uses) {
+        if (fManifest != nullptr) {
+            fManifest->addGlyph(fManifestStrikeID, glyph.getPackedID(), uses);
+        }
+    }
+
     static void OffsetResults(const SkGlyph::Intercept* intercept, SkScalar scale,
                               SkScalar xPos, SkScalar* array, int* count);
     static void AddInterval(SkScalar val, SkGlyph::Intercept* intercept);
@@ -205,10 +271,25 @@ private:
     static const SkGlyph::Intercept* MatchBounds(const SkGlyph* glyph,
                                                  const SkScalar bounds[2]);
 
+    // If shared, fLock guards fScalerContext, fGlyphMap, fAlloc and the glyphs in it.
+    const bool             fShared;
+    mutable SkSharedMutex  fLock;
+
     const SkAutoDescriptor fDesc;
     const std::unique_ptr<SkScalerContext> fScalerContext;
     SkFontMetrics          fFontMetrics;
 
+    sk_sp<SkGlyphFileCache> fFileCache;
+    int                     fFileStrikeID{-1};
+
+    sk_sp<SkStrikeManifest> fManifest;
+    int                     fManifestStrikeID{-1};
+
+    // prepareImages() generates part i > 0 of a split batch with fPartScalerContexts[i - 1],
+    // making it the first time it's needed. Guarded by fLock, held exclusively while they're used.
+    bool                                          fParallelImages{false};
+    std::vector<std::unique_ptr<SkScalerContext>> fPartScalerContexts;
+
     class GlyphMapHashTraits {
     public:
         static SkPackedGlyphID GetKey(const SkGlyph* glyph) {
@@ -232,7 +313,7 @@ private:
     SkArenaAlloc            fAlloc {kMinAllocAmount};
 
     // used to track (approx) how much ram is tied-up in this cache
-    size_t                  fMemoryUsed;
+    std::atomic<size_t>     fMemoryUsed;
 
     const bool              fIsSubpixel;
     const SkAxisAlignment   fAxisAlignment;
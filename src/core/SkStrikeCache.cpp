@@ -13,6 +13,7 @@
 #include "SkGraphics.h"
 #include "SkMutex.h"
 #include "SkStrike.h"
+#include "SkTArray.h"
 #include "SkTemplates.h"
 #include "SkTraceMemoryDump.h"
 #include "SkTypeface.h"
@@ -25,8 +26,14 @@ public:
          const SkFontMetrics& metrics,
          std::unique_ptr<SkStrikePinner> pinner)
             : fStrikeCache{strikeCache}
-            , fStrike{desc, std::move(scaler), metrics}
-            , fPinner{std::move(pinner)} {}
+            , fStrike{desc, std::move(scaler), metrics, strikeCache->fShareStrikes && pinner == nullptr}
+            , fPinner{std::move(pinner)} {
+        if (fPinner == nullptr) {
+            fStrike.setFileCache(strikeCache->refFileCache());
+            fStrike.setManifest(strikeCache->refManifest());
+            fStrike.allowParallelImages();
+        }
+    }
 
     SkVector rounding() const override {
         return fStrike.rounding();
@@ -55,7 +62,16 @@ public:
     }
 
     void onAboutToExitScope() override {
-        fStrikeCache->attachNode(this);
+        fStrikeCache->releaseNode(this);
+    }
+
+    // Whether another user may be handed this strike, or if exclusive, be its only user.
+    // Requires the shard's lock.
+    bool isAvailable(bool exclusive = false) const {
+        if (exclusive) {
+            return !fStrike.isShared() && fUsers == 0;
+        }
+        return fStrike.isShared() || fUsers == 0;
     }
 
     SkStrikeCache* const            fStrikeCache;
@@ -63,10 +79,18 @@ public:
     Node*                           fPrev{nullptr};
     SkStrike                        fStrike;
     std::unique_ptr<SkStrikePinner> fPinner;
+    // These are guarded by the shard's lock. fMemoryCounted is how much of fStrike's memory is
+    // counted in fTotalMemoryUsed, brought up to date as users are done with it. fLastUsed
+    // orders nodes of different shards the way each shard's list orders its own.
+    int                             fUsers{1};
+    size_t                          fMemoryCounted{0};
+    uint64_t                        fLastUsed{0};
 };
 
+std::atomic<bool> gSkShareStrikes{false};
+
 SkStrikeCache* SkStrikeCache::GlobalStrikeCache() {
-    static auto* cache = new SkStrikeCache;
+    static auto* cache = new SkStrikeCache(gSkShareStrikes);
     return cache;
 }
 
@@ -84,7 +108,7 @@ SkStrikeCache::ExclusiveStrikePtr::ExclusiveStrikePtr(ExclusiveStrikePtr&& o)
 SkStrikeCache::ExclusiveStrikePtr&
 SkStrikeCache::ExclusiveStrikePtr::operator = (ExclusiveStrikePtr&& o) {
     if (fNode != nullptr) {
-        fNode->fStrikeCache->attachNode(fNode);
+        fNode->fStrikeCache->releaseNode(fNode);
     }
     fNode = o.fNode;
     o.fNode = nullptr;
@@ -93,7 +117,7 @@ SkStrikeCache::ExclusiveStrikePtr::operator = (ExclusiveStrikePtr&& o) {
 
 SkStrikeCache::ExclusiveStrikePtr::~ExclusiveStrikePtr() {
     if (fNode != nullptr) {
-        fNode->fStrikeCache->attachNode(fNode);
+        fNode->fStrikeCache->releaseNode(fNode);
     }
 }
 
@@ -127,11 +151,13 @@ bool operator == (decltype(nullptr), const SkStrikeCache::ExclusiveStrikePtr& rh
 }
 
 SkStrikeCache::~SkStrikeCache() {
-    Node* node = fHead;
-    while (node) {
-        Node* next = node->fNext;
-        delete node;
-        node = next;
+    for (Shard& shard : fShards) {
+        Node* node = shard.fHead;
+        while (node) {
+            Node* next = node->fNext;
+            delete node;
+            node = next;
+        }
     }
 }
 
@@ -171,10 +197,12 @@ SkExclusiveStrikePtr SkStrikeCache::findOrCreateStrikeExclusive(
 auto SkStrikeCache::findOrCreateStrike(const SkDescriptor& desc,
                                        const SkScalerContextEffects& effects,
                                        const SkTypeface& typeface) -> Node* {
-    Node* node = this->findAndDetachStrike(desc);
+    Node* node = this->findStrike(desc);
     if (node == nullptr) {
         auto scaler = CreateScalerContext(desc, effects, typeface);
-        node = this->createStrike(desc, std::move(scaler));
+        SkFontMetrics fontMetrics;
+        scaler->getFontMetrics(&fontMetrics);
+        node = this->insertNode(new Node{this, desc, std::move(scaler), fontMetrics, nullptr});
     }
     return node;
 }
@@ -182,12 +210,7 @@ auto SkStrikeCache::findOrCreateStrike(const SkDescriptor& desc,
 SkScopedStrike SkStrikeCache::findOrCreateScopedStrike(const SkDescriptor& desc,
                                                        const SkScalerContextEffects& effects,
                                                        const SkTypeface& typeface) {
-    Node* node = this->findAndDetachStrike(desc);
-    if (node == nullptr) {
-        auto scaler = CreateScalerContext(desc, effects, typeface);
-        node = this->createStrike(desc, std::move(scaler));
-    }
-    return SkScopedStrike{node};
+    return SkScopedStrike{this->findOrCreateStrike(desc, effects, typeface)};
 }
 
 SkExclusiveStrikePtr SkStrikeCache::FindOrCreateStrikeExclusive(
@@ -304,29 +327,43 @@ void SkStrikeCache::DumpMemoryStatistics(SkTraceMemoryDump* dump) {
 }
 
 
-void SkStrikeCache::attachNode(Node* node) {
+void SkStrikeCache::releaseNode(Node* node) {
     if (node == nullptr) {
         return;
     }
-    SkAutoExclusive ac(fLock);
-
-    this->validate();
     node->fStrike.validate();
 
-    this->internalAttachToHead(node);
-    this->internalPurge();
+    Shard* shard = this->shardFor(node->fStrike.getDescriptor());
+    {
+        SkAutoExclusive ac(shard->fLock);
+        SkASSERT(node->fUsers > 0);
+        node->fUsers -= 1;
+
+        // A strike's memory only grows, so whichever user sees the most has the latest count.
+        size_t memoryUsed = node->fStrike.getMemoryUsed();
+        if (memoryUsed > node->fMemoryCounted) {
+            fTotalMemoryUsed += memoryUsed - node->fMemoryCounted;
+            node->fMemoryCounted = memoryUsed;
+        }
+        this->internalMoveToHead(shard, node);
+    }
+
+    this->validate();
+    this->purge();
 }
 
 SkExclusiveStrikePtr SkStrikeCache::findStrikeExclusive(const SkDescriptor& desc) {
-    return SkExclusiveStrikePtr(this->findAndDetachStrike(desc));
+    return SkExclusiveStrikePtr(this->findStrike(desc, true));
 }
 
-auto SkStrikeCache::findAndDetachStrike(const SkDescriptor& desc) -> Node* {
-    SkAutoExclusive ac(fLock);
+auto SkStrikeCache::findStrike(const SkDescriptor& desc, bool exclusive) -> Node* {
+    Shard* shard = this->shardFor(desc);
+    SkAutoExclusive ac(shard->fLock);
 
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
-        if (node->fStrike.getDescriptor() == desc) {
-            this->internalDetachCache(node);
+    for (Node* node = shard->fHead; node != nullptr; node = node->fNext) {
+        if (node->isAvailable(exclusive) && node->fStrike.getDescriptor() == desc) {
+            node->fUsers += 1;
+            this->internalMoveToHead(shard, node);
             return node;
         }
     }
@@ -363,59 +400,53 @@ static bool loose_compare(const SkDescriptor& lhs, const SkDescriptor& rhs) {
 
 bool SkStrikeCache::desperationSearchForImage(const SkDescriptor& desc, SkGlyph* glyph,
                                               SkStrike* targetCache) {
-    SkAutoExclusive ac(fLock);
-
-    SkGlyphID glyphID = glyph->getGlyphID();
-    SkFixed targetSubX = glyph->getSubXFixed(),
-            targetSubY = glyph->getSubYFixed();
-
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
-        if (loose_compare(node->fStrike.getDescriptor(), desc)) {
-            auto targetGlyphID = SkPackedGlyphID(glyphID, targetSubX, targetSubY);
-            if (node->fStrike.isGlyphCached(glyphID, targetSubX, targetSubY)) {
-                SkGlyph* fallback = node->fStrike.getRawGlyphByID(targetGlyphID);
-                // This desperate-match node may disappear as soon as we drop fLock, so we
-                // need to copy the glyph from node into this strike, including a
-                // deep copy of the mask.
-                targetCache->initializeGlyphFromFallback(glyph, *fallback);
-                return true;
-            }
-
-            // Look for any sub-pixel pos for this glyph, in case there is a pos mismatch.
-            if (const auto* fallback = node->fStrike.getCachedGlyphAnySubPix(glyphID)) {
-                targetCache->initializeGlyphFromFallback(glyph, *fallback);
-                return true;
+    // Matching strikes may be in any shard. Hold on to them while we search them, outside of the
+    // shards' locks, since our caller has targetCache locked.
+    SkSTArray<8, Node*> matches;
+    for (Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (&node->fStrike != targetCache && node->isAvailable() &&
+                loose_compare(node->fStrike.getDescriptor(), desc)) {
+                node->fUsers += 1;
+                matches.push_back(node);
             }
         }
     }
 
-    return false;
+    bool found = false;
+    for (Node* node : matches) {
+        found = found || node->fStrike.initializeFallbackGlyph(glyph, targetCache);
+        this->releaseNode(node);
+    }
+    return found;
 }
 
 bool SkStrikeCache::desperationSearchForPath(
         const SkDescriptor& desc, SkGlyphID glyphID, SkPath* path) {
-    SkAutoExclusive ac(fLock);
-
     // The following is wrong there is subpixel positioning with paths...
     // Paths are only ever at sub-pixel position (0,0), so we can just try that directly rather
     // than try our packed position first then search all others on failure like for masks.
     //
     // This will have to search the sub-pixel positions too.
     // There is also a problem with accounting for cache size with shared path data.
-    for (Node* node = internalGetHead(); node != nullptr; node = node->fNext) {
-        if (loose_compare(node->fStrike.getDescriptor(), desc)) {
-            if (node->fStrike.isGlyphCached(glyphID, 0, 0)) {
-                SkGlyph* from = node->fStrike.getRawGlyphByID(SkPackedGlyphID(glyphID));
-                if (from->fPathData != nullptr) {
-                    // We can just copy the path out by value here, so no need to worry
-                    // about the lifetime of this desperate-match node.
-                    *path = from->fPathData->fPath;
-                    return true;
-                }
+    SkSTArray<8, Node*> matches;
+    for (Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (node->isAvailable() && loose_compare(node->fStrike.getDescriptor(), desc)) {
+                node->fUsers += 1;
+                matches.push_back(node);
             }
         }
     }
-    return false;
+
+    bool found = false;
+    for (Node* node : matches) {
+        found = found || node->fStrike.copyCachedPath(glyphID, path);
+        this->releaseNode(node);
+    }
+    return found;
 }
 
 SkExclusiveStrikePtr SkStrikeCache::CreateStrikeExclusive(
@@ -450,26 +481,53 @@ auto SkStrikeCache::createStrike(
         scaler->getFontMetrics(&fontMetrics);
     }
 
-    return new Node{this, desc, std::move(scaler), fontMetrics, std::move(pinner)};
+    return this->insertNode(
+            new Node{this, desc, std::move(scaler), fontMetrics, std::move(pinner)});
+}
+
+auto SkStrikeCache::insertNode(Node* node) -> Node* {
+    node->fMemoryCounted = node->fStrike.getMemoryUsed();
+
+    Shard* shard = this->shardFor(node->fStrike.getDescriptor());
+    Node* existing = nullptr;
+    {
+        SkAutoExclusive ac(shard->fLock);
+        for (Node* other = shard->fHead; node->fStrike.isShared() && other != nullptr;
+             other = other->fNext) {
+            if (other->fStrike.isShared() &&
+                other->fStrike.getDescriptor() == node->fStrike.getDescriptor()) {
+                other->fUsers += 1;
+                this->internalMoveToHead(shard, other);
+                existing = other;
+                break;
+            }
+        }
+        if (existing == nullptr) {
+            this->internalAttachToHead(shard, node);
+        }
+    }
+
+    if (existing != nullptr) {
+        delete node;
+        return existing;
+    }
+    this->purge();
+    return node;
 }
 
 void SkStrikeCache::purgeAll() {
-    SkAutoExclusive ac(fLock);
-    this->internalPurge(fTotalMemoryUsed);
+    this->purge(fTotalMemoryUsed);
 }
 
 size_t SkStrikeCache::getTotalMemoryUsed() const {
-    SkAutoExclusive ac(fLock);
     return fTotalMemoryUsed;
 }
 
 int SkStrikeCache::getCacheCountUsed() const {
-    SkAutoExclusive ac(fLock);
     return fCacheCount;
 }
 
 int SkStrikeCache::getCacheCountLimit() const {
-    SkAutoExclusive ac(fLock);
     return fCacheCountLimit;
 }
 
@@ -479,16 +537,12 @@ size_t SkStrikeCache::setCacheSizeLimit(size_t newLimit) {
         newLimit = minLimit;
     }
 
-    SkAutoExclusive ac(fLock);
-
-    size_t prevLimit = fCacheSizeLimit;
-    fCacheSizeLimit = newLimit;
-    this->internalPurge();
+    size_t prevLimit = fCacheSizeLimit.exchange(newLimit);
+    this->purge();
     return prevLimit;
 }
 
 size_t  SkStrikeCache::getCacheSizeLimit() const {
-    SkAutoExclusive ac(fLock);
     return fCacheSizeLimit;
 }
 
@@ -497,16 +551,12 @@ int SkStrikeCache::setCacheCountLimit(int newCount) {
         newCount = 0;
     }
 
-    SkAutoExclusive ac(fLock);
-
-    int prevCount = fCacheCountLimit;
-    fCacheCountLimit = newCount;
-    this->internalPurge();
+    int prevCount = fCacheCountLimit.exchange(newCount);
+    this->purge();
     return prevCount;
 }
 
 int SkStrikeCache::getCachePointSizeLimit() const {
-    SkAutoExclusive ac(fLock);
     return fPointSizeLimit;
 }
 
@@ -515,41 +565,76 @@ int SkStrikeCache::setCachePointSizeLimit(int newLimit) {
         newLimit = 0;
     }
 
-    SkAutoExclusive ac(fLock);
+    return fPointSizeLimit.exchange(newLimit);
+}
 
-    int prevLimit = fPointSizeLimit;
-    fPointSizeLimit = newLimit;
-    return prevLimit;
+void SkStrikeCache::setFileCache(sk_sp<SkGlyphFileCache> fileCache) {
+    SkAutoExclusive ac(fFileCacheLock);
+    fFileCache = std::move(fileCache);
 }
 
-void SkStrikeCache::forEachStrike(std::function<void(const SkStrike&)> visitor) const {
-    SkAutoExclusive ac(fLock);
+sk_sp<SkGlyphFileCache> SkStrikeCache::refFileCache() const {
+    SkAutoExclusive ac(fFileCacheLock);
+    return fFileCache;
+}
 
-    this->validate();
+void SkStrikeCache::setManifest(sk_sp<SkStrikeManifest> manifest) {
+    SkAutoExclusive ac(fManifestLock);
+    fManifest = std::move(manifest);
+}
+
+sk_sp<SkStrikeManifest> SkStrikeCache::refManifest() const {
+    SkAutoExclusive ac(fManifestLock);
+    return fManifest;
+}
+
+void SkStrikeCache::startRecordingManifest() {
+    this->setManifest(SkStrikeManifest::Make());
+}
 
-    for (Node* node = this->internalGetHead(); node != nullptr; node = node->fNext) {
-        visitor(node->fStrike);
+sk_sp<SkData> SkStrikeCache::stopRecordingManifest() {
+    sk_sp<SkStrikeManifest> manifest;
+    {
+        SkAutoExclusive ac(fManifestLock);
+        manifest = std::move(fManifest);
     }
+    return manifest ? manifest->serialize() : nullptr;
 }
 
-size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
+void SkStrikeCache::forEachStrike(std::function<void(const SkStrike&)> visitor) const {
     this->validate();
 
+    for (const Shard& shard : fShards) {
+        SkAutoExclusive ac(shard.fLock);
+        for (Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            if (node->isAvailable()) {
+                visitor(node->fStrike);
+            }
+        }
+    }
+}
+
+size_t SkStrikeCache::purge(size_t minBytesNeeded) {
+    size_t totalMemoryUsed = fTotalMemoryUsed,
+           cacheSizeLimit  = fCacheSizeLimit;
+    int    cacheCount      = fCacheCount,
+           cacheCountLimit = fCacheCountLimit;
+
     size_t bytesNeeded = 0;
-    if (fTotalMemoryUsed > fCacheSizeLimit) {
-        bytesNeeded = fTotalMemoryUsed - fCacheSizeLimit;
+    if (totalMemoryUsed > cacheSizeLimit) {
+        bytesNeeded = totalMemoryUsed - cacheSizeLimit;
     }
     bytesNeeded = SkTMax(bytesNeeded, minBytesNeeded);
     if (bytesNeeded) {
         // no small purges!
-        bytesNeeded = SkTMax(bytesNeeded, fTotalMemoryUsed >> 2);
+        bytesNeeded = SkTMax(bytesNeeded, totalMemoryUsed >> 2);
     }
 
     int countNeeded = 0;
-    if (fCacheCount > fCacheCountLimit) {
-        countNeeded = fCacheCount - fCacheCountLimit;
+    if (cacheCount > cacheCountLimit) {
+        countNeeded = cacheCount - cacheCountLimit;
         // no small purges!
-        countNeeded = SkMax32(countNeeded, fCacheCount >> 2);
+        countNeeded = SkMax32(countNeeded, cacheCount >> 2);
     }
 
     // early exit
@@ -560,20 +645,53 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
     size_t  bytesFreed = 0;
     int     countFreed = 0;
 
-    // Start at the tail and proceed backwards deleting; the list is in LRU
-    // order, with unimportant entries at the tail.
-    Node* node = this->internalGetTail();
-    while (node != nullptr && (bytesFreed < bytesNeeded || countFreed < countNeeded)) {
-        Node* prev = node->fPrev;
+    // Start at the tails and proceed backwards deleting; each shard's list is in LRU order, with
+    // unimportant entries at the tail, so always take from the shard whose tail was used longest
+    // ago. Strikes in use stay.
+    for (Shard& shard : fShards) {
+        shard.fLock.acquire();
+    }
 
-        // Only delete if the strike is not pinned.
-        if (node->fPinner == nullptr || node->fPinner->canDelete()) {
-            bytesFreed += node->fStrike.getMemoryUsed();
+    Node* tails[kShardCount];
+    for (int i = 0; i < kShardCount; i++) {
+        tails[i] = fShards[i].fTail;
+    }
+
+    Node* purged = nullptr;
+    while (bytesFreed < bytesNeeded || countFreed < countNeeded) {
+        int oldest = -1;
+        for (int i = 0; i < kShardCount; i++) {
+            if (tails[i] != nullptr &&
+                (oldest < 0 || tails[i]->fLastUsed < tails[oldest]->fLastUsed)) {
+                oldest = i;
+            }
+        }
+        if (oldest < 0) {
+            break;
+        }
+
+        Node* node = tails[oldest];
+        tails[oldest] = node->fPrev;
+
+        // Only delete if the strike is not in use or pinned.
+        if (node->fUsers == 0 && (node->fPinner == nullptr || node->fPinner->canDelete())) {
+            bytesFreed += node->fMemoryCounted;
             countFreed += 1;
-            this->internalDetachCache(node);
-            delete node;
+            this->internalDetachCache(&fShards[oldest], node);
+            node->fNext = purged;
+            purged = node;
         }
-        node = prev;
+    }
+
+    for (Shard& shard : fShards) {
+        shard.fLock.release();
+    }
+
+    // Strikes can be slow to free, so do that outside of the locks.
+    while (purged != nullptr) {
+        Node* next = purged->fNext;
+        delete purged;
+        purged = next;
     }
 
     this->validate();
@@ -588,36 +706,42 @@ size_t SkStrikeCache::internalPurge(size_t minBytesNeeded) {
     return bytesFreed;
 }
 
-void SkStrikeCache::internalAttachToHead(Node* node) {
+void SkStrikeCache::internalAttachToHead(Shard* shard, Node* node) {
     SkASSERT(nullptr == node->fPrev && nullptr == node->fNext);
-    if (fHead) {
-        fHead->fPrev = node;
-        node->fNext = fHead;
+    if (shard->fHead) {
+        shard->fHead->fPrev = node;
+        node->fNext = shard->fHead;
     }
-    fHead = node;
+    shard->fHead = node;
 
-    if (fTail == nullptr) {
-        fTail = node;
+    if (shard->fTail == nullptr) {
+        shard->fTail = node;
     }
+    node->fLastUsed = fUseClock.fetch_add(1, std::memory_order_relaxed);
 
     fCacheCount += 1;
-    fTotalMemoryUsed += node->fStrike.getMemoryUsed();
+    fTotalMemoryUsed += node->fMemoryCounted;
 }
 
-void SkStrikeCache::internalDetachCache(Node* node) {
+void SkStrikeCache::internalMoveToHead(Shard* shard, Node* node) {
+    this->internalDetachCache(shard, node);
+    this->internalAttachToHead(shard, node);
+}
+
+void SkStrikeCache::internalDetachCache(Shard* shard, Node* node) {
     SkASSERT(fCacheCount > 0);
     fCacheCount -= 1;
-    fTotalMemoryUsed -= node->fStrike.getMemoryUsed();
+    fTotalMemoryUsed -= node->fMemoryCounted;
 
     if (node->fPrev) {
         node->fPrev->fNext = node->fNext;
     } else {
-        fHead = node->fNext;
+        shard->fHead = node->fNext;
     }
     if (node->fNext) {
         node->fNext->fPrev = node->fPrev;
     } else {
-        fTail = node->fPrev;
+        shard->fTail = node->fPrev;
     }
     node->fPrev = node->fNext = nullptr;
 }
@@ -638,20 +762,30 @@ void SkStrikeCache::validateGlyphCacheDataSize() const {
 
 #ifdef SK_DEBUG
 void SkStrikeCache::validate() const {
+    // Lock every shard, always in the same order, so that the totals hold still.
+    for (const Shard& shard : fShards) {
+        shard.fLock.acquire();
+    }
+
     size_t computedBytes = 0;
     int computedCount = 0;
 
-    const Node* node = fHead;
-    while (node != nullptr) {
-        computedBytes += node->fStrike.getMemoryUsed();
-        computedCount += 1;
-        node = node->fNext;
+    for (const Shard& shard : fShards) {
+        for (const Node* node = shard.fHead; node != nullptr; node = node->fNext) {
+            SkASSERT(node->fMemoryCounted <= node->fStrike.getMemoryUsed());
+            computedBytes += node->fMemoryCounted;
+            computedCount += 1;
+        }
     }
 
-    SkASSERTF(fCacheCount == computedCount, "fCacheCount: %d, computedCount: %d", fCacheCount,
-              computedCount);
-    SkASSERTF(fTotalMemoryUsed == computedBytes, "fTotalMemoryUsed: %d, computedBytes: %d",
-              fTotalMemoryUsed, computedBytes);
+    SkASSERTF(fCacheCount == computedCount, "fCacheCount: %d, computedCount: %d",
+              fCacheCount.load(), computedCount);
+    SkASSERTF(fTotalMemoryUsed == computedBytes, "fTotalMemoryUsed: %zu, computedBytes: %zu",
+              fTotalMemoryUsed.load(), computedBytes);
+
+    for (const Shard& shard : fShards) {
+        shard.fLock.release();
+    }
 }
 #endif
 
@@ -8,11 +8,14 @@
 #ifndef SkStrikeCache_DEFINED
 #define SkStrikeCache_DEFINED
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 
 #include "SkDescriptor.h"
+#include "SkGlyphFileCache.h"
 #include "SkStrike.h"
+#include "SkStrikeManifest.h"
 #include "SkSpinlock.h"
 #include "SkTemplates.h"
 
@@ -33,17 +36,32 @@ class SkTraceMemoryDump;
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Whether GlobalStrikeCache() shares its strikes (see SkStrikeCache's constructor). Only read when
+// the global cache is first used.
+extern std::atomic<bool> gSkShareStrikes;
+
 class SkStrikePinner {
 public:
     virtual ~SkStrikePinner() = default;
     virtual bool canDelete() = 0;
 };
 
+/**
+ *  Strikes are spread over shards by the checksums of their descriptors, each shard with its own
+ *  lock and LRU list, so that threads looking up different strikes rarely wait on each other.
+ *
+ *  If the cache shares strikes, those without a pinner are shared: finding one that another
+ *  thread is using returns it rather than making a duplicate, and SkStrike locks itself to add
+ *  glyphs. Other strikes, including pinned ones whose users fill in glyphs directly, are only
+ *  handed to one user at a time.
+ */
 class SkStrikeCache final : public SkStrikeCacheInterface {
     class Node;
 
 public:
-    SkStrikeCache() = default;
+    // With shareStrikes, strikes created without a pinner may be used by several threads at once,
+    // rather than by one at a time.
+    explicit SkStrikeCache(bool shareStrikes = false) : fShareStrikes{shareStrikes} {}
     ~SkStrikeCache() override;
 
     class ExclusiveStrikePtr {
@@ -70,9 +88,12 @@ public:
 
     static SkStrikeCache* GlobalStrikeCache();
 
+    // Finds a strike no one else is using or can use while we do: never a shared strike. Its
+    // user may fill in glyphs directly, as SkStrikeClient does.
     static ExclusiveStrikePtr FindStrikeExclusive(const SkDescriptor&);
     ExclusiveStrikePtr findStrikeExclusive(const SkDescriptor&);
-    Node* findAndDetachStrike(const SkDescriptor&);
+    // Finds a strike we may use, shared or not.
+    Node* findStrike(const SkDescriptor&, bool exclusive = false);
 
     static ExclusiveStrikePtr CreateStrikeExclusive(
             const SkDescriptor& desc,
@@ -149,8 +170,8 @@ public:
     // SkTraceMemoryDump interface.
     static void DumpMemoryStatistics(SkTraceMemoryDump* dump);
 
-    // call when a glyphcache is available for caching (i.e. not in use)
-    void attachNode(Node* node);
+    // call when done with a strike found or created by this cache
+    void releaseNode(Node* node);
 
     void purgeAll(); // does not change budget
 
@@ -165,6 +186,21 @@ public:
     int  getCachePointSizeLimit() const;
     int  setCachePointSizeLimit(int limit);
 
+    // Strikes created from now on without a pinner look for glyphs in fileCache, and add to it.
+    // Pass nullptr to stop.
+    void setFileCache(sk_sp<SkGlyphFileCache> fileCache);
+    sk_sp<SkGlyphFileCache> refFileCache() const;
+
+    // Strikes created from now on without a pinner record the glyphs they use in manifest. Pass
+    // nullptr to stop.
+    void setManifest(sk_sp<SkStrikeManifest> manifest);
+    sk_sp<SkStrikeManifest> refManifest() const;
+
+    // Record in a new manifest, as SkGraphics::StartRecordingFontCacheManifest() does. Stopping
+    // returns it serialized, or nullptr if not recording.
+    void startRecordingManifest();
+    sk_sp<SkData> stopRecordingManifest();
+
 #ifdef SK_DEBUG
     // A simple accounting of what each glyph cache reports and the strike cache total.
     void validate() const;
@@ -176,28 +212,50 @@ public:
 #endif
 
 private:
+    static constexpr int kShardCount = 8;
+
+    struct Shard {
+        mutable SkSpinlock fLock;
+        Node*              fHead{nullptr};
+        Node*              fTail{nullptr};
+    };
+
+    Shard* shardFor(const SkDescriptor& desc) {
+        return &fShards[desc.getChecksum() % kShardCount];
+    }
+
+    // Adds a new node to its shard, in use. If the node's strike is shared, a strike for the same
+    // descriptor that another thread added meanwhile is used instead, and node deleted.
+    Node* insertNode(Node* node);
 
-    // The following methods can only be called when mutex is already held.
-    Node* internalGetHead() const { return fHead; }
-    Node* internalGetTail() const { return fTail; }
-    void internalDetachCache(Node*);
-    void internalAttachToHead(Node*);
+    // The following methods can only be called when the shard's lock is already held.
+    void internalDetachCache(Shard*, Node*);
+    void internalAttachToHead(Shard*, Node*);
+    void internalMoveToHead(Shard*, Node*);
 
     // Checkout budgets, modulated by the specified min-bytes-needed-to-purge,
-    // and attempt to purge caches to match.
+    // and attempt to purge caches to match. Takes every shard's lock, so none may be held.
     // Returns number of bytes freed.
-    size_t internalPurge(size_t minBytesNeeded = 0);
+    size_t purge(size_t minBytesNeeded = 0);
 
     void forEachStrike(std::function<void(const SkStrike&)> visitor) const;
 
-    mutable SkSpinlock fLock;
-    Node*              fHead{nullptr};
-    Node*              fTail{nullptr};
-    size_t             fTotalMemoryUsed{0};
-    size_t             fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
-    int32_t            fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
-    int32_t            fCacheCount{0};
-    int32_t            fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
+    const bool            fShareStrikes;
+    Shard                 fShards[kShardCount];
+    // These change only with a shard locked, so are stable while every shard is.
+    std::atomic<size_t>   fTotalMemoryUsed{0};
+    std::atomic<int32_t>  fCacheCount{0};
+    // Stamps nodes as they move to the head of their shard, to purge in LRU order across shards.
+    std::atomic<uint64_t> fUseClock{0};
+    std::atomic<size_t>   fCacheSizeLimit{SK_DEFAULT_FONT_CACHE_LIMIT};
+    std::atomic<int32_t>  fCacheCountLimit{SK_DEFAULT_FONT_CACHE_COUNT_LIMIT};
+    std::atomic<int32_t>  fPointSizeLimit{SK_DEFAULT_FONT_CACHE_POINT_SIZE_LIMIT};
+
+    mutable SkSpinlock      fFileCacheLock;
+    sk_sp<SkGlyphFileCache> fFileCache;
+
+    mutable SkSpinlock      fManifestLock;
+    sk_sp<SkStrikeManifest> fManifest;
 };
 
 using SkExclusiveStrikePtr = SkStrikeCache::ExclusiveStrikePtr;
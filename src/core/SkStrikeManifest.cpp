@@ -0,0 +1,288 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStrikeManifest.h"
+
+#include "SkDescriptor.h"
+#include "SkOpts.h"
+#include "SkScalerContext.h"
+#include "SkStream.h"
+#include "SkStrikeCache.h"
+#include "SkTypeface.h"
+
+#include <cstring>
+
+// The manifest is a Header, then for each typeface its size and SkTypeface::serialize() bytes,
+// padded to 4, then for each strike a StrikeRecord followed by its GlyphRecords.
+namespace {
+struct Header {
+    uint32_t fMagic;
+    uint32_t fVersion;
+    uint32_t fTypefaceCount;
+    uint32_t fStrikeCount;
+    uint32_t fChecksum;      // of everything after the header
+};
+
+constexpr uint32_t kMagic   = SkSetFourByteTag('S', 'k', 'S', 'M');
+// Bump when the layout of the manifest or of SkScalerContextRec changes.
+constexpr uint32_t kVersion = 1;
+
+struct StrikeRecord {
+    uint32_t           fTypeface;
+    uint32_t           fGlyphCount;
+    SkScalerContextRec fRec;        // with fFontID zeroed
+};
+
+struct GlyphRecord {
+    uint16_t fGlyphID;
+    uint8_t  fSubX, fSubY;          // sub-pixel positions, in 1/(1 << SkPackedID::kSubBits)
+    uint32_t fUses;
+};
+static_assert(sizeof(GlyphRecord) == 8, "");
+
+constexpr uint32_t kAllUses = SkStrikeManifest::kImage_Use | SkStrikeManifest::kPath_Use;
+
+unsigned fixed_to_sub(SkFixed fixed) { return fixed >> (16 - SkPackedID::kSubBits); }
+SkFixed sub_to_fixed(unsigned sub) { return sub << (16 - SkPackedID::kSubBits); }
+
+// Returns the part of data that follows a valid header, or nullptr.
+const uint8_t* validate(const void* data, size_t length, Header* header) {
+    if (data == nullptr || length < sizeof(Header)) {
+        return nullptr;
+    }
+    memcpy(header, data, sizeof(Header));
+    const uint8_t* body = static_cast<const uint8_t*>(data) + sizeof(Header);
+    if (header->fMagic != kMagic || header->fVersion != kVersion
+        || header->fChecksum != SkOpts::hash(body, length - sizeof(Header))) {
+        return nullptr;
+    }
+    return body;
+}
+
+// A strike's rec is only as good as the process that wrote it, and the checksum only catches
+// accidents, so check everything a scaler context would otherwise trust.
+bool valid_rec(const SkScalerContextRec& rec) {
+    SkScalar values[] = { rec.fTextSize, rec.fPreScaleX, rec.fPreSkewX,
+                          rec.fPost2x2[0][0], rec.fPost2x2[0][1],
+                          rec.fPost2x2[1][0], rec.fPost2x2[1][1],
+                          rec.fFrameWidth, rec.fMiterLimit };
+    constexpr uint16_t kKnownFlags = SkScalerContext::kFrameAndFill_Flag
+                                   | SkScalerContext::kEmbeddedBitmapText_Flag
+                                   | SkScalerContext::kEmbolden_Flag
+                                   | SkScalerContext::kSubpixelPositioning_Flag
+                                   | SkScalerContext::kForceAutohinting_Flag
+                                   | SkScalerContext::kHinting_Mask
+                                   | SkScalerContext::kLCD_Vertical_Flag
+                                   | SkScalerContext::kLCD_BGROrder_Flag
+                                   | SkScalerContext::kGenA8FromLCD_Flag;
+    return SkScalarsAreFinite(values, SK_ARRAY_COUNT(values))
+        && rec.fTextSize > 0
+        && rec.fFrameWidth >= 0       // 0 is no frame
+        && rec.fMaskFormat < SkMask::kCountMaskFormats
+        && rec.hasValidStrokeParams()
+        && (rec.fFlags & ~kKnownFlags) == 0;
+}
+}  // namespace
+
+struct SkStrikeManifest::Strike {
+    int                                   fTypeface;
+    SkScalerContextRec                    fRec;
+    SkTHashMap<SkPackedGlyphID, uint32_t> fGlyphs;     // uses by glyph
+};
+
+sk_sp<SkStrikeManifest> SkStrikeManifest::Make() {
+    return sk_sp<SkStrikeManifest>(new SkStrikeManifest);
+}
+
+SkStrikeManifest::SkStrikeManifest() = default;
+SkStrikeManifest::~SkStrikeManifest() = default;
+
+int SkStrikeManifest::findOrAddStrike(const SkDescriptor& desc, const SkTypeface& typeface) {
+    uint32_t recSize;
+    const void* rec = desc.findEntry(kRec_SkDescriptorTag, &recSize);
+    if (rec == nullptr || recSize != sizeof(SkScalerContextRec)
+        || desc.findEntry(kEffects_SkDescriptorTag, nullptr) != nullptr) {
+        return -1;
+    }
+    // The rec holds the typeface's ID, so it identifies the strike.
+    SkString key(static_cast<const char*>(rec), recSize);
+
+    SkAutoMutexAcquire lock(fMutex);
+    if (int* id = fStrikeIDs.find(key)) {
+        return *id;
+    }
+
+    int typefaceIndex;
+    if (int* index = fTypefaceIndices.find(typeface.uniqueID())) {
+        typefaceIndex = *index;
+    } else {
+        typefaceIndex = fTypefaces.count();
+        fTypefaces.push_back(sk_ref_sp(&typeface));
+        fTypefaceIndices.set(typeface.uniqueID(), typefaceIndex);
+    }
+
+    std::unique_ptr<Strike> strike(new Strike);
+    strike->fTypeface = typefaceIndex;
+    memcpy(&strike->fRec, rec, sizeof(SkScalerContextRec));
+    strike->fRec.fFontID = 0;
+    fStrikes.push_back(std::move(strike));
+    return *fStrikeIDs.set(key, fStrikes.count() - 1);
+}
+
+void SkStrikeManifest::addGlyph(int strikeID, SkPackedGlyphID packedID, uint32_t uses) {
+    SkASSERT((uses & ~kAllUses) == 0);
+    SkAutoMutexAcquire lock(fMutex);
+    Strike* strike = fStrikes[strikeID].get();
+    if (uint32_t* recorded = strike->fGlyphs.find(packedID)) {
+        *recorded |= uses;
+    } else {
+        strike->fGlyphs.set(packedID, uses);
+    }
+}
+
+int SkStrikeManifest::countStrikes() const {
+    SkAutoMutexAcquire lock(fMutex);
+    return fStrikes.count();
+}
+
+int SkStrikeManifest::countGlyphs() const {
+    SkAutoMutexAcquire lock(fMutex);
+    int count = 0;
+    for (const std::unique_ptr<Strike>& strike : fStrikes) {
+        count += strike->fGlyphs.count();
+    }
+    return count;
+}
+
+sk_sp<SkData> SkStrikeManifest::serialize() const {
+    SkAutoMutexAcquire lock(fMutex);
+    SkDynamicMemoryWStream body;
+
+    for (const sk_sp<SkTypeface>& typeface : fTypefaces) {
+        sk_sp<SkData> data = typeface->serialize();
+        body.write32(SkToU32(data->size()));
+        body.write(data->data(), data->size());
+        body.padToAlign4();
+    }
+
+    for (const std::unique_ptr<Strike>& strike : fStrikes) {
+        StrikeRecord record;
+        record.fTypeface = SkToU32(strike->fTypeface);
+        record.fGlyphCount = SkToU32(strike->fGlyphs.count());
+        memcpy(&record.fRec, &strike->fRec, sizeof(SkScalerContextRec));
+        body.write(&record, sizeof(record));
+
+        strike->fGlyphs.foreach([&body](SkPackedGlyphID id, uint32_t* uses) {
+            GlyphRecord glyph;
+            glyph.fGlyphID = SkTo<uint16_t>(id.code());
+            glyph.fSubX = SkTo<uint8_t>(fixed_to_sub(id.getSubXFixed()));
+            glyph.fSubY = SkTo<uint8_t>(fixed_to_sub(id.getSubYFixed()));
+            glyph.fUses = *uses;
+            body.write(&glyph, sizeof(glyph));
+        });
+    }
+
+    sk_sp<SkData> bodyData = body.detachAsData();
+    Header header;
+    header.fMagic = kMagic;
+    header.fVersion = kVersion;
+    header.fTypefaceCount = SkToU32(fTypefaces.count());
+    header.fStrikeCount = SkToU32(fStrikes.count());
+    header.fChecksum = SkOpts::hash(bodyData->data(), bodyData->size());
+
+    sk_sp<SkData> data = SkData::MakeUninitialized(sizeof(Header) + bodyData->size());
+    auto bytes = static_cast<uint8_t*>(data->writable_data());
+    memcpy(bytes, &header, sizeof(Header));
+    memcpy(bytes + sizeof(Header), bodyData->data(), bodyData->size());
+    return data;
+}
+
+int SkStrikeManifest::Prewarm(const void* data, size_t length, SkStrikeCache* strikeCache) {
+    Header header;
+    const uint8_t* body = validate(data, length, &header);
+    if (body == nullptr) {
+        return -1;
+    }
+    SkMemoryStream stream(body, length - sizeof(Header), false);
+
+    // Check everything before generating anything.
+    SkTArray<sk_sp<SkData>> typefaceData;
+    for (uint32_t i = 0; i < header.fTypefaceCount; i++) {
+        uint32_t size;
+        if (!stream.readU32(&size) || size > stream.getLength() - stream.getPosition()) {
+            return -1;
+        }
+        typefaceData.push_back(SkData::MakeWithoutCopy(body + stream.getPosition(), size));
+        if (stream.skip(SkAlign4(size)) != SkAlign4(size)) {
+            return -1;
+        }
+    }
+    size_t strikesStart = stream.getPosition();
+    for (uint32_t i = 0; i < header.fStrikeCount; i++) {
+        StrikeRecord record;
+        if (stream.read(&record, sizeof(record)) != sizeof(record)
+            || record.fTypeface >= header.fTypefaceCount || !valid_rec(record.fRec)
+            || record.fGlyphCount > (stream.getLength() - stream.getPosition())
+                                    / sizeof(GlyphRecord)) {
+            return -1;
+        }
+        for (uint32_t j = 0; j < record.fGlyphCount; j++) {
+            GlyphRecord glyph;
+            stream.read(&glyph, sizeof(glyph));
+            if (glyph.fSubX > SkPackedID::kSubMask || glyph.fSubY > SkPackedID::kSubMask
+                || (glyph.fUses & ~kAllUses) != 0) {
+                return -1;
+            }
+        }
+    }
+    if (!stream.isAtEnd()) {
+        return -1;
+    }
+
+    SkTArray<sk_sp<SkTypeface>> typefaces;
+    for (const sk_sp<SkData>& serialized : typefaceData) {
+        SkMemoryStream typefaceStream(serialized);
+        typefaces.push_back(SkTypeface::MakeDeserialize(&typefaceStream));
+    }
+
+    int generated = 0;
+    stream.seek(strikesStart);
+    SkTArray<SkGlyphPos> images;
+    for (uint32_t i = 0; i < header.fStrikeCount; i++) {
+        StrikeRecord record;
+        stream.read(&record, sizeof(record));
+        const SkTypeface* typeface = typefaces[record.fTypeface].get();
+        if (typeface == nullptr) {
+            stream.skip(record.fGlyphCount * sizeof(GlyphRecord));
+            continue;
+        }
+
+        record.fRec.fFontID = typeface->uniqueID();
+        SkAutoDescriptor ad;
+        SkScalerContextEffects noEffects;
+        SkDescriptor* desc = SkScalerContext::AutoDescriptorGivenRecAndEffects(
+                record.fRec, noEffects, &ad);
+        auto strike = strikeCache->findOrCreateStrikeExclusive(*desc, noEffects, *typeface);
+
+        images.reset();
+        for (uint32_t j = 0; j < record.fGlyphCount; j++) {
+            GlyphRecord glyph;
+            stream.read(&glyph, sizeof(glyph));
+            const SkGlyph& metrics = strike->getGlyphIDMetrics(
+                    glyph.fGlyphID, sub_to_fixed(glyph.fSubX), sub_to_fixed(glyph.fSubY));
+            if (glyph.fUses & kImage_Use) {
+                images.push_back({&metrics, {0, 0}});
+            }
+            if (glyph.fUses & kPath_Use) {
+                (void)strike->findPath(metrics);
+            }
+            generated++;
+        }
+        strike->prepareImages(SkSpan<const SkGlyphPos>{images.begin(), images.size()});
+    }
+    return generated;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrikeManifest_DEFINED
+#define SkStrikeManifest_DEFINED
+
+#include "SkData.h"
+#include "SkGlyph.h"
+#include "SkMutex.h"
+#include "SkRefCnt.h"
+#include "SkString.h"
+#include "SkTArray.h"
+#include "SkTHash.h"
+
+#include <memory>
+
+class SkDescriptor;
+class SkStrikeCache;
+class SkTypeface;
+
+/**
+ *  Records which strikes, i.e. typeface, size, matrix and so on, and which of their glyphs'
+ *  metrics, images and paths are used, so that another process can generate them all with
+ *  Prewarm() before it needs them, e.g. on a background thread at startup.
+ *
+ *  Typefaces are written with SkTypeface::serialize(), so a typeface whose font data isn't local
+ *  is only found again if the other process's font manager has it. Strikes with path effects or
+ *  mask filters aren't recorded.
+ *
+ *  All methods are thread safe.
+ */
+class SkStrikeManifest : public SkRefCnt {
+public:
+    static sk_sp<SkStrikeManifest> Make();
+
+    enum Use : uint32_t {
+        kMetrics_Use = 0,
+        kImage_Use   = 1 << 0,
+        kPath_Use    = 1 << 1,
+    };
+
+    /**
+     *  Returns the ID addGlyph() uses for the strike with this descriptor and typeface, or -1 if
+     *  it can't be recorded.
+     */
+    int findOrAddStrike(const SkDescriptor&, const SkTypeface&);
+
+    /** Record that the glyph's metrics, and the other uses (a combination of Use), were needed. */
+    void addGlyph(int strikeID, SkPackedGlyphID, uint32_t uses = kMetrics_Use);
+
+    int countStrikes() const;
+    int countGlyphs() const;
+
+    /** Return the strikes and glyphs recorded, in the form Prewarm() reads. */
+    sk_sp<SkData> serialize() const;
+
+    /**
+     *  Generate the strikes and glyphs in data, as made by serialize(), in strikeCache. Returns the
+     *  number of glyphs generated, or -1 if data is invalid, in which case nothing is generated.
+     *  Strikes whose typefaces can't be deserialized are skipped.
+     */
+    static int Prewarm(const void* data, size_t length, SkStrikeCache* strikeCache);
+
+private:
+    struct Strike;
+
+    SkStrikeManifest();
+    ~SkStrikeManifest() override;
+
+    mutable SkMutex                    fMutex;
+    SkTArray<sk_sp<SkTypeface>>        fTypefaces;
+    SkTHashMap<uint32_t, int>          fTypefaceIndices;    // by typeface unique ID
+    SkTArray<std::unique_ptr<Strike>>  fStrikes;
+    SkTHashMap<SkString, int>          fStrikeIDs;          // by SkScalerContextRec
+};
+
+#endif
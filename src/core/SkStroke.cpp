@@ -9,6 +9,7 @@
 
 #include "SkGeometry.h"
 #include "SkMacros.h"
+#include "SkNx.h"
 #include "SkPathPriv.h"
 #include "SkPointPriv.h"
 #include "SkTo.h"
@@ -1296,6 +1297,343 @@ void SkPathStroker::cubicTo(const SkPoint& pt1, const SkPoint& pt2,
     this->postJoinTo(pt3, normalCD, unitCD);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+std::atomic<bool> gSkBatchPolylineStrokes{false};
+
+/*  Strokes line-only paths just as SkPathStroker does, with the same cappers and joiners, but
+    into SkStrokerPriv::PathBuilders rather than SkPaths, and computing the segments' normals and
+    offset points four at a time, a batch of segments ahead.  SkPath's bookkeeping on every edit
+    dominates stroking long polylines (GPS traces, plots) with SkPathStroker.
+
+    The results are identical, point for point, to SkPathStroker's.  In particular, the normals'
+    lengths are taken in double, exactly as SkPoint::setNormalize() does it.
+*/
+class SkPolylineStroker {
+public:
+    SkPolylineStroker(const SkPath& src, SkScalar radius, SkScalar miterLimit, SkPaint::Cap,
+                      SkPaint::Join, SkScalar resScale);
+
+    bool hasOnlyMoveTo() const { return 0 == fSegmentCount; }
+    SkPoint moveToPt() const { return fFirstPt; }
+
+    void moveTo(const SkPoint&);
+    // srcIndex is the index of pt in the source path, or -1 if it's not one of its points.
+    void lineTo(const SkPoint& pt, int srcIndex, const SkPath::Iter* iter = nullptr);
+    void close(bool isLine) { this->finishContour(true, isLine); }
+
+    void done(SkPath* dst, bool isLine) {
+        this->finishContour(false, isLine);
+        SkPath result;
+        result.setIsVolatile(true);
+        fOuter.appendTo(&result);
+        dst->swap(result);
+    }
+
+    bool isCurrentContourEmpty() const {
+        return fInner.isZeroLengthSincePoint(0) &&
+               fOuter.isZeroLengthSincePoint(fFirstOuterPtIndexInContour);
+    }
+
+private:
+    // The unit normal and offset points of the segment that ends at a source point.
+    struct Segment {
+        SkVector fUnitNormal;       // not yet checked to be finite and non-zero
+        SkPoint  fOuter, fInner;    // the end point offset by +/- the normal
+    };
+    static constexpr int kBatchSize = 64;   // a multiple of 4
+
+    bool findSegment(int srcIndex, const SkPoint& currPt, Segment*);
+    void computeSegments(int srcIndex);
+
+    void finishContour(bool close, bool isLine);
+    bool preJoinTo(const SkPoint&, const Segment*, SkVector* normal, SkVector* unitNormal);
+    void postJoinTo(const SkPoint&, const SkVector& normal, const SkVector& unitNormal);
+
+    SkScalar    fRadius;
+    SkScalar    fInvMiterLimit;
+    SkScalar    fResScale;
+    SkScalar    fInvResScale;
+
+    SkVector    fFirstNormal, fPrevNormal, fFirstUnitNormal, fPrevUnitNormal;
+    SkPoint     fFirstPt, fPrevPt;  // on original path
+    SkPoint     fFirstOuterPt;
+    int         fFirstOuterPtIndexInContour;
+    int         fSegmentCount;
+    bool        fPrevIsLine;
+    bool        fJoinCompleted;
+    bool        fButtCap;
+
+    SkStrokerPriv::BuilderCapProc  fCapper;
+    SkStrokerPriv::BuilderJoinProc fJoiner;
+
+    SkStrokerPriv::PathBuilder fInner, fOuter;  // outer is our working answer, inner is temp
+
+    const SkPoint*  fSrcPts;
+    int             fSrcCount;
+    // The segments ending at source points [fBatchStart, fBatchStart + kBatchSize).
+    int             fBatchStart;
+    SkVector        fUnitNormals[kBatchSize];
+    SkPoint         fOffsetPts[kBatchSize][2];  // outer and inner
+};
+
+SkPolylineStroker::SkPolylineStroker(const SkPath& src, SkScalar radius, SkScalar miterLimit,
+                                     SkPaint::Cap cap, SkPaint::Join join, SkScalar resScale)
+        : fRadius(radius)
+        , fResScale(resScale)
+        , fSrcPts(SkPathPriv::PointData(src))
+        , fSrcCount(src.countPoints())
+        , fBatchStart(0) {
+    fInvMiterLimit = 0;
+    if (join == SkPaint::kMiter_Join) {
+        if (miterLimit <= SK_Scalar1) {
+            join = SkPaint::kBevel_Join;
+        } else {
+            fInvMiterLimit = SkScalarInvert(miterLimit);
+        }
+    }
+    fButtCap = (cap == SkPaint::kButt_Cap);
+    fCapper = SkStrokerPriv::BuilderCapFactory(cap);
+    fJoiner = SkStrokerPriv::BuilderJoinFactory(join);
+    fSegmentCount = -1;
+    fFirstOuterPtIndexInContour = 0;
+    fPrevIsLine = false;
+    fJoinCompleted = false;
+
+    // Each segment adds about an outer point, an inner point and a join.
+    fOuter.reserve(fSrcCount * 3);
+    fInner.reserve(fSrcCount);
+    fInvResScale = SkScalarInvert(resScale * 4);
+}
+
+void SkPolylineStroker::computeSegments(int srcIndex) {
+    SkASSERT(srcIndex > 0 && srcIndex < fSrcCount);
+    fBatchStart = srcIndex;
+    int count = SkTMin(kBatchSize, fSrcCount - srcIndex);
+
+    for (int i = 0; i < count; i += 4) {
+        // Load the segments ending at srcIndex+i ... srcIndex+i+3, padding past the end.
+        const SkPoint* pts = fSrcPts + srcIndex + i - 1;
+        SkPoint padded[5];
+        if (i + 4 > count) {
+            int n = count - i + 1;
+            memcpy(padded, pts, n * sizeof(SkPoint));
+            for (int j = n; j < 5; ++j) {
+                padded[j] = padded[n - 1];
+            }
+            pts = padded;
+        }
+        Sk4f x0, y0, x1, y1;
+        Sk4f::Load2(pts + 0, &x0, &y0);
+        Sk4f::Load2(pts + 1, &x1, &y1);
+
+        float dx[4], dy[4];
+        ((x1 - x0) * fResScale).store(dx);
+        ((y1 - y0) * fResScale).store(dy);
+
+        // As set_normal_unitnormal() does: normalize in double, then rotate CCW.
+        float ux[4], uy[4];
+        for (int j = 0; j < 4; ++j) {
+            double xx = dx[j];
+            double yy = dy[j];
+            double dmag = sqrt(xx * xx + yy * yy);
+            double dscale = sk_ieee_double_divide(1.0f, dmag);
+            float x = dx[j],
+                  y = dy[j];
+            x *= dscale;
+            y *= dscale;
+            ux[j] = y;
+            uy[j] = -x;
+        }
+        Sk4f unitX = Sk4f::Load(ux),
+             unitY = Sk4f::Load(uy),
+             normalX = unitX * fRadius,
+             normalY = unitY * fRadius;
+        Sk4f::Store4(fOffsetPts[i], x1 + normalX, y1 + normalY, x1 - normalX, y1 - normalY);
+        for (int j = 0; j < 4; ++j) {
+            fUnitNormals[i + j].set(ux[j], uy[j]);
+        }
+    }
+}
+
+bool SkPolylineStroker::findSegment(int srcIndex, const SkPoint& currPt, Segment* segment) {
+    // We only batch segments between consecutive source points.
+    if (srcIndex <= 0 || 0 != memcmp(&fSrcPts[srcIndex - 1], &fPrevPt, sizeof(SkPoint)) ||
+                         0 != memcmp(&fSrcPts[srcIndex], &currPt, sizeof(SkPoint))) {
+        return false;
+    }
+    if (fBatchStart == 0 || srcIndex < fBatchStart || srcIndex >= fBatchStart + kBatchSize) {
+        this->computeSegments(srcIndex);
+    }
+    int i = srcIndex - fBatchStart;
+    segment->fUnitNormal = fUnitNormals[i];
+    segment->fOuter = fOffsetPts[i][0];
+    segment->fInner = fOffsetPts[i][1];
+    // If we can't normalize, SkPathStroker's fallbacks apply.
+    const SkVector& unit = segment->fUnitNormal;
+    return SkScalarsAreFinite(unit.fX, unit.fY) && (unit.fX != 0 || unit.fY != 0);
+}
+
+bool SkPolylineStroker::preJoinTo(const SkPoint& currPt, const Segment* segment,
+                                  SkVector* normal, SkVector* unitNormal) {
+    SkASSERT(fSegmentCount >= 0);
+
+    SkScalar    prevX = fPrevPt.fX;
+    SkScalar    prevY = fPrevPt.fY;
+
+    if (segment) {
+        *unitNormal = segment->fUnitNormal;
+        unitNormal->scale(fRadius, normal);
+    } else if (!set_normal_unitnormal(fPrevPt, currPt, fResScale, fRadius, normal, unitNormal)) {
+        if (fButtCap) {
+            return false;
+        }
+        normal->set(fRadius, 0);
+        unitNormal->set(1, 0);
+    }
+
+    if (fSegmentCount == 0) {
+        fFirstNormal = *normal;
+        fFirstUnitNormal = *unitNormal;
+        fFirstOuterPt.set(prevX + normal->fX, prevY + normal->fY);
+
+        fOuter.moveTo(fFirstOuterPt.fX, fFirstOuterPt.fY);
+        fInner.moveTo(prevX - normal->fX, prevY - normal->fY);
+    } else {    // we have a previous segment
+        fJoiner(&fOuter, &fInner, fPrevUnitNormal, fPrevPt, *unitNormal,
+                fRadius, fInvMiterLimit, fPrevIsLine, true);
+    }
+    fPrevIsLine = true;
+    return true;
+}
+
+void SkPolylineStroker::postJoinTo(const SkPoint& currPt, const SkVector& normal,
+                                   const SkVector& unitNormal) {
+    fJoinCompleted = true;
+    fPrevPt = currPt;
+    fPrevUnitNormal = unitNormal;
+    fPrevNormal = normal;
+    fSegmentCount += 1;
+}
+
+void SkPolylineStroker::finishContour(bool close, bool currIsLine) {
+    if (fSegmentCount > 0) {
+        SkPoint pt;
+
+        if (close) {
+            fJoiner(&fOuter, &fInner, fPrevUnitNormal, fPrevPt,
+                    fFirstUnitNormal, fRadius, fInvMiterLimit,
+                    fPrevIsLine, currIsLine);
+            fOuter.close();
+
+            // now add fInner as its own contour
+            fInner.getLastPt(&pt);
+            fOuter.moveTo(pt.fX, pt.fY);
+            fOuter.reversePathTo(fInner);
+            fOuter.close();
+        } else {    // add caps to start and end
+            // cap the end
+            fInner.getLastPt(&pt);
+            fCapper(&fOuter, fPrevPt, fPrevNormal, pt,
+                    currIsLine ? &fInner : nullptr);
+            fOuter.reversePathTo(fInner);
+            // cap the start
+            fCapper(&fOuter, fFirstPt, -fFirstNormal, fFirstOuterPt,
+                    fPrevIsLine ? &fInner : nullptr);
+            fOuter.close();
+        }
+    }
+    fInner.rewind();
+    fSegmentCount = -1;
+    fFirstOuterPtIndexInContour = fOuter.countPoints();
+}
+
+void SkPolylineStroker::moveTo(const SkPoint& pt) {
+    if (fSegmentCount > 0) {
+        this->finishContour(false, false);
+    }
+    fSegmentCount = 0;
+    fFirstPt = fPrevPt = pt;
+    fJoinCompleted = false;
+}
+
+void SkPolylineStroker::lineTo(const SkPoint& currPt, int srcIndex, const SkPath::Iter* iter) {
+    bool teenyLine = SkPointPriv::EqualsWithinTolerance(fPrevPt, currPt,
+                                                        SK_ScalarNearlyZero * fInvResScale);
+    if (fButtCap && teenyLine) {
+        return;
+    }
+    if (teenyLine && (fJoinCompleted || (iter && has_valid_tangent(iter)))) {
+        return;
+    }
+    Segment     batched;
+    bool        isBatched = this->findSegment(srcIndex, currPt, &batched);
+    SkVector    normal, unitNormal;
+
+    if (!this->preJoinTo(currPt, isBatched ? &batched : nullptr, &normal, &unitNormal)) {
+        return;
+    }
+    if (isBatched) {
+        fOuter.lineTo(batched.fOuter);
+        fInner.lineTo(batched.fInner);
+    } else {
+        fOuter.lineTo(currPt.fX + normal.fX, currPt.fY + normal.fY);
+        fInner.lineTo(currPt.fX - normal.fX, currPt.fY - normal.fY);
+    }
+    this->postJoinTo(currPt, normal, unitNormal);
+}
+
+// Like SkStroke::strokePath(), for paths of lines that we won't fill.
+static void stroke_polyline(const SkPath& src, SkScalar radius, SkScalar miterLimit,
+                            SkPaint::Cap cap, SkPaint::Join join, SkScalar resScale,
+                            SkPath* dst) {
+    SkPolylineStroker stroker(src, radius, miterLimit, cap, join, resScale);
+    SkPath::Iter    iter(src, false);
+    SkPath::Verb    lastSegment = SkPath::kMove_Verb;
+    int             srcIndex = -1;
+
+    for (;;) {
+        SkPoint  pts[4];
+        switch (iter.next(pts, false)) {
+            case SkPath::kMove_Verb:
+                srcIndex += 1;
+                stroker.moveTo(pts[0]);
+                break;
+            case SkPath::kLine_Verb:
+                // The line closing a contour doesn't end at the next source point.
+                if (iter.isCloseLine()) {
+                    stroker.lineTo(pts[1], -1, &iter);
+                } else {
+                    srcIndex += 1;
+                    stroker.lineTo(pts[1], srcIndex, &iter);
+                }
+                lastSegment = SkPath::kLine_Verb;
+                break;
+            case SkPath::kClose_Verb:
+                if (SkPaint::kButt_Cap != cap) {
+                    if (stroker.hasOnlyMoveTo()) {
+                        stroker.lineTo(stroker.moveToPt(), -1);
+                        goto ZERO_LENGTH;
+                    }
+                    if (stroker.isCurrentContourEmpty()) {
+                ZERO_LENGTH:
+                        lastSegment = SkPath::kLine_Verb;
+                        break;
+                    }
+                }
+                stroker.close(lastSegment == SkPath::kLine_Verb);
+                break;
+            case SkPath::kDone_Verb:
+                goto DONE;
+            default:
+                SkDEBUGFAIL("unexpected verb");
+                break;
+        }
+    }
+DONE:
+    stroker.done(dst, lastSegment == SkPath::kLine_Verb);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -1308,6 +1646,7 @@ SkStroke::SkStroke() {
     fCap        = SkPaint::kDefault_Cap;
     fJoin       = SkPaint::kDefault_Join;
     fDoFill     = false;
+    fBatchPolylines = gSkBatchPolylineStrokes;
 }
 
 SkStroke::SkStroke(const SkPaint& p) {
@@ -1317,6 +1656,7 @@ SkStroke::SkStroke(const SkPaint& p) {
     fCap        = (uint8_t)p.getStrokeCap();
     fJoin       = (uint8_t)p.getStrokeJoin();
     fDoFill     = SkToU8(p.getStyle() == SkPaint::kStrokeAndFill_Style);
+    fBatchPolylines = gSkBatchPolylineStrokes;
 }
 
 SkStroke::SkStroke(const SkPaint& p, SkScalar width) {
@@ -1326,6 +1666,7 @@ SkStroke::SkStroke(const SkPaint& p, SkScalar width) {
     fCap        = (uint8_t)p.getStrokeCap();
     fJoin       = (uint8_t)p.getStrokeJoin();
     fDoFill     = SkToU8(p.getStyle() == SkPaint::kStrokeAndFill_Style);
+    fBatchPolylines = gSkBatchPolylineStrokes;
 }
 
 void SkStroke::setWidth(SkScalar width) {
@@ -1403,6 +1744,18 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
         }
     }
 
+    // Paths of lines that we won't fill have a faster stroker.
+    if (fBatchPolylines && !fDoFill &&
+            src.getSegmentMasks() == SkPath::kLine_SegmentMask && src.isFinite()) {
+        stroke_polyline(src, radius, fMiterLimit, this->getCap(), this->getJoin(), fResScale, dst);
+        // our answer should preserve the inverseness of the src
+        if (src.isInverseFillType()) {
+            SkASSERT(!dst->isInverseFillType());
+            dst->toggleInverseFillType();
+        }
+        return;
+    }
+
     // We can always ignore centers for stroke and fill convex line-only paths
     // TODO: remove the line-only restriction
     bool ignoreCenter = fDoFill && (src.getSegmentMasks() == SkPath::kLine_SegmentMask) &&
@@ -14,6 +14,13 @@
 #include "SkStrokerPriv.h"
 #include "SkTo.h"
 
+#include <atomic>
+
+// If set, strokePath() strokes paths made only of lines with a batched stroker that matches the
+// general one exactly, but runs much faster on long polylines.  Off by default: the batched
+// stroker still duplicates SkPathStroker's line code.
+extern std::atomic<bool> gSkBatchPolylineStrokes;
+
 #ifdef SK_DEBUG
 extern bool gDebugStrokerErrorSet;
 extern SkScalar gDebugStrokerError;
@@ -65,6 +72,9 @@ public:
                        SkPath::Direction = SkPath::kCW_Direction) const;
     void    strokePath(const SkPath& path, SkPath*) const;
 
+    // Test hook: overrides gSkBatchPolylineStrokes for this stroke.
+    void    setBatchPolylinesForTesting(bool batch) { fBatchPolylines = batch; }
+
     ////////////////////////////////////////////////////////////////
 
 private:
@@ -72,6 +82,7 @@ private:
     SkScalar    fResScale;
     uint8_t     fCap, fJoin;
     bool        fDoFill;
+    bool        fBatchPolylines;
 
     friend class SkPaint;
 };
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStrokeCache.h"
+
+std::atomic<bool> gSkCacheStrokedPaths{false};
+
+namespace {
+struct StrokeParams {
+    explicit StrokeParams(const SkStrokeRec& rec)
+        : fStyle(rec.getStyle())
+        , fCap(rec.getCap())
+        , fJoin(rec.getJoin())
+        , fWidth(rec.getWidth())
+        , fMiter(rec.getMiter())
+        , fResScale(rec.getResScale()) {}
+
+    int32_t     fStyle;
+    int32_t     fCap;
+    int32_t     fJoin;
+    SkScalar    fWidth;
+    SkScalar    fMiter;
+    SkScalar    fResScale;
+};
+} // namespace
+
+static size_t outline_bytes(const SkPath& outline) {
+    return sizeof(SkPathRef) + outline.countPoints() * sizeof(SkPoint) +
+           outline.countVerbs() * sizeof(uint8_t);
+}
+
+// SkPaths are copy-on-write, so finding an outline just shares its points.
+static SkPathResourceCache<StrokeParams, SkPath> gCache("stroked-path", outline_bytes);
+
+bool SkStrokeCache::Find(const SkPath& src, const SkStrokeRec& rec, SkPath* dst,
+                         SkResourceCache* localCache) {
+    return gCache.find(src, StrokeParams(rec), dst, localCache);
+}
+
+void SkStrokeCache::Add(const SkPath& src, const SkStrokeRec& rec, const SkPath& dst,
+                        SkResourceCache* localCache) {
+    SkASSERT(rec.getWidth() > 0);
+    gCache.add(src, StrokeParams(rec), dst, localCache);
+}
+
+bool SkStrokeCache::ApplyToPath(const SkStrokeRec& rec, const SkPath& src, SkPath* dst,
+                                SkResourceCache* localCache) {
+    SkASSERT(dst != &src);
+    bool cacheable = !src.isVolatile() && rec.getWidth() > 0;
+    if (cacheable && Find(src, rec, dst, localCache)) {
+        return true;
+    }
+    if (!rec.applyToPath(dst, src)) {
+        return false;
+    }
+    if (cacheable && dst->isFinite()) {
+        Add(src, rec, *dst, localCache);
+    }
+    return true;
+}
+
+void SkStrokeCache::GetStats(int64_t* hits, int64_t* misses) {
+    gCache.getStats(hits, misses);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrokeCache_DEFINED
+#define SkStrokeCache_DEFINED
+
+#include "SkPath.h"
+#include "SkResourceCache.h"
+#include "SkStrokeRec.h"
+
+#include <atomic>
+
+// If set, SkPaint::getFillPath() keeps the outlines it strokes from (non-volatile) paths in
+// SkResourceCache, so restroking the same path with the same stroke skips SkStroke.
+extern std::atomic<bool> gSkCacheStrokedPaths;
+
+/**
+ *  Caches the fill path a stroke makes from a path, keyed by the path's generation ID and fill
+ *  type, the stroke's width, miter limit, cap, join and style, and its resolution scale.
+ *  Entries are purged when the path's generation ID changes (i.e. it's edited or destroyed).
+ */
+class SkStrokeCache {
+public:
+    /**
+     *  On success, set dst to the cached outline of src stroked by rec and return true.
+     */
+    static bool Find(const SkPath& src, const SkStrokeRec& rec, SkPath* dst,
+                     SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Add dst, the outline of src stroked by rec, to the cache.  rec must be a stroke with a
+     *  positive width (not a fill or hairline).
+     */
+    static void Add(const SkPath& src, const SkStrokeRec& rec, const SkPath& dst,
+                    SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Stroke src by rec into dst, as rec.applyToPath(dst, src) does, going through the cache
+     *  if src isn't volatile and rec is a stroke with a positive width.  dst must not be src.
+     */
+    static bool ApplyToPath(const SkStrokeRec& rec, const SkPath& src, SkPath* dst,
+                            SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Reports how many times Find() found an outline (hits) or didn't (misses), since the
+     *  process started.
+     */
+    static void GetStats(int64_t* hits, int64_t* misses);
+};
+
+#endif
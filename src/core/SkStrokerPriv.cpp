@@ -8,17 +8,20 @@
 #include "SkStrokerPriv.h"
 #include "SkGeometry.h"
 #include "SkPath.h"
+#include "SkPathPriv.h"
 #include "SkPointPriv.h"
 
 #include <utility>
 
-static void ButtCapper(SkPath* path, const SkPoint& pivot, const SkVector& normal,
-                       const SkPoint& stop, SkPath*) {
+template <typename Path>
+static void ButtCapper(Path* path, const SkPoint& pivot, const SkVector& normal,
+                       const SkPoint& stop, Path*) {
     path->lineTo(stop.fX, stop.fY);
 }
 
-static void RoundCapper(SkPath* path, const SkPoint& pivot, const SkVector& normal,
-                        const SkPoint& stop, SkPath*) {
+template <typename Path>
+static void RoundCapper(Path* path, const SkPoint& pivot, const SkVector& normal,
+                        const SkPoint& stop, Path*) {
     SkVector parallel;
     SkPointPriv::RotateCW(normal, &parallel);
 
@@ -28,8 +31,9 @@ static void RoundCapper(SkPath* path, const SkPoint& pivot, const SkVector& norm
     path->conicTo(projectedCenter - normal, stop, SK_ScalarRoot2Over2);
 }
 
-static void SquareCapper(SkPath* path, const SkPoint& pivot, const SkVector& normal,
-                         const SkPoint& stop, SkPath* otherPath) {
+template <typename Path>
+static void SquareCapper(Path* path, const SkPoint& pivot, const SkVector& normal,
+                         const SkPoint& stop, Path* otherPath) {
     SkVector parallel;
     SkPointPriv::RotateCW(normal, &parallel);
 
@@ -67,7 +71,8 @@ static AngleType Dot2AngleType(SkScalar dot) {
     }
 }
 
-static void HandleInnerJoin(SkPath* inner, const SkPoint& pivot, const SkVector& after) {
+template <typename Path>
+static void HandleInnerJoin(Path* inner, const SkPoint& pivot, const SkVector& after) {
 #if 1
     /*  In the degenerate case that the stroke radius is larger than our segments
         just connecting the two inner segments may "show through" as a funny
@@ -81,7 +86,8 @@ static void HandleInnerJoin(SkPath* inner, const SkPoint& pivot, const SkVector&
     inner->lineTo(pivot.fX - after.fX, pivot.fY - after.fY);
 }
 
-static void BluntJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnitNormal,
+template <typename Path>
+static void BluntJoiner(Path* outer, Path* inner, const SkVector& beforeUnitNormal,
                         const SkPoint& pivot, const SkVector& afterUnitNormal,
                         SkScalar radius, SkScalar invMiterLimit, bool, bool) {
     SkVector    after;
@@ -97,7 +103,8 @@ static void BluntJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
     HandleInnerJoin(inner, pivot, after);
 }
 
-static void RoundJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnitNormal,
+template <typename Path>
+static void RoundJoiner(Path* outer, Path* inner, const SkVector& beforeUnitNormal,
                         const SkPoint& pivot, const SkVector& afterUnitNormal,
                         SkScalar radius, SkScalar invMiterLimit, bool, bool) {
     SkScalar    dotProd = SkPoint::DotProduct(beforeUnitNormal, afterUnitNormal);
@@ -134,7 +141,8 @@ static void RoundJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnit
 
 #define kOneOverSqrt2   (0.707106781f)
 
-static void MiterJoiner(SkPath* outer, SkPath* inner, const SkVector& beforeUnitNormal,
+template <typename Path>
+static void MiterJoiner(Path* outer, Path* inner, const SkVector& beforeUnitNormal,
                         const SkPoint& pivot, const SkVector& afterUnitNormal,
                         SkScalar radius, SkScalar invMiterLimit,
                         bool prevIsLine, bool currIsLine) {
@@ -233,3 +241,170 @@ SkStrokerPriv::JoinProc SkStrokerPriv::JoinFactory(SkPaint::Join join) {
     SkASSERT((unsigned)join < SkPaint::kJoinCount);
     return gJoiners[join];
 }
+
+SkStrokerPriv::BuilderCapProc SkStrokerPriv::BuilderCapFactory(SkPaint::Cap cap) {
+    const SkStrokerPriv::BuilderCapProc gCappers[] = {
+        ButtCapper, RoundCapper, SquareCapper
+    };
+
+    SkASSERT((unsigned)cap < SkPaint::kCapCount);
+    return gCappers[cap];
+}
+
+SkStrokerPriv::BuilderJoinProc SkStrokerPriv::BuilderJoinFactory(SkPaint::Join join) {
+    const SkStrokerPriv::BuilderJoinProc gJoiners[] = {
+        MiterJoiner, RoundJoiner, BluntJoiner
+    };
+
+    SkASSERT((unsigned)join < SkPaint::kJoinCount);
+    return gJoiners[join];
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+// Each of these follows its SkPath counterpart exactly, so the verbs and points we collect are
+// the ones SkPath would have stored.
+
+bool SkStrokerPriv::PathBuilder::getLastPt(SkPoint* lastPt) const {
+    if (fPts.isEmpty()) {
+        lastPt->set(0, 0);
+        return false;
+    }
+    *lastPt = fPts.top();
+    return true;
+}
+
+bool SkStrokerPriv::PathBuilder::isZeroLengthSincePoint(int startPtIndex) const {
+    int count = fPts.count() - startPtIndex;
+    if (count < 2) {
+        return true;
+    }
+    const SkPoint* pts = fPts.begin() + startPtIndex;
+    for (int index = 1; index < count; ++index) {
+        if (pts[0] != pts[index]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SkStrokerPriv::PathBuilder::injectMoveToIfNeeded() {
+    if (fLastMoveToIndex < 0) {
+        if (fVerbs.isEmpty()) {
+            this->moveTo(0, 0);
+        } else {
+            SkPoint pt = fPts[~fLastMoveToIndex];
+            this->moveTo(pt.fX, pt.fY);
+        }
+    }
+}
+
+void SkStrokerPriv::PathBuilder::moveTo(SkScalar x, SkScalar y) {
+    fLastMoveToIndex = fPts.count();
+    *fVerbs.append() = SkPath::kMove_Verb;
+    fPts.append()->set(x, y);
+}
+
+void SkStrokerPriv::PathBuilder::lineTo(SkScalar x, SkScalar y) {
+    this->injectMoveToIfNeeded();
+    *fVerbs.append() = SkPath::kLine_Verb;
+    fPts.append()->set(x, y);
+}
+
+void SkStrokerPriv::PathBuilder::quadTo(const SkPoint& pt1, const SkPoint& pt2) {
+    this->injectMoveToIfNeeded();
+    *fVerbs.append() = SkPath::kQuad_Verb;
+    SkPoint* pts = fPts.append(2);
+    pts[0] = pt1;
+    pts[1] = pt2;
+}
+
+void SkStrokerPriv::PathBuilder::conicTo(const SkPoint& pt1, const SkPoint& pt2,
+                                         SkScalar weight) {
+    // check for <= 0 or NaN with this test
+    if (!(weight > 0)) {
+        this->lineTo(pt2);
+    } else if (!SkScalarIsFinite(weight)) {
+        this->lineTo(pt1);
+        this->lineTo(pt2);
+    } else if (SK_Scalar1 == weight) {
+        this->quadTo(pt1, pt2);
+    } else {
+        this->injectMoveToIfNeeded();
+        *fVerbs.append() = SkPath::kConic_Verb;
+        SkPoint* pts = fPts.append(2);
+        pts[0] = pt1;
+        pts[1] = pt2;
+        *fConicWeights.append() = weight;
+    }
+}
+
+void SkStrokerPriv::PathBuilder::setLastPt(SkScalar x, SkScalar y) {
+    if (fPts.isEmpty()) {
+        this->moveTo(x, y);
+    } else {
+        fPts.top().set(x, y);
+    }
+}
+
+void SkStrokerPriv::PathBuilder::close() {
+    // don't add a close if it's the first verb or a repeat
+    if (!fVerbs.isEmpty() && fVerbs.top() != SkPath::kClose_Verb) {
+        *fVerbs.append() = SkPath::kClose_Verb;
+    }
+    // signal that we need a moveTo to follow us (unless we're done)
+    fLastMoveToIndex ^= ~fLastMoveToIndex >> (8 * sizeof(fLastMoveToIndex) - 1);
+}
+
+void SkStrokerPriv::PathBuilder::reversePathTo(const PathBuilder& path) {
+    if (path.fVerbs.isEmpty()) {
+        return;
+    }
+    SkASSERT(path.fVerbs[0] == SkPath::kMove_Verb);
+    const SkPoint*  pts = path.fPts.end() - 1;
+    const SkScalar* conicWeights = path.fConicWeights.end();
+
+    // Walk back to the first verb of the last contour.
+    for (int i = path.fVerbs.count() - 1; i > 0; --i) {
+        switch (path.fVerbs[i]) {
+            case SkPath::kMove_Verb:
+                // if the path has multiple contours, stop after reversing the last
+                return;
+            case SkPath::kLine_Verb:
+                pts -= 1;
+                this->lineTo(pts[0]);
+                break;
+            case SkPath::kQuad_Verb:
+                pts -= 2;
+                this->quadTo(pts[1], pts[0]);
+                break;
+            case SkPath::kConic_Verb:
+                pts -= 2;
+                this->conicTo(pts[1], pts[0], *--conicWeights);
+                break;
+            case SkPath::kClose_Verb:
+                SkASSERT(i == path.fVerbs.count() - 1);
+                break;
+            default:
+                SkDEBUGFAIL("unexpected verb");
+                break;
+        }
+    }
+}
+
+void SkStrokerPriv::PathBuilder::rewind() {
+    fVerbs.rewind();
+    fPts.rewind();
+    fConicWeights.rewind();
+    fLastMoveToIndex = ~0;
+}
+
+void SkStrokerPriv::PathBuilder::reserve(int points) {
+    fVerbs.setReserve(points);
+    fPts.setReserve(points);
+}
+
+void SkStrokerPriv::PathBuilder::appendTo(SkPath* path) const {
+    SkPathPriv::AppendVerbs(path, fVerbs.begin(), fVerbs.count(), fPts.begin(),
+                            fConicWeights.begin());
+}
@@ -10,6 +10,7 @@
 #define SkStrokerPriv_DEFINED
 
 #include "SkStroke.h"
+#include "SkTDArray.h"
 
 #define CWX(x, y)   (-y)
 #define CWY(x, y)   (x)
@@ -38,6 +39,61 @@ public:
 
     static CapProc  CapFactory(SkPaint::Cap);
     static JoinProc JoinFactory(SkPaint::Join);
+
+    /**
+     *  Collects the verbs, points and conic weights of a stroke just as SkPath would for the
+     *  edits the cappers and joiners make, but without SkPath's bookkeeping on every edit.
+     *  Line-only paths are stroked into these (see SkStroke.cpp), and then copied into an SkPath
+     *  in a single edit.
+     */
+    class PathBuilder {
+    public:
+        int countPoints() const { return fPts.count(); }
+        bool getLastPt(SkPoint*) const;
+        bool isZeroLengthSincePoint(int startPtIndex) const;
+
+        void moveTo(SkScalar x, SkScalar y);
+        void lineTo(SkScalar x, SkScalar y);
+        void lineTo(const SkPoint& pt) { this->lineTo(pt.fX, pt.fY); }
+        void quadTo(const SkPoint& pt1, const SkPoint& pt2);
+        void conicTo(const SkPoint& pt1, const SkPoint& pt2, SkScalar weight);
+        void setLastPt(SkScalar x, SkScalar y);
+        void close();
+
+        // Like SkPath::reversePathTo(), adds the last contour of path, in reverse.
+        void reversePathTo(const PathBuilder& path);
+
+        void rewind();
+        void reserve(int points);
+
+        // Appends our verbs to the path, as if we'd made the same edits to it.
+        void appendTo(SkPath*) const;
+
+    private:
+        void injectMoveToIfNeeded();
+
+        SkTDArray<uint8_t>  fVerbs;
+        SkTDArray<SkPoint>  fPts;
+        SkTDArray<SkScalar> fConicWeights;
+        int                 fLastMoveToIndex = ~0;
+    };
+
+    typedef void (*BuilderCapProc)(PathBuilder* path,
+                                   const SkPoint& pivot,
+                                   const SkVector& normal,
+                                   const SkPoint& stop,
+                                   PathBuilder* otherPath);
+
+    typedef void (*BuilderJoinProc)(PathBuilder* outer, PathBuilder* inner,
+                                    const SkVector& beforeUnitNormal,
+                                    const SkPoint& pivot,
+                                    const SkVector& afterUnitNormal,
+                                    SkScalar radius, SkScalar invMiterLimit,
+                                    bool prevIsLine, bool currIsLine);
+
+    // The same cappers and joiners as above, writing to PathBuilders.
+    static BuilderCapProc  BuilderCapFactory(SkPaint::Cap);
+    static BuilderJoinProc BuilderJoinFactory(SkPaint::Join);
 };
 
 #endif
@@ -10,6 +10,7 @@
 
 #include "SkSurfaceProps.h"
 
+class SkSurface;
 struct SkImageInfo;
 
 static inline SkSurfaceProps SkSurfacePropsCopyOrDefault(const SkSurfaceProps* props) {
@@ -24,4 +25,8 @@ constexpr size_t kIgnoreRowBytesValue = static_cast<size_t>(~0);
 
 bool SkSurfaceValidateRasterInfo(const SkImageInfo&, size_t rb = kIgnoreRowBytesValue);
 
+// Test hook: make a raster surface batch fills (see gSkBatchRasterFills) or not, whatever the
+// global said when it was made.  Call before its canvas is first used.
+void SkSurfaceSetBatchRasterFillsForTesting(SkSurface*, bool batchFills);
+
 #endif
@@ -29,6 +29,33 @@ void SkTaskGroup::batch(int N, std::function<void(int)> fn) {
     }
 }
 
+// When the caller doesn't pick a grain size, aim for this many chunks.  That's enough to keep a
+// few dozen threads busy even if some chunks run slower than others.
+static constexpr int kAutoChunks = 64;
+
+static int auto_grain(int N, int grain) {
+    return grain > 0 ? grain : SkTMax(1, (N + kAutoChunks - 1) / kAutoChunks);
+}
+
+static void fork_join(SkTaskGroup* tasks, int start, int end, int grain,
+                      const std::function<void(int, int)>* fn) {
+    // Keep the front half of the range and fork off the back half until it's small enough.
+    while (end - start > grain) {
+        int mid = start + (end - start) / 2;
+        tasks->add([=] { fork_join(tasks, mid, end, grain, fn); });
+        end = mid;
+    }
+    (*fn)(start, end);
+}
+
+void SkTaskGroup::forkJoin(int N, int grain, std::function<void(int, int)> fn) {
+    if (N > 0) {
+        // fn outlives all the tasks, as we wait() for them before returning.
+        fork_join(this, 0, N, auto_grain(N, grain), &fn);
+    }
+    this->wait();
+}
+
 bool SkTaskGroup::done() const {
     return fPending.load(std::memory_order_acquire) == 0;
 }
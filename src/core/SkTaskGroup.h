@@ -26,6 +26,12 @@ public:
     // Add a batch of N tasks, all calling fn with different arguments.
     void batch(int N, std::function<void(int)> fn);
 
+    // Call fn(start, end) over all of [0, N), then wait().  The range is split in half
+    // recursively, each time adding one half as a task and keeping the other, until the pieces
+    // are no bigger than grain (or a size we pick if grain <= 0).  Big pieces are added first,
+    // so threads that steal work from each other steal big pieces.
+    void forkJoin(int N, int grain, std::function<void(int start, int end)> fn);
+
     // Returns true if all Tasks previously add()ed to this SkTaskGroup have run.
     // It is safe to reuse this SkTaskGroup once done().
     bool done() const;
@@ -0,0 +1,373 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkThreadedBMPDevice.h"
+
+#include "SkBlitter.h"
+#include "SkExecutor.h"
+#include "SkMakeUnique.h"
+#include "SkPaint.h"
+#include "SkRRect.h"
+#include "SkShader.h"
+#include "SkSharedScan.h"
+#include "SkSpecialImage.h"
+#include "SkTLazy.h"
+#include "SkTaskGroup.h"
+#include "SkXfermodeInterpretation.h"
+#include <vector>
+
+// Like SkDrawTiler, we never hand SkDraw a destination bigger than this.
+static constexpr int kMaxTileDim = 8192 - 1;
+
+// With no explicit tile count, aim for bands about this tall.
+static constexpr int kDefaultTileHeight = 256;
+
+// Bound the memory held by pending draws.
+static constexpr int kMaxQueuedDraws = 2048;
+
+// Devices no bigger than that draw every tile in place, in device coordinates.
+static bool draws_in_place(int width, int height) {
+    return width <= kMaxTileDim && height <= kMaxTileDim;
+}
+
+// Whether SkBlitter::Choose() might pick a legacy (N32 or 565) blitter for this paint.
+static bool may_use_legacy_blitter(const SkPixmap& dst, const SkMatrix& ctm,
+                                   const SkPaint& paint) {
+    // Like Choose(), first see if we can act like SrcOver.
+    SkTCopyOnFirstWrite<SkPaint> p(paint);
+    if (paint.getBlendMode() != SkBlendMode::kSrcOver &&
+        kSrcOver_SkXfermodeInterpretation ==
+                SkInterpretXfermode(paint, SkColorTypeIsAlwaysOpaque(dst.colorType()))) {
+        p.writable()->setBlendMode(SkBlendMode::kSrcOver);
+    }
+    return !SkBlitter::UseRasterPipelineBlitter(dst, *p, ctm);
+}
+
+static const SkRect* fast_bounds(const SkRect& r, const SkPaint& paint, SkRect* storage) {
+    return paint.canComputeFastBounds() ? &paint.computeFastBounds(r, storage) : nullptr;
+}
+
+SkThreadedBMPDevice::SkThreadedBMPDevice(const SkBitmap& bitmap,
+                                         const SkSurfaceProps& surfaceProps,
+                                         SkExecutor* executor, int tiles)
+        : INHERITED(bitmap, surfaceProps, nullptr, nullptr)
+        , fExecutor(executor) {
+    const int w = bitmap.width(),
+              h = bitmap.height();
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    if (tiles <= 0) {
+        tiles = SkTMax(1, h / kDefaultTileHeight);
+    }
+    tiles = SkTMin(tiles, h);
+
+    // Split into horizontal bands, then split each band into columns if it's too wide.
+    const int bandHeight = SkTMin((h + tiles - 1) / tiles, kMaxTileDim);
+    for (int y = 0; y < h; y += bandHeight) {
+        for (int x = 0; x < w; x += kMaxTileDim) {
+            fTileBounds.push_back(SkIRect::MakeLTRB(x, y, SkTMin(x + kMaxTileDim, w),
+                                                          SkTMin(y + bandHeight, h)));
+        }
+    }
+}
+
+SkThreadedBMPDevice::~SkThreadedBMPDevice() {
+    this->flush();
+}
+
+SkIRect SkThreadedBMPDevice::devBounds(const SkRect* localBounds) const {
+    SkIRect bounds = fRCStack.rc().getBounds();
+    if (localBounds) {
+        // Outset a pixel to be conservative about antialiasing.
+        SkIRect drawBounds = this->ctm().mapRect(*localBounds).roundOut();
+        drawBounds.outset(1, 1);
+        if (!bounds.intersect(drawBounds)) {
+            bounds.setEmpty();
+        }
+    }
+    return bounds;
+}
+
+bool SkThreadedBMPDevice::drawsSerially(const SkPaint& paint) const {
+    // Anti-aliased pixel pairs straddling a tile seam are blended a pixel at a time, and the
+    // legacy blitters round single pixels differently than pairs.
+    return paint.isAntiAlias() && fTileBounds.count() > 1 &&
+           may_use_legacy_blitter(fBitmap.pixmap(), this->ctm(), paint);
+}
+
+void SkThreadedBMPDevice::record(const SkIRect& devBounds, DrawFn&& drawFn) {
+    if (devBounds.isEmpty() || fTileBounds.empty()) {
+        return;
+    }
+    // Tiles drawn in place can share one scan conversion of each path (see SkSharedScan).
+    std::unique_ptr<SkSharedScan> scan;
+    if (fTileBounds.count() > 1 && draws_in_place(fBitmap.width(), fBitmap.height())) {
+        int users = 0;
+        for (const SkIRect& tile : fTileBounds) {
+            users += SkIRect::Intersects(devBounds, tile);
+        }
+        scan = skstd::make_unique<SkSharedScan>(users);
+    }
+    fQueue.push_back({std::move(drawFn), devBounds, SkRecords::TypedMatrix(this->ctm()),
+                      fRCStack.rc(), std::move(scan)});
+    if (fQueue.count() >= kMaxQueuedDraws) {
+        this->flush();
+    }
+}
+
+void SkThreadedBMPDevice::drawTile(const SkPixmap& root, const SkIRect& tile) const {
+    // When the whole device is small enough we draw into it directly, only clipped to the tile.
+    // That keeps every coordinate (and so every rounding decision and dither phase) the same as
+    // drawing serially, and fScanRC scan converts against the whole clip, so edges aren't
+    // chopped differently on each tile.  Paths are scan converted that way only once, by the
+    // first tile to draw them, and every tile replays its own rows of that (fSharedScan).
+    // Bigger devices draw into the tile itself, as SkDrawTiler would.
+    const bool translate = !draws_in_place(root.width(), root.height());
+    const SkIPoint origin = translate ? SkIPoint::Make(tile.x(), tile.y()) : SkIPoint::Make(0, 0);
+
+    SkDraw draw;
+    if (translate) {
+        SkAssertResult(root.extractSubset(&draw.fDst, tile));
+    } else {
+        draw.fDst = root;
+    }
+    const SkIRect clip = tile.makeOffset(-origin.x(), -origin.y());
+
+    for (const DrawElement& element : fQueue) {
+        if (!SkIRect::Intersects(element.fDevBounds, tile)) {
+            continue;
+        }
+
+        SkRasterClip rc;
+        element.fRC.translate(-origin.x(), -origin.y(), &rc);
+        if (rc.op(clip, SkRegion::kIntersect_Op)) {
+            SkMatrix matrix = element.fMatrix;
+            if (translate) {
+                matrix.postTranslate(SkIntToScalar(-origin.x()), SkIntToScalar(-origin.y()));
+            }
+
+            draw.fMatrix = &matrix;
+            draw.fRC = &rc;
+            draw.fScanRC = translate ? nullptr : &element.fRC;
+            draw.fSharedScan = translate ? nullptr : element.fScan.get();
+            element.fDrawFn(draw, origin);
+        }
+        if (element.fScan) {
+            element.fScan->done();
+        }
+    }
+}
+
+void SkThreadedBMPDevice::flush() {
+    if (fQueue.empty()) {
+        return;
+    }
+
+    // We go straight to fBitmap here; our onPeekPixels() and onAccessPixels() would flush.
+    SkPixmap root;
+    if (fBitmap.peekPixels(&root)) {
+        fBitmap.notifyPixelsChanged();
+        SkTaskGroup tasks(fExecutor ? *fExecutor : SkExecutor::GetDefault());
+        tasks.batch(fTileBounds.count(), [&](int i) {
+            this->drawTile(root, fTileBounds[i]);
+        });
+        tasks.wait();
+    }
+    fQueue.reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void SkThreadedBMPDevice::drawPaint(const SkPaint& paint) {
+    this->record(this->devBounds(nullptr), [paint](const SkDraw& draw, const SkIPoint&) {
+        draw.drawPaint(paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPoints(SkCanvas::PointMode mode, size_t count,
+                                     const SkPoint pts[], const SkPaint& paint) {
+    if (0 == count) {
+        return;
+    }
+    if (this->drawsSerially(paint)) {
+        this->flush();
+        INHERITED::drawPoints(mode, count, pts, paint);
+        return;
+    }
+    SkRect r, storage;
+    r.set(pts, SkToInt(count));
+    const SkRect* bounds = paint.canComputeFastBounds()
+                         ? &paint.computeFastStrokeBounds(r, &storage)
+                         : nullptr;
+
+    std::vector<SkPoint> points(pts, pts + count);
+    this->record(this->devBounds(bounds),
+                 [mode, points, paint](const SkDraw& draw, const SkIPoint&) {
+        draw.drawPoints(mode, points.size(), points.data(), paint, nullptr);
+    });
+}
+
+void SkThreadedBMPDevice::drawRect(const SkRect& r, const SkPaint& paint) {
+    if (this->drawsSerially(paint)) {
+        this->flush();
+        INHERITED::drawRect(r, paint);
+        return;
+    }
+    SkRect storage;
+    this->record(this->devBounds(fast_bounds(r, paint, &storage)),
+                 [r, paint](const SkDraw& draw, const SkIPoint&) {
+        draw.drawRect(r, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
+    if (this->drawsSerially(paint)) {
+        this->flush();
+        INHERITED::drawRRect(rrect, paint);
+        return;
+    }
+    SkRect storage;
+    this->record(this->devBounds(fast_bounds(rrect.getBounds(), paint, &storage)),
+                 [rrect, paint](const SkDraw& draw, const SkIPoint&) {
+        draw.drawRRect(rrect, paint);
+    });
+}
+
+void SkThreadedBMPDevice::drawPath(const SkPath& path, const SkPaint& paint,
+                                   bool pathIsMutable) {
+    if (this->drawsSerially(paint)) {
+        this->flush();
+        INHERITED::drawPath(path, paint, pathIsMutable);
+        return;
+    }
+    SkRect storage;
+    const SkRect* bounds = path.isInverseFillType()
+                         ? nullptr
+                         : fast_bounds(path.getBounds(), paint, &storage);
+    // PreCachedPath makes the lazily computed bits of the path safe to read from many threads.
+    SkRecords::PreCachedPath cached(path);
+    this->record(this->devBounds(bounds),
+                 [cached, paint](const SkDraw& draw, const SkIPoint&) {
+        draw.drawPath(cached, paint, nullptr, false);
+    });
+}
+
+void SkThreadedBMPDevice::drawSprite(const SkBitmap& bitmap, int x, int y, const SkPaint& paint) {
+    const SkRect r = SkRect::MakeXYWH(SkIntToScalar(x), SkIntToScalar(y),
+                                      SkIntToScalar(bitmap.width()),
+                                      SkIntToScalar(bitmap.height()));
+    SkIRect bounds = fRCStack.rc().getBounds();
+    if (!bounds.intersect(r.roundOut())) {
+        return;
+    }
+    this->record(bounds, [bitmap, x, y, paint](const SkDraw& draw, const SkIPoint& origin) {
+        draw.drawSprite(bitmap, x - origin.x(), y - origin.y(), paint);
+    });
+    // The caller may change mutable pixels as soon as we return.
+    if (!bitmap.isImmutable()) {
+        this->flush();
+    }
+}
+
+void SkThreadedBMPDevice::drawBitmap(const SkBitmap& bitmap, const SkMatrix& matrix,
+                                     const SkRect* dstOrNull, const SkPaint& paint) {
+    // The bitmap is drawn with a shader, which may be legacy too.
+    if (paint.isAntiAlias() && !paint.getShader()) {
+        SkPaint shaded(paint);
+        shaded.setShader(SkShader::MakeEmptyShader());
+        if (this->drawsSerially(shaded)) {
+            this->flush();
+            INHERITED::drawBitmap(bitmap, matrix, dstOrNull, paint);
+            return;
+        }
+    }
+    SkRect storage;
+    const SkRect* bounds = dstOrNull;
+    if (!bounds) {
+        storage = matrix.mapRect(SkRect::MakeIWH(bitmap.width(), bitmap.height()));
+        bounds = &storage;
+    }
+    bounds = fast_bounds(*bounds, paint, &storage);
+
+    const bool hasDst = dstOrNull != nullptr;
+    const SkRect dst = hasDst ? *dstOrNull : SkRect::MakeEmpty();
+    this->record(this->devBounds(bounds),
+                 [bitmap, matrix, hasDst, dst, paint](const SkDraw& draw, const SkIPoint&) {
+        draw.drawBitmap(bitmap, matrix, hasDst ? &dst : nullptr, paint);
+    });
+    if (!bitmap.isImmutable()) {
+        this->flush();
+    }
+}
+
+void SkThreadedBMPDevice::drawBitmapRect(const SkBitmap& bitmap, const SkRect* src,
+                                         const SkRect& dst, const SkPaint& paint,
+                                         SkCanvas::SrcRectConstraint constraint) {
+    // This may build a shader that shares bitmap's pixels without copying them.
+    INHERITED::drawBitmapRect(bitmap, src, dst, paint, constraint);
+    if (!bitmap.isImmutable()) {
+        this->flush();
+    }
+}
+
+// Glyph runs and vertices point at memory owned by the caller, so we draw them right away.
+void SkThreadedBMPDevice::drawGlyphRunList(const SkGlyphRunList& glyphRunList) {
+    this->flush();
+    INHERITED::drawGlyphRunList(glyphRunList);
+}
+
+void SkThreadedBMPDevice::drawVertices(const SkVertices* vertices, const SkVertices::Bone bones[],
+                                       int boneCount, SkBlendMode mode, const SkPaint& paint) {
+    this->flush();
+    INHERITED::drawVertices(vertices, bones, boneCount, mode, paint);
+}
+
+void SkThreadedBMPDevice::drawDevice(SkBaseDevice* device, int x, int y, const SkPaint& paint) {
+    // Layers with coverage are drawn directly into our pixels, the rest go through drawSprite().
+    if (static_cast<SkBitmapDevice*>(device)->accessCoverage()) {
+        this->flush();
+    }
+    INHERITED::drawDevice(device, x, y, paint);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+sk_sp<SkSpecialImage> SkThreadedBMPDevice::snapSpecial() {
+    this->flush();
+    return INHERITED::snapSpecial();
+}
+
+sk_sp<SkSpecialImage> SkThreadedBMPDevice::snapBackImage(const SkIRect& bounds) {
+    this->flush();
+    return INHERITED::snapBackImage(bounds);
+}
+
+bool SkThreadedBMPDevice::onReadPixels(const SkPixmap& pm, int x, int y) {
+    this->flush();
+    return INHERITED::onReadPixels(pm, x, y);
+}
+
+bool SkThreadedBMPDevice::onWritePixels(const SkPixmap& pm, int x, int y) {
+    this->flush();
+    return INHERITED::onWritePixels(pm, x, y);
+}
+
+bool SkThreadedBMPDevice::onPeekPixels(SkPixmap* pmap) {
+    this->flush();
+    return INHERITED::onPeekPixels(pmap);
+}
+
+bool SkThreadedBMPDevice::onAccessPixels(SkPixmap* pmap) {
+    this->flush();
+    return INHERITED::onAccessPixels(pmap);
+}
+
+void SkThreadedBMPDevice::replaceBitmapBackendForRasterSurface(const SkBitmap& bm) {
+    this->flush();
+    INHERITED::replaceBitmapBackendForRasterSurface(bm);
+}
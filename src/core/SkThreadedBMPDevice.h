@@ -0,0 +1,103 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkThreadedBMPDevice_DEFINED
+#define SkThreadedBMPDevice_DEFINED
+
+#include "SkBitmapDevice.h"
+#include "SkDraw.h"
+#include "SkRasterClip.h"
+#include "SkRecords.h"
+#include "SkSharedScan.h"
+#include "SkTArray.h"
+#include <functional>
+#include <memory>
+
+class SkExecutor;
+
+/**
+ *  An SkBitmapDevice that records draws instead of rasterizing them right away.  The device is
+ *  split into tiles, and when the recorded draws are flushed every tile replays the draws that
+ *  touch it, in the order they were issued, on its own SkExecutor task.  Tiles never share
+ *  pixels, so no locking is needed, and unless the device is huge, they scan convert each path
+ *  only once between them.  The result matches drawing serially.  The legacy N32 and 565
+ *  blitters blend anti-aliased pixel pairs differently than single pixels, so they can't split
+ *  a pair across a tile seam, and anti-aliased draws that may use them are drawn serially.
+ *
+ *  Pending draws are flushed whenever the pixels are observed (peek/access/read/write pixels,
+ *  snapshots), when the queue gets long, and on destruction.  Draws this device can't safely
+ *  defer (text, vertices) flush the queue and then rasterize serially.
+ */
+class SkThreadedBMPDevice : public SkBitmapDevice {
+public:
+    // When tiles is 0 we pick a tile count from the device height.
+    SkThreadedBMPDevice(const SkBitmap& bitmap, const SkSurfaceProps& surfaceProps,
+                        SkExecutor* executor, int tiles = 0);
+    ~SkThreadedBMPDevice() override;
+
+    // Rasterize all pending draws.  Returns once the pixels are up to date.
+    void flush() override;
+
+    int tileCount() const { return fTileBounds.count(); }
+
+protected:
+    void drawPaint(const SkPaint&) override;
+    void drawPoints(SkCanvas::PointMode, size_t count, const SkPoint[], const SkPaint&) override;
+    void drawRect(const SkRect&, const SkPaint&) override;
+    void drawRRect(const SkRRect&, const SkPaint&) override;
+    void drawPath(const SkPath&, const SkPaint&, bool pathIsMutable) override;
+    void drawSprite(const SkBitmap&, int x, int y, const SkPaint&) override;
+    void drawBitmapRect(const SkBitmap&, const SkRect*, const SkRect&,
+                        const SkPaint&, SkCanvas::SrcRectConstraint) override;
+    void drawBitmap(const SkBitmap&, const SkMatrix&, const SkRect* dstOrNull,
+                    const SkPaint&) override;
+
+    void drawGlyphRunList(const SkGlyphRunList&) override;
+    void drawVertices(const SkVertices*, const SkVertices::Bone bones[], int boneCount,
+                      SkBlendMode, const SkPaint&) override;
+    void drawDevice(SkBaseDevice*, int x, int y, const SkPaint&) override;
+
+    sk_sp<SkSpecialImage> snapSpecial() override;
+    sk_sp<SkSpecialImage> snapBackImage(const SkIRect&) override;
+
+    bool onReadPixels(const SkPixmap&, int x, int y) override;
+    bool onWritePixels(const SkPixmap&, int, int) override;
+    bool onPeekPixels(SkPixmap*) override;
+    bool onAccessPixels(SkPixmap*) override;
+
+    void replaceBitmapBackendForRasterSurface(const SkBitmap&) override;
+
+private:
+    // Recorded draws are called with an SkDraw targeting one tile, and that tile's origin.
+    using DrawFn = std::function<void(const SkDraw&, const SkIPoint& origin)>;
+
+    struct DrawElement {
+        DrawFn                 fDrawFn;
+        SkIRect                fDevBounds;
+        SkRecords::TypedMatrix fMatrix;
+        SkRasterClip           fRC;
+        // Shared by the tiles the draw touches, when they draw in place.
+        std::unique_ptr<SkSharedScan> fScan;
+    };
+
+    // Whether to flush and draw this serially rather than record it for the tiles.
+    bool drawsSerially(const SkPaint&) const;
+
+    // Maps local bounds (or nullptr for "everywhere") to clipped device bounds.
+    SkIRect devBounds(const SkRect* localBounds) const;
+
+    void record(const SkIRect& devBounds, DrawFn&&);
+    void drawTile(const SkPixmap& root, const SkIRect& tile) const;
+
+    SkExecutor*            fExecutor;
+    SkTArray<SkIRect>      fTileBounds;
+    SkTArray<DrawElement>  fQueue;
+
+    typedef SkBitmapDevice INHERITED;
+};
+
+#endif // SkThreadedBMPDevice_DEFINED
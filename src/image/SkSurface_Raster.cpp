@@ -8,16 +8,20 @@
 #include "SkSurface_Base.h"
 #include "SkImageInfoPriv.h"
 #include "SkImagePriv.h"
+#include "SkBitmapDevice.h"
 #include "SkCanvas.h"
 #include "SkDevice.h"
+#include "SkExecutor.h"
 #include "SkMallocPixelRef.h"
+#include "SkThreadedBMPDevice.h"
 
 class SkSurface_Raster : public SkSurface_Base {
 public:
     SkSurface_Raster(const SkImageInfo&, void*, size_t rb,
                      void (*releaseProc)(void* pixels, void* context), void* context,
                      const SkSurfaceProps*);
-    SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef>, const SkSurfaceProps*);
+    SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef>, const SkSurfaceProps*,
+                     SkExecutor* executor = nullptr, int tiles = 0);
 
     SkCanvas* onNewCanvas() override;
     sk_sp<SkSurface> onNewSurface(const SkImageInfo&) override;
@@ -27,10 +31,20 @@ public:
     void onCopyOnWrite(ContentChangeMode) override;
     void onRestoreBackingMutability() override;
 
+    void setWantsBatchFills(bool batchFills) { fWantsBatchFills = batchFills; }
+
 private:
+    // Threaded and batching surfaces defer draws, so they must be flushed before we touch
+    // fBitmap directly.
+    void flushPendingDraws();
+
     SkBitmap    fBitmap;
     size_t      fRowBytes;
     bool        fWeOwnThePixels;
+    SkExecutor* fExecutor = nullptr;    // if non-null, we draw with an SkThreadedBMPDevice
+    int         fTiles = 0;
+    bool        fWantsBatchFills = gSkBatchRasterFills;  // Should our canvas batch fills?
+    bool        fBatchFills = false;  // Did our canvas start batching fills?
 
     typedef SkSurface_Base INHERITED;
 };
@@ -78,8 +92,10 @@ SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, void* pixels, size_t
 }
 
 SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef> pr,
-                                   const SkSurfaceProps* props)
+                                   const SkSurfaceProps* props, SkExecutor* executor, int tiles)
     : INHERITED(pr->width(), pr->height(), props)
+    , fExecutor(executor)
+    , fTiles(tiles)
 {
     fBitmap.setInfo(info, pr->rowBytes());
     fRowBytes = pr->rowBytes(); // we track this, so that subsequent re-allocs will match
@@ -87,18 +103,42 @@ SkSurface_Raster::SkSurface_Raster(const SkImageInfo& info, sk_sp<SkPixelRef> pr
     fWeOwnThePixels = true;
 }
 
-SkCanvas* SkSurface_Raster::onNewCanvas() { return new SkCanvas(fBitmap, this->props()); }
+SkCanvas* SkSurface_Raster::onNewCanvas() {
+    if (fExecutor) {
+        return new SkCanvas(sk_make_sp<SkThreadedBMPDevice>(fBitmap, this->props(),
+                                                            fExecutor, fTiles));
+    }
+    SkCanvas* canvas = new SkCanvas(fBitmap, this->props());
+    // Callers of MakeRasterDirect() read their pixels without flushing, so we can't hold fills.
+    if (fWantsBatchFills && fWeOwnThePixels) {
+        static_cast<SkBitmapDevice*>(canvas->getDevice())->fBatchFills = true;
+        fBatchFills = true;
+    }
+    return canvas;
+}
 
 sk_sp<SkSurface> SkSurface_Raster::onNewSurface(const SkImageInfo& info) {
+    if (fExecutor) {
+        return SkSurface::MakeRasterThreaded(info, fExecutor, fTiles, &this->props());
+    }
     return SkSurface::MakeRaster(info, &this->props());
 }
 
+void SkSurface_Raster::flushPendingDraws() {
+    if (fExecutor || fBatchFills) {
+        this->getCachedCanvas()->flush();
+    }
+}
+
 void SkSurface_Raster::onDraw(SkCanvas* canvas, SkScalar x, SkScalar y,
                               const SkPaint* paint) {
+    this->flushPendingDraws();
     canvas->drawBitmap(fBitmap, x, y, paint);
 }
 
 sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot(const SkIRect* subset) {
+    this->flushPendingDraws();
+
     if (subset) {
         SkASSERT(SkIRect::MakeWH(fBitmap.width(), fBitmap.height()).contains(*subset));
         SkBitmap dst;
@@ -125,6 +165,7 @@ sk_sp<SkImage> SkSurface_Raster::onNewImageSnapshot(const SkIRect* subset) {
 }
 
 void SkSurface_Raster::onWritePixels(const SkPixmap& src, int x, int y) {
+    this->flushPendingDraws();
     fBitmap.writePixels(src, x, y);
 }
 
@@ -183,6 +224,10 @@ sk_sp<SkSurface> SkSurface::MakeRasterDirect(const SkImageInfo& info, void* pixe
     return MakeRasterDirectReleaseProc(info, pixels, rowBytes, nullptr, nullptr, props);
 }
 
+void SkSurfaceSetBatchRasterFillsForTesting(SkSurface* surface, bool batchFills) {
+    static_cast<SkSurface_Raster*>(surface)->setWantsBatchFills(batchFills);
+}
+
 sk_sp<SkSurface> SkSurface::MakeRaster(const SkImageInfo& info, size_t rowBytes,
                                        const SkSurfaceProps* props) {
     if (!SkSurfaceValidateRasterInfo(info)) {
@@ -199,6 +244,20 @@ sk_sp<SkSurface> SkSurface::MakeRaster(const SkImageInfo& info, size_t rowBytes,
     return sk_make_sp<SkSurface_Raster>(info, std::move(pr), props);
 }
 
+sk_sp<SkSurface> SkSurface::MakeRasterThreaded(const SkImageInfo& info, SkExecutor* executor,
+                                               int tiles, const SkSurfaceProps* props) {
+    if (!SkSurfaceValidateRasterInfo(info)) {
+        return nullptr;
+    }
+
+    sk_sp<SkPixelRef> pr = SkMallocPixelRef::MakeZeroed(info, 0);
+    if (!pr) {
+        return nullptr;
+    }
+    return sk_make_sp<SkSurface_Raster>(info, std::move(pr), props,
+                                        executor ? executor : &SkExecutor::GetDefault(), tiles);
+}
+
 sk_sp<SkSurface> SkSurface::MakeRasterN32Premul(int width, int height,
                                                 const SkSurfaceProps* surfaceProps) {
     return MakeRaster(SkImageInfo::MakeN32Premul(width, height), surfaceProps);
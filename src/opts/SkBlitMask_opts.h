@@ -9,6 +9,9 @@
 #define SkBlitMask_opts_DEFINED
 
 #include "Sk4px.h"
+#include "SkColor.h"
+#include "SkHalf.h"
+#include "SkNx.h"
 
 namespace SK_OPTS_NS {
 
@@ -226,6 +229,113 @@ namespace SK_OPTS_NS {
     }
 }
 
+// Blend color, premultiplied and in the dst's color space, into F16 or 1010102 pixels through an
+// A8 or LCD16 mask with SrcOver, as SkRasterPipeline would:
+//     d = s*c + d*(1 - sa*c)
+// where c is the coverage of each channel. Uncovered pixels are left alone, and fully covered
+// ones take an opaque color as is.
+namespace blit_mask_4f {
+    struct F16 {
+        using Pixel = uint64_t;
+        static Sk4f Load(const uint64_t* px) { return SkHalfToFloat_finite_ftz(*px); }
+        static void Store(uint64_t* px, const Sk4f& v) { SkFloatToHalf_finite_ftz(v).store(px); }
+    };
+
+    struct RGBA1010102 {
+        using Pixel = uint32_t;
+        static Sk4f Load(const uint32_t* px) {
+            uint32_t v = *px;
+            return SkNx_cast<float>(Sk4i(v & 1023, (v >> 10) & 1023, (v >> 20) & 1023, v >> 30))
+                 * Sk4f(1/1023.0f, 1/1023.0f, 1/1023.0f, 1/3.0f);
+        }
+        static void Store(uint32_t* px, const Sk4f& v) {
+            Sk4i u = SkNx_cast<int>(Sk4f::Min(Sk4f::Max(v, 0.0f), 1.0f)
+                                    * Sk4f(1023, 1023, 1023, 3) + 0.5f);
+            *px = (uint32_t)u[0] | (uint32_t)u[1] << 10 | (uint32_t)u[2] << 20
+                                 | (uint32_t)u[3] << 30;
+        }
+    };
+
+    struct A8 {
+        using Coverage = uint8_t;
+        static bool IsNone(uint8_t c) { return c == 0; }
+        static bool IsFull(uint8_t c) { return c == 0xFF; }
+        static Sk4f ToFloats(uint8_t c) { return c * (1/255.0f); }
+    };
+
+    struct LCD16 {
+        using Coverage = uint16_t;
+        static bool IsNone(uint16_t c) { return c == 0; }
+        static bool IsFull(uint16_t c) { return c == 0xFFFF; }
+        static Sk4f ToFloats(uint16_t c) {
+            float r = (c >> 11)        * (1/31.0f),
+                  g = ((c >> 5) & 63)  * (1/63.0f),
+                  b = (c & 31)         * (1/31.0f);
+            // SkRasterPipeline's lerp_565 picks alpha's coverage by comparing alpha after SrcOver,
+            // which is never less than dst alpha, against dst alpha, so it's always the max.
+            return Sk4f(r, g, b, SkTMax(r, SkTMax(g, b)));
+        }
+    };
+
+    template <typename Dst, typename Mask>
+    static void blit(typename Dst::Pixel* dst, size_t dstRB,
+                     const typename Mask::Coverage* mask, size_t maskRB,
+                     const SkColor4f& color, int w, int h) {
+        const Sk4f s = Sk4f::Load(color.vec());
+        const float sa = color.fA;
+
+        typename Dst::Pixel opaque;
+        Dst::Store(&opaque, s);
+        const bool isOpaque = sa == 1.0f;
+
+        while (h --> 0) {
+            for (int x = 0; x < w; x++) {
+                auto m = mask[x];
+                if (Mask::IsNone(m)) {
+                    continue;
+                }
+                if (isOpaque && Mask::IsFull(m)) {
+                    dst[x] = opaque;
+                    continue;
+                }
+                Sk4f d = Dst::Load(dst + x),
+                     c = Mask::ToFloats(m);
+                Dst::Store(dst + x, s*c + d*(1.0f - sa*c));
+            }
+            dst  = SkTAddOffset<typename Dst::Pixel>(dst, dstRB);
+            mask = SkTAddOffset<const typename Mask::Coverage>(mask, maskRB);
+        }
+    }
+}  // namespace blit_mask_4f
+
+/*not static*/ inline void blit_mask_f16_a8(uint64_t* dst, size_t dstRB,
+                                            const SkAlpha* mask, size_t maskRB,
+                                            const SkColor4f& color, int w, int h) {
+    blit_mask_4f::blit<blit_mask_4f::F16, blit_mask_4f::A8>(dst, dstRB, mask, maskRB,
+                                                            color, w, h);
+}
+
+/*not static*/ inline void blit_mask_f16_lcd16(uint64_t* dst, size_t dstRB,
+                                               const uint16_t* mask, size_t maskRB,
+                                               const SkColor4f& color, int w, int h) {
+    blit_mask_4f::blit<blit_mask_4f::F16, blit_mask_4f::LCD16>(dst, dstRB, mask, maskRB,
+                                                               color, w, h);
+}
+
+/*not static*/ inline void blit_mask_1010102_a8(uint32_t* dst, size_t dstRB,
+                                                const SkAlpha* mask, size_t maskRB,
+                                                const SkColor4f& color, int w, int h) {
+    blit_mask_4f::blit<blit_mask_4f::RGBA1010102, blit_mask_4f::A8>(dst, dstRB, mask, maskRB,
+                                                                    color, w, h);
+}
+
+/*not static*/ inline void blit_mask_1010102_lcd16(uint32_t* dst, size_t dstRB,
+                                                   const uint16_t* mask, size_t maskRB,
+                                                   const SkColor4f& color, int w, int h) {
+    blit_mask_4f::blit<blit_mask_4f::RGBA1010102, blit_mask_4f::LCD16>(dst, dstRB, mask, maskRB,
+                                                                       color, w, h);
+}
+
 }  // SK_OPTS_NS
 
 #endif//SkBlitMask_opts_DEFINED
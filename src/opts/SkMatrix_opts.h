@@ -0,0 +1,157 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMatrix_opts_DEFINED
+#define SkMatrix_opts_DEFINED
+
+#include "SkMatrix.h"
+#include "SkNx.h"
+#include "SkPoint3.h"
+
+namespace SK_OPTS_NS {
+
+    // We work on N floats at a time.  Each lane does exactly the math SkMatrix's scalar code
+    // would, in the same order, so the results don't depend on N.
+#if defined(SK_CPU_SSE_LEVEL) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX
+    static const int kMapPtsN = 8;
+#else
+    static const int kMapPtsN = 4;
+#endif
+    using MapPtsF = SkNx<kMapPtsN, float>;
+
+    // Maps points N at a time, as N xs and N ys.
+    template <typename Fn>
+    static void map_pts(SkPoint dst[], const SkPoint src[], int count, Fn&& fn) {
+        while (count >= kMapPtsN) {
+            MapPtsF x, y;
+            MapPtsF::Load2(src, &x, &y);
+            fn(&x, &y);
+            MapPtsF::Store2(dst, x, y);
+            src   += kMapPtsN;
+            dst   += kMapPtsN;
+            count -= kMapPtsN;
+        }
+        if (count > 0) {
+            SkPoint tmp[kMapPtsN] = {};
+            memcpy(tmp, src, count * sizeof(SkPoint));
+            MapPtsF x, y;
+            MapPtsF::Load2(tmp, &x, &y);
+            fn(&x, &y);
+            MapPtsF::Store2(tmp, x, y);
+            memcpy(dst, tmp, count * sizeof(SkPoint));
+        }
+    }
+
+    // Translating and scaling treat xs and ys alike, so these leave the points interleaved,
+    // mapping N/2 points at a time with (x,y,x,y,...) translates and scales.
+
+    /*not static*/ inline void map_trans_pts(const SkMatrix& m, SkPoint dst[],
+                                             const SkPoint src[], int count) {
+        SkScalar tx = m.getTranslateX(),
+                 ty = m.getTranslateY();
+        float t[kMapPtsN];
+        for (int i = 0; i < kMapPtsN; i += 2) {
+            t[i+0] = tx;
+            t[i+1] = ty;
+        }
+        MapPtsF trans = MapPtsF::Load(t);
+        for (; count >= kMapPtsN/2; count -= kMapPtsN/2) {
+            (MapPtsF::Load(src) + trans).store(dst);
+            src += kMapPtsN/2;
+            dst += kMapPtsN/2;
+        }
+        for (; count > 0; count--) {
+            dst->set(src->fX + tx, src->fY + ty);
+            src += 1;
+            dst += 1;
+        }
+    }
+
+    /*not static*/ inline void map_scale_pts(const SkMatrix& m, SkPoint dst[],
+                                             const SkPoint src[], int count) {
+        SkScalar tx = m.getTranslateX(),
+                 ty = m.getTranslateY(),
+                 sx = m.getScaleX(),
+                 sy = m.getScaleY();
+        float t[kMapPtsN], s[kMapPtsN];
+        for (int i = 0; i < kMapPtsN; i += 2) {
+            t[i+0] = tx;
+            t[i+1] = ty;
+            s[i+0] = sx;
+            s[i+1] = sy;
+        }
+        MapPtsF trans = MapPtsF::Load(t),
+                scale = MapPtsF::Load(s);
+        for (; count >= kMapPtsN/2; count -= kMapPtsN/2) {
+            (MapPtsF::Load(src) * scale + trans).store(dst);
+            src += kMapPtsN/2;
+            dst += kMapPtsN/2;
+        }
+        for (; count > 0; count--) {
+            dst->set(src->fX * sx + tx, src->fY * sy + ty);
+            src += 1;
+            dst += 1;
+        }
+    }
+
+    /*not static*/ inline void map_affine_pts(const SkMatrix& m, SkPoint dst[],
+                                              const SkPoint src[], int count) {
+        // SkNx lives in an anonymous namespace, so the lambdas capture scalars, not MapPtsF.
+        // (A lambda in an inline function with external linkage can't hold internal types.)
+        SkScalar tx = m.getTranslateX(),
+                 ty = m.getTranslateY(),
+                 sx = m.getScaleX(),
+                 sy = m.getScaleY(),
+                 kx = m.getSkewX(),
+                 ky = m.getSkewY();
+        map_pts(dst, src, count, [&](MapPtsF* x, MapPtsF* y) {
+            MapPtsF X = *x * sx + *y * kx + tx,
+                    Y = *x * ky + *y * sy + ty;
+            *x = X;
+            *y = Y;
+        });
+    }
+
+    /*not static*/ inline void map_persp_pts(const SkMatrix& m, SkPoint dst[],
+                                             const SkPoint src[], int count) {
+        SkScalar tx = m.getTranslateX(),
+                 ty = m.getTranslateY(),
+                 sx = m.getScaleX(),
+                 sy = m.getScaleY(),
+                 kx = m.getSkewX(),
+                 ky = m.getSkewY(),
+                 p0 = m.getPerspX(),
+                 p1 = m.getPerspY(),
+                 p2 = m.get(SkMatrix::kMPersp2);
+        map_pts(dst, src, count, [&](MapPtsF* x, MapPtsF* y) {
+            MapPtsF X = *x * sx + *y * kx + tx,
+                    Y = *x * ky + *y * sy + ty;
+            // As SkMatrix.cpp does under SK_LEGACY_MATRIX_MATH_ORDER.
+            MapPtsF Z = *x * p0 + (*y * p1 + p2);
+            // Points at infinity (z == 0) map to zero, or NaN.
+            Z = (Z != 0).thenElse(1.0f / Z, Z);
+            *x = X * Z;
+            *y = Y * Z;
+        });
+    }
+
+    /*not static*/ inline void map_homogeneous_pts(const SkMatrix& m, SkPoint3 dst[],
+                                                   const SkPoint3 src[], int count) {
+        // Each point is a sum of the matrix's columns, scaled by the point's x, y and z.
+        Sk4f col0(m.getScaleX(),     m.getSkewY(),      m.getPerspX(),               0),
+             col1(m.getSkewX(),      m.getScaleY(),     m.getPerspY(),               0),
+             col2(m.getTranslateX(), m.getTranslateY(), m.get(SkMatrix::kMPersp2),   0);
+        for (int i = 0; i < count; ++i) {
+            float p[4];
+            (Sk4f(src[i].fX) * col0 + Sk4f(src[i].fY) * col1 + Sk4f(src[i].fZ) * col2).store(p);
+            memcpy(&dst[i], p, sizeof(SkPoint3));
+        }
+    }
+
+}
+
+#endif//SkMatrix_opts_DEFINED
@@ -8,6 +8,7 @@
 #include "SkOpts.h"
 
 #define SK_OPTS_NS avx
+#include "SkMatrix_opts.h"
 #include "SkRasterPipeline_opts.h"
 #include "SkUtils_opts.h"
 
@@ -17,6 +18,11 @@ namespace SkOpts {
         memset32 = SK_OPTS_NS::memset32;
         memset64 = SK_OPTS_NS::memset64;
 
+        map_trans_pts  = SK_OPTS_NS::map_trans_pts;
+        map_scale_pts  = SK_OPTS_NS::map_scale_pts;
+        map_affine_pts = SK_OPTS_NS::map_affine_pts;
+        map_persp_pts  = SK_OPTS_NS::map_persp_pts;
+
     #define M(st) stages_highp[SkRasterPipeline::st] = (StageFn)SK_OPTS_NS::st;
         SK_RASTER_PIPELINE_STAGES(M)
         just_return_highp = (StageFn)SK_OPTS_NS::just_return;
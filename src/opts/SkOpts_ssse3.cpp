@@ -16,6 +16,10 @@ namespace SkOpts {
     void Init_ssse3() {
         create_xfermode = ssse3::create_xfermode;
         blit_mask_d32_a8 = ssse3::blit_mask_d32_a8;
+        blit_mask_f16_a8        = ssse3::blit_mask_f16_a8;
+        blit_mask_f16_lcd16     = ssse3::blit_mask_f16_lcd16;
+        blit_mask_1010102_a8    = ssse3::blit_mask_1010102_a8;
+        blit_mask_1010102_lcd16 = ssse3::blit_mask_1010102_lcd16;
 
         RGBA_to_BGRA          = ssse3::RGBA_to_BGRA;
         RGBA_to_rgbA          = ssse3::RGBA_to_rgbA;
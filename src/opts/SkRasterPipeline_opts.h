@@ -1930,6 +1930,32 @@ STAGE(matrix_perspective, const float* m) {
     g = G * rcp(Z);
 }
 
+// Fused stages.  SkRasterPipeline swaps these in for runs of the stages they're built from,
+// saving the calls between them.  They must give exactly the same results as that run.
+// (srcover_rgba_8888 above is close, but rounds differently, so it's only used explicitly.)
+STAGE(srcover_8888, const SkRasterPipeline_MemoryCtx* ctx) {
+    load_8888_dst_k(ctx, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    srcover_k(Ctx::None{}, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    store_8888_k(ctx, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+}
+STAGE(srcover_f16, const SkRasterPipeline_MemoryCtx* ctx) {
+    load_f16_dst_k(ctx, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    srcover_k(Ctx::None{}, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    store_f16_k(ctx, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+}
+STAGE(seed_shader_matrix_translate, const float* m) {
+    seed_shader_k(Ctx::None{}, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    matrix_translate_k(m, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+}
+STAGE(seed_shader_matrix_scale_translate, const float* m) {
+    seed_shader_k(Ctx::None{}, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    matrix_scale_translate_k(m, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+}
+STAGE(seed_shader_matrix_2x3, const float* m) {
+    seed_shader_k(Ctx::None{}, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    matrix_2x3_k(m, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+}
+
 SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         F* r, F* g, F* b, F* a) {
     F fr, br, fg, bg, fb, bb, fa, ba;
@@ -3130,6 +3156,24 @@ STAGE_PP(emboss, const SkRasterPipeline_EmbossCtx* ctx) {
 
 // ~~~~~~ Gradient stages ~~~~~~ //
 
+SI F exclusive_repeat(F v, const SkRasterPipeline_TileCtx* ctx) {
+    return v - floor_(v*ctx->invScale)*ctx->scale;
+}
+SI F exclusive_mirror(F v, const SkRasterPipeline_TileCtx* ctx) {
+    auto limit = ctx->scale;
+    auto invLimit = ctx->invScale;
+    return abs_( (v-limit) - (limit+limit)*floor_((v-limit)*(invLimit*0.5f)) - limit );
+}
+// Tile x or y to [0,limit) == [0,limit - 1 ulp] (think, sampling from images).
+// The gather stages will hard clamp the output of these stages to [0,limit)...
+// we just need to do the basic repeat or mirroring.
+STAGE_GG(repeat_x, const SkRasterPipeline_TileCtx* ctx) { x = exclusive_repeat(x, ctx); }
+STAGE_GG(repeat_y, const SkRasterPipeline_TileCtx* ctx) { y = exclusive_repeat(y, ctx); }
+STAGE_GG(mirror_x, const SkRasterPipeline_TileCtx* ctx) { x = exclusive_mirror(x, ctx); }
+STAGE_GG(mirror_y, const SkRasterPipeline_TileCtx* ctx) { y = exclusive_mirror(y, ctx); }
+
+STAGE_GG(negate_x, Ctx::None) { x = -x; }
+
 // Clamp x to [0,1], both sides inclusive (think, gradients).
 // Even repeat and mirror funnel through a clamp to handle bad inputs like +Inf, NaN.
 SI F clamp_01(F v) { return min(max(0, v), 1); }
@@ -3289,6 +3333,25 @@ STAGE_PP(srcover_rgba_8888, const SkRasterPipeline_MemoryCtx* ctx) {
     store_8888_(ptr, tail, r,g,b,a);
 }
 
+// Fused stages, as in highp above.
+STAGE_PP(srcover_8888, const SkRasterPipeline_MemoryCtx* ctx) {
+    load_8888_dst_k(ctx, dx,dy,tail, 0,0, r,g,b,a, dr,dg,db,da);
+    srcover_k(Ctx::None{}, dx,dy,tail, 0,0, r,g,b,a, dr,dg,db,da);
+    store_8888_k(ctx, dx,dy,tail, 0,0, r,g,b,a, dr,dg,db,da);
+}
+STAGE_GG(seed_shader_matrix_translate, const float* m) {
+    seed_shader_k(Ctx::None{}, dx,dy,tail, x,y, 0,0,0,0, 0,0,0,0);
+    matrix_translate_k(m, dx,dy,tail, x,y, 0,0,0,0, 0,0,0,0);
+}
+STAGE_GG(seed_shader_matrix_scale_translate, const float* m) {
+    seed_shader_k(Ctx::None{}, dx,dy,tail, x,y, 0,0,0,0, 0,0,0,0);
+    matrix_scale_translate_k(m, dx,dy,tail, x,y, 0,0,0,0, 0,0,0,0);
+}
+STAGE_GG(seed_shader_matrix_2x3, const float* m) {
+    seed_shader_k(Ctx::None{}, dx,dy,tail, x,y, 0,0,0,0, 0,0,0,0);
+    matrix_2x3_k(m, dx,dy,tail, x,y, 0,0,0,0, 0,0,0,0);
+}
+
 #if defined(SK_DISABLE_LOWP_BILERP_CLAMP_CLAMP_STAGE)
     static void(*bilerp_clamp_8888)(void) = nullptr;
 #else
@@ -3356,6 +3419,67 @@ STAGE_GP(bilerp_clamp_8888, const SkRasterPipeline_GatherCtx* ctx) {
 }
 #endif
 
+// The general bilinear sampler works just like highp's: save_xy, then for each of the 4 samples,
+// bilinear_[np]x and bilinear_[np]y pick the point and its weight, tiling and a gather fetch it,
+// and accumulate adds it into the dst registers, scaling them back down with the fourth sample.
+// (We don't do bicubic in lowp.)
+STAGE_GG(save_xy, SkRasterPipeline_SamplerCtx* c) {
+    F fx = fract(x + 0.5f),
+      fy = fract(y + 0.5f);
+
+    unaligned_store(c->x,  x);
+    unaligned_store(c->y,  y);
+    unaligned_store(c->fx, fx);
+    unaligned_store(c->fy, fy);
+    c->samples = 0;
+}
+
+// Like the legacy bilerp procs, lowp weighs samples in 4 fractional bits along each axis.  The
+// near and far weights along an axis sum to exactly 16, so whatever order the samples come in,
+// the four products sum to exactly 256, keeping opaque opaque, and 255*256 still fits in 16 bits.
+template <int kScale>
+SI void bilinear_x(SkRasterPipeline_SamplerCtx* ctx, F* x) {
+    *x = unaligned_load<F>(ctx->x) + (kScale * 0.5f);
+    F wx = floor_(unaligned_load<F>(ctx->fx) * 16 + 0.5f);
+
+    F scalex;
+    if (kScale == -1) { scalex = 16 - wx; }
+    if (kScale == +1) { scalex =      wx; }
+    unaligned_store(ctx->scalex, scalex);
+}
+template <int kScale>
+SI void bilinear_y(SkRasterPipeline_SamplerCtx* ctx, F* y) {
+    *y = unaligned_load<F>(ctx->y) + (kScale * 0.5f);
+    F wy = floor_(unaligned_load<F>(ctx->fy) * 16 + 0.5f);
+
+    F scaley;
+    if (kScale == -1) { scaley = 16 - wy; }
+    if (kScale == +1) { scaley =      wy; }
+    unaligned_store(ctx->scaley, scaley);
+}
+
+STAGE_GG(bilinear_nx, SkRasterPipeline_SamplerCtx* ctx) { bilinear_x<-1>(ctx, &x); }
+STAGE_GG(bilinear_px, SkRasterPipeline_SamplerCtx* ctx) { bilinear_x<+1>(ctx, &x); }
+STAGE_GG(bilinear_ny, SkRasterPipeline_SamplerCtx* ctx) { bilinear_y<-1>(ctx, &y); }
+STAGE_GG(bilinear_py, SkRasterPipeline_SamplerCtx* ctx) { bilinear_y<+1>(ctx, &y); }
+
+STAGE_PP(accumulate, SkRasterPipeline_SamplerCtx* c) {
+    // Each sample's weight is exact, from its own x and y weights.  We sum the samples
+    // unnormalized, and divide by 256 once all four are in.
+    U16 w = cast<U16>(unaligned_load<F>(c->scalex) * unaligned_load<F>(c->scaley));
+    dr += r * w;
+    dg += g * w;
+    db += b * w;
+    da += a * w;
+
+    if (++c->samples == 4) {
+        dr = (dr + 128) / 256;
+        dg = (dg + 128) / 256;
+        db = (db + 128) / 256;
+        da = (da + 128) / 256;
+    }
+}
+
 // Now we'll add null stand-ins for stages we haven't implemented in lowp.
 // If a pipeline uses these stages, it'll boot it out of lowp into highp.
 #define NOT_IMPLEMENTED(st) static void (*st)(void) = nullptr;
@@ -3373,6 +3497,7 @@ STAGE_GP(bilerp_clamp_8888, const SkRasterPipeline_GatherCtx* ctx) {
     NOT_IMPLEMENTED(load_f16)
     NOT_IMPLEMENTED(load_f16_dst)
     NOT_IMPLEMENTED(store_f16)
+    NOT_IMPLEMENTED(srcover_f16)
     NOT_IMPLEMENTED(gather_f16)
     NOT_IMPLEMENTED(load_f32)
     NOT_IMPLEMENTED(load_f32_dst)
@@ -3400,15 +3525,6 @@ STAGE_GP(bilerp_clamp_8888, const SkRasterPipeline_GatherCtx* ctx) {
     NOT_IMPLEMENTED(rgb_to_hsl)
     NOT_IMPLEMENTED(hsl_to_rgb)
     NOT_IMPLEMENTED(gauss_a_to_rgba)  // TODO
-    NOT_IMPLEMENTED(mirror_x)         // TODO
-    NOT_IMPLEMENTED(repeat_x)         // TODO
-    NOT_IMPLEMENTED(mirror_y)         // TODO
-    NOT_IMPLEMENTED(repeat_y)         // TODO
-    NOT_IMPLEMENTED(negate_x)
-    NOT_IMPLEMENTED(bilinear_nx)      // TODO
-    NOT_IMPLEMENTED(bilinear_ny)      // TODO
-    NOT_IMPLEMENTED(bilinear_px)      // TODO
-    NOT_IMPLEMENTED(bilinear_py)      // TODO
     NOT_IMPLEMENTED(bicubic_n3x)      // TODO
     NOT_IMPLEMENTED(bicubic_n1x)      // TODO
     NOT_IMPLEMENTED(bicubic_p1x)      // TODO
@@ -3417,8 +3533,6 @@ STAGE_GP(bilerp_clamp_8888, const SkRasterPipeline_GatherCtx* ctx) {
     NOT_IMPLEMENTED(bicubic_n1y)      // TODO
     NOT_IMPLEMENTED(bicubic_p1y)      // TODO
     NOT_IMPLEMENTED(bicubic_p3y)      // TODO
-    NOT_IMPLEMENTED(save_xy)          // TODO
-    NOT_IMPLEMENTED(accumulate)       // TODO
     NOT_IMPLEMENTED(xy_to_2pt_conical_well_behaved)
     NOT_IMPLEMENTED(xy_to_2pt_conical_strip)
     NOT_IMPLEMENTED(xy_to_2pt_conical_focal_on_circle)
@@ -7,6 +7,9 @@
 #include "SkAddIntersections.h"
 #include "SkOpCoincidence.h"
 #include "SkPathOpsBounds.h"
+#include "SkRTree.h"
+#include "SkTLazy.h"
+#include "SkTSort.h"
 
 #include <utility>
 
@@ -256,6 +259,46 @@ static void debugShowCubicIntersection(int , const SkIntersectionHelper& ,
 }
 #endif
 
+// Contour pairs with at least this many pairs of segments find the pairs worth intersecting
+// with an SkSegmentIndex, rather than by comparing every pair's bounds.
+static constexpr int kMinIndexedSegmentPairs = 1024;
+
+// An SkRTree of a contour's segments, finding those that may touch a segment in contour order.
+// Bounds are outset by slop, so that pairs whose bounds almost touch in ulps are found too.
+class SkSegmentIndex {
+public:
+    SkSegmentIndex(SkOpContour* contour, SkScalar slop) : fSlop(slop) {
+        SkTDArray<SkRect> bounds;
+        SkOpSegment* segment = contour->first();
+        do {
+            fSegments.push_back(segment);
+            bounds.push_back(segment->bounds().makeOutset(fSlop, fSlop));
+        } while ((segment = segment->next()));
+        fTree.insert(bounds.begin(), bounds.count());
+    }
+
+    // Sets found to the segments after the first skip whose bounds may touch these.
+    void find(const SkPathOpsBounds& bounds, int skip, SkTDArray<SkOpSegment*>* found) {
+        fIndices.rewind();
+        fTree.search(bounds.makeOutset(fSlop, fSlop), &fIndices);
+        if (fIndices.count() > 1) {
+            SkTQSort(fIndices.begin(), fIndices.end() - 1);
+        }
+        found->rewind();
+        for (int index : fIndices) {
+            if (index >= skip) {
+                found->push_back(fSegments[index]);
+            }
+        }
+    }
+
+private:
+    SkScalar fSlop;
+    SkTDArray<SkOpSegment*> fSegments;
+    SkTDArray<int> fIndices;
+    SkRTree fTree;
+};
+
 bool AddIntersectTs(SkOpContour* test, SkOpContour* next, SkOpCoincidence* coincidence) {
     if (test != next) {
         if (AlmostLessUlps(test->bounds().fBottom, next->bounds().fTop)) {
@@ -266,9 +309,26 @@ bool AddIntersectTs(SkOpContour* test, SkOpContour* next, SkOpCoincidence* coinc
             return true;
         }
     }
+    // Bounds that almost touch are within 16 ulps, so outset by twice that at the largest
+    // coordinate, or at one for bounds near zero.
+    SkTLazy<SkSegmentIndex> index;
+    SkTDArray<SkOpSegment*> candidates;
+    if ((int64_t) test->count() * next->count() >= kMinIndexedSegmentPairs
+            && test->bounds().isFinite() && next->bounds().isFinite()) {
+        SkScalar largest = 1;
+        for (const SkRect* bounds : { &test->bounds(), &next->bounds() }) {
+            largest = SkTMax(largest, SkTMax(SkTMax(SkScalarAbs(bounds->fLeft),
+                                                    SkScalarAbs(bounds->fTop)),
+                                             SkTMax(SkScalarAbs(bounds->fRight),
+                                                    SkScalarAbs(bounds->fBottom))));
+        }
+        index.init(next, 32 * FLT_EPSILON * largest);
+    }
     SkIntersectionHelper wt;
     wt.init(test);
+    int testIndex = -1;
     do {
+        ++testIndex;
         SkIntersectionHelper wn;
         wn.init(next);
         test->debugValidate();
@@ -276,6 +336,25 @@ bool AddIntersectTs(SkOpContour* test, SkOpContour* next, SkOpCoincidence* coinc
         if (test == next && !wn.startAfter(wt)) {
             continue;
         }
+        // Only the segments the index finds need a look, in the order we'd otherwise see them.
+        int candidate = 0;
+        if (index.isValid()) {
+            index.get()->find(wt.bounds(), test == next ? testIndex + 1 : 0, &candidates);
+            if (candidates.isEmpty()) {
+                continue;
+            }
+            wn.init(candidates[0]);
+        }
+        auto advance = [&]() {
+            if (!index.isValid()) {
+                return wn.advance();
+            }
+            if (++candidate == candidates.count()) {
+                return false;
+            }
+            wn.init(candidates[candidate]);
+            return true;
+        };
         do {
             if (!SkPathOpsBounds::Intersects(wt.bounds(), wn.bounds())) {
                 continue;
@@ -573,7 +652,7 @@ bool AddIntersectTs(SkOpContour* test, SkOpContour* next, SkOpCoincidence* coinc
                 coinIndex = -1;
             }
             SkOPOBJASSERT(coincidence, coinIndex < 0);  // expect coincidence to be paired
-        } while (wn.advance());
+        } while (advance());
     } while (wt.advance());
     return true;
 }
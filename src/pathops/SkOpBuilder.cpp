@@ -11,6 +11,10 @@
 #include "SkPathPriv.h"
 #include "SkPathOps.h"
 #include "SkPathOpsCommon.h"
+#include "SkTSort.h"
+#include "SkTaskGroup.h"
+
+#include <atomic>
 
 static bool one_contour(const SkPath& path) {
     SkSTArenaAlloc<256> allocator;
@@ -193,3 +197,149 @@ bool SkOpBuilder::resolve(SkPath* result) {
     }
     return success;
 }
+
+// Sets of paths no bigger than this are unioned with one Simplify() instead of being split.
+static constexpr int kUnionLeafPaths = 64;
+
+// Unions paths that are already simplified and in winding form. Sets too big for one Simplify()
+// are split in half across the longer side of their bounds, and the halves unioned in parallel.
+static bool union_tree(const SkPath* paths[], int count, SkExecutor* executor, SkPath* result) {
+    if (1 == count) {
+        *result = *paths[0];
+        return true;
+    }
+    if (count <= kUnionLeafPaths) {
+        SkPath sum;
+        for (int index = 0; index < count; ++index) {
+            sum.addPath(*paths[index]);
+        }
+        return Simplify(sum, result);
+    }
+    SkRect bounds = SkRect::MakeEmpty();
+    for (int index = 0; index < count; ++index) {
+        bounds.join(paths[index]->getBounds());
+    }
+    if (bounds.width() > bounds.height()) {
+        SkTQSort(paths, paths + count - 1, [](const SkPath* a, const SkPath* b) {
+            return a->getBounds().centerX() < b->getBounds().centerX();
+        });
+    } else {
+        SkTQSort(paths, paths + count - 1, [](const SkPath* a, const SkPath* b) {
+            return a->getBounds().centerY() < b->getBounds().centerY();
+        });
+    }
+    int half = count / 2;
+    SkPath front;
+    bool frontSuccess = false;
+    SkTaskGroup tasks(*executor);
+    tasks.add([&] { frontSuccess = union_tree(paths, half, executor, &front); });
+    bool backSuccess = union_tree(paths + half, count - half, executor, result);
+    tasks.wait();
+    return frontSuccess && backSuccess && Op(front, *result, kUnion_SkPathOp, result);
+}
+
+// Groups the non-empty paths whose bounds overlap or touch, directly or through others. Unions of
+// different groups can't overlap, so each can be found on its own.
+static void group_overlapping(const SkTArray<SkPath>& paths,
+                              SkTArray<SkTDArray<const SkPath*>>* groups) {
+    SkTDArray<int> order, parent;
+    for (int index = 0; index < paths.count(); ++index) {
+        if (!paths[index].isEmpty()) {
+            order.push_back(index);
+        }
+        parent.push_back(index);
+    }
+    auto root = [&](int index) {
+        while (parent[index] != index) {
+            index = parent[index] = parent[parent[index]];
+        }
+        return index;
+    };
+
+    // Sweep the paths left to right, checking each against those still open to its left.
+    if (order.count() > 1) {
+        SkTQSort(order.begin(), order.end() - 1, [&](int a, int b) {
+            return paths[a].getBounds().fLeft < paths[b].getBounds().fLeft;
+        });
+    }
+    SkTDArray<int> open;
+    for (int index : order) {
+        const SkRect& bounds = paths[index].getBounds();
+        for (int o = 0; o < open.count(); ) {
+            const SkRect& other = paths[open[o]].getBounds();
+            if (other.fRight < bounds.fLeft) {
+                open.removeShuffle(o);
+                continue;
+            }
+            if (other.fTop <= bounds.fBottom && bounds.fTop <= other.fBottom) {
+                parent[root(open[o])] = root(index);
+            }
+            ++o;
+        }
+        open.push_back(index);
+    }
+
+    // Number the groups in the order of their first paths.
+    SkTDArray<int> groupOf;
+    groupOf.setCount(paths.count());
+    for (int& group : groupOf) {
+        group = -1;
+    }
+    for (int index = 0; index < paths.count(); ++index) {
+        if (paths[index].isEmpty()) {
+            continue;
+        }
+        int& group = groupOf[root(index)];
+        if (group < 0) {
+            group = groups->count();
+            groups->push_back();
+        }
+        (*groups)[group].push_back(&paths[index]);
+    }
+}
+
+bool SkOpBuilder::resolve(SkPath* result, SkExecutor* executor) {
+    int count = fOps.count();
+    bool allUnion = executor != nullptr;
+    for (int index = 0; allUnion && index < count; ++index) {
+        allUnion = kUnion_SkPathOp == fOps[index] && !fPathRefs[index].isInverseFillType();
+    }
+    if (!allUnion) {
+        return this->resolve(result);
+    }
+
+    // As in resolve(), bring each path to its simplified, winding form before summing them.
+    std::atomic<bool> success{true};
+    SkTaskGroup(*executor).forkJoin(count, 16, [&](int start, int end) {
+        for (int index = start; index < end && success; ++index) {
+            SkPath* path = &fPathRefs[index];
+            if (!Simplify(*path, path) || (!path->isEmpty() && !FixWinding(path))) {
+                success = false;
+            }
+        }
+    });
+    SkTArray<SkTDArray<const SkPath*>> groups;
+    if (success) {
+        group_overlapping(fPathRefs, &groups);
+    }
+    SkTArray<SkPath> unions(groups.count());
+    unions.push_back_n(groups.count());
+    SkTaskGroup(*executor).batch(groups.count(), [&](int index) {
+        SkTDArray<const SkPath*>& group = groups[index];
+        if (success && !union_tree(group.begin(), group.count(), executor, &unions[index])) {
+            success = false;
+        }
+    });
+    reset();
+    if (!success) {
+        return false;
+    }
+
+    // The unions are simplified and don't overlap each other, so either fill type works for them.
+    result->reset();
+    for (const SkPath& path : unions) {
+        result->addPath(path);
+    }
+    result->setFillType(SkPath::kEvenOdd_FillType);
+    return true;
+}
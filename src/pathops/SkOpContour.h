@@ -390,10 +390,11 @@ protected:
 
 class SkOpContourHead : public SkOpContour {
 public:
-    SkOpContour* appendContour() {
+    // If given, last must be the list's last contour, saving a walk to find it.
+    SkOpContour* appendContour(SkOpContour* last = nullptr) {
         SkOpContour* contour = this->globalState()->allocator()->make<SkOpContour>();
         contour->setNext(nullptr);
-        SkOpContour* prev = this;
+        SkOpContour* prev = last ? last : this;
         SkOpContour* next;
         while ((next = prev->next())) {
             prev = next;
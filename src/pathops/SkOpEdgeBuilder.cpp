@@ -179,6 +179,7 @@ bool SkOpEdgeBuilder::walk() {
     SkScalar* weightPtr = fWeights.begin();
     SkPath::Verb verb;
     SkOpContour* contour = fContourBuilder.contour();
+    SkOpContour* lastContour = nullptr;
     int moveToPtrBump = 0;
     while ((verb = (SkPath::Verb) *verbPtr) != SkPath::kDone_Verb) {
         if (verbPtr == endOfFirstHalf) {
@@ -195,7 +196,8 @@ bool SkOpEdgeBuilder::walk() {
                     }
                 }
                 if (!contour) {
-                    fContourBuilder.setContour(contour = fContoursHead->appendContour());
+                    contour = lastContour = fContoursHead->appendContour(lastContour);
+                    fContourBuilder.setContour(contour);
                 }
                 contour->init(fGlobalState, fOperand,
                     fXorMask[fOperand] == kEvenOdd_PathOpsMask);
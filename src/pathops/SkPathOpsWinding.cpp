@@ -104,6 +104,10 @@ struct SkOpRayHit {
 
 void SkOpContour::rayCheck(const SkOpRayHit& base, SkOpRayDir dir, SkOpRayHit** hits,
                            SkArenaAlloc* allocator) {
+    // if the ray passes beside the bounds, it can't hit any of our segments
+    if (!sideways_overlap(fBounds, base.fPt, dir)) {
+        return;
+    }
     // if the bounds extreme is outside the best, we're done
     SkScalar baseXY = pt_xy(base.fPt, dir);
     SkScalar boundsXY = rect_side(fBounds, dir);
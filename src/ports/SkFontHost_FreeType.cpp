@@ -15,6 +15,7 @@
 #include "SkFontDescriptor.h"
 #include "SkFontHost_FreeType_common.h"
 #include "SkFontMetrics.h"
+#include "SkGlyphFileCache.h"
 #include "SkGlyph.h"
 #include "SkMakeUnique.h"
 #include "SkMalloc.h"
@@ -269,6 +270,16 @@ static void unref_ft_library() {
     }
 }
 
+uint32_t SkFreeTypeVersion() {
+    SkAutoMutexAcquire ac(gFTMutex);
+    FT_Int major = 0, minor = 0, patch = 0;
+    if (ref_ft_library()) {
+        FT_Library_Version(gFTLibrary->library(), &major, &minor, &patch);
+    }
+    unref_ft_library();
+    return SkToU32((major << 16) | (minor << 8) | patch);
+}
+
 ///////////////////////////////////////////////////////////////////////////
 
 struct SkFaceRec {
@@ -504,6 +515,8 @@ protected:
     void generateImage(const SkGlyph& glyph) override;
     bool generatePath(SkGlyphID glyphID, SkPath* path) override;
     void generateFontMetrics(SkFontMetrics*) override;
+    void beginGlyphBatch() override;
+    void endGlyphBatch() override;
 
 private:
     using UnrefFTFace = SkFunctionWrapper<void, SkFaceRec, unref_ft_face>;
@@ -527,6 +540,13 @@ private:
     bool      fDoLinearMetrics;
     bool      fLCDIsVert;
 
+    // Through a batch of glyphs gFTMutex stays locked and the size set up, rather than per glyph.
+    bool      fInGlyphBatch{false};
+    FT_Error  fGlyphBatchSetupError{0};
+
+    // gFTMutex, unless a batch of glyphs already holds it.
+    SkBaseMutex* glyphMutex() { return fInGlyphBatch ? nullptr : &gFTMutex; }
+
     FT_Error setupSize();
     void getBBoxForCurrentGlyph(const SkGlyph* glyph, FT_BBox* bbox,
                                 bool snapToPixelBoundary = false);
@@ -1017,6 +1037,9 @@ SkScalerContext_FreeType::~SkScalerContext_FreeType() {
 */
 FT_Error SkScalerContext_FreeType::setupSize() {
     gFTMutex.assertHeld();
+    if (fInGlyphBatch) {
+        return fGlyphBatchSetupError;
+    }
     FT_Error err = FT_Activate_Size(fFTSize);
     if (err != 0) {
         return err;
@@ -1025,6 +1048,19 @@ FT_Error SkScalerContext_FreeType::setupSize() {
     return 0;
 }
 
+void SkScalerContext_FreeType::beginGlyphBatch() {
+    SkASSERT(!fInGlyphBatch);
+    gFTMutex.acquire();
+    fGlyphBatchSetupError = this->setupSize();
+    fInGlyphBatch = true;
+}
+
+void SkScalerContext_FreeType::endGlyphBatch() {
+    SkASSERT(fInGlyphBatch);
+    fInGlyphBatch = false;
+    gFTMutex.release();
+}
+
 unsigned SkScalerContext_FreeType::generateGlyphCount() {
     return fFace->num_glyphs;
 }
@@ -1042,7 +1078,7 @@ bool SkScalerContext_FreeType::generateAdvance(SkGlyph* glyph) {
         return false;
     }
 
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->glyphMutex());
 
     if (this->setupSize()) {
         glyph->zeroMetrics();
@@ -1147,7 +1183,7 @@ bool SkScalerContext_FreeType::shouldSubpixelBitmap(const SkGlyph& glyph, const
 }
 
 void SkScalerContext_FreeType::generateMetrics(SkGlyph* glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->glyphMutex());
 
     glyph->fMaskFormat = fRec.fMaskFormat;
 
@@ -1303,7 +1339,7 @@ static void clear_glyph_image(const SkGlyph& glyph) {
 }
 
 void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->glyphMutex());
 
     if (this->setupSize()) {
         clear_glyph_image(glyph);
@@ -1336,7 +1372,7 @@ void SkScalerContext_FreeType::generateImage(const SkGlyph& glyph) {
 bool SkScalerContext_FreeType::generatePath(SkGlyphID glyphID, SkPath* path) {
     SkASSERT(path);
 
-    SkAutoMutexAcquire  ac(gFTMutex);
+    SkAutoMutexAcquire  ac(this->glyphMutex());
 
     // FT_IS_SCALABLE is documented to mean the face contains outline glyphs.
     if (!FT_IS_SCALABLE(fFace) || this->setupSize()) {
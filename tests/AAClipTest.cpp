@@ -12,6 +12,7 @@
 #include "SkImageInfo.h"
 #include "SkMalloc.h"
 #include "SkMask.h"
+#include "SkMath.h"
 #include "SkMatrix.h"
 #include "SkPath.h"
 #include "SkRRect.h"
@@ -429,6 +430,64 @@ static void test_huge(skiatest::Reporter* reporter) {
     clip.setRect(r);
 }
 
+static U8CPU mask_alpha(const SkMask& mask, int x, int y) {
+    return mask.fBounds.contains(x, y) ? *mask.getAddr8(x, y) : 0;
+}
+
+// Intersecting clips skips rows where either is opaque, and shares runs when either is opaque
+// all over the other.  Check those against intersecting the clips' masks.
+static void test_nested_intersect(skiatest::Reporter* reporter) {
+    SkRandom rand;
+    for (int i = 0; i < 200; ++i) {
+        SkAAClip clip;
+        clip.setRect(SkIRect::MakeWH(100, 100));
+        for (int depth = 0; depth < 6 && !clip.isEmpty(); ++depth) {
+            SkRect r = SkRect::MakeLTRB(rand.nextRangeScalar(-10,  60),
+                                        rand.nextRangeScalar(-10,  60),
+                                        rand.nextRangeScalar( 40, 110),
+                                        rand.nextRangeScalar( 40, 110));
+            if (rand.nextBool()) {
+                r.set(r.roundOut());
+            }
+            SkPath path;
+            switch (rand.nextULessThan(3)) {
+                case 0: path.addRect(r);                                          break;
+                case 1: path.addOval(r);                                          break;
+                case 2: path.addRRect(SkRRect::MakeRectXY(r, rand.nextRangeScalar(1, 12),
+                                                             rand.nextRangeScalar(1, 12)));
+                        break;
+            }
+            SkAAClip other;
+            other.setPath(path);
+
+            SkAutoMaskFreeImage before, with, after;
+            SkMask beforeMask, withMask, afterMask;
+            clip.copyToMask(&beforeMask);
+            other.copyToMask(&withMask);
+            before.reset(beforeMask.fImage);
+            with.reset(withMask.fImage);
+
+            SkAAClip prev(clip);
+            clip.op(other, SkRegion::kIntersect_Op);
+            clip.copyToMask(&afterMask);
+            after.reset(afterMask.fImage);
+
+            bool ok = true;
+            for (int y = -10; y < 110; ++y) {
+                for (int x = -10; x < 110; ++x) {
+                    U8CPU expected = SkMulDiv255Round(mask_alpha(beforeMask, x, y),
+                                                      mask_alpha(withMask, x, y));
+                    ok &= expected == mask_alpha(afterMask, x, y);
+                }
+            }
+            REPORTER_ASSERT(reporter, ok);
+            if (other.quickContains(prev.getBounds())) {
+                REPORTER_ASSERT(reporter, clip == prev);
+            }
+        }
+    }
+}
+
 DEF_TEST(AAClip, reporter) {
     test_empty(reporter);
     test_path_bounds(reporter);
@@ -440,4 +499,5 @@ DEF_TEST(AAClip, reporter) {
     test_really_a_rect(reporter);
     test_crbug_422693(reporter);
     test_huge(reporter);
+    test_nested_intersect(reporter);
 }
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAAClip.h"
+#include "SkAnalyticClip.h"
+#include "SkBitmapDevice.h"
+#include "SkCanvas.h"
+#include "SkMask.h"
+#include "SkMaskFilter.h"
+#include "SkRRect.h"
+#include "SkRandom.h"
+#include "SkRasterClip.h"
+#include "Test.h"
+
+static SkRRect random_rrect(SkRandom* rand) {
+    SkRect r = SkRect::MakeXYWH(rand->nextRangeScalar(-10, 60), rand->nextRangeScalar(-10, 60),
+                                rand->nextRangeScalar(0.5f, 70), rand->nextRangeScalar(0.5f, 70));
+    SkVector radii[4];
+    for (SkVector& radius : radii) {
+        radius.set(rand->nextRangeScalar(0, 20), rand->nextRangeScalar(0, 20));
+    }
+    if (rand->nextBool()) {
+        radii[1] = radii[2] = radii[3] = radii[0];
+    }
+    SkRRect rrect;
+    rrect.setRectRadii(r, radii);
+    return rrect;
+}
+
+// Rows must span the clip, and lastY must only cover identical rows.  Coverage should be close to
+// sampling the rrect finely, and quickContains() right.
+DEF_TEST(AnalyticClip, r) {
+    const SkIRect bounds = SkIRect::MakeLTRB(0, 0, 100, 100);
+    SkRandom rand;
+    for (int i = 0; i < 200; i++) {
+        const SkRRect rrect = random_rrect(&rand);
+        SkAnalyticClip clip;
+        if (!clip.set(rrect, bounds)) {
+            REPORTER_ASSERT(r, !SkIRect::Intersects(rrect.getBounds().roundOut(), bounds));
+            continue;
+        }
+        const SkIRect& cb = clip.getBounds();
+        REPORTER_ASSERT(r, bounds.contains(cb));
+
+        for (int y = cb.fTop; y < cb.fBottom; y++) {
+            int lastY;
+            const uint8_t* row = clip.findRow(y, &lastY);
+            REPORTER_ASSERT(r, lastY >= y && lastY < cb.fBottom);
+            REPORTER_ASSERT(r, clip.rowLeft() <= cb.fLeft);
+            for (int x = clip.rowLeft(), run = 0; x < cb.fRight; x += row[run], run += 2) {
+                REPORTER_ASSERT(r, row[run] > 0);
+            }
+            for (int same = y + 1; same <= lastY; same++) {
+                REPORTER_ASSERT(r, clip.findRow(same) == row);
+            }
+        }
+
+        SkAAClip aaclip;
+        aaclip.setAnalyticClip(clip);
+        SkMask mask;
+        aaclip.copyToMask(&mask);
+        SkAutoMaskFreeImage freeMask(mask.fImage);
+        for (int y = cb.fTop; i % 4 == 0 && y < cb.fBottom; y++)
+        for (int x = cb.fLeft; x < cb.fRight; x++) {
+            int covered = 0;
+            for (int sy = 0; sy < 16; sy++)
+            for (int sx = 0; sx < 16; sx++) {
+                SkPoint p = { x + (sx + 0.5f) / 16, y + (sy + 0.5f) / 16 };
+                covered += rrect.contains(SkRect::MakeXYWH(p.fX, p.fY, 1e-4f, 1e-4f));
+            }
+            int alpha = mask.fBounds.contains(x, y) ? *mask.getAddr8(x, y) : 0;
+            REPORTER_ASSERT(r, SkTAbs(alpha - covered * 255 / 256) <= 12);
+        }
+
+        SkIRect inner = SkIRect::MakeXYWH(cb.fLeft + rand.nextULessThan(cb.width()),
+                                          cb.fTop  + rand.nextULessThan(cb.height()),
+                                          1 + rand.nextULessThan(8), 1 + rand.nextULessThan(8));
+        if (clip.quickContains(inner)) {
+            for (int y = inner.fTop; y < inner.fBottom; y++)
+            for (int x = inner.fLeft; x < inner.fRight; x++) {
+                REPORTER_ASSERT(r, *mask.getAddr8(x, y) == 0xFF);
+            }
+        }
+
+        // Narrowing the clip keeps the coverage of what's left.
+        SkIRect sub = SkIRect::MakeXYWH(rand.nextULessThan(100), rand.nextULessThan(100),
+                                        1 + rand.nextULessThan(60), 1 + rand.nextULessThan(60));
+        SkAnalyticClip narrowed = clip, direct;
+        if (narrowed.intersect(sub) && direct.set(rrect, narrowed.getBounds())) {
+            SkAAClip a, b;
+            a.setAnalyticClip(narrowed);
+            b.setAnalyticClip(direct);
+            REPORTER_ASSERT(r, a == b);
+        }
+    }
+}
+
+// Each kind of blit under an analytic rrect clip.
+static void draw_card(SkCanvas* canvas, const SkRRect& card, bool materialize) {
+    canvas->save();
+    canvas->clipRRect(card, true);
+    if (materialize) {
+        // Intersecting with the whole surface doesn't change the clip, but makes it an SkAAClip.
+        canvas->clipRegion(SkRegion(SkIRect::MakeWH(128, 128)));
+    }
+
+    SkPaint paint;
+    paint.setColor(0xff3366cc);
+    canvas->drawPaint(paint);
+
+    paint.setAntiAlias(true);
+    paint.setColor(0x80ff8000);
+    canvas->drawRect(SkRect::MakeXYWH(card.rect().fLeft - 3.3f, card.rect().fTop + 4.6f,
+                                      30.2f, 7.7f), paint);
+    canvas->drawCircle(card.rect().fRight - 8, card.rect().fBottom - 8, 11.5f, paint);
+
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setColor(0xff20c040);
+    canvas->drawLine(card.rect().fLeft, card.rect().fTop, card.rect().fRight,
+                     card.rect().fBottom, paint);
+    canvas->drawLine(card.rect().centerX(), 0, card.rect().centerX() + 0.5f, 128, paint);
+
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 2));
+    canvas->drawOval(SkRect::MakeXYWH(card.rect().fLeft - 5, card.rect().centerY(), 25, 12),
+                     paint);
+    canvas->restore();
+}
+
+// Blitting through an analytic clip should match blitting through the SkAAClip made from it.
+DEF_TEST(AnalyticClip_Canvas, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(128, 128);
+
+    SkBitmap results[2];
+    for (int materialize = 0; materialize < 2; materialize++) {
+        SkAssertResult(results[materialize].tryAllocPixels(info));
+        sk_sp<SkBitmapDevice> device(new SkBitmapDevice(results[materialize]));
+        device->rasterClipForTesting().setAnalyticForTesting(true);
+        SkCanvas canvas(device);
+        canvas.clear(SK_ColorWHITE);
+
+        SkRandom rand;
+        for (int i = 0; i < 20; i++) {
+            canvas.save();
+            canvas.translate(rand.nextRangeScalar(-0.5f, 0.5f), 0);
+            canvas.scale(1, rand.nextRangeScalar(0.9f, 1.2f));
+            if (i % 5 == 4) {
+                canvas.clipRect(SkRect::MakeXYWH(10, 10, 100, 100));
+            }
+            draw_card(&canvas, random_rrect(&rand), materialize);
+            canvas.restore();
+        }
+    }
+
+    for (int y = 0; y < info.height(); y++) {
+        REPORTER_ASSERT(r, 0 == memcmp(results[0].getAddr(0, y), results[1].getAddr(0, y),
+                                       info.minRowBytes()));
+    }
+}
+
+// Rect and integer ops keep the clip analytic, and translate() carries it along.
+DEF_TEST(AnalyticClip_RasterClip, r) {
+    const SkIRect device = SkIRect::MakeWH(100, 100);
+    SkRasterClip rc(device);
+    rc.setAnalyticForTesting(true);
+    SkRRect rrect = SkRRect::MakeRectXY(SkRect::MakeLTRB(10.5f, 10.25f, 80.5f, 70.75f), 8, 6);
+    rc.op(rrect, SkMatrix::I(), device, SkRegion::kIntersect_Op, true);
+    REPORTER_ASSERT(r, rc.isAnalytic());
+    REPORTER_ASSERT(r, rc.getBounds() == SkIRect::MakeLTRB(10, 10, 81, 71));
+    REPORTER_ASSERT(r, rc.quickContains(SkIRect::MakeLTRB(20, 20, 60, 60)));
+    REPORTER_ASSERT(r, !rc.quickContains(SkIRect::MakeLTRB(10, 10, 20, 20)));
+
+    rc.op(SkIRect::MakeLTRB(0, 0, 50, 100), SkRegion::kIntersect_Op);
+    REPORTER_ASSERT(r, rc.isAnalytic());
+    REPORTER_ASSERT(r, rc.getBounds() == SkIRect::MakeLTRB(10, 10, 50, 71));
+
+    SkRasterClip moved;
+    rc.translate(5, -5, &moved);
+    REPORTER_ASSERT(r, moved.isAnalytic());
+    REPORTER_ASSERT(r, moved.getBounds() == SkIRect::MakeLTRB(15, 5, 55, 66));
+
+    // Anything else turns it into an SkAAClip.
+    SkRasterClip copy(rc);
+    copy.op(SkRect::MakeLTRB(20.5f, 20.5f, 30.5f, 30.5f), SkMatrix::I(), device,
+            SkRegion::kUnion_Op, true);
+    REPORTER_ASSERT(r, !copy.isAnalytic() && copy.isAA());
+
+    rc.op(SkRect::MakeLTRB(0, 0, 100, 40), SkMatrix::I(), device, SkRegion::kIntersect_Op, false);
+    REPORTER_ASSERT(r, rc.isAnalytic());
+    REPORTER_ASSERT(r, rc.getBounds() == SkIRect::MakeLTRB(10, 10, 50, 40));
+    rc.op(SkRect::MakeLTRB(0, 0, 100, 100), SkMatrix::I(), device, SkRegion::kIntersect_Op,
+          false);
+    REPORTER_ASSERT(r, rc.isAnalytic());
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkArenaAlloc.h"
+#include "SkHalf.h"
+#include "SkOpts.h"
+#include "SkRandom.h"
+#include "SkRasterPipeline.h"
+#include "Test.h"
+
+static constexpr int W = 19,
+                     H = 7;
+
+// What the SkRasterPipeline blitter does with a constant color SrcOver mask.
+template <typename Dst, typename Mask>
+static void blit_with_pipeline(SkColorType ct, Dst* dst, const Mask* mask,
+                               const SkColor4f& color) {
+    SkRasterPipeline_MemoryCtx dstCtx  = { dst,  W },
+                               maskCtx = { const_cast<Mask*>(mask), W };
+    SkSTArenaAlloc<256> alloc;
+    SkRasterPipeline p(&alloc);
+    p.append_constant_color(&alloc, color);
+    if (sizeof(Mask) == 1) {
+        p.append(SkRasterPipeline::scale_u8, &maskCtx);
+        p.append_load_dst(ct, &dstCtx);
+        p.append(SkRasterPipeline::srcover);
+    } else {
+        p.append_load_dst(ct, &dstCtx);
+        p.append(SkRasterPipeline::srcover);
+        p.append(SkRasterPipeline::lerp_565, &maskCtx);
+    }
+    p.append_store(ct, &dstCtx);
+    p.run(0,0, W,H);
+}
+
+static SkColor4f random_color(SkRandom* rand, bool opaque) {
+    float a = opaque ? 1.0f : rand->nextF();
+    return { rand->nextF() * a, rand->nextF() * a, rand->nextF() * a, a };
+}
+
+template <typename Mask>
+static void random_mask(SkRandom* rand, Mask mask[W*H]) {
+    for (int i = 0; i < W*H; i++) {
+        // Plenty of the uncovered and fully covered pixels glyphs are mostly made of.
+        switch (rand->nextULessThan(4)) {
+            case 0:  mask[i] = 0;                    break;
+            case 1:  mask[i] = (Mask)~0;             break;
+            default: mask[i] = (Mask)rand->nextU();  break;
+        }
+    }
+}
+
+DEF_TEST(BlitMaskOpts_F16, r) {
+    SkRandom rand;
+    for (int i = 0; i < 40; i++) {
+        SkColor4f color = random_color(&rand, i % 2 == 0);
+        uint64_t dst[W*H], expected[W*H];
+        for (uint64_t& px : dst) {
+            SkColor4f d = random_color(&rand, i % 4 < 2);
+            SkFloatToHalf_finite_ftz(Sk4f::Load(d.vec())).store(&px);
+        }
+        memcpy(expected, dst, sizeof(dst));
+
+        if (i < 20) {
+            uint8_t mask[W*H];
+            random_mask(&rand, mask);
+            blit_with_pipeline(kRGBA_F16_SkColorType, expected, mask, color);
+            SkOpts::blit_mask_f16_a8(dst, W*sizeof(uint64_t), mask, W, color, W, H);
+        } else {
+            uint16_t mask[W*H];
+            random_mask(&rand, mask);
+            blit_with_pipeline(kRGBA_F16_SkColorType, expected, mask, color);
+            SkOpts::blit_mask_f16_lcd16(dst, W*sizeof(uint64_t), mask, W*sizeof(uint16_t),
+                                        color, W, H);
+        }
+
+        for (int j = 0; j < W*H; j++) {
+            Sk4f diff = (SkHalfToFloat_finite_ftz(dst[j]) -
+                         SkHalfToFloat_finite_ftz(expected[j])).abs();
+            REPORTER_ASSERT(r, (diff <= 1/512.0f).allTrue());
+        }
+    }
+}
+
+DEF_TEST(BlitMaskOpts_1010102, r) {
+    SkRandom rand;
+    for (int i = 0; i < 40; i++) {
+        SkColor4f color = random_color(&rand, i % 2 == 0);
+        uint32_t dst[W*H], expected[W*H];
+        for (uint32_t& px : dst) {
+            px = rand.nextU();
+        }
+        memcpy(expected, dst, sizeof(dst));
+
+        if (i < 20) {
+            uint8_t mask[W*H];
+            random_mask(&rand, mask);
+            blit_with_pipeline(kRGBA_1010102_SkColorType, expected, mask, color);
+            SkOpts::blit_mask_1010102_a8(dst, W*sizeof(uint32_t), mask, W, color, W, H);
+        } else {
+            uint16_t mask[W*H];
+            random_mask(&rand, mask);
+            blit_with_pipeline(kRGBA_1010102_SkColorType, expected, mask, color);
+            SkOpts::blit_mask_1010102_lcd16(dst, W*sizeof(uint32_t), mask, W*sizeof(uint16_t),
+                                            color, W, H);
+        }
+
+        for (int j = 0; j < W*H; j++) {
+            for (int shift : { 0, 10, 20, 30 }) {
+                int d = (dst[j]      >> shift) & 1023,
+                    e = (expected[j] >> shift) & 1023;
+                REPORTER_ASSERT(r, SkTAbs(d - e) <= 1);
+            }
+        }
+    }
+}
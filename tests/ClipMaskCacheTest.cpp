@@ -0,0 +1,137 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapDevice.h"
+#include "SkCanvas.h"
+#include "SkClipMaskCache.h"
+#include "SkClipOpPriv.h"
+#include "SkGraphics.h"
+#include "SkPath.h"
+#include "SkRRect.h"
+#include "SkResourceCache.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+DEF_TEST(ClipMaskCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+
+    SkPath path;
+    path.addCircle(50, 50, 30);
+    const SkMatrix matrix = SkMatrix::MakeTrans(3.5f, 0);
+    const SkIRect bounds = SkIRect::MakeWH(100, 100);
+
+    SkAAClip clip;
+    REPORTER_ASSERT(reporter, !SkClipMaskCache::Find(path, matrix, bounds, &clip, &cache));
+
+    SkPath devPath;
+    path.transform(matrix, &devPath);
+    SkAAClip expected;
+    SkRegion rgn(bounds);
+    expected.setPath(devPath, &rgn, true);
+    SkClipMaskCache::Add(path, matrix, bounds, expected, &cache);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() > 0);
+
+    REPORTER_ASSERT(reporter, SkClipMaskCache::Find(path, matrix, bounds, &clip, &cache));
+    REPORTER_ASSERT(reporter, clip == expected);
+
+    // A different matrix, bounds or fill type misses.
+    REPORTER_ASSERT(reporter, !SkClipMaskCache::Find(path, SkMatrix::I(), bounds, &clip, &cache));
+    REPORTER_ASSERT(reporter, !SkClipMaskCache::Find(path, matrix, SkIRect::MakeWH(100, 90),
+                                                     &clip, &cache));
+    {
+        SkPath inverse = path;
+        inverse.toggleInverseFillType();
+        REPORTER_ASSERT(reporter, !SkClipMaskCache::Find(inverse, matrix, bounds, &clip, &cache));
+    }
+
+    // Editing the path purges its clips from the cache.
+    path.lineTo(0, 0);
+    REPORTER_ASSERT(reporter, !SkClipMaskCache::Find(path, matrix, bounds, &clip, &cache));
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == 0);
+}
+
+// A few frames of a layout clipped by paths, combined with every op and with rect, rrect and
+// path clips.
+static void draw_frame(SkCanvas* canvas, const SkPath paths[3]) {
+    SkPaint paint;
+    paint.setColor(0xff3366cc);
+
+    canvas->clear(SK_ColorWHITE);
+    for (SkClipOp op : { kIntersect_SkClipOp, kDifference_SkClipOp, kUnion_SkClipOp,
+                         kXOR_SkClipOp, kReverseDifference_SkClipOp, kReplace_SkClipOp }) {
+        canvas->save();
+        canvas->translate(10.5f, 0);
+        canvas->clipPath(paths[0], true);
+        canvas->clipPath(paths[1], op, true);
+        canvas->drawPaint(paint);
+        canvas->restore();
+
+        canvas->save();
+        canvas->clipRRect(SkRRect::MakeRectXY(SkRect::MakeXYWH(5, 5, 90, 110), 20, 20), true);
+        canvas->rotate(10);
+        canvas->clipPath(paths[2], op, true);
+        canvas->drawPaint(paint);
+        canvas->restore();
+    }
+
+    // Non-AA clips aren't cached.
+    canvas->save();
+    canvas->clipRect(SkRect::MakeXYWH(20, 20, 60, 60));
+    canvas->clipPath(paths[1], false);
+    canvas->drawPaint(paint);
+    canvas->restore();
+}
+
+static bool equal(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < a.height(); y++) {
+        if (0 != memcmp(a.getAddr(0,y), b.getAddr(0,y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Clipping should draw the same with and without the cache, and find clips in the cache on
+// later frames.
+DEF_TEST(ClipMaskCache_Canvas, reporter) {
+    SkPath paths[3];
+    paths[0].addCircle(60, 60, 50);
+    paths[1].addOval(SkRect::MakeXYWH(30, 10, 40, 100));
+    paths[2].moveTo(20, 10);
+    paths[2].lineTo(110, 40);
+    paths[2].lineTo(40, 110);
+    paths[2].close();
+    paths[2].addCircle(50, 50, 20);
+    paths[2].setFillType(SkPath::kEvenOdd_FillType);
+
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(128, 128);
+    SkBitmap expected;
+    SkAssertResult(expected.tryAllocPixels(info));
+    {
+        auto surface = SkSurface::MakeRaster(info);
+        draw_frame(surface->getCanvas(), paths);
+        SkAssertResult(surface->readPixels(expected, 0, 0));
+    }
+
+    for (int frame = 0; frame < 2; frame++) {
+        // Other threads may be clipping too, so we can only bound the stats.
+        int64_t hitsBefore, missesBefore;
+        SkGraphics::GetClipMaskCacheStats(&hitsBefore, &missesBefore);
+
+        SkBitmap result;
+        SkAssertResult(result.tryAllocPixels(info));
+        sk_sp<SkBitmapDevice> device(new SkBitmapDevice(result));
+        device->rasterClipForTesting().setCachePathsForTesting(true);
+        SkCanvas canvas(device);
+        draw_frame(&canvas, paths);
+        REPORTER_ASSERT(reporter, equal(expected, result));
+
+        int64_t hits, misses;
+        SkGraphics::GetClipMaskCacheStats(&hits, &misses);
+        REPORTER_ASSERT(reporter, frame == 0 ? misses > missesBefore : hits > hitsBefore);
+    }
+}
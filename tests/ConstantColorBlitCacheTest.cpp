@@ -0,0 +1,127 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkArenaAlloc.h"
+#include "SkBitmap.h"
+#include "SkColorFilter.h"
+#include "SkColorSpace.h"
+#include "SkCoreBlitters.h"
+#include "SkMask.h"
+#include "SkPaint.h"
+#include "Test.h"
+
+// Blits with each kind of blit: rects, anti-aliased runs, and A8 and LCD16 masks.
+static void blit(SkBlitter* blitter) {
+    blitter->blitRect(4, 4, 40, 30);
+
+    SkAlpha aa[12] = {};
+    int16_t runs[13] = {};
+    aa[0] = 0x40;  runs[0] = 3;
+    aa[3] = 0xff;  runs[3] = 5;
+    aa[8] = 0x90;  runs[8] = 4;
+    blitter->blitAntiH(10, 40, aa, runs);
+
+    // These blit through A8 masks.
+    blitter->blitAntiH2(30, 50, 0x20, 0xe0);
+    blitter->blitV(50, 10, 20, 0x70);
+
+    uint8_t a8[8*8];
+    uint16_t lcd16[8*8];
+    for (int i = 0; i < 8*8; i++) {
+        a8[i]    = (uint8_t)(i * 4);
+        lcd16[i] = (uint16_t)(i * 1021);
+    }
+    SkMask mask;
+    mask.fImage    = a8;
+    mask.fBounds   = SkIRect::MakeXYWH(20, 20, 8, 8);
+    mask.fRowBytes = 8;
+    mask.fFormat   = SkMask::kA8_Format;
+    blitter->blitMask(mask, mask.fBounds);
+
+    mask.fImage    = (uint8_t*)lcd16;
+    mask.fBounds   = SkIRect::MakeXYWH(40, 44, 8, 8);
+    mask.fRowBytes = 8 * sizeof(uint16_t);
+    mask.fFormat   = SkMask::kLCD16_Format;
+    blitter->blitMask(mask, mask.fBounds);
+}
+
+static void draw(const SkImageInfo& info, const SkPaint& paint, SkConstantColorBlitCache* cache,
+                 SkBitmap* bitmap) {
+    SkAssertResult(bitmap->tryAllocPixels(info));
+    bitmap->eraseColor(SK_ColorWHITE);
+    SkPixmap pixmap;
+    SkAssertResult(bitmap->peekPixels(&pixmap));
+
+    SkSTArenaAlloc<2048> alloc;
+    blit(SkCreateRasterPipelineBlitter(pixmap, paint, SkMatrix::I(), &alloc, cache));
+}
+
+static bool pixels_equal(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < a.height(); y++) {
+        if (0 != memcmp(a.getAddr(0,y), b.getAddr(0,y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(ConstantColorBlitCache, r) {
+    const SkImageInfo infos[] = {
+        SkImageInfo::MakeN32Premul(64, 64),
+        SkImageInfo::Make(64, 64, kRGBA_F16_SkColorType, kPremul_SkAlphaType,
+                          SkColorSpace::MakeSRGBLinear()),
+    };
+
+    SkPaint paints[4];
+    paints[0].setColor(0x80336699);
+    paints[1].setColor(0x80336699);
+    paints[1].setBlendMode(SkBlendMode::kMultiply);
+    paints[2].setColor(0xff20c040);  // Opaque SrcOver draws as Src, and memsets rects.
+    paints[3].setColor(0xc0ff8000);
+    paints[3].setColorFilter(SkColorFilter::MakeModeFilter(0x4000ff00, SkBlendMode::kSrcOver));
+
+    for (const SkImageInfo& info : infos) {
+        for (const SkPaint& paint : paints) {
+            // Draw once without caching, for reference.
+            SkConstantColorBlitCache uncached(0);
+            SkBitmap expected;
+            draw(info, paint, &uncached, &expected);
+            REPORTER_ASSERT(r, uncached.getCountUsed() == 0);
+
+            // The first draw fills the cache and the second should use everything it cached.
+            SkConstantColorBlitCache cache(64);
+            int64_t hits, misses;
+            for (int i = 0; i < 2; i++) {
+                SkBitmap result;
+                draw(info, paint, &cache, &result);
+                REPORTER_ASSERT(r, pixels_equal(expected, result));
+
+                cache.getStats(&hits, &misses);
+                REPORTER_ASSERT(r, misses > 0);
+                REPORTER_ASSERT(r, hits == (i == 0 ? 0 : misses));
+                REPORTER_ASSERT(r, cache.getCountUsed() == misses);
+            }
+
+            // A different color misses.
+            SkPaint other = paint;
+            other.setAlpha(paint.getAlpha() / 2);
+            SkBitmap result;
+            draw(info, other, &cache, &result);
+            int64_t otherHits, otherMisses;
+            cache.getStats(&otherHits, &otherMisses);
+            REPORTER_ASSERT(r, otherHits == hits && otherMisses > misses);
+
+            cache.purgeAll();
+            REPORTER_ASSERT(r, cache.getCountUsed() == 0);
+            REPORTER_ASSERT(r, cache.getCountLimit() == 64);
+            REPORTER_ASSERT(r, cache.setCountLimit(0) == 64);
+            draw(info, paint, &cache, &result);
+            REPORTER_ASSERT(r, pixels_equal(expected, result));
+            REPORTER_ASSERT(r, cache.getCountUsed() == 0);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkArenaAlloc.h"
+#include "SkBitmap.h"
+#include "SkBlitter.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkScan.h"
+#include "Test.h"
+
+#if !defined(SK_DISABLE_DAA)
+
+// A big non-convex path of lines, quads and cubics that crosses itself and the canvas bounds.
+static SkPath make_path(SkPath::FillType fillType) {
+    SkRandom rand;
+    auto pt = [&] { return SkPoint::Make(rand.nextRangeScalar(-40, 300),
+                                         rand.nextRangeScalar(-40, 440)); };
+    SkPath path;
+    path.setFillType(fillType);
+    path.moveTo(pt());
+    for (int i = 0; i < 400; i++) {
+        switch (i % 3) {
+            case 0: path.lineTo(pt());                    break;
+            case 1: path.quadTo(pt(), pt());              break;
+            case 2: path.cubicTo(pt(), pt(), pt());       break;
+        }
+    }
+    path.close();
+    return path;
+}
+
+static void fill(const SkPixmap& dst, const SkPath& path, SkColor color, const SkIRect& clip,
+                 int threads) {
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setColor(color);
+    SkSTArenaAlloc<2048> alloc;
+    SkScan::DAAFillPathForTesting(path, clip, SkBlitter::Choose(dst, SkMatrix::I(), paint, &alloc),
+                                  threads);
+}
+
+static void draw(const SkPixmap& dst, const SkPath& path, int threads) {
+    dst.erase(SK_ColorWHITE);
+    fill(dst, path, 0xc0336699, dst.bounds(), threads);
+
+    SkMatrix rotate;
+    rotate.setRotate(15);
+    SkPath rotated;
+    path.transform(rotate, &rotated);
+    fill(dst, rotated, 0x8020c040, SkIRect::MakeLTRB(20, 37, 230, 350), threads);
+}
+
+static bool equal(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < a.height(); y++) {
+        if (0 != memcmp(a.getAddr(0,y), b.getAddr(0,y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Splitting a path into bands, whether they run in parallel or not, must not change its pixels.
+DEF_TEST(DeltaAABands, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(256, 400);
+    const SkPath::FillType fillTypes[] = {
+        SkPath::kWinding_FillType,
+        SkPath::kEvenOdd_FillType,
+        SkPath::kInverseWinding_FillType,
+    };
+
+    for (SkPath::FillType fillType : fillTypes) {
+        SkPath path = make_path(fillType);
+
+        SkBitmap results[3];
+        const int bands[] = { 0, 2, 7 };
+        for (int i = 0; i < 3; i++) {
+            SkAssertResult(results[i].tryAllocPixels(info));
+            draw(results[i].pixmap(), path, bands[i]);
+        }
+        REPORTER_ASSERT(r, equal(results[0], results[1]));
+        REPORTER_ASSERT(r, equal(results[0], results[2]));
+    }
+}
+
+#endif
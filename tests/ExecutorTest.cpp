@@ -0,0 +1,68 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkExecutor.h"
+#include "SkTaskGroup.h"
+#include "Test.h"
+#include <atomic>
+
+DEF_TEST(SkExecutor_WorkStealing, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeWorkStealingThreadPool(4);
+
+    // Lots of small tasks, added from outside the pool.
+    std::atomic<int> sum{0};
+    SkTaskGroup(*executor).batch(1000, [&](int i) {
+        sum.fetch_add(i, std::memory_order_relaxed);
+    });
+    REPORTER_ASSERT(r, 999 * 1000 / 2 == sum.load());
+
+    // Tasks that add and wait on tasks of their own, nested a few levels deep.
+    std::atomic<int> leaves{0};
+    std::function<void(int)> spawn = [&](int depth) {
+        if (depth == 0) {
+            leaves.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        SkTaskGroup(*executor).batch(5, [&](int) { spawn(depth - 1); });
+    };
+    SkTaskGroup(*executor).batch(5, [&](int) { spawn(3); });
+    REPORTER_ASSERT(r, 5 * 5 * 5 * 5 == leaves.load());
+
+    // Tasks that add work to another pool aren't that pool's threads.
+    std::unique_ptr<SkExecutor> other = SkExecutor::MakeWorkStealingThreadPool(2);
+    sum = 0;
+    SkTaskGroup(*executor).batch(10, [&](int i) {
+        SkTaskGroup(*other).batch(10, [&](int j) {
+            sum.fetch_add(10 * i + j, std::memory_order_relaxed);
+        });
+    });
+    REPORTER_ASSERT(r, 99 * 100 / 2 == sum.load());
+}
+
+DEF_TEST(SkTaskGroup_ForkJoin, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeWorkStealingThreadPool(4);
+
+    for (int grain : { 0, 1, 7, 1000, 5000 }) {
+        int hits[1000] = {};
+
+        SkTaskGroup tasks(*executor);
+        tasks.forkJoin(1000, grain, [&](int start, int end) {
+            REPORTER_ASSERT(r, 0 <= start && start < end && end <= 1000);
+            REPORTER_ASSERT(r, grain <= 0 || end - start <= grain);
+            for (int i = start; i < end; i++) {
+                hits[i]++;
+            }
+        });
+        for (int hit : hits) {
+            REPORTER_ASSERT(r, 1 == hit);
+        }
+    }
+
+    // Empty ranges call nothing.
+    SkTaskGroup tasks(*executor);
+    tasks.forkJoin(0, 0, [&](int, int) { REPORTER_ASSERT(r, false); });
+}
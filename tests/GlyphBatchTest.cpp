@@ -0,0 +1,166 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Resources.h"
+#include "SkDashPathEffect.h"
+#include "SkExecutor.h"
+#include "SkFont.h"
+#include "SkPaint.h"
+#include "SkStrikeCache.h"
+#include "SkSurfaceProps.h"
+#include "SkTaskGroup.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+static constexpr int kGlyphCount = 200;
+
+static SkExclusiveStrikePtr find_or_create(SkStrikeCache* cache, const SkFont& font,
+                                           const SkPaint& paint) {
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            font, paint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I(), &ad, &effects);
+    return cache->findOrCreateStrikeExclusive(*desc, effects, *font.getTypefaceOrDefault());
+}
+
+// Glyphs generated a run at a time, serially or in parallel, are the glyphs generated one by one.
+static void check_batch(skiatest::Reporter* r, const SkFont& font, const SkPaint& paint) {
+    SkStrikeCache referenceCache;
+    auto reference = find_or_create(&referenceCache, font, paint);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (int threads : { 1, 4 }) {
+        SkStrikeCache cache;
+        auto strike = find_or_create(&cache, font, paint);
+        // Some glyphs are already there, some with just their advances.
+        strike->getGlyphIDMetrics(3);
+        strike->getGlyphIDAdvance(5);
+
+        // A second batch of new glyphs reuses the scaler contexts the first one split across.
+        for (int batch = 0; batch < 2; batch++) {
+            SkGlyphID ids[kGlyphCount];
+            SkPoint positions[kGlyphCount];
+            for (int i = 0; i < kGlyphCount; i++) {
+                // Each glyph more than once.
+                ids[i] = (SkGlyphID)(batch * kGlyphCount / 2 + i % (kGlyphCount / 2));
+                positions[i] = {0, 0};
+            }
+
+            SkGlyphPos glyphs[kGlyphCount];
+            int count = strike->glyphMetrics(ids, positions, kGlyphCount, glyphs);
+            REPORTER_ASSERT(r, count > 0 && count <= kGlyphCount);
+            strike->prepareImages(SkSpan<const SkGlyphPos>{glyphs, SkTo<size_t>(count)},
+                                  executor.get(), threads);
+
+            for (int i = 0; i < count; i++) {
+                const SkGlyph& glyph = *glyphs[i].glyph;
+                REPORTER_ASSERT(r, !glyph.isEmpty());
+                REPORTER_ASSERT(r, glyph.fImage != nullptr);
+                const SkGlyph& expected = reference->getGlyphIDMetrics(glyph.getGlyphID());
+                REPORTER_ASSERT(r, glyph.fAdvanceX == expected.fAdvanceX);
+                REPORTER_ASSERT(r, glyph.fWidth == expected.fWidth &&
+                                   glyph.fHeight == expected.fHeight);
+                REPORTER_ASSERT(r, glyph.fTop == expected.fTop && glyph.fLeft == expected.fLeft);
+                REPORTER_ASSERT(r, glyph.fMaskFormat == expected.fMaskFormat);
+                const void* image = reference->findImage(expected);
+                REPORTER_ASSERT(r, image != nullptr && glyph.fImage != nullptr &&
+                                   !memcmp(glyph.fImage, image, glyph.computeImageSize()));
+            }
+
+            // The same glyph is only generated once.
+            for (int i = 0; i < count; i++) {
+                for (int j = i + 1; j < count; j++) {
+                    if (glyphs[i].glyph->getGlyphID() == glyphs[j].glyph->getGlyphID()) {
+                        REPORTER_ASSERT(r, glyphs[i].glyph == glyphs[j].glyph);
+                    }
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(GlyphBatch_Images, r) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    SkFont font(typeface, 18);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    check_batch(r, font, SkPaint());
+
+    // Glyphs drawn from paths, the ones that gain the most from generating in parallel.
+    SkPaint dashed;
+    const SkScalar intervals[] = { 2, 1 };
+    dashed.setPathEffect(SkDashPathEffect::Make(intervals, SK_ARRAY_COUNT(intervals), 0));
+    check_batch(r, font, dashed);
+
+    font.setEmbolden(true);
+    check_batch(r, font, SkPaint());
+}
+
+// Text drawn from tasks on the pool its batches could be split on, all from one shared strike.
+// Waiting on a split batch may run another of these tasks on the same thread, which then waits
+// for the strike the first one holds, so shared strikes must generate their batches unsplit.
+DEF_TEST(GlyphBatch_SharedStrikes, r) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    SkFont font(typeface, 18);
+    font.setEdging(SkFont::Edging::kAntiAlias);
+    SkPaint dashed;
+    const SkScalar intervals[] = { 2, 1 };
+    dashed.setPathEffect(SkDashPathEffect::Make(intervals, SK_ARRAY_COUNT(intervals), 0));
+
+    SkStrikeCache referenceCache;
+    auto reference = find_or_create(&referenceCache, font, dashed);
+    std::vector<std::vector<uint8_t>> images;
+    for (int id = 0; id < kGlyphCount; id++) {
+        const SkGlyph& glyph = reference->getGlyphIDMetrics((SkGlyphID)id);
+        auto image = static_cast<const uint8_t*>(reference->findImage(glyph));
+        images.push_back(image ? std::vector<uint8_t>(image, image + glyph.computeImageSize())
+                               : std::vector<uint8_t>());
+    }
+
+    SkStrikeCache cache(true);
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    std::atomic<int> mismatches{0};
+    SkTaskGroup(*executor).batch(16, [&](int i) {
+        auto strike = find_or_create(&cache, font, dashed);
+        SkGlyphID ids[kGlyphCount];
+        SkPoint positions[kGlyphCount];
+        for (int j = 0; j < kGlyphCount; j++) {
+            ids[j] = (SkGlyphID)((j * 7 + i) % kGlyphCount);
+            positions[j] = {0, 0};
+        }
+
+        SkGlyphPos glyphs[kGlyphCount];
+        int count = strike->glyphMetrics(ids, positions, kGlyphCount, glyphs);
+        strike->prepareImages(SkSpan<const SkGlyphPos>{glyphs, SkTo<size_t>(count)},
+                              executor.get(), 4);
+        for (int j = 0; j < count; j++) {
+            const SkGlyph& glyph = *glyphs[j].glyph;
+            auto image = static_cast<const uint8_t*>(strike->findImage(glyph));
+            std::vector<uint8_t> actual;
+            if (image) {
+                actual.assign(image, image + glyph.computeImageSize());
+            }
+            if (actual != images[glyph.getGlyphID()]) {
+                mismatches++;
+            }
+        }
+    });
+
+    REPORTER_ASSERT(r, mismatches == 0);
+    REPORTER_ASSERT(r, cache.getCacheCountUsed() == 1);
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Resources.h"
+#include "SkFont.h"
+#include "SkGlyphFileCache.h"
+#include "SkOSPath.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkStrikeCache.h"
+#include "SkSurfaceProps.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+// What a strike generates for its first glyphs.
+struct Glyphs {
+    std::vector<SkGlyph>              fMetrics;
+    std::vector<std::vector<uint8_t>> fImages;
+    std::vector<SkPath>               fPaths;
+};
+}  // namespace
+
+static constexpr SkGlyphID kGlyphCount = 32;
+
+static Glyphs draw_glyphs(sk_sp<SkGlyphFileCache> fileCache, sk_sp<SkTypeface> typeface,
+                          SkScalar size) {
+    SkStrikeCache cache;
+    cache.setFileCache(std::move(fileCache));
+
+    SkFont font(std::move(typeface), size);
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I(), &ad, &effects);
+    auto strike = cache.findOrCreateStrikeExclusive(*desc, effects, *font.getTypefaceOrDefault());
+
+    Glyphs glyphs;
+    for (SkGlyphID id = 0; id < kGlyphCount; id++) {
+        const SkGlyph& glyph = strike->getGlyphIDMetrics(id);
+        glyphs.fMetrics.push_back(glyph);
+        auto image = static_cast<const uint8_t*>(strike->findImage(glyph));
+        glyphs.fImages.push_back(
+                image ? std::vector<uint8_t>(image, image + glyph.computeImageSize())
+                      : std::vector<uint8_t>());
+        const SkPath* path = strike->findPath(glyph);
+        glyphs.fPaths.push_back(path ? *path : SkPath());
+    }
+    return glyphs;
+}
+
+static void check_same(skiatest::Reporter* r, const Glyphs& a, const Glyphs& b) {
+    for (int i = 0; i < kGlyphCount; i++) {
+        const SkGlyph& ma = a.fMetrics[i];
+        const SkGlyph& mb = b.fMetrics[i];
+        REPORTER_ASSERT(r, ma.fAdvanceX == mb.fAdvanceX && ma.fAdvanceY == mb.fAdvanceY);
+        REPORTER_ASSERT(r, ma.fWidth == mb.fWidth && ma.fHeight == mb.fHeight);
+        REPORTER_ASSERT(r, ma.fTop == mb.fTop && ma.fLeft == mb.fLeft);
+        REPORTER_ASSERT(r, ma.fMaskFormat == mb.fMaskFormat);
+        REPORTER_ASSERT(r, a.fImages[i] == b.fImages[i]);
+        REPORTER_ASSERT(r, a.fPaths[i] == b.fPaths[i]);
+    }
+}
+
+// Glyphs generated in one process are found, the same, in the next.
+DEF_TEST(GlyphFileCache_RoundTrip, r) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+
+    auto first = SkGlyphFileCache::Make();
+    Glyphs generated = draw_glyphs(first, typeface, 24);
+    REPORTER_ASSERT(r, first->countLoaded() == 0);
+    REPORTER_ASSERT(r, first->countAdded() > 0);
+
+    // The typeface's ID doesn't matter, only its font data.
+    auto second = SkGlyphFileCache::Make(first->serialize());
+    REPORTER_ASSERT(r, second->countLoaded() == first->countAdded());
+    check_same(r, generated,
+               draw_glyphs(second, MakeResourceAsTypeface("fonts/Roboto-Regular.ttf"), 24));
+    REPORTER_ASSERT(r, second->countAdded() == 0);
+
+    // Other strikes aren't found, and are added.
+    draw_glyphs(second, typeface, 25);
+    REPORTER_ASSERT(r, second->countAdded() > 0);
+
+    auto third = SkGlyphFileCache::Make(second->serialize());
+    REPORTER_ASSERT(r, third->countLoaded() == second->countLoaded() + second->countAdded());
+    check_same(r, generated, draw_glyphs(third, typeface, 24));
+    REPORTER_ASSERT(r, third->countAdded() == 0);
+}
+
+// Data that has been damaged in any way is ignored.
+DEF_TEST(GlyphFileCache_Invalid, r) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    auto fileCache = SkGlyphFileCache::Make();
+    draw_glyphs(fileCache, typeface, 12);
+    sk_sp<SkData> data = fileCache->serialize();
+    REPORTER_ASSERT(r, SkGlyphFileCache::Make(data)->countLoaded() == fileCache->countAdded());
+
+    REPORTER_ASSERT(r, SkGlyphFileCache::Make(SkData::MakeEmpty())->countLoaded() == 0);
+    for (size_t size : { (size_t)4, data->size() / 2, data->size() - 4 }) {
+        auto truncated = SkData::MakeSubset(data.get(), 0, size);
+        REPORTER_ASSERT(r, SkGlyphFileCache::Make(truncated)->countLoaded() == 0);
+    }
+    // The magic, the version, the milestone, the FreeType version, and the rest of the data.
+    for (size_t offset : { (size_t)0, (size_t)4, (size_t)8, (size_t)12,
+                           data->size() / 2, data->size() - 1 }) {
+        sk_sp<SkData> damaged = SkData::MakeWithCopy(data->data(), data->size());
+        static_cast<uint8_t*>(damaged->writable_data())[offset] ^= 0x10;
+        REPORTER_ASSERT(r, SkGlyphFileCache::Make(damaged)->countLoaded() == 0);
+    }
+}
+
+// Added glyphs stop being kept once they reach the limit, but are still drawn the same.
+DEF_TEST(GlyphFileCache_AddedByteLimit, r) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    auto unlimited = SkGlyphFileCache::Make();
+    Glyphs generated = draw_glyphs(unlimited, typeface, 32);
+    size_t bytes = unlimited->getAddedBytes();
+    REPORTER_ASSERT(r, bytes > 0);
+
+    auto limited = SkGlyphFileCache::Make();
+    limited->setAddedByteLimit(bytes / 2);
+    check_same(r, generated, draw_glyphs(limited, typeface, 32));
+    REPORTER_ASSERT(r, limited->getAddedBytes() <= bytes / 2);
+    REPORTER_ASSERT(r, 0 < limited->countAdded() &&
+                       limited->countAdded() < unlimited->countAdded());
+
+    // What was kept is still written out and found.
+    auto reloaded = SkGlyphFileCache::Make(limited->serialize());
+    REPORTER_ASSERT(r, reloaded->countLoaded() == limited->countAdded());
+    check_same(r, generated, draw_glyphs(reloaded, typeface, 32));
+
+    // The limit can't drop below what's already added.
+    REPORTER_ASSERT(r, limited->setAddedByteLimit(0) == bytes / 2);
+    REPORTER_ASSERT(r, limited->setAddedByteLimit(0) == limited->getAddedBytes());
+}
+
+DEF_TEST(GlyphFileCache_File, r) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (tmpDir.isEmpty() || !typeface) {
+        return;
+    }
+    SkString path = SkOSPath::Join(tmpDir.c_str(), "glyph_file_cache");
+    remove(path.c_str());
+
+    auto first = SkGlyphFileCache::MakeFromFile(path.c_str());
+    REPORTER_ASSERT(r, first->countLoaded() == 0);
+    Glyphs generated = draw_glyphs(first, typeface, 16);
+    REPORTER_ASSERT(r, first->writeToFile());
+
+    auto second = SkGlyphFileCache::MakeFromFile(path.c_str());
+    REPORTER_ASSERT(r, second->countLoaded() == first->countAdded());
+    check_same(r, generated, draw_glyphs(second, typeface, 16));
+
+    // Rewriting the file leaves the mapped one alone.
+    draw_glyphs(second, typeface, 17);
+    REPORTER_ASSERT(r, second->writeToFile());
+    check_same(r, generated, draw_glyphs(second, typeface, 16));
+    REPORTER_ASSERT(r, SkGlyphFileCache::MakeFromFile(path.c_str())->countLoaded() ==
+                       second->countLoaded() + second->countAdded());
+
+    // Writers never share a temporary file, so interleaved writes each leave a whole file.
+    std::vector<sk_sp<SkGlyphFileCache>> writers;
+    for (int i = 0; i < 4; i++) {
+        writers.push_back(SkGlyphFileCache::MakeFromFile(path.c_str()));
+        draw_glyphs(writers.back(), typeface, 18 + i);
+    }
+    for (const auto& writer : writers) {
+        REPORTER_ASSERT(r, writer->writeToFile());
+        REPORTER_ASSERT(r, SkGlyphFileCache::MakeFromFile(path.c_str())->countLoaded() ==
+                           writer->countLoaded() + writer->countAdded());
+    }
+    remove(path.c_str());
+
+    REPORTER_ASSERT(r, !SkGlyphFileCache::Make()->writeToFile());
+}
@@ -6,7 +6,9 @@
  */
 
 #include "SkCachedData.h"
+#include "SkDraw.h"
 #include "SkMaskCache.h"
+#include "SkRasterClip.h"
 #include "SkResourceCache.h"
 #include "Test.h"
 
@@ -102,3 +104,139 @@ DEF_TEST(RectsMaskCache, reporter) {
     check_data(reporter, data, 1, kNotInCache, kLocked);
     data->unref();
 }
+
+DEF_TEST(PathMaskCache, reporter) {
+    SkResourceCache cache(1024);
+
+    SkPath path;
+    path.addCircle(50, 50, 40);
+    SkMatrix matrix = SkMatrix::MakeScale(0.5f);
+    SkIRect clipBounds = SkIRect::MakeWH(100, 100);
+
+    SkCachedData* data = SkMaskCache::FindAndRef(path, matrix, clipBounds, &cache);
+    REPORTER_ASSERT(reporter, nullptr == data);
+
+    size_t size = 256;
+    data = cache.newCachedData(size);
+    memset(data->writable_data(), 0xff, size);
+    SkMaskCache::Add(path, matrix, clipBounds, data, &cache);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    data->unref();
+    check_data(reporter, data, 1, kInCache, kUnlocked);
+
+    // A different matrix, fill type or clip misses.
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(path, SkMatrix::I(), clipBounds, &cache));
+    {
+        SkPath evenOdd = path;
+        evenOdd.setFillType(SkPath::kEvenOdd_FillType);
+        REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(evenOdd, matrix, clipBounds, &cache));
+    }
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(path, matrix, SkIRect::MakeWH(50, 100),
+                                                       &cache));
+
+    data = SkMaskCache::FindAndRef(path, matrix, clipBounds, &cache);
+    REPORTER_ASSERT(reporter, data);
+    REPORTER_ASSERT(reporter, data->size() == size);
+    check_data(reporter, data, 2, kInCache, kLocked);
+
+    // Editing the path purges its entries from the cache.
+    path.lineTo(0, 0);
+    REPORTER_ASSERT(reporter, !SkMaskCache::FindAndRef(path, matrix, clipBounds, &cache));
+    check_data(reporter, data, 1, kNotInCache, kLocked);
+    data->unref();
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < a.height(); y++) {
+        if (memcmp(a.getAddr(0, y), b.getAddr(0, y), a.width() * a.bytesPerPixel())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Drawing through cached scan conversions, on a miss and then a hit, should look exactly like
+// drawing directly, clipped or not, and for paths inside or crossing the clip or device edge.
+DEF_TEST(PathMaskCache_Draw, reporter) {
+    SkPath star;
+    for (int i = 0; i < 7; i++) {
+        SkScalar angle = i * SK_ScalarPI * 6 / 7;
+        star.lineTo(40 + 35 * SkScalarCos(angle), 40 + 35 * SkScalarSin(angle));
+    }
+    SkPath curvy;
+    curvy.moveTo(10, 70);
+    curvy.cubicTo(20, -20, 60, 120, 75, 5);
+    curvy.quadTo(40, 40, 10, 70);
+    curvy.setFillType(SkPath::kEvenOdd_FillType);
+
+    const SkIRect devBounds = SkIRect::MakeWH(128, 128);
+    const SkRect clip = SkRect::MakeXYWH(20, 10, 40, 50);
+    auto draw = [&](bool cached, bool clipped) {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(devBounds.width(), devBounds.height());
+        bitmap.eraseColor(SK_ColorWHITE);
+
+        SkRasterClip rc(devBounds);
+        if (clipped) {
+            rc.op(clip, SkMatrix::I(), devBounds, SkRegion::kIntersect_Op, false);
+        }
+        SkMatrix matrix = SkMatrix::I();
+        SkDraw draw;
+        SkAssertResult(bitmap.peekPixels(&draw.fDst));
+        draw.fMatrix = &matrix;
+        draw.fRC = &rc;
+        draw.fCachePathMasks = cached;
+
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setColor(0xc0336699);
+        draw.drawPath(star, paint);
+        matrix.preTranslate(30.25f, 20.5f);
+        paint.setColor(0x8020c040);
+        draw.drawPath(curvy, paint);
+        matrix.preScale(1.5f, 1.25f);
+        draw.drawPath(star, paint);
+
+        // These lie within the device, and the first within the clip.
+        matrix.setTranslate(21.25f, 11.75f);
+        matrix.preScale(0.5f, 0.5f);
+        draw.drawPath(star, paint);
+        matrix.setTranslate(64.5f, 60.25f);
+        matrix.preScale(0.75f, 0.75f);
+        paint.setColor(0xc0336699);
+        draw.drawPath(star, paint);
+        matrix.setTranslate(64, 64);
+        matrix.preScale(0.5f, 0.5f);
+        draw.drawPath(curvy, paint);
+        return bitmap;
+    };
+
+    SkBitmap expected = draw(false, false),
+             expectedClipped = draw(false, true);
+    for (int i = 0; i < 2; i++) {
+        REPORTER_ASSERT(reporter, equal_pixels(expected, draw(true, false)));
+
+        // Clipped draws are recorded against their own clip bounds, and must still be clipped.
+        SkBitmap clipped = draw(true, true);
+        REPORTER_ASSERT(reporter, equal_pixels(expectedClipped, clipped));
+        for (int y = 0; y < clipped.height(); y++) {
+            for (int x = 0; x < clipped.width(); x++) {
+                if (!clip.contains(x + 0.5f, y + 0.5f)) {
+                    REPORTER_ASSERT(reporter, clipped.getColor(x, y) == SK_ColorWHITE);
+                }
+            }
+        }
+    }
+
+    // The path inside the clip was drawn from the cache, clipped and not.
+    SkMatrix inClip = SkMatrix::MakeTrans(21.25f, 11.75f);
+    inClip.preScale(0.5f, 0.5f);
+    for (const SkIRect& clipBounds : {devBounds, clip.roundOut()}) {
+        SkCachedData* data = SkMaskCache::FindAndRef(star, inClip, clipBounds);
+        REPORTER_ASSERT(reporter, data);
+        if (data) {
+            data->unref();
+        }
+    }
+}
@@ -1066,3 +1066,73 @@ DEF_TEST(Matrix_maprects, r) {
         }
     }
 }
+
+// mapPoints() runs SkOpts kernels that map several points at once.  They should match mapping
+// the points one at a time, as SkMatrix used to, exactly, for any count and in place.
+static SkPoint map_one(const SkMatrix& m, SkPoint p) {
+    SkScalar x = p.fX * m.getScaleX() + p.fY * m.getSkewX()  + m.getTranslateX(),
+             y = p.fX * m.getSkewY()  + p.fY * m.getScaleY() + m.getTranslateY();
+    if (!m.hasPerspective()) {
+        return {x, y};
+    }
+    SkScalar z = p.fX * m.getPerspX() + (p.fY * m.getPerspY() + m.get(SkMatrix::kMPersp2));
+    if (z) {
+        z = 1 / z;
+    }
+    return {x * z, y * z};
+}
+
+DEF_TEST(Matrix_mapPoints, r) {
+    SkMatrix persp;
+    persp.setRotate(20);
+    persp.postScale(1.5f, 0.75f);
+    persp.postTranslate(3, -7);
+    persp.setPerspX(0.001f);
+    persp.setPerspY(-0.002f);
+
+    SkMatrix atInfinity = SkMatrix::MakeAll(1, 0, 0,
+                                            0, 1, 0,
+                                            1, 0, 0);  // z == 0 wherever x == 0
+
+    const SkMatrix matrices[] = {
+        SkMatrix::MakeTrans(2.5f, -3),
+        SkMatrix::MakeScale(1.5f, 0.25f),
+        SkMatrix::Concat(SkMatrix::MakeTrans(2.5f, -3), SkMatrix::MakeScale(1.5f, 0.25f)),
+        SkMatrix::Concat(SkMatrix::MakeTrans(2.5f, -3), SkMatrix::MakeAll(1, 0.5f, 0,
+                                                                         -0.3f, 2, 0,
+                                                                         0, 0, 1)),
+        persp,
+        atInfinity,
+    };
+
+    SkRandom rand;
+    const int kMaxCount = 35;
+    SkPoint src[kMaxCount], expected[kMaxCount], dst[kMaxCount];
+    for (const SkMatrix& m : matrices) {
+        for (int count = 0; count <= kMaxCount; ++count) {
+            for (int i = 0; i < count; ++i) {
+                src[i].set(rand.nextRangeScalar(-100, 100), rand.nextRangeScalar(-100, 100));
+                if (i % 7 == 0) {
+                    src[i].fX = 0;
+                }
+                expected[i] = map_one(m, src[i]);
+            }
+            m.mapPoints(dst, src, count);
+            REPORTER_ASSERT(r, 0 == memcmp(dst, expected, count * sizeof(SkPoint)));
+
+            m.mapPoints(src, count);
+            REPORTER_ASSERT(r, 0 == memcmp(src, expected, count * sizeof(SkPoint)));
+        }
+
+        SkPoint3 src3[kMaxCount], expected3[kMaxCount];
+        for (int i = 0; i < kMaxCount; ++i) {
+            src3[i].set(rand.nextSScalar1(), rand.nextSScalar1(), rand.nextSScalar1());
+            SkScalar x = src3[i].fX, y = src3[i].fY, z = src3[i].fZ;
+            expected3[i].set(x * m.getScaleX() + y * m.getSkewX()  + z * m.getTranslateX(),
+                             x * m.getSkewY()  + y * m.getScaleY() + z * m.getTranslateY(),
+                             x * m.getPerspX() + y * m.getPerspY() + z * m[SkMatrix::kMPersp2]);
+        }
+        m.mapHomogeneousPoints(src3, src3, kMaxCount);
+        REPORTER_ASSERT(r, 0 == memcmp(src3, expected3, sizeof(src3)));
+    }
+}
@@ -6,6 +6,7 @@
  */
 
 #include "SkBitmap.h"
+#include "SkExecutor.h"
 #include "SkMipMap.h"
 #include "SkRandom.h"
 #include "Test.h"
@@ -209,3 +210,36 @@ DEF_TEST(MipMap_F16, reporter) {
     bmp.eraseColor(0);
     sk_sp<SkMipMap> mipmap(SkMipMap::Build(bmp, nullptr));
 }
+
+// Threaded builds should make exactly the same levels as a serial build.
+DEF_TEST(MipMap_Threaded, reporter) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeWorkStealingThreadPool(4);
+
+    SkRandom rand;
+    for (SkISize size : { SkISize{1001, 777}, SkISize{512, 512}, SkISize{3, 1500} }) {
+        SkBitmap bm;
+        bm.allocN32Pixels(size.width(), size.height());
+        for (int y = 0; y < bm.height(); ++y) {
+            for (int x = 0; x < bm.width(); ++x) {
+                *bm.getAddr32(x, y) = rand.nextU() | 0xFF000000;
+            }
+        }
+
+        sk_sp<SkMipMap> serial(SkMipMap::Build(bm, nullptr, nullptr)),
+                        threaded(SkMipMap::Build(bm, nullptr, executor.get()));
+        REPORTER_ASSERT(reporter, serial->countLevels() == threaded->countLevels());
+
+        for (int i = 0; i < serial->countLevels(); ++i) {
+            SkMipMap::Level expected, actual;
+            REPORTER_ASSERT(reporter, serial->getLevel(i, &expected));
+            REPORTER_ASSERT(reporter, threaded->getLevel(i, &actual));
+            REPORTER_ASSERT(reporter, actual.fPixmap.info() == expected.fPixmap.info());
+            for (int y = 0; y < expected.fPixmap.height(); ++y) {
+                REPORTER_ASSERT(reporter, 0 == memcmp(expected.fPixmap.addr(0, y),
+                                                      actual.fPixmap.addr(0, y),
+                                                      expected.fPixmap.info().minRowBytes()),
+                                "level %d row %d", i, y);
+            }
+        }
+    }
+}
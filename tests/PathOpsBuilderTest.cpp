@@ -8,6 +8,8 @@
 #include "PathOpsExtendedTest.h"
 #include "PathOpsTestCommon.h"
 #include "SkBitmap.h"
+#include "SkExecutor.h"
+#include "SkRandom.h"
 #include "Test.h"
 
 DEF_TEST(PathOpsBuilder, reporter) {
@@ -361,3 +363,43 @@ SkOpBuilder builder;
     builder.add(path1, SkPathOp::kUnion_SkPathOp);
     builder.resolve(&path);
 }
+
+DEF_TEST(SkOpBuilderThreaded, reporter) {
+    // Three separate clumps of overlapping polygons, some concave, each too big to union at once.
+    SkRandom rand;
+    SkTArray<SkPath> polygons;
+    for (int index = 0; index < 300; ++index) {
+        SkScalar x = (index % 10) * 8 + (index % 30 / 10) * 120,
+                 y = (index / 30) * 8;
+        SkPath polygon;
+        polygon.moveTo(x + rand.nextRangeScalar(-2, 2), y + rand.nextRangeScalar(-2, 2));
+        polygon.lineTo(x + 12 + rand.nextRangeScalar(-2, 2), y + rand.nextRangeScalar(-2, 2));
+        polygon.lineTo(x + 12 + rand.nextRangeScalar(-2, 2), y + 12 + rand.nextRangeScalar(-2, 2));
+        polygon.lineTo(x + 6, index % 3 ? y + 14 : y + 7);
+        polygon.lineTo(x + rand.nextRangeScalar(-2, 2), y + 12 + rand.nextRangeScalar(-2, 2));
+        polygon.close();
+        polygons.push_back(polygon);
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeWorkStealingThreadPool(4);
+    SkOpBuilder serial, threaded;
+    for (const SkPath& polygon : polygons) {
+        serial.add(polygon, kUnion_SkPathOp);
+        threaded.add(polygon, kUnion_SkPathOp);
+    }
+    SkPath expected, result;
+    REPORTER_ASSERT(reporter, serial.resolve(&expected));
+    REPORTER_ASSERT(reporter, threaded.resolve(&result, executor.get()));
+    REPORTER_ASSERT(reporter, 0 == comparePaths(reporter, __FUNCTION__, expected, result));
+
+    // Other ops are applied in order, as resolve() does.
+    threaded.add(polygons[0], kUnion_SkPathOp);
+    threaded.add(polygons[1], kDifference_SkPathOp);
+    REPORTER_ASSERT(reporter, threaded.resolve(&result, executor.get()));
+    REPORTER_ASSERT(reporter, Op(polygons[0], polygons[1], kDifference_SkPathOp, &expected));
+    REPORTER_ASSERT(reporter, 0 == comparePaths(reporter, __FUNCTION__, expected, result));
+
+    // An empty builder resolves to an empty path.
+    REPORTER_ASSERT(reporter, threaded.resolve(&result, executor.get()));
+    REPORTER_ASSERT(reporter, result.isEmpty());
+}
@@ -9357,11 +9357,44 @@ static void bug8290(skiatest::Reporter* reporter, const char* filename) {
     testSimplify(reporter, path, filename);
 }
 
+// Enough segments that the pairs to intersect are found with an index: a star whose points
+// cross many others, over a wiggled circle whose segments touch only their neighbors.
+static void manySegments(skiatest::Reporter* reporter, const char* filename) {
+    SkPath path;
+    const int kStarPoints = 41;
+    for (int i = 0; i < kStarPoints; ++i) {
+        SkScalar angle = 2 * SK_ScalarPI * (i * 17 % kStarPoints) / kStarPoints;
+        SkPoint pt = { 128 + 100 * SkScalarCos(angle), 128 + 100 * SkScalarSin(angle) };
+        if (i == 0) {
+            path.moveTo(pt);
+        } else {
+            path.lineTo(pt);
+        }
+    }
+    path.close();
+    const int kWigglePoints = 120;
+    for (int i = 0; i < kWigglePoints; ++i) {
+        SkScalar angle = 2 * SK_ScalarPI * i / kWigglePoints;
+        SkScalar radius = (i & 1) ? 61 : 59;
+        SkPoint pt = { 140 + radius * SkScalarCos(angle), 120 + radius * SkScalarSin(angle) };
+        if (i == 0) {
+            path.moveTo(pt);
+        } else {
+            path.lineTo(pt);
+        }
+    }
+    path.close();
+    testSimplify(reporter, path, filename);
+    path.setFillType(SkPath::kEvenOdd_FillType);
+    testSimplify(reporter, path, filename);
+}
+
 static void (*skipTest)(skiatest::Reporter* , const char* filename) = nullptr;
 static void (*firstTest)(skiatest::Reporter* , const char* filename) = nullptr;
 static void (*stopTest)(skiatest::Reporter* , const char* filename) = nullptr;
 
 static TestDesc tests[] = {
+    TEST(manySegments),
     TEST(bug8290),
     TEST(bug8249),
     TEST(grshapearc),
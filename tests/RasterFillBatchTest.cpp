@@ -0,0 +1,103 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBitmapDevice.h"
+#include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkRRect.h"
+#include "SkRandom.h"
+#include "SkSurface.h"
+#include "SkSurfacePriv.h"
+#include "Test.h"
+
+// Runs of overlapping same-paint rects and rrects, broken up by paint, matrix, clip and layer
+// changes, and by reads of the pixels part way through.
+static void draw(SkSurface* surface, SkBitmap* midway) {
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorWHITE);
+
+    SkRandom rand;
+    auto rect = [&] {
+        return SkRect::MakeXYWH(rand.nextRangeScalar(-8, 100), rand.nextRangeScalar(-8, 100),
+                                rand.nextRangeScalar(1, 30),   rand.nextRangeScalar(1, 30));
+    };
+
+    SkPaint paints[3];
+    paints[0].setColor(0x80336699);
+    paints[1].setColor(0xff20c040);
+    paints[2].setColor(0x60ff8000);
+    paints[2].setBlendMode(SkBlendMode::kMultiply);
+
+    for (int run = 0; run < 12; run++) {
+        SkPaint paint = paints[run % 3];
+        paint.setAntiAlias(run % 4 >= 2);
+
+        for (int i = 0; i < 40; i++) {
+            if (run % 5 == 4) {
+                canvas->drawRRect(SkRRect::MakeRectXY(rect(), 4, 3), paint);
+            } else {
+                canvas->drawRect(rect(), paint);
+            }
+        }
+
+        switch (run) {
+            case 1: canvas->translate(3.5f, 1.25f);                            break;
+            case 3: canvas->clipRect(SkRect::MakeXYWH(10, 10, 80, 70), true); break;
+            case 5: canvas->scale(1.5f, 0.75f);                                break;
+            case 6: canvas->saveLayerAlpha(nullptr, 0xc0);                     break;
+            case 8: canvas->restore();                                         break;
+            case 9:
+                SkAssertResult(midway->tryAllocPixels(surface->getCanvas()->imageInfo()));
+                SkAssertResult(surface->readPixels(*midway, 0, 0));
+                break;
+            case 10: surface->makeImageSnapshot();                             break;
+        }
+    }
+}
+
+static bool equal(const SkBitmap& a, const SkBitmap& b) {
+    for (int y = 0; y < a.height(); y++) {
+        if (0 != memcmp(a.getAddr(0,y), b.getAddr(0,y), a.info().minRowBytes())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+DEF_TEST(RasterFillBatch, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(128, 128);
+    SkBitmap results[2], midway[2];
+
+    for (int batch = 0; batch < 2; batch++) {
+        auto surface = SkSurface::MakeRaster(info);
+        SkSurfaceSetBatchRasterFillsForTesting(surface.get(), batch);
+        draw(surface.get(), &midway[batch]);
+
+        SkAssertResult(results[batch].tryAllocPixels(info));
+        SkAssertResult(surface->readPixels(results[batch], 0, 0));
+    }
+
+    REPORTER_ASSERT(r, equal(midway[0], midway[1]));
+    REPORTER_ASSERT(r, equal(results[0], results[1]));
+}
+
+// Direct surfaces' callers read their own pixels without flushing, so fills can't wait.
+DEF_TEST(RasterFillBatch_Direct, r) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(16, 16);
+    uint32_t pixels[16 * 16] = {0};
+
+    auto surface = SkSurface::MakeRasterDirect(info, pixels, info.minRowBytes());
+    SkSurfaceSetBatchRasterFillsForTesting(surface.get(), true);
+    SkPaint paint;
+    paint.setColor(SK_ColorBLUE);
+    surface->getCanvas()->drawRect(SkRect::MakeXYWH(2, 2, 4, 4), paint);
+    surface->getCanvas()->drawRect(SkRect::MakeXYWH(8, 8, 4, 4), paint);
+
+    REPORTER_ASSERT(r, pixels[3 * 16 + 3] == SkPreMultiplyColor(SK_ColorBLUE));
+    REPORTER_ASSERT(r, pixels[9 * 16 + 9] == SkPreMultiplyColor(SK_ColorBLUE));
+    REPORTER_ASSERT(r, pixels[0] == 0);
+}
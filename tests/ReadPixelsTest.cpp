@@ -8,9 +8,12 @@
 #include <initializer_list>
 #include "SkCanvas.h"
 #include "SkColorData.h"
+#include "SkConvertPixels.h"
+#include "SkExecutor.h"
 #include "SkHalf.h"
 #include "SkImageInfoPriv.h"
 #include "SkMathPriv.h"
+#include "SkRandom.h"
 #include "SkSurface.h"
 #include "Test.h"
 
@@ -688,3 +691,38 @@ DEF_TEST(ReadPixels_ValidConversion, reporter) {
         }
     }
 }
+
+DEF_TEST(ReadPixels_Threaded, reporter) {
+    // Big enough to be split into bands, with an odd height so the last band is short.
+    const int kW = 1000, kH = 333;
+    const SkImageInfo srcInfo = SkImageInfo::Make(kW, kH, kRGBA_8888_SkColorType,
+                                                  kUnpremul_SkAlphaType, SkColorSpace::MakeSRGB());
+    SkAutoTMalloc<uint32_t> srcPixels(kW * kH);
+    SkRandom rand;
+    for (int i = 0; i < kW * kH; i++) {
+        srcPixels[i] = rand.nextU();
+    }
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeWorkStealingThreadPool(4);
+    const SkImageInfo dstInfos[] = {
+        srcInfo.makeColorType(kBGRA_8888_SkColorType).makeAlphaType(kPremul_SkAlphaType),
+        srcInfo.makeColorType(kRGBA_F16_SkColorType).makeColorSpace(SkColorSpace::MakeRGB(
+                SkNamedTransferFn::kLinear, SkNamedGamut::kDCIP3)),
+        srcInfo.makeColorType(kAlpha_8_SkColorType),
+    };
+    for (const SkImageInfo& dstInfo : dstInfos) {
+        // Pad the rows to make sure bands step by rowBytes, not by width.
+        const size_t rowBytes = dstInfo.minRowBytes() + 16;
+        SkAutoTMalloc<char> serial(rowBytes * kH),
+                            threaded(rowBytes * kH);
+        sk_bzero(serial.get(), rowBytes * kH);
+        sk_bzero(threaded.get(), rowBytes * kH);
+
+        SkConvertPixels(dstInfo, serial.get(), rowBytes,
+                        srcInfo, srcPixels.get(), srcInfo.minRowBytes(), nullptr);
+        SkConvertPixels(dstInfo, threaded.get(), rowBytes,
+                        srcInfo, srcPixels.get(), srcInfo.minRowBytes(), executor.get());
+        REPORTER_ASSERT(reporter, 0 == memcmp(serial.get(), threaded.get(), rowBytes * kH),
+                        "%d", dstInfo.colorType());
+    }
+}
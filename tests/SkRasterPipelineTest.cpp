@@ -202,3 +202,314 @@ DEF_TEST(SkRasterPipeline_lowp_clamp01, r) {
     p.append(SkRasterPipeline::store_8888, &ptr);
     p.run(0,0,1,1);
 }
+
+DEF_TEST(SkRasterPipeline_fused, r) {
+    // Fused stages must draw exactly what the stages they replace would.
+    // We keep stages from fusing by giving them different (but equivalent) contexts,
+    // or by breaking up the run with a no-op pair of stages.
+    const int N = 37;  // Not a multiple of any stride, so we test tails too.
+    uint32_t src[N], fusedDst[N], plainDst[N];
+    for (int i = 0; i < N; i++) {
+        uint32_t a = (i * 7) & 0xff;
+        src[i] = a << 24 | (a/2) << 16 | (a/3) << 8 | (a/5);
+        fusedDst[i] = plainDst[i] = 0xff000000 | (uint32_t)(i * 0x010305);
+    }
+
+    SkRasterPipeline_MemoryCtx srcCtx   = { src,      0 },
+                               fusedCtx = { fusedDst, 0 },
+                               loadCtx  = { plainDst, 0 },
+                               storeCtx = { plainDst, 0 };
+    SkRasterPipeline_<256> fused;
+    fused.append(SkRasterPipeline::load_8888,     &srcCtx);
+    fused.append(SkRasterPipeline::load_8888_dst, &fusedCtx);
+    fused.append(SkRasterPipeline::srcover);
+    fused.append(SkRasterPipeline::store_8888,    &fusedCtx);
+    fused.run(0,0,N,1);
+
+    SkRasterPipeline_<256> plain;
+    plain.append(SkRasterPipeline::load_8888,     &srcCtx);
+    plain.append(SkRasterPipeline::load_8888_dst, &loadCtx);
+    plain.append(SkRasterPipeline::srcover);
+    plain.append(SkRasterPipeline::store_8888,    &storeCtx);
+    plain.compile()(0,0,N,1);
+
+    REPORTER_ASSERT(r, 0 == memcmp(fusedDst, plainDst, sizeof(fusedDst)));
+
+    const float m[] = { 0.5f, -0.25f, 0.75f, 2.0f, 3.0f, -4.0f };
+    float fusedXY[4*N], plainXY[4*N];
+    SkRasterPipeline_MemoryCtx fusedXYCtx = { fusedXY, 0 },
+                               plainXYCtx = { plainXY, 0 };
+
+    SkRasterPipeline_<256> fusedMatrix;
+    fusedMatrix.append(SkRasterPipeline::seed_shader);
+    fusedMatrix.append(SkRasterPipeline::matrix_2x3, m);
+    fusedMatrix.append(SkRasterPipeline::store_f32, &fusedXYCtx);
+    fusedMatrix.run(0,0,N,1);
+
+    SkRasterPipeline_<256> plainMatrix;
+    plainMatrix.append(SkRasterPipeline::seed_shader);
+    plainMatrix.append(SkRasterPipeline::move_src_dst);
+    plainMatrix.append(SkRasterPipeline::move_dst_src);
+    plainMatrix.append(SkRasterPipeline::matrix_2x3, m);
+    plainMatrix.append(SkRasterPipeline::store_f32, &plainXYCtx);
+    plainMatrix.run(0,0,N,1);
+
+    REPORTER_ASSERT(r, 0 == memcmp(fusedXY, plainXY, sizeof(fusedXY)));
+}
+
+DEF_TEST(SkRasterPipeline_fused_lowp, r) {
+    // Sampling through each fused seed_shader_matrix_* stage can run entirely in lowp (where we
+    // have lowp), and must match sampling through the unfused stages.
+    uint32_t image[16*16];
+    for (int i = 0; i < 16*16; i++) {
+        image[i] = 0xff000000 | (uint32_t)(i * 0x0a0301);
+    }
+    SkRasterPipeline_GatherCtx gatherCtx = { image, 16, 16.0f, 16.0f };
+
+    const float m[] = { 0.375f, 0.25f, -0.125f, 0.5f, 1.5f, 3.25f };
+    const SkRasterPipeline::StockStage matrices[] = {
+        SkRasterPipeline::matrix_translate,
+        SkRasterPipeline::matrix_scale_translate,
+        SkRasterPipeline::matrix_2x3,
+    };
+    const int N = 37;
+    for (SkRasterPipeline::StockStage matrix : matrices) {
+        uint32_t fusedDst[N*3], plainDst[N*3];
+        SkRasterPipeline_MemoryCtx fusedCtx = { fusedDst, N },
+                                   plainCtx = { plainDst, N };
+
+        SkRasterPipeline_<256> fused;
+        fused.append(SkRasterPipeline::seed_shader);
+        fused.append(matrix, m);
+        fused.append(SkRasterPipeline::gather_8888, &gatherCtx);
+        fused.append(SkRasterPipeline::store_8888, &fusedCtx);
+        fused.run(0,0,N,3);
+
+        SkRasterPipeline_<256> plain;
+        plain.append(SkRasterPipeline::seed_shader);
+        plain.append(SkRasterPipeline::move_src_dst);
+        plain.append(SkRasterPipeline::move_dst_src);
+        plain.append(matrix, m);
+        plain.append(SkRasterPipeline::gather_8888, &gatherCtx);
+        plain.append(SkRasterPipeline::store_8888, &plainCtx);
+        plain.run(0,0,N,3);
+
+        REPORTER_ASSERT(r, fused.canRunLowp() == plain.canRunLowp());
+        REPORTER_ASSERT(r, 0 == memcmp(fusedDst, plainDst, sizeof(fusedDst)));
+    }
+}
+
+DEF_TEST(SkRasterPipeline_stats, r) {
+    uint32_t pixels[20] = {0};
+    SkRasterPipeline_MemoryCtx ctx = { pixels, 0 };
+
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipeline::white_color);
+    p.append(SkRasterPipeline::load_8888_dst, &ctx);
+    p.append(SkRasterPipeline::srcover);
+    p.append(SkRasterPipeline::store_8888, &ctx);
+    REPORTER_ASSERT(r, p.stage_sequence().equals(
+                               "white_color, load_8888_dst, srcover, store_8888"));
+
+    auto find = [&] {
+        for (const auto& stats : SkRasterPipeline::GetStats()) {
+            if (stats.stages.equals(p.stage_sequence())) {
+                return stats.pixels;
+            }
+        }
+        return (int64_t)0;
+    };
+    int64_t before = find();
+    auto precisionBefore = SkRasterPipeline::GetPrecisionCounts();
+
+    SkRasterPipeline::SetStatsEnabled(true);
+    p.run(0,0,20,1);
+    auto fn = p.compile();
+    fn(0,0,10,1);
+    fn(10,0,10,1);
+    auto precisionAfter = SkRasterPipeline::GetPrecisionCounts();
+    SkRasterPipeline::SetStatsEnabled(false);
+    p.run(0,0,20,1);
+
+    // Other threads may be running this same pipeline, so we can only bound the counts.
+    REPORTER_ASSERT(r, find() >= before + 40);
+    // run() and compile() each built one pipeline.
+    if (p.canRunLowp()) {
+        REPORTER_ASSERT(r, precisionAfter.lowp  >= precisionBefore.lowp + 2);
+    } else {
+        REPORTER_ASSERT(r, precisionAfter.highp >= precisionBefore.highp + 2);
+    }
+    for (uint32_t px : pixels) {
+        REPORTER_ASSERT(r, px == 0xffffffff);
+    }
+}
+
+DEF_TEST(SkRasterPipeline_lowp_bilerp, r) {
+    // A 2x2 image, sampled bilinearly with repeat tiling, halfway between its pixel centers.
+    uint32_t src[] = { 0xff0000ff, 0xff00ff00,
+                       0xffff0000, 0xff000000 };
+    uint32_t dst[4] = {0};
+
+    SkRasterPipeline_GatherCtx gather = { src, 2, 2, 2 };
+    SkRasterPipeline_TileCtx   tile   = { 2, 0.5f };
+    SkRasterPipeline_SamplerCtx sampler;
+    SkRasterPipeline_MemoryCtx dst_ctx = { dst, 0 };
+    const float translate[] = { 0.5f, 0.5f };  // Pixel centers land on image pixel corners.
+
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipeline::seed_shader);
+    p.append(SkRasterPipeline::matrix_translate, translate);
+    p.append(SkRasterPipeline::save_xy, &sampler);
+    auto sample = [&](SkRasterPipeline::StockStage setup_x, SkRasterPipeline::StockStage setup_y) {
+        p.append(setup_x, &sampler);
+        p.append(setup_y, &sampler);
+        p.append(SkRasterPipeline::repeat_x, &tile);
+        p.append(SkRasterPipeline::repeat_y, &tile);
+        p.append(SkRasterPipeline::gather_8888, &gather);
+        p.append(SkRasterPipeline::accumulate, &sampler);
+    };
+    sample(SkRasterPipeline::bilinear_nx, SkRasterPipeline::bilinear_ny);
+    sample(SkRasterPipeline::bilinear_px, SkRasterPipeline::bilinear_ny);
+    sample(SkRasterPipeline::bilinear_nx, SkRasterPipeline::bilinear_py);
+    sample(SkRasterPipeline::bilinear_px, SkRasterPipeline::bilinear_py);
+    p.append(SkRasterPipeline::move_dst_src);
+    p.append(SkRasterPipeline::store_8888, &dst_ctx);
+
+    p.run(0,0,4,1);
+
+    // Every sample averages all four pixels equally: 1/4 of each channel, and opaque.
+    for (uint32_t px : dst) {
+        for (int shift = 0; shift < 24; shift += 8) {
+            int c = (px >> shift) & 0xff;
+            REPORTER_ASSERT(r, 63 <= c && c <= 65);
+        }
+        REPORTER_ASSERT(r, (px >> 24) == 0xff);
+    }
+}
+
+DEF_TEST(SkRasterPipeline_lowp_bilerp_opaque, r) {
+    // Bilinear sampling of an opaque image must stay opaque at any fractional offset.
+    uint32_t src[] = { 0xff0000ff, 0xff00ff00, 0xff808080,
+                       0xffff0000, 0xff000000, 0xffffffff,
+                       0xff204060, 0xff0000ff, 0xff00ff00 };
+    const int N = 37;
+    uint32_t dst[N];
+
+    SkRasterPipeline_GatherCtx gather = { src, 3, 3, 3 };
+    SkRasterPipeline_TileCtx   tile   = { 3, 1/3.0f };
+    SkRasterPipeline_SamplerCtx sampler;
+    SkRasterPipeline_MemoryCtx dst_ctx = { dst, 0 };
+
+    for (int step = 0; step < 64; step++) {
+        // Each pixel gets a different x fraction, and each step a different y fraction.
+        const float matrix[] = { 1 + 1/37.0f, 0, step/64.0f,
+                                 0,           1, step/67.0f };
+
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipeline::seed_shader);
+        p.append(SkRasterPipeline::matrix_2x3, matrix);
+        p.append(SkRasterPipeline::save_xy, &sampler);
+        auto sample = [&](SkRasterPipeline::StockStage setup_x,
+                          SkRasterPipeline::StockStage setup_y) {
+            p.append(setup_x, &sampler);
+            p.append(setup_y, &sampler);
+            p.append(SkRasterPipeline::repeat_x, &tile);
+            p.append(SkRasterPipeline::repeat_y, &tile);
+            p.append(SkRasterPipeline::gather_8888, &gather);
+            p.append(SkRasterPipeline::accumulate, &sampler);
+        };
+        // The samples' weights don't depend on their order, so take them in an unusual one.
+        sample(SkRasterPipeline::bilinear_px, SkRasterPipeline::bilinear_py);
+        sample(SkRasterPipeline::bilinear_nx, SkRasterPipeline::bilinear_py);
+        sample(SkRasterPipeline::bilinear_px, SkRasterPipeline::bilinear_ny);
+        sample(SkRasterPipeline::bilinear_nx, SkRasterPipeline::bilinear_ny);
+        p.append(SkRasterPipeline::move_dst_src);
+        p.append(SkRasterPipeline::store_8888, &dst_ctx);
+        p.run(0,0,N,1);
+
+        for (uint32_t px : dst) {
+            REPORTER_ASSERT(r, (px >> 24) == 0xff);
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_dither, r) {
+    // Every lane of every stride must get its own entry of the 8x8 dither matrix.
+    const int N = 37;
+    float src[4*N], dst[4*N];
+    for (int i = 0; i < N; i++) {
+        src[4*i+0] = src[4*i+1] = src[4*i+2] = 0.5f;
+        src[4*i+3] = 1.0f;
+    }
+    SkRasterPipeline_MemoryCtx srcCtx = { src, 0 },
+                               dstCtx = { dst, 0 };
+    const float rate = 1.0f;
+
+    for (int y : { 0, 5 }) {
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipeline::load_f32, &srcCtx);
+        p.append(SkRasterPipeline::dither, &rate);
+        p.append(SkRasterPipeline::store_f32, &dstCtx);
+        p.run(0,y,N,1);
+
+        for (int x = 0; x < N; x++) {
+            uint32_t X = x, Y = x ^ y;
+            uint32_t M = (Y & 1) << 5 | (X & 1) << 4
+                       | (Y & 2) << 2 | (X & 2) << 1
+                       | (Y & 4) >> 1 | (X & 4) >> 2;
+            float want = 0.5f + (M * (2/128.0f) - (63/128.0f));
+            for (int c = 0; c < 3; c++) {
+                REPORTER_ASSERT(r, dst[4*x+c] == want, "(%d,%d): %g, want %g",
+                                x, y, dst[4*x+c], want);
+            }
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_evenly_spaced_gradient, r) {
+    // Small gradients may look up their stops with register permutes instead of gathers.
+    // Either way each t must find the factor and bias of its own interval.
+    const int N = 37;
+    float ts[4*N], dst[4*N];
+    for (int i = 0; i < N; i++) {
+        ts[4*i+0] = (i + 0.5f) / N;
+        ts[4*i+1] = ts[4*i+2] = ts[4*i+3] = 0;
+    }
+    SkRasterPipeline_MemoryCtx srcCtx = { ts,  0 },
+                               dstCtx = { dst, 0 };
+
+    for (int stops : { 2, 3, 5, 8, 9, 12, 16, 17, 20 }) {
+        // Like SkGradientShaderBase, pad the arrays for 16-wide permutes.
+        float fs[4][20] = {}, bs[4][20] = {};
+        SkRasterPipeline_GradientCtx ctx;
+        ctx.stopCount = stops;
+        for (int c = 0; c < 4; c++) {
+            for (int i = 0; i < stops; i++) {
+                fs[c][i] = 10.0f * i + c;
+                bs[c][i] = -1.0f * i - c;
+            }
+            ctx.fs[c] = fs[c];
+            ctx.bs[c] = bs[c];
+        }
+        ctx.ts = nullptr;
+        ctx.interpolatedInPremul = false;
+
+        SkRasterPipeline_<256> p;
+        p.append(SkRasterPipeline::load_f32, &srcCtx);
+        p.append(SkRasterPipeline::evenly_spaced_gradient, &ctx);
+        p.append(SkRasterPipeline::store_f32, &dstCtx);
+        p.run(0,0,N,1);
+
+        for (int x = 0; x < N; x++) {
+            float t = ts[4*x];
+            int idx = (int)(t * (stops - 1));
+            for (int c = 0; c < 4; c++) {
+                // We might have used an FMA, so allow a little rounding slop.
+                float want = t * fs[c][idx] + bs[c][idx];
+                REPORTER_ASSERT(r, fabsf(dst[4*x+c] - want) <= 1e-4f,
+                                "%d stops, t=%g, channel %d: %g, want %g",
+                                stops, t, c, dst[4*x+c], want);
+            }
+        }
+    }
+}
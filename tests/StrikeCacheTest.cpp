@@ -0,0 +1,140 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkExecutor.h"
+#include "SkFont.h"
+#include "SkMakeUnique.h"
+#include "SkPaint.h"
+#include "SkStrikeCache.h"
+#include "SkSurfaceProps.h"
+#include "SkTaskGroup.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+#include <vector>
+
+namespace {
+class Pinner : public SkStrikePinner {
+public:
+    bool canDelete() override { return false; }
+};
+}  // namespace
+
+static SkExclusiveStrikePtr find_or_create(SkStrikeCache* cache, SkScalar size) {
+    SkFont font(SkTypeface::MakeDefault(), size);
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I(), &ad, &effects);
+    return cache->findOrCreateStrikeExclusive(*desc, effects, *font.getTypefaceOrDefault());
+}
+
+// In a cache that shares strikes, users of a strike share it, unless it's pinned.
+DEF_TEST(StrikeCache_Shared, r) {
+    {
+        SkStrikeCache cache;
+        auto a = find_or_create(&cache, 12),
+             b = find_or_create(&cache, 12);
+        REPORTER_ASSERT(r, !(a == b));
+        REPORTER_ASSERT(r, !a->isShared());
+        REPORTER_ASSERT(r, cache.getCacheCountUsed() == 2);
+    }
+
+    SkStrikeCache cache(true);
+    {
+        auto a = find_or_create(&cache, 12),
+             b = find_or_create(&cache, 12),
+             c = find_or_create(&cache, 13);
+        REPORTER_ASSERT(r, a == b);
+        REPORTER_ASSERT(r, !(a == c));
+        REPORTER_ASSERT(r, cache.getCacheCountUsed() == 2);
+    }
+    REPORTER_ASSERT(r, cache.getCacheCountUsed() == 2);
+
+    SkAutoDescriptor ad(find_or_create(&cache, 14)->getDescriptor());
+    // Other threads may find shared strikes at any time, so they're never exclusive.
+    REPORTER_ASSERT(r, cache.findStrikeExclusive(*ad.getDesc()) == nullptr);
+    cache.purgeAll();
+    REPORTER_ASSERT(r, cache.getCacheCountUsed() == 0);
+
+    auto scaler = SkStrikeCache::CreateScalerContext(
+            *ad.getDesc(), SkScalerContextEffects(), *SkTypeface::MakeDefault());
+    auto pinned = cache.createStrikeExclusive(*ad.getDesc(), std::move(scaler), nullptr,
+                                              skstd::make_unique<Pinner>());
+    REPORTER_ASSERT(r, !pinned->isShared());
+    REPORTER_ASSERT(r, cache.findStrikeExclusive(*ad.getDesc()) == nullptr);
+    pinned = SkExclusiveStrikePtr();
+    REPORTER_ASSERT(r, !(cache.findStrikeExclusive(*ad.getDesc()) == nullptr));
+
+    // Pinned strikes outlive purges.
+    cache.purgeAll();
+    REPORTER_ASSERT(r, cache.getCacheCountUsed() == 1);
+}
+
+// Strikes in use stay through purges, and are counted once their users are done.
+DEF_TEST(StrikeCache_Purge, r) {
+    SkStrikeCache cache;
+    auto held = find_or_create(&cache, 20);
+    for (int size = 21; size < 30; size++) {
+        auto strike = find_or_create(&cache, size);
+        strike->findImage(strike->getGlyphIDMetrics(1));
+    }
+    REPORTER_ASSERT(r, cache.getCacheCountUsed() == 10);
+
+    size_t before = cache.getTotalMemoryUsed();
+    held->findImage(held->getGlyphIDMetrics(1));
+    REPORTER_ASSERT(r, cache.getTotalMemoryUsed() == before);
+
+    cache.setCacheCountLimit(0);
+    REPORTER_ASSERT(r, cache.getCacheCountUsed() == 1);
+    REPORTER_ASSERT(r, cache.getTotalMemoryUsed() < held->getMemoryUsed());
+
+    held = SkExclusiveStrikePtr();
+    REPORTER_ASSERT(r, cache.getCacheCountUsed() == 0);
+    REPORTER_ASSERT(r, cache.getTotalMemoryUsed() == 0);
+}
+
+// Many threads drawing from the same strikes share them, and see the same glyphs as one thread.
+DEF_TEST(StrikeCache_Threaded, r) {
+    const int kGlyphCount = 64;
+    const SkScalar kSizes[] = { 10, 16 };
+
+    auto image_of = [](SkStrike* strike, SkGlyphID id) {
+        const SkGlyph& glyph = strike->getGlyphIDMetrics(id);
+        auto image = static_cast<const uint8_t*>(strike->findImage(glyph));
+        return image ? std::vector<uint8_t>(image, image + glyph.computeImageSize())
+                     : std::vector<uint8_t>();
+    };
+
+    SkStrikeCache reference;
+    std::vector<std::vector<uint8_t>> images;
+    for (SkScalar size : kSizes) {
+        auto strike = find_or_create(&reference, size);
+        for (SkGlyphID id = 0; id < kGlyphCount; id++) {
+            images.push_back(image_of(strike.get(), id));
+        }
+    }
+
+    SkStrikeCache cache(true);
+    std::atomic<int> mismatches{0};
+    auto executor = SkExecutor::MakeFIFOThreadPool(4);
+    SkTaskGroup(*executor).batch(64, [&](int i) {
+        int which = i % SK_ARRAY_COUNT(kSizes);
+        auto strike = find_or_create(&cache, kSizes[which]);
+        for (int j = 0; j < kGlyphCount; j++) {
+            SkGlyphID id = (j * 7 + i) % kGlyphCount;
+            if (image_of(strike.get(), id) != images[which * kGlyphCount + id]) {
+                mismatches++;
+            }
+        }
+    });
+
+    REPORTER_ASSERT(r, mismatches == 0);
+    REPORTER_ASSERT(r, cache.getCacheCountUsed() == SK_ARRAY_COUNT(kSizes));
+    REPORTER_ASSERT(r, cache.getTotalMemoryUsed() == reference.getTotalMemoryUsed());
+}
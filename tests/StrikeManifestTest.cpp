@@ -0,0 +1,179 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Resources.h"
+#include "SkFont.h"
+#include "SkPaint.h"
+#include "SkStrikeCache.h"
+#include "SkStrikeManifest.h"
+#include "SkSurfaceProps.h"
+#include "SkTypeface.h"
+#include "Test.h"
+
+static SkExclusiveStrikePtr find_or_create(SkStrikeCache* cache, const SkFont& font) {
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            font, SkPaint(), SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I(), &ad, &effects);
+    return cache->findOrCreateStrikeExclusive(*desc, effects, *font.getTypefaceOrDefault());
+}
+
+// Use some glyphs' metrics, images and paths in two strikes, recording them in manifest.
+static void use_glyphs(SkStrikeCache* cache, sk_sp<SkTypeface> typeface) {
+    for (SkScalar size : { 12, 30 }) {
+        SkFont font(typeface, size);
+        auto strike = find_or_create(cache, font);
+        for (SkGlyphID id = 0; id < 40; id++) {
+            const SkGlyph& glyph = strike->getGlyphIDMetrics(id);
+            if (id % 2 == 0) {
+                strike->findImage(glyph);
+            }
+            if (id % 3 == 0) {
+                strike->findPath(glyph);
+            }
+        }
+        strike->getGlyphIDAdvance(50);
+    }
+}
+
+static void check_same(skiatest::Reporter* r, const SkStrikeCache& a, const SkStrikeCache& b) {
+    REPORTER_ASSERT(r, a.getCacheCountUsed() == b.getCacheCountUsed());
+    // The same glyphs, images and paths.
+    REPORTER_ASSERT(r, a.getTotalMemoryUsed() == b.getTotalMemoryUsed());
+}
+
+DEF_TEST(StrikeManifest_Prewarm, r) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+
+    SkStrikeCache used;
+    auto manifest = SkStrikeManifest::Make();
+    used.setManifest(manifest);
+    use_glyphs(&used, typeface);
+    REPORTER_ASSERT(r, manifest->countStrikes() == 2);
+    REPORTER_ASSERT(r, manifest->countGlyphs() == 2 * 41);
+
+    sk_sp<SkData> data = manifest->serialize();
+    SkStrikeCache prewarmed;
+    REPORTER_ASSERT(r, SkStrikeManifest::Prewarm(data->data(), data->size(), &prewarmed) == 82);
+    check_same(r, used, prewarmed);
+
+    // Strikes that aren't recording don't add to the manifest.
+    used.setManifest(nullptr);
+    SkFont font(typeface, 40);
+    find_or_create(&used, font)->getGlyphIDMetrics(1);
+    REPORTER_ASSERT(r, manifest->countStrikes() == 2);
+}
+
+// Manifests that have been damaged in any way are ignored.
+DEF_TEST(StrikeManifest_Invalid, r) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    SkStrikeCache used;
+    auto manifest = SkStrikeManifest::Make();
+    used.setManifest(manifest);
+    use_glyphs(&used, typeface);
+    sk_sp<SkData> data = manifest->serialize();
+
+    SkStrikeCache cache;
+    REPORTER_ASSERT(r, SkStrikeManifest::Prewarm(nullptr, 0, &cache) == -1);
+    for (size_t size : { (size_t)4, data->size() / 2, data->size() - 4 }) {
+        REPORTER_ASSERT(r, SkStrikeManifest::Prewarm(data->data(), size, &cache) == -1);
+    }
+    for (size_t offset : { (size_t)0, (size_t)4, data->size() / 2, data->size() - 1 }) {
+        sk_sp<SkData> damaged = SkData::MakeWithCopy(data->data(), data->size());
+        static_cast<uint8_t*>(damaged->writable_data())[offset] ^= 0x10;
+        REPORTER_ASSERT(r, SkStrikeManifest::Prewarm(damaged->data(), damaged->size(), &cache)
+                           == -1);
+    }
+    REPORTER_ASSERT(r, cache.getCacheCountUsed() == 0);
+
+    // An empty manifest is valid.
+    sk_sp<SkData> empty = SkStrikeManifest::Make()->serialize();
+    REPORTER_ASSERT(r, SkStrikeManifest::Prewarm(empty->data(), empty->size(), &cache) == 0);
+}
+
+// What SkGraphics::StartRecordingFontCacheManifest() etc. do to the global cache.
+DEF_TEST(StrikeManifest_Recording, r) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    SkStrikeCache used;
+    REPORTER_ASSERT(r, used.stopRecordingManifest() == nullptr);
+
+    used.startRecordingManifest();
+    use_glyphs(&used, typeface);
+    sk_sp<SkData> data = used.stopRecordingManifest();
+    REPORTER_ASSERT(r, data != nullptr);
+    REPORTER_ASSERT(r, used.refManifest() == nullptr);
+    REPORTER_ASSERT(r, used.stopRecordingManifest() == nullptr);
+
+    SkStrikeCache prewarmed;
+    REPORTER_ASSERT(r, SkStrikeManifest::Prewarm(data->data(), data->size(), &prewarmed) == 82);
+    check_same(r, used, prewarmed);
+    REPORTER_ASSERT(r, SkStrikeManifest::Prewarm(data->data(), data->size() - 1, &prewarmed) < 0);
+}
+
+// A manifest with a good checksum whose one strike has the given stroked rec, edited by edit.
+static sk_sp<SkData> manifest_with_rec(sk_sp<SkTypeface> typeface,
+                                       std::function<void(SkScalerContextRec*)> edit) {
+    SkFont font(typeface, 12);
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(1);
+    SkAutoDescriptor ad;
+    SkScalerContextEffects effects;
+    auto desc = SkScalerContext::CreateDescriptorAndEffectsUsingPaint(
+            font, paint, SkSurfaceProps(0, kUnknown_SkPixelGeometry),
+            SkScalerContextFlags::kNone, SkMatrix::I(), &ad, &effects);
+
+    SkScalerContextRec rec;
+    memcpy(&rec, desc->findEntry(kRec_SkDescriptorTag, nullptr), sizeof(rec));
+    edit(&rec);
+
+    SkAutoDescriptor editedAD;
+    SkDescriptor* edited = SkScalerContext::AutoDescriptorGivenRecAndEffects(
+            rec, SkScalerContextEffects(), &editedAD);
+    auto manifest = SkStrikeManifest::Make();
+    manifest->addGlyph(manifest->findOrAddStrike(*edited, *typeface), SkPackedGlyphID(1));
+    return manifest->serialize();
+}
+
+// Recs are checked field by field, since the checksum doesn't stop anyone writing a bad one.
+DEF_TEST(StrikeManifest_InvalidRec, r) {
+    sk_sp<SkTypeface> typeface = MakeResourceAsTypeface("fonts/Roboto-Regular.ttf");
+    if (!typeface) {
+        return;
+    }
+    auto prewarm = [&](std::function<void(SkScalerContextRec*)> edit) {
+        sk_sp<SkData> data = manifest_with_rec(typeface, edit);
+        SkStrikeCache cache;
+        return SkStrikeManifest::Prewarm(data->data(), data->size(), &cache);
+    };
+    REPORTER_ASSERT(r, prewarm([](SkScalerContextRec*) {}) == 1);
+
+    // The stroke join and cap share the byte after fMaskFormat, 4 bits each, and are both 0 for
+    // the default miter join and butt cap.  3 is one past the last join and the last cap, so
+    // whichever order the compiler lays them out in, these make one of each out of range.
+    auto strokeParams = [](SkScalerContextRec* rec) {
+        return reinterpret_cast<uint8_t*>(&rec->fMaskFormat) + 1;
+    };
+    REPORTER_ASSERT(r, prewarm([&](SkScalerContextRec* rec) { *strokeParams(rec) = 0x03; }) == -1);
+    REPORTER_ASSERT(r, prewarm([&](SkScalerContextRec* rec) { *strokeParams(rec) = 0x30; }) == -1);
+
+    REPORTER_ASSERT(r, prewarm([](SkScalerContextRec* rec) { rec->fFrameWidth = -1; }) == -1);
+    REPORTER_ASSERT(r, prewarm([](SkScalerContextRec* rec) {
+        rec->fFlags |= SkScalerContext::kUnused;
+    }) == -1);
+    REPORTER_ASSERT(r, prewarm([](SkScalerContextRec* rec) { rec->fFlags |= 0x8000; }) == -1);
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkResourceCache.h"
+#include "SkStrokeCache.h"
+#include "SkStrokeRec.h"
+#include "Test.h"
+
+static SkStrokeRec make_stroke(SkScalar width, SkPaint::Join join) {
+    SkStrokeRec rec(SkStrokeRec::kHairline_InitStyle);
+    rec.setStrokeStyle(width);
+    rec.setStrokeParams(SkPaint::kRound_Cap, join, 4);
+    return rec;
+}
+
+DEF_TEST(StrokeCache, reporter) {
+    SkResourceCache cache(1024 * 1024);
+
+    SkPath path;
+    path.moveTo(10, 10);
+    path.lineTo(50, 80);
+    path.quadTo(90, 10, 120, 60);
+
+    const SkStrokeRec rec = make_stroke(4, SkPaint::kRound_Join);
+    SkPath outline;
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, rec, &outline, &cache));
+
+    SkPath stroked;
+    REPORTER_ASSERT(reporter, rec.applyToPath(&stroked, path));
+    SkStrokeCache::Add(path, rec, stroked, &cache);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() > 0);
+
+    REPORTER_ASSERT(reporter, SkStrokeCache::Find(path, rec, &outline, &cache));
+    REPORTER_ASSERT(reporter, outline == stroked);
+
+    // A different stroke, resolution scale or fill type misses.
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, make_stroke(5, SkPaint::kRound_Join),
+                                                   &outline, &cache));
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, make_stroke(4, SkPaint::kMiter_Join),
+                                                   &outline, &cache));
+    {
+        SkStrokeRec scaled = rec;
+        scaled.setResScale(2);
+        REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, scaled, &outline, &cache));
+
+        SkPath evenOdd = path;
+        evenOdd.setFillType(SkPath::kEvenOdd_FillType);
+        REPORTER_ASSERT(reporter, !SkStrokeCache::Find(evenOdd, rec, &outline, &cache));
+    }
+
+    // Editing the path purges its outlines from the cache.
+    path.lineTo(0, 0);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, rec, &outline, &cache));
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() == 0);
+}
+
+// Stroking through the cache should make the same outlines as SkPaint::getFillPath() does
+// without it, and find them in the cache the second time around.
+DEF_TEST(StrokeCache_ApplyToPath, reporter) {
+    SkResourceCache cache(1024 * 1024);
+
+    auto zigzag = [] {
+        SkPath path;
+        path.moveTo(3, 60);
+        for (int i = 1; i < 20; i++) {
+            path.lineTo(3 + 10 * i, 60 + ((i * 37) % 23) - 11);
+        }
+        return path;
+    };
+    SkPath path = zigzag();
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(3);
+    paint.setStrokeJoin(SkPaint::kRound_Join);
+    const SkStrokeRec rec(paint, 1.5f);
+
+    SkPath expected;
+    REPORTER_ASSERT(reporter, paint.getFillPath(path, &expected, nullptr, 1.5f));
+
+    for (int i = 0; i < 2; i++) {
+        SkPath outline;
+        REPORTER_ASSERT(reporter, SkStrokeCache::ApplyToPath(rec, path, &outline, &cache));
+        REPORTER_ASSERT(reporter, outline == expected);
+        REPORTER_ASSERT(reporter, SkStrokeCache::Find(path, rec, &outline, &cache));
+    }
+
+    // Volatile paths aren't cached, but still stroke the same.
+    SkPath volatilePath = zigzag();
+    volatilePath.setIsVolatile(true);
+    SkPath outline;
+    REPORTER_ASSERT(reporter, SkStrokeCache::ApplyToPath(rec, volatilePath, &outline, &cache));
+    REPORTER_ASSERT(reporter, outline == expected);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(volatilePath, rec, &outline, &cache));
+}
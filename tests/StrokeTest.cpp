@@ -5,8 +5,11 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
+#include "SkCanvas.h"
 #include "SkPaint.h"
 #include "SkPath.h"
+#include "SkRandom.h"
 #include "SkRect.h"
 #include "SkStroke.h"
 #include "SkStrokeRec.h"
@@ -185,3 +188,79 @@ DEF_TEST(Stroke, reporter) {
     test_strokerec_equality(reporter);
     test_big_stroke(reporter);
 }
+
+// Polylines with several contours, some closed, with repeated points, tiny segments, reversals
+// and runs of collinear points.
+static SkPath make_polyline(SkRandom* rand) {
+    SkPath path;
+    int contours = rand->nextRangeU(1, 3);
+    for (int c = 0; c < contours; ++c) {
+        SkPoint pt = { rand->nextRangeScalar(10, 90), rand->nextRangeScalar(10, 90) };
+        path.moveTo(pt);
+        int count = rand->nextRangeU(0, 150);
+        for (int i = 0; i < count; ++i) {
+            switch (rand->nextULessThan(8)) {
+                case 0:                                                                 break;
+                case 1: pt += SkVector::Make(rand->nextSScalar1(), 0) * 0.0001f;       break;
+                case 2: pt = path.getPoint(path.countPoints() - 2);                     break;
+                case 3: pt += pt - path.getPoint(SkTMax(0, path.countPoints() - 2));   break;
+                default:
+                    pt += SkVector::Make(rand->nextSScalar1(), rand->nextSScalar1()) * 12;
+                    break;
+            }
+            path.lineTo(pt);
+        }
+        if (rand->nextBool()) {
+            path.close();
+        }
+    }
+    if (rand->nextULessThan(4) == 0) {
+        path.setFillType(SkPath::kInverseWinding_FillType);
+    }
+    return path;
+}
+
+static bool draws_same(const SkPath& a, const SkPath& b) {
+    SkBitmap bitmaps[2];
+    const SkPath* paths[2] = { &a, &b };
+    for (int i = 0; i < 2; ++i) {
+        bitmaps[i].allocN32Pixels(100, 100);
+        SkCanvas canvas(bitmaps[i]);
+        canvas.clear(SK_ColorWHITE);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        canvas.drawPath(*paths[i], paint);
+    }
+    return 0 == memcmp(bitmaps[0].getPixels(), bitmaps[1].getPixels(),
+                       bitmaps[0].computeByteSize());
+}
+
+// Line-only paths are stroked by a faster stroker, which should match the general one exactly.
+DEF_TEST(StrokePolyline, reporter) {
+    SkRandom rand;
+    for (int i = 0; i < 300; ++i) {
+        SkPath path = make_polyline(&rand);
+
+        SkStroke stroke;
+        stroke.setWidth(rand.nextRangeScalar(0.5f, 12));
+        stroke.setCap((SkPaint::Cap)rand.nextULessThan(SkPaint::kCapCount));
+        stroke.setJoin((SkPaint::Join)rand.nextULessThan(SkPaint::kJoinCount));
+        stroke.setMiterLimit(rand.nextRangeScalar(0.5f, 6));
+        stroke.setResScale(rand.nextBool() ? 1 : rand.nextRangeScalar(0.25f, 8));
+
+        SkPath results[2];
+        for (int batch = 0; batch < 2; ++batch) {
+            stroke.setBatchPolylinesForTesting(batch);
+            stroke.strokePath(path, &results[batch]);
+        }
+        REPORTER_ASSERT(reporter, results[0] == results[1]);
+        REPORTER_ASSERT(reporter, results[0].isVolatile() == results[1].isVolatile());
+        REPORTER_ASSERT(reporter, draws_same(results[0], results[1]));
+
+        // Both should continue the same way, too.
+        for (SkPath& result : results) {
+            result.lineTo(50, 50);
+        }
+        REPORTER_ASSERT(reporter, results[0] == results[1]);
+    }
+}
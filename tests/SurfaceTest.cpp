@@ -13,8 +13,12 @@
 #include "GrRenderTargetContext.h"
 #include "GrResourceProvider.h"
 #include "SkCanvas.h"
+#include "SkColorSpace.h"
 #include "SkData.h"
 #include "SkDevice.h"
+#include "SkExecutor.h"
+#include "SkFont.h"
+#include "SkGradientShader.h"
 #include "SkGpuDevice.h"
 #include "SkImage_Base.h"
 #include "SkImage_Gpu.h"
@@ -653,6 +657,114 @@ DEF_TEST(surface_raster_zeroinitialized, reporter) {
     }
 }
 
+static void draw_threaded_scene(SkCanvas* canvas, SkSurface* surface) {
+    canvas->clear(SK_ColorWHITE);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    for (int i = 0; i < 50; ++i) {
+        paint.setColor(0x80000000 | (i * 0x050301));
+        canvas->drawRect(SkRect::MakeXYWH(i * 7.3f, i * 11.1f, 120, 40), paint);
+    }
+
+    canvas->save();
+    canvas->clipRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(20.5f, 30.5f, 300.5f, 430.5f), 40, 40),
+                      true);
+    const SkPoint pts[] = { {0, 0}, {320, 480} };
+    const SkColor colors[] = { SK_ColorRED, SK_ColorBLUE };
+    paint.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                 SkShader::kClamp_TileMode));
+    canvas->drawPaint(paint);
+    paint.setShader(nullptr);
+    canvas->restore();
+
+    SkPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(300, 50, -100, 300, 310, 470);
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(9);
+    paint.setColor(SK_ColorGREEN);
+    canvas->drawPath(path, paint);
+    paint.setStrokeWidth(0);
+    canvas->translate(3, 0);
+    canvas->drawPath(path, paint);
+    canvas->translate(-3, 0);
+    // Shallow anti-aliased hairlines blend vertical pixel pairs, which straddle tile seams.
+    for (int i = 0; i < 8; ++i) {
+        canvas->drawLine(5, 20.3f + i * 55.1f, 315, 60.6f + i * 51.7f, paint);
+    }
+
+    // Tiles share one scan conversion of each path, including inverse fills, which blit every
+    // row of their clip, and aliased fills.
+    paint.setStyle(SkPaint::kFill_Style);
+    paint.setColor(0x6000A0FF);
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(200.5f, 250.5f, 310.5f, 400.5f), true);
+    path.setFillType(SkPath::kInverseWinding_FillType);
+    canvas->drawPath(path, paint);
+    path.setFillType(SkPath::kWinding_FillType);
+    canvas->restore();
+    paint.setAntiAlias(false);
+    canvas->drawPath(path, paint);
+    paint.setAntiAlias(true);
+
+    // Snapshotting in the middle of the scene must see all the draws so far.
+    sk_sp<SkImage> snapshot = surface->makeImageSnapshot();
+
+    paint.setStyle(SkPaint::kFill_Style);
+    canvas->saveLayerAlpha(nullptr, 0x80);
+    canvas->rotate(15);
+    canvas->drawImage(snapshot, 40, 0);
+    canvas->drawOval(SkRect::MakeXYWH(100, 100, 150, 250), paint);
+    canvas->restore();
+
+    SkBitmap mutableBitmap;
+    mutableBitmap.allocN32Pixels(20, 20);
+    mutableBitmap.eraseColor(SK_ColorMAGENTA);
+    canvas->drawBitmap(mutableBitmap, 5, 400);
+    mutableBitmap.eraseColor(SK_ColorCYAN);    // must not affect the draw above
+    canvas->drawBitmap(mutableBitmap, 30, 400);
+
+    paint.setColor(SK_ColorBLACK);
+    canvas->drawString("threaded", 50, 200, SkFont(nullptr, 24), paint);
+    const SkPoint points[] = { {5, 5}, {315, 5}, {315, 475}, {5, 475} };
+    paint.setStrokeWidth(5);
+    canvas->drawPoints(SkCanvas::kPolygon_PointMode, SK_ARRAY_COUNT(points), points, paint);
+}
+
+DEF_TEST(surface_raster_threaded, reporter) {
+    // N32 draws anti-aliased content serially wherever it may use the legacy blitters,
+    // while F16 always uses SkRasterPipelineBlitter and so draws everything in tiles.
+    const SkImageInfo infos[] = {
+        SkImageInfo::MakeN32Premul(320, 480),
+        SkImageInfo::Make(320, 480, kRGBA_F16_SkColorType, kPremul_SkAlphaType,
+                          SkColorSpace::MakeSRGBLinear()),
+    };
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+
+    for (const SkImageInfo& info : infos) {
+        auto expected = SkSurface::MakeRaster(info);
+        draw_threaded_scene(expected->getCanvas(), expected.get());
+
+        for (int tiles : { 0, 1, 7, 480 }) {
+            auto threaded = SkSurface::MakeRasterThreaded(info, executor.get(), tiles);
+            REPORTER_ASSERT(reporter, threaded);
+            draw_threaded_scene(threaded->getCanvas(), threaded.get());
+
+            SkPixmap expectedPixels, threadedPixels;
+            REPORTER_ASSERT(reporter, expected->peekPixels(&expectedPixels));
+            REPORTER_ASSERT(reporter, threaded->peekPixels(&threadedPixels));
+            int mismatches = 0;
+            for (int y = 0; y < info.height(); ++y) {
+                mismatches += 0 != memcmp(expectedPixels.addr(0, y), threadedPixels.addr(0, y),
+                                          info.minRowBytes());
+            }
+            REPORTER_ASSERT(reporter, mismatches == 0, "color type %d, tiles %d: %d rows differ",
+                            info.colorType(), tiles, mismatches);
+        }
+    }
+}
+
 static sk_sp<SkSurface> create_gpu_surface_backend_texture(
     GrContext* context, int sampleCnt, uint32_t color, GrBackendTexture* outTexture) {
     GrGpu* gpu = context->priv().getGpu();
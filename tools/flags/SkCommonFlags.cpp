@@ -96,6 +96,29 @@ DEFINE_bool(forceAnalyticAA, false, "Force analytic anti-aliasing even if the pa
 DEFINE_bool(deltaAA, false,
             "If true, use delta anti-aliasing in suitable cases (it overrides forceAnalyticAA.");
 DEFINE_bool(forceDeltaAA, false, "Force delta anti-aliasing for all paths.");
+DEFINE_int32(deltaAAThreads, 0,
+             "If > 1, delta anti-aliasing fills huge paths in this many bands, in parallel.");
+
+DEFINE_bool(batchRasterFills, false,
+            "If true, raster surfaces batch runs of same-paint rect and rrect fills.");
+
+DEFINE_bool(cacheRasterPathMasks, false,
+            "If true, cache the scan conversions of anti-aliased raster path fills.");
+
+DEFINE_bool(cacheStrokedPaths, false,
+            "If true, cache the outlines of stroked paths in the resource cache.");
+
+DEFINE_bool(cacheRasterClips, false,
+            "If true, cache the anti-aliased clips raster surfaces scan convert from paths.");
+
+DEFINE_bool(analyticRasterClips, false,
+            "If true, raster surfaces keep anti-aliased rect and rrect clips analytic.");
+
+DEFINE_int32(glyphRasterThreads, 0,
+             "If > 1, raster text generates missing glyphs in this many parts, in parallel.");
+
+DEFINE_bool(shareStrikes, false,
+            "If true, threads drawing text with the same strike share it rather than copy it.");
 
 DEFINE_int32(backendTiles, 3, "Number of tiles in the experimental threaded backend.");
 DEFINE_int32(backendThreads, 2, "Number of threads in the experimental threaded backend.");
@@ -40,6 +40,14 @@ DECLARE_bool(analyticAA);
 DECLARE_bool(forceAnalyticAA);
 DECLARE_bool(deltaAA);
 DECLARE_bool(forceDeltaAA);
+DECLARE_int32(deltaAAThreads);
+DECLARE_bool(batchRasterFills);
+DECLARE_bool(cacheRasterPathMasks);
+DECLARE_bool(cacheStrokedPaths);
+DECLARE_bool(cacheRasterClips);
+DECLARE_bool(analyticRasterClips);
+DECLARE_int32(glyphRasterThreads);
+DECLARE_bool(shareStrikes);
 DECLARE_string(key);
 DECLARE_string(properties);
 DECLARE_int32(backendTiles);
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2018 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkColorSpace.h"
+#include "SkCommandLineFlags.h"
+#include "SkOSFile.h"
+#include "SkOSPath.h"
+#include "SkPicture.h"
+#include "SkRasterPipeline.h"
+#include "SkStream.h"
+#include "SkSurface.h"
+
+// Draws SKPs into raster surfaces and reports which SkRasterPipeline stage sequences ran, and over
+// how many pixels.  Use this to decide which sequences deserve fused stages.
+
+DEFINE_string2(skps, s, "skps", "A path to a directory of skps or a single skp.");
+DEFINE_string(config, "8888", "Raster config to draw into: 8888, srgb, or f16.");
+DEFINE_int32(maxSize, 4096, "Clamp SKP dimensions to at most this.");
+DEFINE_int32(top, 25, "Print at most this many stage sequences.");
+
+static sk_sp<SkSurface> make_surface(int w, int h) {
+    if (0 == strcmp(FLAGS_config[0], "f16")) {
+        return SkSurface::MakeRaster(SkImageInfo::Make(w, h, kRGBA_F16_SkColorType,
+                                                       kPremul_SkAlphaType,
+                                                       SkColorSpace::MakeSRGBLinear()));
+    }
+    if (0 == strcmp(FLAGS_config[0], "srgb")) {
+        return SkSurface::MakeRaster(SkImageInfo::MakeS32(w, h, kPremul_SkAlphaType));
+    }
+    return SkSurface::MakeRaster(SkImageInfo::MakeN32Premul(w, h));
+}
+
+static bool draw_skp(const SkString& path) {
+    std::unique_ptr<SkStream> stream = SkStream::MakeFromFile(path.c_str());
+    sk_sp<SkPicture> picture = stream ? SkPicture::MakeFromStream(stream.get()) : nullptr;
+    if (!picture) {
+        SkDebugf("Could not read %s.\n", path.c_str());
+        return false;
+    }
+
+    SkIRect bounds = picture->cullRect().roundOut();
+    int w = SkTMin(bounds.width(),  FLAGS_maxSize),
+        h = SkTMin(bounds.height(), FLAGS_maxSize);
+    sk_sp<SkSurface> surface = w > 0 && h > 0 ? make_surface(w, h) : nullptr;
+    if (!surface) {
+        SkDebugf("Could not make a %dx%d %s surface for %s.\n",
+                 w, h, FLAGS_config[0], path.c_str());
+        return false;
+    }
+
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->translate(-bounds.x(), -bounds.y());
+    canvas->drawPicture(picture);
+    canvas->flush();
+    return true;
+}
+
+int main(int argc, char** argv) {
+    SkCommandLineFlags::SetUsage("Usage: raster_pipeline_stats -s <dir of skps or skp> "
+                                 "[--config 8888|srgb|f16] [--top N]\n");
+    SkCommandLineFlags::Parse(argc, argv);
+
+    SkRasterPipeline::SetStatsEnabled(true);
+
+    const char* inputs = FLAGS_skps[0];
+    int drawn = 0;
+    if (sk_isdir(inputs)) {
+        SkOSFile::Iter iter(inputs, "skp");
+        for (SkString file; iter.next(&file); ) {
+            drawn += draw_skp(SkOSPath::Join(inputs, file.c_str()));
+        }
+    } else {
+        drawn += draw_skp(SkString(inputs));
+    }
+    SkRasterPipeline::SetStatsEnabled(false);
+
+    if (drawn == 0) {
+        SkCommandLineFlags::PrintUsage();
+        return 1;
+    }
+
+    std::vector<SkRasterPipeline::SequenceStats> stats = SkRasterPipeline::GetStats();
+    int64_t totalPixels = 0;
+    for (const auto& s : stats) {
+        totalPixels += s.pixels;
+    }
+    SkDebugf("%d skps, %zu stage sequences, %lld pixels\n\n",
+             drawn, stats.size(), (long long)totalPixels);
+    SkDebugf("%8s %14s %10s  %-5s  %s\n", "pixels%", "pixels", "runs", "prec", "stages");
+
+    int64_t printedPixels = 0;
+    for (int i = 0; i < SkTMin((int)stats.size(), FLAGS_top); i++) {
+        const auto& s = stats[i];
+        printedPixels += s.pixels;
+        SkDebugf("%7.2f%% %14lld %10lld  %-5s  %s\n",
+                 totalPixels ? 100.0 * s.pixels / totalPixels : 0.0,
+                 (long long)s.pixels, (long long)s.runs, s.lowp ? "lowp" : "highp",
+                 s.stages.c_str());
+    }
+    if (totalPixels) {
+        SkDebugf("\nThese %d sequences cover %.2f%% of pixels.\n",
+                 SkTMin((int)stats.size(), FLAGS_top), 100.0 * printedPixels / totalPixels);
+    }
+    return 0;
+}